@@ -0,0 +1,326 @@
+/**
+ * @file nhal.hpp
+ * @brief Header-only C++ layer with compile-time pin and pin group bindings.
+ *
+ * Pins and pin groups are template types bound to their backend at compile
+ * time, so no runtime context pointer is stored or passed around, and every
+ * call can be inlined down to whatever the backend does. Pin modes are part
+ * of the type and checked statically (writing an input pin does not compile).
+ *
+ * A backend is any type providing static functions:
+ * - Pin backend:  `nhal_result_t write(bool high)`, `nhal_result_t read(bool *high)`,
+ *                 and optionally `nhal_result_t configure(nhal_pin_dir_t, nhal_pin_pull_mode_t)`.
+ * - Port backend: `nhal_result_t write(uint32_t mask, uint32_t values)`, `nhal_result_t read(uint32_t *values)`,
+ *                 and optionally `nhal_result_t configure(uint32_t mask, nhal_pin_dir_t, nhal_pin_pull_mode_t)`.
+ *
+ * Two generic backends are provided on top of the C interface:
+ * nhal::context_pin (nhal_pin.h) and nhal::context_port (nhal_pin_group.h).
+ * Implementations with direct register access can provide their own backend,
+ * in which case set/get reduce to the raw register operations. Backends
+ * that cannot fail simply return NHAL_OK, which the compiler folds away.
+ *
+ * @par Example usage:
+ * @code
+ * // Register-level port backend supplied by the platform implementation
+ * struct GpioA {
+ *     static nhal_result_t write(uint32_t mask, uint32_t values) {
+ *         GPIOA->BSRR = (mask & values) | ((mask & ~values) << 16);
+ *         return NHAL_OK;
+ *     }
+ *     static nhal_result_t read(uint32_t *values) { *values = GPIOA->IDR; return NHAL_OK; }
+ * };
+ *
+ * typedef nhal::Pin<nhal::port_pin<GpioA, 5>, nhal::Output> Led;
+ * typedef nhal::Pin<nhal::port_pin<GpioA, 0>, nhal::InputPullUp> Button;
+ * typedef nhal::PinGroup<nhal::Pin<nhal::port_pin<GpioA, 8>, nhal::Output>,
+ *                        nhal::Pin<nhal::port_pin<GpioA, 9>, nhal::Output>> Leds;
+ *
+ * Led::high();        // single store to BSRR
+ * Leds::write(0x2);   // both pins updated with a single store to BSRR
+ * Button::high();     // compile error: pin is not an output
+ * @endcode
+ */
+#ifndef NHAL_HPP
+#define NHAL_HPP
+
+#include <stdint.h>
+#include <type_traits>
+
+#include "nhal_pin.h"
+#include "nhal_pin_group.h"
+
+namespace nhal {
+
+/**
+ * @brief Pin mode: output
+ */
+struct Output {
+    static constexpr bool is_output = true;
+    static constexpr nhal_pin_dir_t direction = NHAL_PIN_DIR_OUTPUT;
+    static constexpr nhal_pin_pull_mode_t pull_mode = NHAL_PIN_PMODE_NONE;
+};
+
+/**
+ * @brief Pin mode: floating input
+ */
+struct Input {
+    static constexpr bool is_output = false;
+    static constexpr nhal_pin_dir_t direction = NHAL_PIN_DIR_INPUT;
+    static constexpr nhal_pin_pull_mode_t pull_mode = NHAL_PIN_PMODE_NONE;
+};
+
+/**
+ * @brief Pin mode: input with pull-up resistor
+ */
+struct InputPullUp {
+    static constexpr bool is_output = false;
+    static constexpr nhal_pin_dir_t direction = NHAL_PIN_DIR_INPUT;
+    static constexpr nhal_pin_pull_mode_t pull_mode = NHAL_PIN_PMODE_PULL_UP;
+};
+
+/**
+ * @brief Pin mode: input with pull-down resistor
+ */
+struct InputPullDown {
+    static constexpr bool is_output = false;
+    static constexpr nhal_pin_dir_t direction = NHAL_PIN_DIR_INPUT;
+    static constexpr nhal_pin_pull_mode_t pull_mode = NHAL_PIN_PMODE_PULL_DOWN;
+};
+
+/**
+ * @brief Pin backend bound to a statically allocated nhal_pin_context
+ *
+ * @tparam Ctx Address of the pin context (must have static storage duration)
+ */
+template <struct nhal_pin_context *Ctx>
+struct context_pin {
+    static nhal_result_t write(bool high) {
+        return nhal_pin_set_state(Ctx, high ? NHAL_PIN_HIGH : NHAL_PIN_LOW);
+    }
+    static nhal_result_t read(bool *high) {
+        nhal_pin_state_t state = NHAL_PIN_LOW;
+        nhal_result_t result = nhal_pin_get_state(Ctx, &state);
+        *high = (state == NHAL_PIN_HIGH);
+        return result;
+    }
+    static nhal_result_t configure(nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode) {
+        return nhal_pin_set_direction(Ctx, direction, pull_mode);
+    }
+};
+
+/**
+ * @brief Port backend bound to a statically allocated nhal_pin_group_context
+ *
+ * @tparam Ctx Address of the pin group context (must have static storage duration)
+ */
+template <struct nhal_pin_group_context *Ctx>
+struct context_port {
+    static nhal_result_t write(uint32_t mask, uint32_t values) {
+        return nhal_pin_group_write(Ctx, mask, values);
+    }
+    static nhal_result_t read(uint32_t *values) {
+        return nhal_pin_group_read(Ctx, values);
+    }
+    static nhal_result_t configure(uint32_t mask, nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode) {
+        return nhal_pin_group_set_direction(Ctx, mask, direction, pull_mode);
+    }
+};
+
+/**
+ * @brief Pin backend for a single bit of a port backend
+ *
+ * Pin groups made only of port_pin backends sharing the same port are
+ * accessed with a single port operation.
+ *
+ * @tparam Port Port backend
+ * @tparam Bit Bit of the port driving this pin
+ */
+template <typename Port, unsigned Bit>
+struct port_pin {
+    static_assert(Bit < 32, "nhal::port_pin: bit out of range");
+
+    typedef Port port_type;
+    static constexpr uint32_t mask = UINT32_C(1) << Bit;
+
+    static nhal_result_t write(bool high) {
+        return Port::write(mask, high ? mask : 0u);
+    }
+    static nhal_result_t read(bool *high) {
+        uint32_t values = 0;
+        nhal_result_t result = Port::read(&values);
+        *high = (values & mask) != 0;
+        return result;
+    }
+    static nhal_result_t configure(nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode) {
+        return Port::configure(mask, direction, pull_mode);
+    }
+};
+
+/**
+ * @brief Pin bound at compile time to a backend and a mode
+ *
+ * @tparam Backend Pin backend (see file documentation)
+ * @tparam Mode One of Output, Input, InputPullUp, InputPullDown
+ */
+template <typename Backend, typename Mode>
+class Pin {
+public:
+    typedef Backend backend;
+    typedef Mode mode;
+
+    /** @brief Apply the pin mode to the hardware */
+    static nhal_result_t init() {
+        return Backend::configure(Mode::direction, Mode::pull_mode);
+    }
+
+    static nhal_result_t write(bool high) {
+        static_assert(Mode::is_output, "nhal::Pin: cannot drive a pin that is not in an output mode");
+        return Backend::write(high);
+    }
+
+    static nhal_result_t high() { return write(true); }
+
+    static nhal_result_t low() { return write(false); }
+
+    static nhal_result_t read(bool *high) {
+        return Backend::read(high);
+    }
+};
+
+namespace detail {
+
+template <typename T>
+struct voider { typedef void type; };
+
+template <typename T, typename = void>
+struct port_of { typedef void type; };
+
+template <typename T>
+struct port_of<T, typename voider<typename T::port_type>::type> { typedef typename T::port_type type; };
+
+template <bool... B>
+struct bool_pack;
+
+template <bool... B>
+struct all_of : std::is_same<bool_pack<true, B...>, bool_pack<B..., true> > {};
+
+template <typename... Pins>
+struct common_port { typedef void type; };
+
+template <typename First, typename... Rest>
+struct common_port<First, Rest...> {
+    typedef typename port_of<typename First::backend>::type first_port;
+    typedef typename std::conditional<
+        all_of<std::is_same<first_port, typename port_of<typename Rest::backend>::type>::value...>::value,
+        first_port, void>::type type;
+};
+
+template <unsigned Index, typename... Pins>
+struct group_ops {
+    static constexpr uint32_t port_mask() { return 0u; }
+    static constexpr uint32_t scatter(uint32_t) { return 0u; }
+    static constexpr uint32_t gather(uint32_t) { return 0u; }
+    static nhal_result_t write_each(uint32_t) { return NHAL_OK; }
+    static nhal_result_t read_each(uint32_t *) { return NHAL_OK; }
+};
+
+template <unsigned Index, typename First, typename... Rest>
+struct group_ops<Index, First, Rest...> {
+    typedef group_ops<Index + 1, Rest...> next;
+
+    static constexpr uint32_t port_mask() {
+        return First::backend::mask | next::port_mask();
+    }
+    static constexpr uint32_t scatter(uint32_t values) {
+        return (((values >> Index) & 1u) != 0 ? First::backend::mask : 0u) | next::scatter(values);
+    }
+    static constexpr uint32_t gather(uint32_t port_values) {
+        return ((port_values & First::backend::mask) != 0 ? (UINT32_C(1) << Index) : 0u) | next::gather(port_values);
+    }
+    static nhal_result_t write_each(uint32_t values) {
+        nhal_result_t result = First::write(((values >> Index) & 1u) != 0);
+        return result != NHAL_OK ? result : next::write_each(values);
+    }
+    static nhal_result_t read_each(uint32_t *values) {
+        bool high = false;
+        nhal_result_t result = First::read(&high);
+        if (high) {
+            *values |= UINT32_C(1) << Index;
+        }
+        return result != NHAL_OK ? result : next::read_each(values);
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Group of pins accessed as one value
+ *
+ * Bit N of the values refers to the N-th pin of the group. When all pins
+ * are port_pin backends of the same port, reads and writes become a single
+ * port operation; otherwise pins are accessed one after the other.
+ *
+ * @tparam Pins Pin types (nhal::Pin instantiations)
+ */
+template <typename... Pins>
+class PinGroup {
+    static_assert(sizeof...(Pins) > 0 && sizeof...(Pins) <= 32, "nhal::PinGroup: 1 to 32 pins supported");
+
+    typedef detail::group_ops<0, Pins...> ops;
+    typedef typename detail::common_port<Pins...>::type port;
+    typedef std::integral_constant<bool, !std::is_void<port>::value> single_port;
+
+public:
+    static constexpr unsigned size = sizeof...(Pins);
+
+    /** @brief Apply every pin's mode to the hardware */
+    static nhal_result_t init() {
+        return init_each<Pins...>();
+    }
+
+    static nhal_result_t write(uint32_t values) {
+        static_assert(detail::all_of<Pins::mode::is_output...>::value,
+                      "nhal::PinGroup: cannot drive a group containing pins that are not in an output mode");
+        return write_impl(values, single_port());
+    }
+
+    static nhal_result_t read(uint32_t *values) {
+        return read_impl(values, single_port());
+    }
+
+private:
+    template <typename First, typename Second, typename... Rest>
+    static nhal_result_t init_each() {
+        nhal_result_t result = First::init();
+        return result != NHAL_OK ? result : init_each<Second, Rest...>();
+    }
+
+    template <typename Last>
+    static nhal_result_t init_each() {
+        return Last::init();
+    }
+
+    static nhal_result_t write_impl(uint32_t values, std::true_type) {
+        return port::write(ops::port_mask(), ops::scatter(values));
+    }
+
+    static nhal_result_t write_impl(uint32_t values, std::false_type) {
+        return ops::write_each(values);
+    }
+
+    static nhal_result_t read_impl(uint32_t *values, std::true_type) {
+        uint32_t port_values = 0;
+        nhal_result_t result = port::read(&port_values);
+        *values = ops::gather(port_values);
+        return result;
+    }
+
+    static nhal_result_t read_impl(uint32_t *values, std::false_type) {
+        *values = 0;
+        return ops::read_each(values);
+    }
+};
+
+} // namespace nhal
+
+#endif /* NHAL_HPP */
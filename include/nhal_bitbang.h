@@ -0,0 +1,1172 @@
+/**
+ * @file nhal_bitbang.h
+ * @brief Software (bit-banged) SPI master, I2C master and 1-Wire engine over a pin group.
+ *
+ * This engine implements nhal_spi_master.h, nhal_i2c_master.h (with
+ * nhal_i2c_transfer.h) and nhal_onewire.h purely on nhal_pin_group.h, for
+ * boards that run out of hardware buses. Instead of toggling pins one call
+ * at a time, every transfer is turned into precomputed pin states at a fixed
+ * step and played back with nhal_pin_group_run_sequence(), a chunk of up to
+ * NHAL_BITBANG_MAX_STEPS steps per call:
+ * - Timing is computed once, in set_config (SPI), at setup (I2C) or from a
+ *   per-speed table (1-Wire), so transfers only fill the step buffer.
+ * - All lines of a bus belong to one pin group and change together, and
+ *   the sampled line states come back with the same call.
+ *
+ * Wiring requirements:
+ * - SPI: SCK, MOSI and CS are push-pull outputs, MISO an input. CS is
+ *   optional (NHAL_BITBANG_NO_PIN) and MISO may be omitted on write-only
+ *   buses. Only full duplex 8-bit words are supported. write_read() clocks
+ *   the tx bytes then the rx bytes with CS asserted throughout.
+ * - I2C: SCL and SDA are open-drain with pull-ups; writing 1 releases the
+ *   line. Clock stretching is not supported. A NACKed address aborts the
+ *   transaction; a NACKed data byte is reported once the chunk it belongs
+ *   to has been played.
+ * - 1-Wire: the data line is open-drain with a pull-up.
+ *
+ * Each engine state is bound to the NHAL API in one of two ways:
+ * - Dispatch mode (NHAL_SPI_DISPATCH / NHAL_I2C_DISPATCH): the exported
+ *   nhal_bitbang_spi_ops / nhal_bitbang_i2c_ops tables are bound to a
+ *   context whose backend_ctx points to the engine state, next to hardware
+ *   backends.
+ * - Standalone: defining NHAL_BITBANG_SPI_NHAL_API, NHAL_BITBANG_I2C_NHAL_API
+ *   and/or NHAL_BITBANG_ONEWIRE_NHAL_API for the whole build makes the
+ *   engine the only implementation: the context structure wraps the engine
+ *   state (ctx->bus) and the nhal_* functions are emitted here.
+ *
+ * The engine is generic: exactly one C translation unit defines
+ * NHAL_BITBANG_IMPLEMENTATION before including this header to emit it.
+ *
+ * @par Example usage:
+ * @code
+ * static struct nhal_bitbang_spi display_spi;
+ * struct nhal_spi_context display_ctx;
+ *
+ * nhal_bitbang_spi_setup(&display_spi, &port_b_group, 3, 5, NHAL_BITBANG_NO_PIN, 6);   // SCK, MOSI, MISO, CS
+ * nhal_spi_context_bind(&display_ctx, &nhal_bitbang_spi_ops, &display_spi);
+ * nhal_spi_master_init(&display_ctx);
+ * nhal_spi_master_set_config(&display_ctx, &(struct nhal_spi_config){ .clock_hz = 4000000 });
+ * nhal_spi_master_write(&display_ctx, frame, sizeof(frame));
+ * @endcode
+ */
+#ifndef NHAL_BITBANG_H
+#define NHAL_BITBANG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nhal_common.h"
+#include "nhal_pin_group.h"
+#include "nhal_spi_master.h"
+#include "nhal_i2c_master.h"
+#include "nhal_i2c_transfer.h"
+#include "nhal_onewire.h"
+
+#ifdef NHAL_SPI_DISPATCH
+#include "nhal_spi_ops.h"
+#endif
+#ifdef NHAL_I2C_DISPATCH
+#include "nhal_i2c_ops.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Pin states played back per nhal_pin_group_run_sequence() call
+ *
+ * Sizes the step buffers of every engine state (two arrays of this many
+ * nhal_pin_group_mask_t). Must hold a 1-Wire byte slot set: at least 184.
+ */
+#ifndef NHAL_BITBANG_MAX_STEPS
+#define NHAL_BITBANG_MAX_STEPS 256
+#endif
+
+/**
+ * @brief SCK frequency used when the SPI configuration leaves clock_hz at 0
+ */
+#ifndef NHAL_BITBANG_SPI_DEFAULT_HZ
+#define NHAL_BITBANG_SPI_DEFAULT_HZ 1000000u
+#endif
+
+/**
+ * @brief Optional line not connected
+ */
+#define NHAL_BITBANG_NO_PIN 0xFF
+
+/**
+ * @brief Software SPI master state
+ */
+struct nhal_bitbang_spi{
+    struct nhal_pin_group_context *group;
+    uint8_t sck_bit;                         /**< Bit of each line within the group. */
+    uint8_t mosi_bit;
+    uint8_t miso_bit;                        /**< NHAL_BITBANG_NO_PIN on write-only buses. */
+    uint8_t cs_bit;                          /**< NHAL_BITBANG_NO_PIN if the application drives chip select. */
+    bool initialized;
+    bool configured;
+    struct nhal_spi_config config;
+    uint32_t step_ns;                        /**< Half SCK period. */
+    nhal_pin_group_mask_t mask;              /**< Lines driven by the engine. */
+    nhal_pin_group_mask_t idle;              /**< SCK idle, CS released. */
+    nhal_pin_group_mask_t first_half;        /**< SCK/CS states of the first half of each bit. */
+    nhal_pin_group_mask_t second_half;
+    nhal_pin_group_mask_t out[NHAL_BITBANG_MAX_STEPS];
+    nhal_pin_group_mask_t in[NHAL_BITBANG_MAX_STEPS];
+};
+
+/**
+ * @brief Software I2C master state
+ */
+struct nhal_bitbang_i2c{
+    struct nhal_pin_group_context *group;
+    uint8_t scl_bit;
+    uint8_t sda_bit;
+    bool initialized;
+    struct nhal_i2c_config config;
+    uint32_t bitrate_hz;
+    uint32_t step_ns;                        /**< Quarter SCL period. */
+    nhal_pin_group_mask_t scl;
+    nhal_pin_group_mask_t sda;
+    size_t count;                            /**< Steps queued in out. */
+    nhal_pin_group_mask_t out[NHAL_BITBANG_MAX_STEPS];
+    nhal_pin_group_mask_t in[NHAL_BITBANG_MAX_STEPS];
+};
+
+/**
+ * @brief 1-Wire slot timing for one speed, in steps of step_ns
+ */
+struct nhal_bitbang_onewire_timing{
+    uint32_t step_ns;
+    uint8_t slot_steps;                      /**< Whole time slot, recovery included. */
+    uint8_t write1_low_steps;
+    uint8_t write0_low_steps;
+    uint8_t read_low_steps;
+    uint8_t read_sample_steps;               /**< Line sampled at the end of this step count. */
+    uint32_t reset_low_ns;
+    uint32_t presence_sample_ns;             /**< From the end of the reset pulse. */
+    uint32_t reset_recovery_ns;
+};
+
+/**
+ * @brief Software 1-Wire master state
+ */
+struct nhal_bitbang_onewire{
+    struct nhal_pin_group_context *group;
+    uint8_t data_bit;
+    bool initialized;
+    struct nhal_onewire_config config;
+    const struct nhal_bitbang_onewire_timing *timing;
+    nhal_pin_group_mask_t out[NHAL_BITBANG_MAX_STEPS];
+    nhal_pin_group_mask_t in[NHAL_BITBANG_MAX_STEPS];
+};
+
+/**
+ * @brief Bind an SPI engine state to its lines (no pin access)
+ * @param bus Engine state
+ * @param group Pin group holding every line, already initialized
+ * @param sck_bit SCK line
+ * @param mosi_bit MOSI line
+ * @param miso_bit MISO line or NHAL_BITBANG_NO_PIN
+ * @param cs_bit Chip select line or NHAL_BITBANG_NO_PIN
+ */
+void nhal_bitbang_spi_setup(struct nhal_bitbang_spi *bus, struct nhal_pin_group_context *group,
+                            uint8_t sck_bit, uint8_t mosi_bit, uint8_t miso_bit, uint8_t cs_bit);
+
+/** @brief nhal_spi_master_init() on an engine state */
+nhal_result_t nhal_bitbang_spi_init(struct nhal_bitbang_spi *bus);
+/** @brief nhal_spi_master_deinit() on an engine state */
+nhal_result_t nhal_bitbang_spi_deinit(struct nhal_bitbang_spi *bus);
+/**
+ * @brief nhal_spi_master_set_config() on an engine state
+ * @retval NHAL_ERR_UNSUPPORTED Half duplex or words other than 8 bits
+ */
+nhal_result_t nhal_bitbang_spi_set_config(struct nhal_bitbang_spi *bus, const struct nhal_spi_config *config);
+/** @brief nhal_spi_master_get_config() on an engine state */
+nhal_result_t nhal_bitbang_spi_get_config(struct nhal_bitbang_spi *bus, struct nhal_spi_config *config);
+/** @brief nhal_spi_master_write_read() on an engine state: tx phase, then rx phase, one chip select */
+nhal_result_t nhal_bitbang_spi_write_read(struct nhal_bitbang_spi *bus, const uint8_t *tx_data, size_t tx_len,
+                                          uint8_t *rx_data, size_t rx_len);
+
+/**
+ * @brief Bind an I2C engine state to its lines (no pin access)
+ * @param bus Engine state
+ * @param group Pin group holding both lines, already initialized
+ * @param scl_bit SCL line
+ * @param sda_bit SDA line
+ * @param bitrate_hz SCL frequency; the closest lower one the step resolution allows is used
+ */
+void nhal_bitbang_i2c_setup(struct nhal_bitbang_i2c *bus, struct nhal_pin_group_context *group,
+                            uint8_t scl_bit, uint8_t sda_bit, uint32_t bitrate_hz);
+
+/** @brief nhal_i2c_master_init() on an engine state: releases both lines */
+nhal_result_t nhal_bitbang_i2c_init(struct nhal_bitbang_i2c *bus);
+/** @brief nhal_i2c_master_deinit() on an engine state */
+nhal_result_t nhal_bitbang_i2c_deinit(struct nhal_bitbang_i2c *bus);
+/** @brief nhal_i2c_master_set_config() on an engine state (stored, the bit rate is set at setup) */
+nhal_result_t nhal_bitbang_i2c_set_config(struct nhal_bitbang_i2c *bus, const struct nhal_i2c_config *config);
+/** @brief nhal_i2c_master_get_config() on an engine state */
+nhal_result_t nhal_bitbang_i2c_get_config(struct nhal_bitbang_i2c *bus, struct nhal_i2c_config *config);
+/**
+ * @brief nhal_i2c_master_perform_transfer() on an engine state
+ *
+ * dev_address addresses every operation; ops[].address is not used.
+ *
+ * @retval NHAL_ERR_NO_RESPONSE Address not acknowledged
+ * @retval NHAL_ERR_TRANSMISSION_ERROR Data byte not acknowledged
+ */
+nhal_result_t nhal_bitbang_i2c_transfer(struct nhal_bitbang_i2c *bus, nhal_i2c_address_t dev_address,
+                                        const nhal_i2c_transfer_op_t *ops, size_t num_ops);
+
+/**
+ * @brief Bind a 1-Wire engine state to its line (no pin access)
+ * @param bus Engine state
+ * @param group Pin group holding the data line, already initialized
+ * @param data_bit Data line
+ */
+void nhal_bitbang_onewire_setup(struct nhal_bitbang_onewire *bus, struct nhal_pin_group_context *group, uint8_t data_bit);
+
+/** @brief nhal_onewire_init() on an engine state: releases the line, standard speed */
+nhal_result_t nhal_bitbang_onewire_init(struct nhal_bitbang_onewire *bus);
+/** @brief nhal_onewire_deinit() on an engine state */
+nhal_result_t nhal_bitbang_onewire_deinit(struct nhal_bitbang_onewire *bus);
+/** @brief nhal_onewire_set_config() on an engine state */
+nhal_result_t nhal_bitbang_onewire_set_config(struct nhal_bitbang_onewire *bus, const struct nhal_onewire_config *config);
+/** @brief nhal_onewire_get_config() on an engine state */
+nhal_result_t nhal_bitbang_onewire_get_config(struct nhal_bitbang_onewire *bus, struct nhal_onewire_config *config);
+/** @brief nhal_onewire_reset() on an engine state */
+nhal_result_t nhal_bitbang_onewire_reset(struct nhal_bitbang_onewire *bus, bool *presence);
+/**
+ * @brief Write bits LSB first, as many time slots per run_sequence call as fit
+ * @param bus Engine state
+ * @param data Bits to write, LSB of data[0] first
+ * @param num_bits Number of bits
+ */
+nhal_result_t nhal_bitbang_onewire_write_bits(struct nhal_bitbang_onewire *bus, const uint8_t *data, size_t num_bits);
+/**
+ * @brief Read bits LSB first, as many time slots per run_sequence call as fit
+ * @param bus Engine state
+ * @param data Buffer for ceil(num_bits / 8) bytes
+ * @param num_bits Number of bits
+ */
+nhal_result_t nhal_bitbang_onewire_read_bits(struct nhal_bitbang_onewire *bus, uint8_t *data, size_t num_bits);
+
+#ifdef NHAL_SPI_DISPATCH
+/** @brief SPI master ops serving contexts bound to a struct nhal_bitbang_spi */
+extern const struct nhal_spi_master_ops nhal_bitbang_spi_ops;
+#elif defined(NHAL_BITBANG_SPI_NHAL_API)
+/** @brief SPI context of the standalone binding */
+struct nhal_spi_context{
+    struct nhal_bitbang_spi bus;
+};
+#endif
+
+#ifdef NHAL_I2C_DISPATCH
+/** @brief I2C master ops serving contexts bound to a struct nhal_bitbang_i2c */
+extern const struct nhal_i2c_master_ops nhal_bitbang_i2c_ops;
+#elif defined(NHAL_BITBANG_I2C_NHAL_API)
+/** @brief I2C context of the standalone binding */
+struct nhal_i2c_context{
+    struct nhal_bitbang_i2c bus;
+};
+#endif
+
+#ifdef NHAL_BITBANG_ONEWIRE_NHAL_API
+/** @brief 1-Wire context of the standalone binding */
+struct nhal_onewire_context{
+    struct nhal_bitbang_onewire bus;
+};
+#endif
+
+#ifdef NHAL_BITBANG_IMPLEMENTATION
+
+static nhal_pin_group_mask_t nhal_bitbang_line(uint8_t bit)
+{
+    return bit == NHAL_BITBANG_NO_PIN ? 0 : (nhal_pin_group_mask_t)1 << bit;
+}
+
+/* ------------------------------------------------------------------------- */
+/* SPI                                                                       */
+/* ------------------------------------------------------------------------- */
+
+void nhal_bitbang_spi_setup(struct nhal_bitbang_spi *bus, struct nhal_pin_group_context *group,
+                            uint8_t sck_bit, uint8_t mosi_bit, uint8_t miso_bit, uint8_t cs_bit)
+{
+    memset(bus, 0, sizeof(*bus));
+    bus->group = group;
+    bus->sck_bit = sck_bit;
+    bus->mosi_bit = mosi_bit;
+    bus->miso_bit = miso_bit;
+    bus->cs_bit = cs_bit;
+}
+
+static void nhal_bitbang_spi_precompute(struct nhal_bitbang_spi *bus)
+{
+    nhal_pin_group_mask_t sck = nhal_bitbang_line(bus->sck_bit);
+    nhal_pin_group_mask_t cs = nhal_bitbang_line(bus->cs_bit);
+    bool cpol = bus->config.mode == NHAL_SPI_MODE_2 || bus->config.mode == NHAL_SPI_MODE_3;
+    bool cpha = bus->config.mode == NHAL_SPI_MODE_1 || bus->config.mode == NHAL_SPI_MODE_3;
+    uint32_t clock_hz = bus->config.clock_hz != 0 ? bus->config.clock_hz : NHAL_BITBANG_SPI_DEFAULT_HZ;
+
+    /* Rounded up: the closest SCK frequency not above the requested one */
+    bus->step_ns = (uint32_t)((UINT64_C(1000000000) + 2u * (uint64_t)clock_hz - 1u) / (2u * (uint64_t)clock_hz));
+    bus->mask = sck | nhal_bitbang_line(bus->mosi_bit) | cs;
+    bus->idle = cs | (cpol ? sck : 0);
+    /* The data line changes with the first half and is sampled at the end of the second */
+    bus->first_half = (cpol != cpha) ? sck : 0;
+    bus->second_half = (cpol != cpha) ? 0 : sck;
+}
+
+nhal_result_t nhal_bitbang_spi_init(struct nhal_bitbang_spi *bus)
+{
+    if (bus == NULL || bus->group == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (bus->initialized) {
+        return NHAL_ERR_ALREADY_INITIALIZED;
+    }
+    if (!bus->configured) {
+        memset(&bus->config, 0, sizeof(bus->config));
+        nhal_bitbang_spi_precompute(bus);
+    }
+    bus->initialized = true;
+    return nhal_pin_group_write(bus->group, bus->mask, bus->idle);
+}
+
+nhal_result_t nhal_bitbang_spi_deinit(struct nhal_bitbang_spi *bus)
+{
+    if (bus == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!bus->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    bus->initialized = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_bitbang_spi_set_config(struct nhal_bitbang_spi *bus, const struct nhal_spi_config *config)
+{
+    if (bus == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (config->mode > NHAL_SPI_MODE_3 || config->bit_order > NHAL_SPI_BIT_ORDER_LSB_FIRST
+        || config->duplex > NHAL_SPI_HALF_DUPLEX || config->word_size > NHAL_SPI_WORD_SIZE_32) {
+        return NHAL_ERR_INVALID_CONFIG;
+    }
+    if (config->duplex != NHAL_SPI_FULL_DUPLEX || config->word_size != NHAL_SPI_WORD_SIZE_8) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    bus->config = *config;
+    bus->configured = true;
+    nhal_bitbang_spi_precompute(bus);
+    if (bus->initialized) {
+        return nhal_pin_group_write(bus->group, bus->mask, bus->idle);
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_bitbang_spi_get_config(struct nhal_bitbang_spi *bus, struct nhal_spi_config *config)
+{
+    if (bus == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!bus->configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+    *config = bus->config;
+    return NHAL_OK;
+}
+
+/* Clock len bytes out of tx (0xFF if NULL), into rx (if not NULL), CS already asserted */
+static nhal_result_t nhal_bitbang_spi_shift(struct nhal_bitbang_spi *bus, const uint8_t *tx, uint8_t *rx, size_t len,
+                                            bool last)
+{
+    const size_t bytes_per_chunk = (NHAL_BITBANG_MAX_STEPS - 1) / 16;
+    nhal_pin_group_mask_t mosi = nhal_bitbang_line(bus->mosi_bit);
+    nhal_pin_group_mask_t miso = nhal_bitbang_line(bus->miso_bit);
+    nhal_pin_group_mask_t first = bus->first_half;
+    nhal_pin_group_mask_t second = bus->second_half;
+    bool lsb_first = bus->config.bit_order == NHAL_SPI_BIT_ORDER_LSB_FIRST;
+
+    while (len > 0) {
+        size_t chunk = len < bytes_per_chunk ? len : bytes_per_chunk;
+        size_t count = 0;
+        size_t i;
+        int bit;
+        nhal_result_t result;
+
+        for (i = 0; i < chunk; i++) {
+            unsigned value = tx != NULL ? tx[i] : 0xFFu;
+            if (lsb_first) {
+                for (bit = 0; bit < 8; bit++) {
+                    nhal_pin_group_mask_t data = ((value >> bit) & 1u) ? mosi : 0;
+                    bus->out[count++] = first | data;
+                    bus->out[count++] = second | data;
+                }
+            } else {
+                for (bit = 7; bit >= 0; bit--) {
+                    nhal_pin_group_mask_t data = ((value >> bit) & 1u) ? mosi : 0;
+                    bus->out[count++] = first | data;
+                    bus->out[count++] = second | data;
+                }
+            }
+        }
+        /* Back to the idle clock level before chip select is released */
+        if (last && chunk == len) {
+            bus->out[count] = (bus->idle & ~nhal_bitbang_line(bus->cs_bit)) | (bus->out[count - 1] & mosi);
+            count++;
+        }
+
+        result = nhal_pin_group_run_sequence(bus->group, bus->mask, bus->out, rx != NULL ? bus->in : NULL, count, bus->step_ns);
+        if (result != NHAL_OK) {
+            return result;
+        }
+
+        if (rx != NULL) {
+            for (i = 0; i < chunk; i++) {
+                const nhal_pin_group_mask_t *sample = &bus->in[i * 16 + 1];
+                unsigned value = 0;
+                for (bit = 0; bit < 8; bit++) {
+                    unsigned level = (sample[bit * 2] & miso) ? 1u : 0u;
+                    value = lsb_first ? value | (level << bit) : (value << 1) | level;
+                }
+                rx[i] = (uint8_t)value;
+            }
+            rx += chunk;
+        }
+        if (tx != NULL) {
+            tx += chunk;
+        }
+        len -= chunk;
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_bitbang_spi_write_read(struct nhal_bitbang_spi *bus, const uint8_t *tx_data, size_t tx_len,
+                                          uint8_t *rx_data, size_t rx_len)
+{
+    nhal_pin_group_mask_t cs = nhal_bitbang_line(bus != NULL ? bus->cs_bit : NHAL_BITBANG_NO_PIN);
+    nhal_result_t result;
+
+    if (bus == NULL || (tx_data == NULL && tx_len > 0) || (rx_data == NULL && rx_len > 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!bus->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    if (rx_len > 0 && bus->miso_bit == NHAL_BITBANG_NO_PIN) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    if (tx_len + rx_len == 0) {
+        return NHAL_OK;
+    }
+
+    if (cs != 0) {
+        result = nhal_pin_group_write(bus->group, cs, 0);
+        if (result != NHAL_OK) {
+            return result;
+        }
+    }
+    result = nhal_bitbang_spi_shift(bus, tx_data, NULL, tx_len, rx_len == 0);
+    if (result == NHAL_OK) {
+        result = nhal_bitbang_spi_shift(bus, NULL, rx_data, rx_len, true);
+    }
+    if (cs != 0) {
+        nhal_result_t release = nhal_pin_group_write(bus->group, bus->mask, bus->idle);
+        if (result == NHAL_OK) {
+            result = release;
+        }
+    }
+    return result;
+}
+
+/* ------------------------------------------------------------------------- */
+/* I2C                                                                       */
+/* ------------------------------------------------------------------------- */
+
+void nhal_bitbang_i2c_setup(struct nhal_bitbang_i2c *bus, struct nhal_pin_group_context *group,
+                            uint8_t scl_bit, uint8_t sda_bit, uint32_t bitrate_hz)
+{
+    memset(bus, 0, sizeof(*bus));
+    bus->group = group;
+    bus->scl_bit = scl_bit;
+    bus->sda_bit = sda_bit;
+    bus->bitrate_hz = bitrate_hz != 0 ? bitrate_hz : 100000u;
+    bus->scl = nhal_bitbang_line(scl_bit);
+    bus->sda = nhal_bitbang_line(sda_bit);
+    bus->step_ns = (uint32_t)((UINT64_C(1000000000) + 4u * (uint64_t)bus->bitrate_hz - 1u) / (4u * (uint64_t)bus->bitrate_hz));
+}
+
+nhal_result_t nhal_bitbang_i2c_init(struct nhal_bitbang_i2c *bus)
+{
+    if (bus == NULL || bus->group == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (bus->initialized) {
+        return NHAL_ERR_ALREADY_INITIALIZED;
+    }
+    bus->initialized = true;
+    return nhal_pin_group_write(bus->group, bus->scl | bus->sda, bus->scl | bus->sda);
+}
+
+nhal_result_t nhal_bitbang_i2c_deinit(struct nhal_bitbang_i2c *bus)
+{
+    if (bus == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!bus->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    bus->initialized = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_bitbang_i2c_set_config(struct nhal_bitbang_i2c *bus, const struct nhal_i2c_config *config)
+{
+    if (bus == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    bus->config = *config;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_bitbang_i2c_get_config(struct nhal_bitbang_i2c *bus, struct nhal_i2c_config *config)
+{
+    if (bus == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    *config = bus->config;
+    return NHAL_OK;
+}
+
+static void nhal_bitbang_i2c_step(struct nhal_bitbang_i2c *bus, bool scl, bool sda)
+{
+    bus->out[bus->count++] = (scl ? bus->scl : 0) | (sda ? bus->sda : 0);
+}
+
+/* Each bit takes four quarter periods: hold, data setup, SCL high (sampled at its end), SCL high */
+static void nhal_bitbang_i2c_bit(struct nhal_bitbang_i2c *bus, bool value)
+{
+    bool previous = (bus->out[bus->count - 1] & bus->sda) != 0;
+    nhal_bitbang_i2c_step(bus, false, previous);
+    nhal_bitbang_i2c_step(bus, false, value);
+    nhal_bitbang_i2c_step(bus, true, value);
+    nhal_bitbang_i2c_step(bus, true, value);
+}
+
+static nhal_result_t nhal_bitbang_i2c_flush(struct nhal_bitbang_i2c *bus)
+{
+    nhal_result_t result = NHAL_OK;
+    if (bus->count > 0) {
+        result = nhal_pin_group_run_sequence(bus->group, bus->scl | bus->sda, bus->out, bus->in, bus->count, bus->step_ns);
+    }
+    return result;
+}
+
+/* Keep the last state so the next chunk continues from it */
+static void nhal_bitbang_i2c_restart_chunk(struct nhal_bitbang_i2c *bus)
+{
+    bus->out[0] = bus->out[bus->count - 1];
+    bus->count = 1;
+}
+
+/* Step at which the I-th bit after step index base is sampled */
+#define NHAL_BITBANG_I2C_SAMPLE(base, i) ((base) + (i) * 4u + 2u)
+
+static void nhal_bitbang_i2c_start(struct nhal_bitbang_i2c *bus, bool repeated)
+{
+    if (repeated) {
+        nhal_bitbang_i2c_step(bus, false, true);
+        nhal_bitbang_i2c_step(bus, true, true);
+    }
+    nhal_bitbang_i2c_step(bus, true, true);
+    nhal_bitbang_i2c_step(bus, true, false);
+    nhal_bitbang_i2c_step(bus, false, false);
+}
+
+static void nhal_bitbang_i2c_stop(struct nhal_bitbang_i2c *bus)
+{
+    nhal_bitbang_i2c_step(bus, false, false);
+    nhal_bitbang_i2c_step(bus, true, false);
+    nhal_bitbang_i2c_step(bus, true, true);
+}
+
+/* Queue one byte and its acknowledge bit, returns the step index of the first bit */
+static size_t nhal_bitbang_i2c_byte(struct nhal_bitbang_i2c *bus, unsigned value, bool master_ack)
+{
+    size_t base = bus->count;
+    int bit;
+    for (bit = 7; bit >= 0; bit--) {
+        nhal_bitbang_i2c_bit(bus, ((value >> bit) & 1u) != 0);
+    }
+    nhal_bitbang_i2c_bit(bus, !master_ack);
+    return base;
+}
+
+static bool nhal_bitbang_i2c_acked(const struct nhal_bitbang_i2c *bus, size_t base)
+{
+    return (bus->in[NHAL_BITBANG_I2C_SAMPLE(base, 8)] & bus->sda) == 0;
+}
+
+/* Start (or repeated start), address bytes and their acknowledges, played immediately */
+static nhal_result_t nhal_bitbang_i2c_address(struct nhal_bitbang_i2c *bus, nhal_i2c_address_t address, bool read,
+                                              bool repeated)
+{
+    size_t first, second = 0;
+    nhal_result_t result;
+
+    nhal_bitbang_i2c_start(bus, repeated);
+    if (address.type == NHAL_I2C_10BIT_ADDR) {
+        unsigned high = 0xF0u | ((address.addr.address_10bit >> 7) & 0x06u);
+        first = nhal_bitbang_i2c_byte(bus, high, false);
+        second = nhal_bitbang_i2c_byte(bus, address.addr.address_10bit & 0xFFu, false);
+        if (read) {
+            /* Only the first address byte, with R/W set, follows the repeated start */
+            result = nhal_bitbang_i2c_flush(bus);
+            if (result != NHAL_OK) {
+                return result;
+            }
+            if (!nhal_bitbang_i2c_acked(bus, first) || !nhal_bitbang_i2c_acked(bus, second)) {
+                return NHAL_ERR_NO_RESPONSE;
+            }
+            nhal_bitbang_i2c_restart_chunk(bus);
+            nhal_bitbang_i2c_start(bus, true);
+            first = nhal_bitbang_i2c_byte(bus, high | 1u, false);
+            second = first;
+        }
+    } else {
+        first = nhal_bitbang_i2c_byte(bus, ((unsigned)address.addr.address_7bit << 1) | (read ? 1u : 0u), false);
+        second = first;
+    }
+
+    result = nhal_bitbang_i2c_flush(bus);
+    if (result != NHAL_OK) {
+        return result;
+    }
+    if (!nhal_bitbang_i2c_acked(bus, first) || !nhal_bitbang_i2c_acked(bus, second)) {
+        return NHAL_ERR_NO_RESPONSE;
+    }
+    nhal_bitbang_i2c_restart_chunk(bus);
+    return NHAL_OK;
+}
+
+static nhal_result_t nhal_bitbang_i2c_data(struct nhal_bitbang_i2c *bus, const nhal_i2c_transfer_op_t *op, bool last_read_op)
+{
+    bool read = op->type == NHAL_I2C_READ_OP;
+    size_t len = read ? op->read.length : op->write.length;
+    size_t done = 0;
+
+    while (done < len) {
+        size_t room = (NHAL_BITBANG_MAX_STEPS - bus->count) / 36u;
+        size_t chunk = len - done < room ? len - done : room;
+        size_t base = bus->count;
+        size_t i;
+        nhal_result_t result;
+
+        for (i = 0; i < chunk; i++) {
+            if (read) {
+                /* The master acknowledges every byte but the last one of the transaction */
+                bool ack = !(last_read_op && done + i + 1 == len);
+                nhal_bitbang_i2c_byte(bus, 0xFFu, ack);
+            } else {
+                nhal_bitbang_i2c_byte(bus, op->write.bytes[done + i], false);
+            }
+        }
+        result = nhal_bitbang_i2c_flush(bus);
+        if (result != NHAL_OK) {
+            return result;
+        }
+        for (i = 0; i < chunk; i++) {
+            size_t byte_base = base + i * 36u;
+            if (read) {
+                unsigned value = 0;
+                int bit;
+                for (bit = 0; bit < 8; bit++) {
+                    value = (value << 1) | ((bus->in[NHAL_BITBANG_I2C_SAMPLE(byte_base, bit)] & bus->sda) ? 1u : 0u);
+                }
+                op->read.buffer[done + i] = (uint8_t)value;
+            } else if (!nhal_bitbang_i2c_acked(bus, byte_base)) {
+                return NHAL_ERR_TRANSMISSION_ERROR;
+            }
+        }
+        nhal_bitbang_i2c_restart_chunk(bus);
+        done += chunk;
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_bitbang_i2c_transfer(struct nhal_bitbang_i2c *bus, nhal_i2c_address_t dev_address,
+                                        const nhal_i2c_transfer_op_t *ops, size_t num_ops)
+{
+    nhal_result_t result = NHAL_OK;
+    bool in_transaction = false;
+    size_t i;
+
+    if (bus == NULL || (ops == NULL && num_ops > 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!bus->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    /* Bus idle: both lines released */
+    bus->out[0] = bus->scl | bus->sda;
+    bus->count = 1;
+
+    for (i = 0; i < num_ops && result == NHAL_OK; i++) {
+        const nhal_i2c_transfer_op_t *op = &ops[i];
+        bool read = op->type == NHAL_I2C_READ_OP;
+        bool last_read_op = read && (i + 1 == num_ops || !(op->flags & NHAL_I2C_TRANSFER_MSG_NO_STOP)
+                                     || !(ops[i + 1].flags & NHAL_I2C_TRANSFER_MSG_NO_START));
+
+        if ((read && op->read.buffer == NULL && op->read.length > 0)
+            || (!read && op->write.bytes == NULL && op->write.length > 0)) {
+            result = NHAL_ERR_INVALID_ARG;
+            break;
+        }
+        if (!(op->flags & NHAL_I2C_TRANSFER_MSG_NO_START) || !in_transaction) {
+            if (op->flags & NHAL_I2C_TRANSFER_MSG_NO_ADDR) {
+                nhal_bitbang_i2c_start(bus, in_transaction);
+            } else {
+                result = nhal_bitbang_i2c_address(bus, dev_address, read, in_transaction);
+            }
+            in_transaction = true;
+        }
+        if (result == NHAL_OK) {
+            result = nhal_bitbang_i2c_data(bus, op, last_read_op);
+        }
+        if (result == NHAL_OK && !(op->flags & NHAL_I2C_TRANSFER_MSG_NO_STOP)) {
+            nhal_bitbang_i2c_stop(bus);
+            result = nhal_bitbang_i2c_flush(bus);
+            nhal_bitbang_i2c_restart_chunk(bus);
+            in_transaction = false;
+        }
+    }
+
+    if (in_transaction) {
+        /* Error or NO_STOP on the last operation: release the bus anyway */
+        bus->out[0] = bus->out[bus->count - 1];
+        bus->count = 1;
+        nhal_bitbang_i2c_stop(bus);
+        if (nhal_bitbang_i2c_flush(bus) != NHAL_OK && result == NHAL_OK) {
+            result = NHAL_ERR_HW_FAILURE;
+        }
+    }
+    return result;
+}
+
+/* ------------------------------------------------------------------------- */
+/* 1-Wire                                                                    */
+/* ------------------------------------------------------------------------- */
+
+static const struct nhal_bitbang_onewire_timing nhal_bitbang_onewire_timings[] = {
+    /* Standard: 3 us steps, 69 us slots; write 1: 6 us low, write 0: 60 us low, read sampled at 12 us */
+    { 3000u, 23u, 2u, 20u, 2u, 4u, 480000u, 70000u, 410000u },
+    /* Overdrive: 0.5 us steps, 10 us slots; write 1: 1 us low, write 0: 7.5 us low, read sampled at 2 us */
+    { 500u, 20u, 2u, 15u, 2u, 4u, 70000u, 8500u, 40000u },
+};
+
+void nhal_bitbang_onewire_setup(struct nhal_bitbang_onewire *bus, struct nhal_pin_group_context *group, uint8_t data_bit)
+{
+    memset(bus, 0, sizeof(*bus));
+    bus->group = group;
+    bus->data_bit = data_bit;
+    bus->timing = &nhal_bitbang_onewire_timings[NHAL_ONEWIRE_SPEED_STANDARD];
+}
+
+nhal_result_t nhal_bitbang_onewire_init(struct nhal_bitbang_onewire *bus)
+{
+    nhal_pin_group_mask_t line;
+
+    if (bus == NULL || bus->group == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (bus->initialized) {
+        return NHAL_ERR_ALREADY_INITIALIZED;
+    }
+    line = nhal_bitbang_line(bus->data_bit);
+    bus->initialized = true;
+    return nhal_pin_group_write(bus->group, line, line);
+}
+
+nhal_result_t nhal_bitbang_onewire_deinit(struct nhal_bitbang_onewire *bus)
+{
+    if (bus == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!bus->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    bus->initialized = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_bitbang_onewire_set_config(struct nhal_bitbang_onewire *bus, const struct nhal_onewire_config *config)
+{
+    if (bus == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (config->speed > NHAL_ONEWIRE_SPEED_OVERDRIVE) {
+        return NHAL_ERR_INVALID_CONFIG;
+    }
+    bus->config = *config;
+    bus->timing = &nhal_bitbang_onewire_timings[config->speed];
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_bitbang_onewire_get_config(struct nhal_bitbang_onewire *bus, struct nhal_onewire_config *config)
+{
+    if (bus == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    *config = bus->config;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_bitbang_onewire_reset(struct nhal_bitbang_onewire *bus, bool *presence)
+{
+    nhal_pin_group_mask_t line;
+    nhal_pin_group_mask_t sample;
+    nhal_result_t result;
+
+    if (bus == NULL || presence == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!bus->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    line = nhal_bitbang_line(bus->data_bit);
+
+    /* Phases of different lengths: one single-step sequence each */
+    bus->out[0] = 0;
+    result = nhal_pin_group_run_sequence(bus->group, line, bus->out, NULL, 1, bus->timing->reset_low_ns);
+    if (result == NHAL_OK) {
+        bus->out[0] = line;
+        result = nhal_pin_group_run_sequence(bus->group, line, bus->out, &sample, 1, bus->timing->presence_sample_ns);
+    }
+    if (result != NHAL_OK) {
+        return result;
+    }
+    *presence = (sample & line) == 0;
+    result = nhal_pin_group_run_sequence(bus->group, line, bus->out, &sample, 1, bus->timing->reset_recovery_ns);
+    if (result != NHAL_OK) {
+        return result;
+    }
+    /* Still low long after every presence pulse ended */
+    return (sample & line) == 0 ? NHAL_ERR_HW_FAILURE : NHAL_OK;
+}
+
+/* Play num_bits slots; data supplies the written bits, or is filled with the read ones */
+static nhal_result_t nhal_bitbang_onewire_slots(struct nhal_bitbang_onewire *bus, const uint8_t *tx, uint8_t *rx, size_t num_bits)
+{
+    const struct nhal_bitbang_onewire_timing *timing = bus->timing;
+    nhal_pin_group_mask_t line = nhal_bitbang_line(bus->data_bit);
+    size_t bits_per_chunk = NHAL_BITBANG_MAX_STEPS / timing->slot_steps;
+    size_t done = 0;
+
+    if (!bus->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    if (rx != NULL) {
+        memset(rx, 0, (num_bits + 7) / 8);
+    }
+
+    while (done < num_bits) {
+        size_t chunk = num_bits - done < bits_per_chunk ? num_bits - done : bits_per_chunk;
+        size_t count = 0;
+        size_t i;
+        nhal_result_t result;
+
+        for (i = 0; i < chunk; i++) {
+            size_t bit = done + i;
+            uint8_t low_steps = rx != NULL ? timing->read_low_steps
+                : ((tx[bit / 8] >> (bit % 8)) & 1u) ? timing->write1_low_steps : timing->write0_low_steps;
+            uint8_t step;
+            for (step = 0; step < timing->slot_steps; step++) {
+                bus->out[count++] = step < low_steps ? 0 : line;
+            }
+        }
+        result = nhal_pin_group_run_sequence(bus->group, line, bus->out, rx != NULL ? bus->in : NULL, count, timing->step_ns);
+        if (result != NHAL_OK) {
+            return result;
+        }
+        if (rx != NULL) {
+            for (i = 0; i < chunk; i++) {
+                size_t bit = done + i;
+                if (bus->in[i * timing->slot_steps + timing->read_sample_steps - 1u] & line) {
+                    rx[bit / 8] |= (uint8_t)(1u << (bit % 8));
+                }
+            }
+        }
+        done += chunk;
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_bitbang_onewire_write_bits(struct nhal_bitbang_onewire *bus, const uint8_t *data, size_t num_bits)
+{
+    if (bus == NULL || (data == NULL && num_bits > 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    return nhal_bitbang_onewire_slots(bus, data, NULL, num_bits);
+}
+
+nhal_result_t nhal_bitbang_onewire_read_bits(struct nhal_bitbang_onewire *bus, uint8_t *data, size_t num_bits)
+{
+    if (bus == NULL || (data == NULL && num_bits > 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    return nhal_bitbang_onewire_slots(bus, NULL, data, num_bits);
+}
+
+/* ------------------------------------------------------------------------- */
+/* NHAL API bindings                                                         */
+/* ------------------------------------------------------------------------- */
+
+#if defined(NHAL_SPI_DISPATCH) || defined(NHAL_BITBANG_SPI_NHAL_API)
+
+#ifdef NHAL_SPI_DISPATCH
+#define NHAL_BITBANG_SPI_OF(ctx) ((struct nhal_bitbang_spi *)(ctx)->backend_ctx)
+#define NHAL_BITBANG_SPI_FN(name) nhal_bitbang_spi_op_##name
+#define NHAL_BITBANG_SPI_LINKAGE static
+#else
+#define NHAL_BITBANG_SPI_OF(ctx) (&(ctx)->bus)
+#define NHAL_BITBANG_SPI_FN(name) nhal_spi_master_##name
+#define NHAL_BITBANG_SPI_LINKAGE
+#endif
+
+NHAL_BITBANG_SPI_LINKAGE nhal_result_t NHAL_BITBANG_SPI_FN(init)(struct nhal_spi_context *ctx)
+{
+    return ctx != NULL ? nhal_bitbang_spi_init(NHAL_BITBANG_SPI_OF(ctx)) : NHAL_ERR_INVALID_ARG;
+}
+
+NHAL_BITBANG_SPI_LINKAGE nhal_result_t NHAL_BITBANG_SPI_FN(deinit)(struct nhal_spi_context *ctx)
+{
+    return ctx != NULL ? nhal_bitbang_spi_deinit(NHAL_BITBANG_SPI_OF(ctx)) : NHAL_ERR_INVALID_ARG;
+}
+
+NHAL_BITBANG_SPI_LINKAGE nhal_result_t NHAL_BITBANG_SPI_FN(set_config)(struct nhal_spi_context *ctx, struct nhal_spi_config *config)
+{
+    return ctx != NULL ? nhal_bitbang_spi_set_config(NHAL_BITBANG_SPI_OF(ctx), config) : NHAL_ERR_INVALID_ARG;
+}
+
+NHAL_BITBANG_SPI_LINKAGE nhal_result_t NHAL_BITBANG_SPI_FN(get_config)(struct nhal_spi_context *ctx, struct nhal_spi_config *config)
+{
+    return ctx != NULL ? nhal_bitbang_spi_get_config(NHAL_BITBANG_SPI_OF(ctx), config) : NHAL_ERR_INVALID_ARG;
+}
+
+NHAL_BITBANG_SPI_LINKAGE nhal_result_t NHAL_BITBANG_SPI_FN(write)(struct nhal_spi_context *ctx, const uint8_t *data, size_t len)
+{
+    return ctx != NULL ? nhal_bitbang_spi_write_read(NHAL_BITBANG_SPI_OF(ctx), data, len, NULL, 0) : NHAL_ERR_INVALID_ARG;
+}
+
+NHAL_BITBANG_SPI_LINKAGE nhal_result_t NHAL_BITBANG_SPI_FN(read)(struct nhal_spi_context *ctx, uint8_t *data, size_t len)
+{
+    return ctx != NULL ? nhal_bitbang_spi_write_read(NHAL_BITBANG_SPI_OF(ctx), NULL, 0, data, len) : NHAL_ERR_INVALID_ARG;
+}
+
+NHAL_BITBANG_SPI_LINKAGE nhal_result_t NHAL_BITBANG_SPI_FN(write_read)(struct nhal_spi_context *ctx, const uint8_t *tx_data, size_t tx_len,
+                                                                       uint8_t *rx_data, size_t rx_len)
+{
+    return ctx != NULL ? nhal_bitbang_spi_write_read(NHAL_BITBANG_SPI_OF(ctx), tx_data, tx_len, rx_data, rx_len)
+                       : NHAL_ERR_INVALID_ARG;
+}
+
+#ifdef NHAL_SPI_DISPATCH
+const struct nhal_spi_master_ops nhal_bitbang_spi_ops = {
+    .init = NHAL_BITBANG_SPI_FN(init),
+    .deinit = NHAL_BITBANG_SPI_FN(deinit),
+    .set_config = NHAL_BITBANG_SPI_FN(set_config),
+    .get_config = NHAL_BITBANG_SPI_FN(get_config),
+    .write = NHAL_BITBANG_SPI_FN(write),
+    .read = NHAL_BITBANG_SPI_FN(read),
+    .write_read = NHAL_BITBANG_SPI_FN(write_read),
+};
+#endif
+
+#undef NHAL_BITBANG_SPI_OF
+#undef NHAL_BITBANG_SPI_FN
+#undef NHAL_BITBANG_SPI_LINKAGE
+
+#endif /* NHAL_SPI_DISPATCH || NHAL_BITBANG_SPI_NHAL_API */
+
+#if defined(NHAL_I2C_DISPATCH) || defined(NHAL_BITBANG_I2C_NHAL_API)
+
+#ifdef NHAL_I2C_DISPATCH
+#define NHAL_BITBANG_I2C_OF(ctx) ((struct nhal_bitbang_i2c *)(ctx)->backend_ctx)
+#define NHAL_BITBANG_I2C_FN(name) nhal_bitbang_i2c_op_##name
+#define NHAL_BITBANG_I2C_LINKAGE static
+#else
+#define NHAL_BITBANG_I2C_OF(ctx) (&(ctx)->bus)
+#define NHAL_BITBANG_I2C_FN(name) nhal_i2c_master_##name
+#define NHAL_BITBANG_I2C_LINKAGE
+#endif
+
+NHAL_BITBANG_I2C_LINKAGE nhal_result_t NHAL_BITBANG_I2C_FN(init)(struct nhal_i2c_context *ctx)
+{
+    return ctx != NULL ? nhal_bitbang_i2c_init(NHAL_BITBANG_I2C_OF(ctx)) : NHAL_ERR_INVALID_ARG;
+}
+
+NHAL_BITBANG_I2C_LINKAGE nhal_result_t NHAL_BITBANG_I2C_FN(deinit)(struct nhal_i2c_context *ctx)
+{
+    return ctx != NULL ? nhal_bitbang_i2c_deinit(NHAL_BITBANG_I2C_OF(ctx)) : NHAL_ERR_INVALID_ARG;
+}
+
+NHAL_BITBANG_I2C_LINKAGE nhal_result_t NHAL_BITBANG_I2C_FN(set_config)(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config)
+{
+    return ctx != NULL ? nhal_bitbang_i2c_set_config(NHAL_BITBANG_I2C_OF(ctx), config) : NHAL_ERR_INVALID_ARG;
+}
+
+NHAL_BITBANG_I2C_LINKAGE nhal_result_t NHAL_BITBANG_I2C_FN(get_config)(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config)
+{
+    return ctx != NULL ? nhal_bitbang_i2c_get_config(NHAL_BITBANG_I2C_OF(ctx), config) : NHAL_ERR_INVALID_ARG;
+}
+
+NHAL_BITBANG_I2C_LINKAGE nhal_result_t NHAL_BITBANG_I2C_FN(write)(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                                                  const uint8_t *data, size_t len)
+{
+    nhal_i2c_transfer_op_t op;
+
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    memset(&op, 0, sizeof(op));
+    op.type = NHAL_I2C_WRITE_OP;
+    op.address = dev_address;
+    op.write.bytes = data;
+    op.write.length = len;
+    return nhal_bitbang_i2c_transfer(NHAL_BITBANG_I2C_OF(ctx), dev_address, &op, 1);
+}
+
+NHAL_BITBANG_I2C_LINKAGE nhal_result_t NHAL_BITBANG_I2C_FN(read)(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                                                 uint8_t *data, size_t len)
+{
+    nhal_i2c_transfer_op_t op;
+
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    memset(&op, 0, sizeof(op));
+    op.type = NHAL_I2C_READ_OP;
+    op.address = dev_address;
+    op.read.buffer = data;
+    op.read.length = len;
+    return nhal_bitbang_i2c_transfer(NHAL_BITBANG_I2C_OF(ctx), dev_address, &op, 1);
+}
+
+NHAL_BITBANG_I2C_LINKAGE nhal_result_t NHAL_BITBANG_I2C_FN(write_read_reg)(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                                                           const uint8_t *reg_address, size_t reg_len,
+                                                                           uint8_t *data, size_t data_len)
+{
+    nhal_i2c_transfer_op_t ops[2];
+
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    memset(ops, 0, sizeof(ops));
+    ops[0].type = NHAL_I2C_WRITE_OP;
+    ops[0].address = dev_address;
+    ops[0].flags = NHAL_I2C_TRANSFER_MSG_NO_STOP;
+    ops[0].write.bytes = reg_address;
+    ops[0].write.length = reg_len;
+    ops[1].type = NHAL_I2C_READ_OP;
+    ops[1].address = dev_address;
+    ops[1].read.buffer = data;
+    ops[1].read.length = data_len;
+    return nhal_bitbang_i2c_transfer(NHAL_BITBANG_I2C_OF(ctx), dev_address, ops, 2);
+}
+
+NHAL_BITBANG_I2C_LINKAGE nhal_result_t NHAL_BITBANG_I2C_FN(perform_transfer)(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                                                             nhal_i2c_transfer_op_t *ops, size_t num_ops)
+{
+    return ctx != NULL ? nhal_bitbang_i2c_transfer(NHAL_BITBANG_I2C_OF(ctx), dev_address, ops, num_ops) : NHAL_ERR_INVALID_ARG;
+}
+
+#ifdef NHAL_I2C_DISPATCH
+const struct nhal_i2c_master_ops nhal_bitbang_i2c_ops = {
+    .init = NHAL_BITBANG_I2C_FN(init),
+    .deinit = NHAL_BITBANG_I2C_FN(deinit),
+    .set_config = NHAL_BITBANG_I2C_FN(set_config),
+    .get_config = NHAL_BITBANG_I2C_FN(get_config),
+    .write = NHAL_BITBANG_I2C_FN(write),
+    .read = NHAL_BITBANG_I2C_FN(read),
+    .write_read_reg = NHAL_BITBANG_I2C_FN(write_read_reg),
+    .perform_transfer = NHAL_BITBANG_I2C_FN(perform_transfer),
+};
+#endif
+
+#undef NHAL_BITBANG_I2C_OF
+#undef NHAL_BITBANG_I2C_FN
+#undef NHAL_BITBANG_I2C_LINKAGE
+
+#endif /* NHAL_I2C_DISPATCH || NHAL_BITBANG_I2C_NHAL_API */
+
+#ifdef NHAL_BITBANG_ONEWIRE_NHAL_API
+
+nhal_result_t nhal_onewire_init(struct nhal_onewire_context *ctx)
+{
+    return ctx != NULL ? nhal_bitbang_onewire_init(&ctx->bus) : NHAL_ERR_INVALID_ARG;
+}
+
+nhal_result_t nhal_onewire_deinit(struct nhal_onewire_context *ctx)
+{
+    return ctx != NULL ? nhal_bitbang_onewire_deinit(&ctx->bus) : NHAL_ERR_INVALID_ARG;
+}
+
+nhal_result_t nhal_onewire_set_config(struct nhal_onewire_context *ctx, struct nhal_onewire_config *config)
+{
+    return ctx != NULL ? nhal_bitbang_onewire_set_config(&ctx->bus, config) : NHAL_ERR_INVALID_ARG;
+}
+
+nhal_result_t nhal_onewire_get_config(struct nhal_onewire_context *ctx, struct nhal_onewire_config *config)
+{
+    return ctx != NULL ? nhal_bitbang_onewire_get_config(&ctx->bus, config) : NHAL_ERR_INVALID_ARG;
+}
+
+nhal_result_t nhal_onewire_reset(struct nhal_onewire_context *ctx, bool *presence)
+{
+    return ctx != NULL ? nhal_bitbang_onewire_reset(&ctx->bus, presence) : NHAL_ERR_INVALID_ARG;
+}
+
+nhal_result_t nhal_onewire_write_bit(struct nhal_onewire_context *ctx, bool bit)
+{
+    uint8_t value = bit ? 1u : 0u;
+    return ctx != NULL ? nhal_bitbang_onewire_write_bits(&ctx->bus, &value, 1) : NHAL_ERR_INVALID_ARG;
+}
+
+nhal_result_t nhal_onewire_read_bit(struct nhal_onewire_context *ctx, bool *bit)
+{
+    uint8_t value;
+    nhal_result_t result;
+
+    if (ctx == NULL || bit == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    result = nhal_bitbang_onewire_read_bits(&ctx->bus, &value, 1);
+    *bit = value != 0;
+    return result;
+}
+
+nhal_result_t nhal_onewire_write(struct nhal_onewire_context *ctx, const uint8_t *data, size_t len)
+{
+    return ctx != NULL ? nhal_bitbang_onewire_write_bits(&ctx->bus, data, len * 8) : NHAL_ERR_INVALID_ARG;
+}
+
+nhal_result_t nhal_onewire_read(struct nhal_onewire_context *ctx, uint8_t *data, size_t len)
+{
+    return ctx != NULL ? nhal_bitbang_onewire_read_bits(&ctx->bus, data, len * 8) : NHAL_ERR_INVALID_ARG;
+}
+
+#endif /* NHAL_BITBANG_ONEWIRE_NHAL_API */
+
+#endif /* NHAL_BITBANG_IMPLEMENTATION */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_BITBANG_H */
@@ -0,0 +1,170 @@
+/**
+ * @file nhal_can.h
+ * @brief Header for the Hardware Abstraction Layer (HAL) CAN controller module.
+ *
+ * This module provides an interface for classic CAN controllers. Received
+ * frames are sorted by the controller's hardware acceptance filters into RX
+ * FIFOs, so at full bus load the CPU only handles the frames it asked for.
+ * A FIFO is read in batches: nhal_can_receive() returns every frame waiting,
+ * up to the caller's buffer size, in one call, and the optional RX callback
+ * fires once per watermark instead of once per frame.
+ *
+ * Frames are transmitted through the controller's TX mailboxes. When several
+ * are pending, the configured priority decides whether the lowest identifier
+ * or the oldest submission is sent first.
+ *
+ * @par Example usage:
+ * @code
+ * static const nhal_can_filter_t filters[] = {
+ *     { .id = 0x100, .mask = 0x7F0, .fifo = 0 },                                    // 0x100-0x10F
+ *     { .id = 0x18FF0000, .mask = 0x1FFF0000, .flags = NHAL_CAN_FILTER_EXTENDED, .fifo = 1 },
+ * };
+ * struct nhal_can_config config = { .bitrate = 1000000, .rx_watermark = 4 };
+ * nhal_can_set_config(can_ctx, &config);
+ * nhal_can_set_filters(can_ctx, filters, 2);
+ * nhal_can_start(can_ctx);
+ *
+ * nhal_can_frame_t frames[8];
+ * size_t count;
+ * if (nhal_can_receive(can_ctx, 0, frames, 8, &count, 10) == NHAL_OK) {
+ *     for (size_t i = 0; i < count; i++) {
+ *         handle_frame(&frames[i]);
+ *     }
+ * }
+ * @endcode
+ */
+#ifndef NHAL_CAN_H
+#define NHAL_CAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_can_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize CAN context
+ * @param ctx Pointer to CAN context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_can_init(struct nhal_can_context *ctx);
+
+/**
+ * @brief Deinitialize CAN context
+ * @param ctx Pointer to CAN context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_can_deinit(struct nhal_can_context *ctx);
+
+/**
+ * @brief Set CAN configuration
+ * @param ctx Pointer to CAN context structure
+ * @param config Pointer to configuration structure
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_BUSY Controller is started, stop it first
+ * @retval NHAL_ERR_UNSUPPORTED Bit rate or sample point not reachable from the controller clock
+ */
+nhal_result_t nhal_can_set_config(struct nhal_can_context *ctx, struct nhal_can_config *config);
+
+/**
+ * @brief Get current CAN configuration
+ * @param ctx Pointer to CAN context structure
+ * @param config Pointer to configuration structure to fill
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_can_get_config(struct nhal_can_context *ctx, struct nhal_can_config *config);
+
+/**
+ * @brief Load the acceptance filter table
+ *
+ * Replaces the whole table; frames are checked against the filters in order
+ * and the first match decides the FIFO. Frames matching no filter never
+ * reach software, so an empty table, the state after init, receives nothing;
+ * one filter with a mask of 0 per identifier type accepts every frame. May be
+ * called while started: frames arriving during the update are filtered by
+ * either the old or the new table.
+ *
+ * @param ctx Pointer to CAN context structure
+ * @param filters Filter table (copied)
+ * @param num_filters Number of filters
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_CONFIG A filter targets a FIFO the controller does not have
+ * @retval NHAL_ERR_UNSUPPORTED More filters than hardware filter banks
+ */
+nhal_result_t nhal_can_set_filters(struct nhal_can_context *ctx, const nhal_can_filter_t *filters, size_t num_filters);
+
+/**
+ * @brief Join the bus
+ *
+ * Resets the statistics and empties the RX FIFOs.
+ *
+ * @param ctx Pointer to CAN context structure
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_NOT_CONFIGURED No configuration set
+ * @retval NHAL_ERR_ALREADY_STARTED Controller already started
+ */
+nhal_result_t nhal_can_start(struct nhal_can_context *ctx);
+
+/**
+ * @brief Leave the bus, aborting pending transmissions
+ * @param ctx Pointer to CAN context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_can_stop(struct nhal_can_context *ctx);
+
+/**
+ * @brief Queue a frame in a free TX mailbox
+ *
+ * Returns once the frame is in a mailbox, not when it has been sent.
+ *
+ * @param ctx Pointer to CAN context structure
+ * @param frame Frame to send (copied)
+ * @param timeout_ms Maximum time to wait for a free mailbox (0: do not wait)
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_TIMEOUT No mailbox became free within timeout_ms
+ * @retval NHAL_ERR_NOT_STARTED Controller not started
+ * @retval NHAL_ERR_UNSUPPORTED Controller is in listen-only mode
+ * @retval NHAL_ERR_HW_FAILURE Controller is bus-off
+ */
+nhal_result_t nhal_can_transmit(struct nhal_can_context *ctx, const nhal_can_frame_t *frame, uint32_t timeout_ms);
+
+/**
+ * @brief Read every frame waiting in an RX FIFO, up to max_frames
+ *
+ * Waits for the first frame only; frames are returned in reception order.
+ *
+ * @param ctx Pointer to CAN context structure
+ * @param fifo RX FIFO index
+ * @param frames Buffer for the frames
+ * @param max_frames Capacity of frames
+ * @param received Pointer to store the number of frames read
+ * @param timeout_ms Maximum time to wait for a frame (0: do not wait)
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_TIMEOUT No frame received within timeout_ms
+ * @retval NHAL_ERR_NOT_STARTED Controller not started
+ */
+nhal_result_t nhal_can_receive(struct nhal_can_context *ctx, uint8_t fifo, nhal_can_frame_t *frames, size_t max_frames,
+                               size_t *received, uint32_t timeout_ms);
+
+/**
+ * @brief Get CAN statistics and error state
+ * @param ctx Pointer to CAN context structure
+ * @param stats Pointer to statistics structure to fill
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_can_get_stats(struct nhal_can_context *ctx, struct nhal_can_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_CAN_H */
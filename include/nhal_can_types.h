@@ -0,0 +1,151 @@
+/**
+ * @file nhal_can_types.h
+ * @brief Defines the types and structures used by the CAN controller HAL module.
+ *
+ * This header provides definitions for the CAN context, frames, acceptance
+ * filters, the controller configuration and its statistics.
+ */
+#ifndef NHAL_CAN_TYPES_H
+#define NHAL_CAN_TYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "nhal_common.h"
+
+/**
+ * @brief CAN context structure (implementation-defined)
+ *
+ * Contains platform-specific controller identification and runtime state.
+ *
+ * @par Example content:
+ * @code
+ * struct nhal_can_context {
+ *     // Controller identification
+ *     CAN_TypeDef *can;
+ *     // First filter bank owned by this controller (banks shared between CAN1/CAN2)
+ *     uint8_t first_filter_bank;
+ *     // RTOS objects the RX/TX interrupts signal
+ *     semaphore_t rx_ready[2];
+ *     semaphore_t tx_mailbox_free;
+ * };
+ * @endcode
+ */
+struct nhal_can_context;
+
+#define NHAL_CAN_STD_ID_MASK    0x7FFu          /**< 11-bit standard identifier. */
+#define NHAL_CAN_EXT_ID_MASK    0x1FFFFFFFu     /**< 29-bit extended identifier. */
+#define NHAL_CAN_MAX_DLC        8               /**< Classic CAN payload size. */
+
+/**
+ * @brief CAN frame flags
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_CAN_FRAME_EXTENDED = 1,        /**< 29-bit identifier, 11-bit otherwise. */
+    NHAL_CAN_FRAME_REMOTE   = 1<<1,     /**< Remote transmission request: dlc is the requested length, no data. */
+} nhal_can_frame_bit_flags_t;
+
+/**
+ * @brief Classic CAN frame
+ */
+typedef struct {
+    uint32_t id;                     /**< Identifier, right aligned. */
+    uint8_t flags;                   /**< Combination of nhal_can_frame_bit_flags_t. */
+    uint8_t dlc;                     /**< Data length, 0 to NHAL_CAN_MAX_DLC. */
+    uint8_t filter_index;            /**< Received frames: index of the filter that accepted it. */
+    uint8_t data[NHAL_CAN_MAX_DLC];
+    uint64_t timestamp_ticks;        /**< Received frames: reception time (nhal_get_timestamp_ticks()), 0 if not available. */
+} nhal_can_frame_t;
+
+/**
+ * @brief CAN acceptance filter flags
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_CAN_FILTER_EXTENDED = 1,       /**< Match extended frames, standard frames otherwise. */
+} nhal_can_filter_bit_flags_t;
+
+/**
+ * @brief Hardware acceptance filter
+ *
+ * A frame matches when its identifier type matches the filter and
+ * (frame.id & mask) == (id & mask). Matching frames are stored in the RX FIFO
+ * fifo; frames matching no filter never reach software. A mask of all ones
+ * accepts a single identifier, a mask of 0 every identifier of that type.
+ */
+typedef struct {
+    uint32_t id;                     /**< Identifier to compare against. */
+    uint32_t mask;                   /**< Identifier bits that must match. */
+    uint8_t flags;                   /**< Combination of nhal_can_filter_bit_flags_t. */
+    uint8_t fifo;                    /**< RX FIFO receiving matching frames. */
+} nhal_can_filter_t;
+
+/**
+ * @brief CAN controller operating mode
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_CAN_MODE_NORMAL = 0,           /**< Transmit, receive and acknowledge frames. */
+    NHAL_CAN_MODE_LISTEN_ONLY,          /**< Receive only, never drives the bus (no ACK, no error frames). */
+    NHAL_CAN_MODE_LOOPBACK,             /**< Transmitted frames are also received by this controller. */
+} nhal_can_mode_t;
+
+/**
+ * @brief Order in which pending TX mailboxes are sent
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_CAN_TX_PRIORITY_ID = 0,        /**< Lowest identifier first, as bus arbitration would. */
+    NHAL_CAN_TX_PRIORITY_FIFO,          /**< Submission order, keeps a multi-frame message in sequence. */
+} nhal_can_tx_priority_t;
+
+/**
+ * @brief CAN bus error state
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_CAN_STATE_ERROR_ACTIVE = 0,    /**< Error counters below 96. */
+    NHAL_CAN_STATE_ERROR_WARNING,       /**< An error counter reached 96. */
+    NHAL_CAN_STATE_ERROR_PASSIVE,       /**< An error counter reached 128. */
+    NHAL_CAN_STATE_BUS_OFF,             /**< Transmit error counter exceeded 255, controller off the bus. */
+} nhal_can_state_t;
+
+/**
+ * @brief RX FIFO callback function type
+ *
+ * Called when an RX FIFO reaches the configured watermark, so the whole
+ * batch can be read with one nhal_can_receive() call.
+ *
+ * @param ctx CAN context
+ * @param fifo RX FIFO index
+ * @param user_data User data pointer provided in the configuration
+ *
+ * @note This executes in interrupt context - keep it fast and minimal
+ */
+typedef void (*nhal_can_rx_callback_t)(struct nhal_can_context *ctx, uint8_t fifo, void *user_data);
+
+/**
+ * @brief CAN configuration structure
+ */
+struct nhal_can_config{
+    uint32_t bitrate;                   /**< Nominal bit rate (bits per second). */
+    nhal_can_mode_t mode;
+    nhal_can_tx_priority_t tx_priority;
+    uint8_t rx_watermark;               /**< FIFO level that triggers rx_callback, 0 for every frame. */
+    nhal_can_rx_callback_t rx_callback; /**< NULL to poll with nhal_can_receive() only. */
+    void *user_data;                    /**< Passed to rx_callback. */
+    struct nhal_can_impl_config * impl_config;
+    nhal_config_id_t config_id;         /**< Identity token, NHAL_CONFIG_ID_NONE if unused. */
+    uint16_t sample_point_permille;     /**< Sample point position in the bit, 0 for the implementation default (typically 875). */
+};
+
+/**
+ * @brief CAN counters since the controller was started
+ */
+struct nhal_can_stats{
+    uint32_t frames_transmitted;     /**< Frames sent and acknowledged. */
+    uint32_t frames_received;        /**< Frames accepted by the filters and stored in an RX FIFO. */
+    uint32_t rx_overruns;            /**< Accepted frames lost because their RX FIFO was full. */
+    uint32_t bus_off_count;          /**< Times the controller went bus-off. */
+    uint16_t tx_error_count;         /**< Current transmit error counter. */
+    uint16_t rx_error_count;         /**< Current receive error counter. */
+    nhal_can_state_t state;          /**< Current error state. */
+};
+
+#endif /* NHAL_CAN_TYPES_H */
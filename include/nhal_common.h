@@ -20,10 +20,97 @@ extern "C" {
 
 typedef uint16_t nhal_timeout_ms;
 
+/**
+ * @brief Configuration identity token
+ *
+ * Cheap identity for configuration structures. Two configurations carrying the
+ * same non-zero id are guaranteed by the application to have identical contents,
+ * including the contents of the structure impl_config points to, which lets
+ * implementations skip reprogramming hardware that already runs that
+ * configuration.
+ *
+ * The id is trusted, never checked against the contents, so:
+ * - Configuration structures must be zero-initialized (`= {0}`, designated
+ *   initializers or memset) before their fields are set: an indeterminate
+ *   config_id is taken as an identity, and indeterminate fields appended
+ *   after it as requests.
+ * - Non-zero ids are built with NHAL_CONFIG_ID_MAKE(): every driver sharing
+ *   a bus takes its own owner number, so ids of different drivers never
+ *   collide, and bumps the generation whenever the configuration or its
+ *   impl_config contents change.
+ *
+ * As a cheap guard, implementations only skip reprogramming when the
+ * impl_config pointer also matches the one of the applied configuration.
+ */
+typedef uint32_t nhal_config_id_t;
+
+/**
+ * @brief Configuration carries no identity, it is always applied in full
+ */
+#define NHAL_CONFIG_ID_NONE ((nhal_config_id_t)0)
+
+/**
+ * @brief Flag bit of a configuration id: portable fields were validated at compile time
+ *
+ * Set by configuration builders that checked the portable fields of the
+ * configuration (everything but impl_config) against the implementation's
+ * own capabilities (see nhal_config.hpp). Implementations may skip
+ * validating those fields in *_set_config(), but always validate the
+ * structure impl_config points to, which the builders do not see.
+ *
+ * Application code does not set this flag by hand: invalid portable fields
+ * carrying it reach the hardware unchecked. The flag is not part of the
+ * identity token.
+ */
+#define NHAL_CONFIG_ID_PREVALIDATED ((nhal_config_id_t)0x80000000u)
+
+/**
+ * @brief Identity token of a configuration id, without flag bits
+ */
+#define NHAL_CONFIG_ID_TOKEN(id) ((nhal_config_id_t)((id) & ~NHAL_CONFIG_ID_PREVALIDATED))
+
+/**
+ * @brief Build a configuration id from an owner and a generation
+ *
+ * @param owner Number identifying the configuration on its bus, 1 to 0x7FFF
+ * @param generation Revision of that configuration's contents, 0 to 0xFFFF
+ */
+#define NHAL_CONFIG_ID_MAKE(owner, generation) \
+    ((nhal_config_id_t)((((uint32_t)(owner) & 0x7FFFu) << 16) | ((uint32_t)(generation) & 0xFFFFu)))
+
+/**
+ * @brief Owner number of a configuration id
+ */
+#define NHAL_CONFIG_ID_OWNER(id) ((uint16_t)(((id) >> 16) & 0x7FFFu))
+
+/**
+ * @brief Same configuration id with the next generation, keeping owner and flags
+ *
+ * Use when the contents of a configuration (or of its impl_config) change.
+ */
+#define NHAL_CONFIG_ID_NEXT(id) \
+    ((nhal_config_id_t)(((id) & 0xFFFF0000u) | (((uint32_t)(id) + 1u) & 0xFFFFu)))
+
+/**
+ * @brief Storage of NHAL enumerations
+ *
+ * Defining NHAL_COMPACT to a non-zero value for the whole build selects the
+ * compact profile: every NHAL enumeration, nhal_result_t included, is stored
+ * in one byte instead of an int, and the configuration structures holding
+ * them shrink accordingly. This changes the ABI, so the implementation and
+ * all C and C++ code using it must agree on the setting. Requires GCC or
+ * Clang, no effect with other compilers.
+ */
+#if defined(NHAL_COMPACT) && NHAL_COMPACT && (defined(__GNUC__) || defined(__clang__))
+#define NHAL_ENUM_PACKED __attribute__((packed))
+#else
+#define NHAL_ENUM_PACKED
+#endif
+
 /**
  * @brief Unified HAL result type for all peripheral operations
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_OK = 0,                         /**< Operation completed successfully. */
 
     // Common argument/validation errors
@@ -0,0 +1,256 @@
+/**
+ * @file nhal_config.hpp
+ * @brief Header-only C++ builders for compile-time validated bus configurations.
+ *
+ * nhal_spi_config, nhal_uart_config and nhal_i2c_config are normally checked
+ * at runtime inside every *_set_config(), so an invalid combination only shows
+ * up as NHAL_ERR_INVALID_CONFIG on the device. The builders below take the
+ * configuration as template parameters and reject invalid combinations with
+ * static_assert diagnostics at compile time. They can also precompute platform
+ * divisor values for the implementation-specific configuration.
+ *
+ * Validation is performed against a capabilities type. nhal::generic_caps only
+ * checks what is invalid everywhere. Platform implementations can provide their
+ * own capabilities by deriving from it and setting `is_platform = true`;
+ * configurations built with such capabilities carry the
+ * NHAL_CONFIG_ID_PREVALIDATED flag, so set_config() may skip validating their
+ * portable fields. The impl_config passed to make() is not checked by the
+ * builders and is still validated at runtime.
+ *
+ * @par Example usage:
+ * @code
+ * struct my_mcu_caps : nhal::generic_caps {
+ *     static constexpr bool is_platform = true;
+ *     static constexpr bool spi_lsb_first = false;
+ *     static constexpr uint32_t uart_clock_hz = 48000000;
+ * };
+ *
+ * typedef nhal::uart_config<115200, NHAL_UART_PARITY_NONE, NHAL_UART_STOP_BITS_1,
+ *                           NHAL_UART_DATA_BITS_8, my_mcu_caps> console_uart;
+ *
+ * static struct my_uart_impl_config console_impl = { console_uart::divisor::value };
+ * static struct nhal_uart_config console_config = console_uart::make(&console_impl, NHAL_CONFIG_ID_MAKE(1, 0));
+ *
+ * typedef nhal::spi_config<NHAL_SPI_MODE_0, NHAL_SPI_BIT_ORDER_LSB_FIRST, NHAL_SPI_FULL_DUPLEX,
+ *                          my_mcu_caps> lsb_spi;   // compile error: LSB first unsupported
+ * @endcode
+ */
+#ifndef NHAL_CONFIG_HPP
+#define NHAL_CONFIG_HPP
+
+#include <stdint.h>
+
+#include "nhal_common.h"
+#include "nhal_spi_types.h"
+#include "nhal_uart_types.h"
+#include "nhal_i2c_types.h"
+
+namespace nhal {
+
+/**
+ * @brief Capabilities assumed when the platform is unknown
+ *
+ * Platforms override the members they restrict. Clock frequencies left at 0
+ * make divisor computation unavailable.
+ */
+struct generic_caps {
+    static constexpr bool is_platform = false;             /**< Describes a real implementation. */
+
+    static constexpr bool spi_half_duplex = true;          /**< Half duplex SPI supported. */
+    static constexpr bool spi_lsb_first = true;            /**< LSB first SPI supported. */
+    static constexpr uint32_t spi_max_clock_hz = UINT32_MAX; /**< Highest supported SCK frequency. */
+    static constexpr bool spi_word_16 = true;              /**< 16-bit words supported. */
+    static constexpr bool spi_word_32 = true;              /**< 32-bit words supported. */
+
+    static constexpr uint32_t uart_min_baud = 1;           /**< Lowest supported baud rate. */
+    static constexpr uint32_t uart_max_baud = UINT32_MAX;  /**< Highest supported baud rate. */
+    static constexpr bool uart_7bit_no_parity = true;      /**< 7 data bits without parity supported. */
+    static constexpr bool uart_2_stop_bits = true;         /**< 2 stop bits supported. */
+    static constexpr uint32_t uart_clock_hz = 0;           /**< UART kernel clock. */
+    static constexpr uint32_t uart_oversampling = 16;      /**< UART clock cycles per bit at divisor 1. */
+    static constexpr uint32_t uart_max_error_permille = 20; /**< Tolerated baud rate error. */
+    static constexpr bool uart_rts_cts = true;             /**< RTS/CTS flow control supported. */
+    static constexpr bool uart_rs485_de = true;            /**< RS-485 driver enable supported. */
+
+    static constexpr uint32_t i2c_max_bus_hz = 1000000;    /**< Highest supported SCL frequency. */
+    static constexpr uint32_t i2c_clock_hz = 0;            /**< I2C kernel clock. */
+};
+
+namespace detail {
+
+template <typename Caps>
+constexpr nhal_config_id_t config_id(nhal_config_id_t token) {
+    return NHAL_CONFIG_ID_TOKEN(token) | (Caps::is_platform ? NHAL_CONFIG_ID_PREVALIDATED : NHAL_CONFIG_ID_NONE);
+}
+
+} // namespace detail
+
+/**
+ * @brief UART baud rate divisor computed at compile time
+ *
+ * Rounds to the nearest divisor and checks the resulting baud rate error.
+ */
+template <uint32_t ClockHz, uint32_t Baud, uint32_t Oversampling, uint32_t MaxErrorPermille>
+struct uart_divisor {
+    static_assert(ClockHz != 0, "nhal::uart_divisor: UART clock unknown, set uart_clock_hz in the capabilities");
+    static_assert(Oversampling != 0, "nhal::uart_divisor: oversampling must not be 0");
+
+    static constexpr uint64_t bit_clock = static_cast<uint64_t>(Oversampling ? Oversampling : 1) * Baud;
+    static constexpr uint32_t value = static_cast<uint32_t>((ClockHz + bit_clock / 2) / bit_clock);
+    static_assert(value >= 1, "nhal::uart_divisor: baud rate too high for the UART clock");
+
+    static constexpr uint32_t actual_baud = static_cast<uint32_t>(ClockHz / (static_cast<uint64_t>(Oversampling) * (value ? value : 1)));
+    static constexpr uint32_t error_permille = static_cast<uint32_t>(
+        (actual_baud > Baud ? actual_baud - Baud : Baud - actual_baud) * UINT64_C(1000) / Baud);
+    static_assert(error_permille <= MaxErrorPermille, "nhal::uart_divisor: baud rate error too large for the UART clock");
+};
+
+/**
+ * @brief I2C SCL divisor computed at compile time
+ *
+ * Rounds up, so the resulting SCL frequency never exceeds the requested one.
+ */
+template <uint32_t ClockHz, uint32_t BusHz>
+struct i2c_divisor {
+    static_assert(ClockHz != 0, "nhal::i2c_divisor: I2C clock unknown, set i2c_clock_hz in the capabilities");
+
+    static constexpr uint32_t value = static_cast<uint32_t>((ClockHz + 2ull * BusHz - 1) / (2ull * BusHz));
+    static_assert(value >= 1, "nhal::i2c_divisor: bus frequency too high for the I2C clock");
+
+    static constexpr uint32_t actual_bus_hz = ClockHz / (2 * (value ? value : 1));
+};
+
+/**
+ * @brief Compile-time validated SPI configuration
+ *
+ * ClockHz 0 leaves the SCK frequency to the implementation default.
+ */
+template <nhal_spi_mode_t Mode,
+          nhal_spi_bit_order_t BitOrder = NHAL_SPI_BIT_ORDER_MSB_FIRST,
+          nhal_spi_duplex_t Duplex = NHAL_SPI_FULL_DUPLEX,
+          typename Caps = generic_caps,
+          uint32_t ClockHz = 0,
+          nhal_spi_word_size_t WordSize = NHAL_SPI_WORD_SIZE_8>
+struct spi_config {
+    static_assert(Mode >= NHAL_SPI_MODE_0 && Mode <= NHAL_SPI_MODE_3, "nhal::spi_config: invalid SPI mode");
+    static_assert(BitOrder == NHAL_SPI_BIT_ORDER_MSB_FIRST || BitOrder == NHAL_SPI_BIT_ORDER_LSB_FIRST,
+                  "nhal::spi_config: invalid bit order");
+    static_assert(Duplex == NHAL_SPI_FULL_DUPLEX || Duplex == NHAL_SPI_HALF_DUPLEX, "nhal::spi_config: invalid duplex mode");
+    static_assert(BitOrder != NHAL_SPI_BIT_ORDER_LSB_FIRST || Caps::spi_lsb_first,
+                  "nhal::spi_config: LSB first not supported by this platform");
+    static_assert(Duplex != NHAL_SPI_HALF_DUPLEX || Caps::spi_half_duplex,
+                  "nhal::spi_config: half duplex not supported by this platform");
+    static_assert(ClockHz <= Caps::spi_max_clock_hz, "nhal::spi_config: SCK frequency not supported by this platform");
+    static_assert(WordSize == NHAL_SPI_WORD_SIZE_8 || WordSize == NHAL_SPI_WORD_SIZE_16 || WordSize == NHAL_SPI_WORD_SIZE_32,
+                  "nhal::spi_config: invalid word size");
+    static_assert(WordSize != NHAL_SPI_WORD_SIZE_16 || Caps::spi_word_16,
+                  "nhal::spi_config: 16-bit words not supported by this platform");
+    static_assert(WordSize != NHAL_SPI_WORD_SIZE_32 || Caps::spi_word_32,
+                  "nhal::spi_config: 32-bit words not supported by this platform");
+
+    /**
+     * @brief Build the C configuration
+     * @param impl_config Implementation-specific configuration, validated at runtime by set_config()
+     * @param token Identity token (NHAL_CONFIG_ID_NONE if unused)
+     */
+    static constexpr struct nhal_spi_config make(struct nhal_spi_impl_config *impl_config = nullptr,
+                                                 nhal_config_id_t token = NHAL_CONFIG_ID_NONE) {
+        return nhal_spi_config{Duplex, Mode, BitOrder, impl_config, detail::config_id<Caps>(token), ClockHz, WordSize};
+    }
+};
+
+/**
+ * @brief Compile-time validated UART configuration
+ *
+ * `divisor::value` holds the baud rate divisor for the platform clock given
+ * in the capabilities; it is only evaluated (and checked) when used.
+ *
+ * The flow control and RX FIFO tuning fields are set by chaining the member
+ * templates, each naming the configuration with one field changed:
+ * @code
+ * typedef nhal::uart_config<921600>::flow_control<NHAL_UART_FLOW_CONTROL_RTS_CTS>
+ *                                  ::rx_fifo_threshold<12>::rx_idle_timeout_bits<20> modem_uart;
+ * @endcode
+ */
+template <uint32_t Baud,
+          nhal_uart_parity_t Parity = NHAL_UART_PARITY_NONE,
+          nhal_uart_stop_bits_t StopBits = NHAL_UART_STOP_BITS_1,
+          nhal_uart_data_bits_t DataBits = NHAL_UART_DATA_BITS_8,
+          typename Caps = generic_caps,
+          nhal_uart_flow_control_t FlowControl = NHAL_UART_FLOW_CONTROL_NONE,
+          uint16_t RxFifoThreshold = 0,
+          uint16_t RxIdleTimeoutBits = 0>
+struct uart_config {
+    static_assert(Baud >= Caps::uart_min_baud && Baud <= Caps::uart_max_baud && Baud != 0,
+                  "nhal::uart_config: baud rate not supported by this platform");
+    static_assert(Parity == NHAL_UART_PARITY_NONE || Parity == NHAL_UART_PARITY_EVEN || Parity == NHAL_UART_PARITY_ODD,
+                  "nhal::uart_config: invalid parity");
+    static_assert(StopBits == NHAL_UART_STOP_BITS_1 || StopBits == NHAL_UART_STOP_BITS_2,
+                  "nhal::uart_config: invalid stop bits");
+    static_assert(DataBits == NHAL_UART_DATA_BITS_7 || DataBits == NHAL_UART_DATA_BITS_8,
+                  "nhal::uart_config: invalid data bits");
+    static_assert(StopBits != NHAL_UART_STOP_BITS_2 || Caps::uart_2_stop_bits,
+                  "nhal::uart_config: 2 stop bits not supported by this platform");
+    static_assert(DataBits != NHAL_UART_DATA_BITS_7 || Parity != NHAL_UART_PARITY_NONE || Caps::uart_7bit_no_parity,
+                  "nhal::uart_config: 7 data bits without parity not supported by this platform");
+    static_assert(FlowControl == NHAL_UART_FLOW_CONTROL_NONE || FlowControl == NHAL_UART_FLOW_CONTROL_RTS_CTS ||
+                  FlowControl == NHAL_UART_FLOW_CONTROL_RS485_DE,
+                  "nhal::uart_config: invalid flow control");
+    static_assert(FlowControl != NHAL_UART_FLOW_CONTROL_RTS_CTS || Caps::uart_rts_cts,
+                  "nhal::uart_config: RTS/CTS flow control not supported by this platform");
+    static_assert(FlowControl != NHAL_UART_FLOW_CONTROL_RS485_DE || Caps::uart_rs485_de,
+                  "nhal::uart_config: RS-485 driver enable not supported by this platform");
+
+    /** @brief Same configuration with another flow control mode */
+    template <nhal_uart_flow_control_t Value>
+    using flow_control = uart_config<Baud, Parity, StopBits, DataBits, Caps, Value, RxFifoThreshold, RxIdleTimeoutBits>;
+
+    /** @brief Same configuration with another RX FIFO threshold (bytes, 0 for the implementation default) */
+    template <uint16_t Value>
+    using rx_fifo_threshold = uart_config<Baud, Parity, StopBits, DataBits, Caps, FlowControl, Value, RxIdleTimeoutBits>;
+
+    /** @brief Same configuration with another RX idle timeout (bit times, 0 for the implementation default) */
+    template <uint16_t Value>
+    using rx_idle_timeout_bits = uart_config<Baud, Parity, StopBits, DataBits, Caps, FlowControl, RxFifoThreshold, Value>;
+
+    typedef uart_divisor<Caps::uart_clock_hz, Baud, Caps::uart_oversampling, Caps::uart_max_error_permille> divisor;
+
+    /**
+     * @brief Build the C configuration
+     * @param impl_config Implementation-specific configuration, validated at runtime by set_config()
+     * @param token Identity token (NHAL_CONFIG_ID_NONE if unused)
+     */
+    static constexpr struct nhal_uart_config make(struct nhal_uart_impl_config *impl_config = nullptr,
+                                                  nhal_config_id_t token = NHAL_CONFIG_ID_NONE) {
+        return nhal_uart_config{Baud, Parity, StopBits, DataBits, impl_config, detail::config_id<Caps>(token),
+                                FlowControl, RxFifoThreshold, RxIdleTimeoutBits};
+    }
+};
+
+/**
+ * @brief Compile-time validated I2C configuration
+ *
+ * The bus frequency is implementation-specific configuration; `divisor::value`
+ * holds the SCL divisor for the platform clock given in the capabilities.
+ */
+template <uint32_t BusHz, typename Caps = generic_caps>
+struct i2c_config {
+    static_assert(BusHz != 0 && BusHz <= Caps::i2c_max_bus_hz,
+                  "nhal::i2c_config: bus frequency not supported by this platform");
+
+    typedef i2c_divisor<Caps::i2c_clock_hz, BusHz> divisor;
+
+    /**
+     * @brief Build the C configuration
+     * @param impl_config Implementation-specific configuration, validated at runtime by set_config()
+     * @param token Identity token (NHAL_CONFIG_ID_NONE if unused)
+     */
+    static constexpr struct nhal_i2c_config make(struct nhal_i2c_impl_config *impl_config = nullptr,
+                                                 nhal_config_id_t token = NHAL_CONFIG_ID_NONE) {
+        return nhal_i2c_config{impl_config, detail::config_id<Caps>(token)};
+    }
+};
+
+} // namespace nhal
+
+#endif /* NHAL_CONFIG_HPP */
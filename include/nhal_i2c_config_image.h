@@ -0,0 +1,73 @@
+/**
+ * @file nhal_i2c_config_image.h
+ * @brief Hardware Abstraction Layer for cached I2C master configuration images.
+ *
+ * When several devices with different settings share one I2C bus, each
+ * device driver can build a register image of its configuration once, then
+ * apply it before every access. Building performs all validation and
+ * register value computation; applying only writes the precomputed values,
+ * and is skipped entirely when the bus already runs that image.
+ *
+ * @par Example usage:
+ * @code
+ * struct nhal_i2c_config_image sensor_image;
+ * nhal_i2c_master_config_image_build(i2c_ctx, &sensor_config, &sensor_image);
+ *
+ * // On every sensor access
+ * nhal_i2c_master_config_image_apply(i2c_ctx, &sensor_image);
+ * @endcode
+ */
+#ifndef NHAL_I2C_CONFIG_IMAGE_H
+#define NHAL_I2C_CONFIG_IMAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_i2c_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Validate a configuration and build its register image
+ *
+ * Does not touch the hardware. The image is tied to the context it was
+ * built for.
+ *
+ * @param ctx Pointer to I2C context structure
+ * @param config Pointer to configuration structure
+ * @param image Pointer to image structure to fill
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_CONFIG Configuration not supported
+ */
+nhal_result_t nhal_i2c_master_config_image_build(
+    struct nhal_i2c_context *ctx,
+    const struct nhal_i2c_config *config,
+    struct nhal_i2c_config_image *image
+);
+
+/**
+ * @brief Apply a prebuilt configuration image
+ *
+ * Writes the precomputed register values without further validation.
+ * Returns immediately if the image is the one currently applied.
+ *
+ * @param ctx Pointer to I2C context structure the image was built for
+ * @param image Pointer to prebuilt image
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_BUSY A transfer is in progress on the bus
+ */
+nhal_result_t nhal_i2c_master_config_image_apply(
+    struct nhal_i2c_context *ctx,
+    const struct nhal_i2c_config_image *image
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_I2C_CONFIG_IMAGE_H */
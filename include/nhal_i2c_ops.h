@@ -0,0 +1,237 @@
+/**
+ * @file nhal_i2c_ops.h
+ * @brief Optional ops-table dispatch for the I2C Hardware Abstraction Layer (HAL).
+ *
+ * By default every nhal_i2c function is a single global symbol provided by
+ * one implementation at link time. Defining NHAL_I2C_DISPATCH for the whole
+ * build switches to dispatch mode, where each context carries a pointer to
+ * the function table of its backend, so several I2C master implementations
+ * can coexist in one binary (e.g.: hw_i2c and bitbang_i2c).
+ * Consumers keep calling the regular C API.
+ *
+ * In dispatch mode:
+ * - struct nhal_i2c_context is defined here, holding the ops table and the
+ *   backend's own state pointer.
+ * - Backends implement the functions of struct nhal_i2c_master_ops under their own
+ *   names. Ops receive the generic context and retrieve their state from
+ *   ctx->backend_ctx.
+ * - Exactly one translation unit defines NHAL_DISPATCH_IMPLEMENTATION
+ *   before including this header to emit the dispatching nhal_i2c functions.
+ *   Missing (NULL) ops return NHAL_ERR_UNSUPPORTED, except
+ *   perform_transfer_packed, which falls back to perform_transfer through
+ *   nhal_i2c_packed_perform_transfer() with NHAL_I2C_PACKED_FALLBACK_OPS
+ *   operations of stack scratch.
+ *
+ * Each dispatched call costs one extra indirect call. Builds that do not
+ * define NHAL_I2C_DISPATCH are unaffected.
+ *
+ * @par Example usage:
+ * @code
+ * static const struct nhal_i2c_master_ops hw_i2c_ops = { .init = hw_i2c_init, ... };
+ * static struct hw_i2c_state hw_i2c_state;
+ *
+ * struct nhal_i2c_context ctx;
+ * nhal_i2c_context_bind(&ctx, &hw_i2c_ops, &hw_i2c_state);
+ * nhal_i2c_master_init(&ctx);
+ * @endcode
+ */
+#ifndef NHAL_I2C_OPS_H
+#define NHAL_I2C_OPS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_i2c_master.h"
+#include "nhal_i2c_transfer.h"
+#include "nhal_i2c_config_image.h"
+#include "nhal_i2c_transfer_packed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief I2C backend function table
+ *
+ * Each member has the signature of the matching nhal_i2c_master_* function.
+ */
+struct nhal_i2c_master_ops{
+    nhal_result_t (*init)(struct nhal_i2c_context *ctx);
+    nhal_result_t (*deinit)(struct nhal_i2c_context *ctx);
+    nhal_result_t (*set_config)(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config);
+    nhal_result_t (*get_config)(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config);
+    nhal_result_t (*write)(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const uint8_t *data, size_t len);
+    nhal_result_t (*read)(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, uint8_t *data, size_t len);
+    nhal_result_t (*write_read_reg)(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const uint8_t *reg_address, size_t reg_len, uint8_t *data, size_t data_len);
+    nhal_result_t (*perform_transfer)(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, nhal_i2c_transfer_op_t *ops, size_t num_ops);
+    nhal_result_t (*config_image_build)(struct nhal_i2c_context *ctx, const struct nhal_i2c_config *config, struct nhal_i2c_config_image *image);
+    nhal_result_t (*config_image_apply)(struct nhal_i2c_context *ctx, const struct nhal_i2c_config_image *image);
+    nhal_result_t (*perform_transfer_packed)(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const struct nhal_i2c_packed_ops *ops);
+};
+
+#ifdef NHAL_I2C_DISPATCH
+
+#ifndef NHAL_I2C_PACKED_FALLBACK_OPS
+/**
+ * @brief Scratch operations used when a backend has no perform_transfer_packed
+ *
+ * Bounds the operations chained without STOP in a packed list sent to such
+ * a backend (see nhal_i2c_packed_perform_transfer()).
+ */
+#define NHAL_I2C_PACKED_FALLBACK_OPS 8
+#endif
+
+/**
+ * @brief I2C context structure in dispatch mode
+ */
+struct nhal_i2c_context{
+    const struct nhal_i2c_master_ops *ops;     /**< Function table of the backend serving this context. */
+    void *backend_ctx;                         /**< Backend-specific state. */
+};
+
+/**
+ * @brief Bind a context to a backend
+ * @param ctx Pointer to I2C context structure
+ * @param ops Backend function table
+ * @param backend_ctx Backend-specific state
+ */
+static inline void nhal_i2c_context_bind(struct nhal_i2c_context *ctx, const struct nhal_i2c_master_ops *ops, void *backend_ctx)
+{
+    ctx->ops = ops;
+    ctx->backend_ctx = backend_ctx;
+}
+
+#ifdef NHAL_DISPATCH_IMPLEMENTATION
+
+nhal_result_t nhal_i2c_master_init(struct nhal_i2c_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->init == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->init(ctx);
+}
+
+nhal_result_t nhal_i2c_master_deinit(struct nhal_i2c_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->deinit == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->deinit(ctx);
+}
+
+nhal_result_t nhal_i2c_master_set_config(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->set_config == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->set_config(ctx, config);
+}
+
+nhal_result_t nhal_i2c_master_get_config(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->get_config == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->get_config(ctx, config);
+}
+
+nhal_result_t nhal_i2c_master_write(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const uint8_t *data, size_t len)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->write == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->write(ctx, dev_address, data, len);
+}
+
+nhal_result_t nhal_i2c_master_read(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, uint8_t *data, size_t len)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->read == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->read(ctx, dev_address, data, len);
+}
+
+nhal_result_t nhal_i2c_master_write_read_reg(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const uint8_t *reg_address, size_t reg_len, uint8_t *data, size_t data_len)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->write_read_reg == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->write_read_reg(ctx, dev_address, reg_address, reg_len, data, data_len);
+}
+
+nhal_result_t nhal_i2c_master_perform_transfer(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, nhal_i2c_transfer_op_t *ops, size_t num_ops)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->perform_transfer == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->perform_transfer(ctx, dev_address, ops, num_ops);
+}
+
+nhal_result_t nhal_i2c_master_config_image_build(struct nhal_i2c_context *ctx, const struct nhal_i2c_config *config, struct nhal_i2c_config_image *image)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->config_image_build == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->config_image_build(ctx, config, image);
+}
+
+nhal_result_t nhal_i2c_master_config_image_apply(struct nhal_i2c_context *ctx, const struct nhal_i2c_config_image *image)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->config_image_apply == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->config_image_apply(ctx, image);
+}
+
+nhal_result_t nhal_i2c_master_perform_transfer_packed(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const struct nhal_i2c_packed_ops *ops)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->perform_transfer_packed == NULL) {
+        nhal_i2c_transfer_op_t scratch[NHAL_I2C_PACKED_FALLBACK_OPS];
+        return nhal_i2c_packed_perform_transfer(ctx, dev_address, ops, scratch, NHAL_I2C_PACKED_FALLBACK_OPS);
+    }
+    return ctx->ops->perform_transfer_packed(ctx, dev_address, ops);
+}
+
+#endif /* NHAL_DISPATCH_IMPLEMENTATION */
+
+#endif /* NHAL_I2C_DISPATCH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_I2C_OPS_H */
@@ -0,0 +1,375 @@
+/**
+ * @file nhal_i2c_transfer_packed.h
+ * @brief Compact packed operation lists for long I2C transfers.
+ *
+ * nhal_i2c_transfer_op_t takes about 32 bytes per operation on 64-bit hosts
+ * (24 on 32-bit targets) and repeats the device address in every operation,
+ * although nhal_i2c_master_perform_transfer() already takes it. Long
+ * transactions (display initialization sequences, EEPROM page lists, sensor
+ * register dumps) are better described with the packed byte stream defined
+ * here, where every operation is:
+ *
+ * | Bytes           | Content                                               |
+ * |-----------------|-------------------------------------------------------|
+ * | 1               | Type and flag bits (NHAL_I2C_PACKED_*)                |
+ * | 4               | Length, native-endian                                 |
+ * | sizeof(void *)  | Buffer pointer, native-endian (no INLINE flag)        |
+ * | length          | Payload (writes with the INLINE flag)                 |
+ *
+ * Fields are unaligned and accessed with memcpy(), which compiles to plain
+ * loads on cores with unaligned access. A pointer operation is 9 bytes on
+ * 32-bit targets and 13 on 64-bit hosts; a 2-byte register write inlined
+ * is 7 bytes and needs no separate buffer.
+ *
+ * All operations address the device passed to
+ * nhal_i2c_master_perform_transfer_packed(). Lists can be built
+ * incrementally or converted from an nhal_i2c_transfer_op_t array.
+ * Backends without a native packed path can implement
+ * nhal_i2c_master_perform_transfer_packed() with
+ * nhal_i2c_packed_perform_transfer(), which decodes the list in batches and
+ * hands them to nhal_i2c_master_perform_transfer().
+ *
+ * @par Example usage:
+ * @code
+ * static uint8_t storage[64];
+ * struct nhal_i2c_packed_ops ops;
+ * static const uint8_t reg = 0x3B;
+ * uint8_t sample[14];
+ *
+ * nhal_i2c_packed_init(&ops, storage, sizeof(storage));
+ * nhal_i2c_packed_add_write_inline(&ops, NHAL_I2C_PACKED_NO_STOP, &reg, 1);
+ * nhal_i2c_packed_add_read(&ops, 0, sample, sizeof(sample));
+ * nhal_i2c_master_perform_transfer_packed(i2c_ctx, imu_address, &ops);
+ *
+ * // Implementation side
+ * const uint8_t *pos = ops.data;
+ * nhal_i2c_packed_op_t op;
+ * while ((pos = nhal_i2c_packed_next(&ops, pos, &op)) != NULL) {
+ *     ...
+ * }
+ * @endcode
+ */
+#ifndef NHAL_I2C_TRANSFER_PACKED_H
+#define NHAL_I2C_TRANSFER_PACKED_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "nhal_common.h"
+#include "nhal_i2c_types.h"
+#include "nhal_i2c_transfer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Packed operation type and flag bits
+ *
+ * The flags are the nhal_i2c_transfer_bit_flags_t values shifted left by one.
+ */
+#define NHAL_I2C_PACKED_READ      0x01    /**< Read operation (write when clear). */
+#define NHAL_I2C_PACKED_NO_START  0x02    /**< As NHAL_I2C_TRANSFER_MSG_NO_START. */
+#define NHAL_I2C_PACKED_NO_STOP   0x04    /**< As NHAL_I2C_TRANSFER_MSG_NO_STOP. */
+#define NHAL_I2C_PACKED_NO_ADDR   0x08    /**< As NHAL_I2C_TRANSFER_MSG_NO_ADDR. */
+#define NHAL_I2C_PACKED_INLINE    0x10    /**< Write payload follows the length instead of a pointer. */
+
+#define NHAL_I2C_PACKED_FLAGS_MASK (NHAL_I2C_PACKED_NO_START | NHAL_I2C_PACKED_NO_STOP | NHAL_I2C_PACKED_NO_ADDR)
+
+/**
+ * @brief Encoded size of an operation
+ */
+#define NHAL_I2C_PACKED_HEADER_SIZE (1 + sizeof(uint32_t))
+#define NHAL_I2C_PACKED_POINTER_OP_SIZE (NHAL_I2C_PACKED_HEADER_SIZE + sizeof(void *))
+#define NHAL_I2C_PACKED_INLINE_OP_SIZE(len) (NHAL_I2C_PACKED_HEADER_SIZE + (len))
+
+/**
+ * @brief Packed operation list
+ */
+struct nhal_i2c_packed_ops{
+    uint8_t *data;               /**< Encoded operations. */
+    size_t size;                 /**< Bytes used. */
+    size_t capacity;             /**< Bytes available in data. */
+    size_t num_ops;              /**< Number of operations. */
+};
+
+/**
+ * @brief Decoded operation
+ */
+typedef struct {
+    uint8_t op;                  /**< NHAL_I2C_PACKED_* bits. */
+    uint32_t length;
+    union {
+        uint8_t *buffer;         /**< Read destination. */
+        const uint8_t *bytes;    /**< Write source (points into the list when inline). */
+    };
+} nhal_i2c_packed_op_t;
+
+/**
+ * @brief Initialize an empty list over caller-provided storage
+ * @param ops List to initialize
+ * @param storage Buffer receiving the encoded operations
+ * @param capacity Size of storage in bytes
+ */
+static inline void nhal_i2c_packed_init(struct nhal_i2c_packed_ops *ops, uint8_t *storage, size_t capacity)
+{
+    ops->data = storage;
+    ops->size = 0;
+    ops->capacity = capacity;
+    ops->num_ops = 0;
+}
+
+/** @cond INTERNAL */
+static inline uint8_t *nhal_i2c_packed_append_(struct nhal_i2c_packed_ops *ops, uint8_t op, uint32_t length, size_t body_size)
+{
+    uint8_t *pos;
+
+    if (ops->capacity - ops->size < NHAL_I2C_PACKED_HEADER_SIZE + body_size) {
+        return NULL;
+    }
+    pos = ops->data + ops->size;
+    pos[0] = op;
+    memcpy(pos + 1, &length, sizeof(length));
+    ops->size += NHAL_I2C_PACKED_HEADER_SIZE + body_size;
+    ops->num_ops++;
+    return pos + NHAL_I2C_PACKED_HEADER_SIZE;
+}
+/** @endcond */
+
+/**
+ * @brief Append a write referencing caller-owned data
+ * @param ops List
+ * @param flags NHAL_I2C_PACKED_NO_START, _NO_STOP and/or _NO_ADDR
+ * @param bytes Data to send, must stay valid until the transfer is performed
+ * @param length Number of bytes
+ * @return NHAL_OK, or NHAL_ERR_BUFFER_FULL if the list storage is full
+ */
+static inline nhal_result_t nhal_i2c_packed_add_write(struct nhal_i2c_packed_ops *ops, uint8_t flags, const uint8_t *bytes, uint32_t length)
+{
+    uint8_t *body = nhal_i2c_packed_append_(ops, (uint8_t)(flags & NHAL_I2C_PACKED_FLAGS_MASK), length, sizeof(bytes));
+    if (body == NULL) {
+        return NHAL_ERR_BUFFER_FULL;
+    }
+    memcpy(body, &bytes, sizeof(bytes));
+    return NHAL_OK;
+}
+
+/**
+ * @brief Append a write whose data is copied into the list
+ * @param ops List
+ * @param flags NHAL_I2C_PACKED_NO_START, _NO_STOP and/or _NO_ADDR
+ * @param bytes Data to send, copied
+ * @param length Number of bytes
+ * @return NHAL_OK, or NHAL_ERR_BUFFER_FULL if the list storage is full
+ */
+static inline nhal_result_t nhal_i2c_packed_add_write_inline(struct nhal_i2c_packed_ops *ops, uint8_t flags, const uint8_t *bytes, uint32_t length)
+{
+    uint8_t *body = nhal_i2c_packed_append_(ops, (uint8_t)((flags & NHAL_I2C_PACKED_FLAGS_MASK) | NHAL_I2C_PACKED_INLINE), length, length);
+    if (body == NULL) {
+        return NHAL_ERR_BUFFER_FULL;
+    }
+    memcpy(body, bytes, length);
+    return NHAL_OK;
+}
+
+/**
+ * @brief Append a read
+ * @param ops List
+ * @param flags NHAL_I2C_PACKED_NO_START, _NO_STOP and/or _NO_ADDR
+ * @param buffer Destination, must stay valid until the transfer is performed
+ * @param length Number of bytes
+ * @return NHAL_OK, or NHAL_ERR_BUFFER_FULL if the list storage is full
+ */
+static inline nhal_result_t nhal_i2c_packed_add_read(struct nhal_i2c_packed_ops *ops, uint8_t flags, uint8_t *buffer, uint32_t length)
+{
+    uint8_t *body = nhal_i2c_packed_append_(ops, (uint8_t)((flags & NHAL_I2C_PACKED_FLAGS_MASK) | NHAL_I2C_PACKED_READ), length, sizeof(buffer));
+    if (body == NULL) {
+        return NHAL_ERR_BUFFER_FULL;
+    }
+    memcpy(body, &buffer, sizeof(buffer));
+    return NHAL_OK;
+}
+
+/**
+ * @brief Append operations converted from nhal_i2c_transfer_op_t
+ *
+ * The per-operation address is dropped: the packed list addresses the
+ * device given to nhal_i2c_master_perform_transfer_packed().
+ *
+ * @param ops List
+ * @param transfer_ops Operations to convert
+ * @param num_ops Number of operations
+ * @param inline_max Writes up to this length are copied inline (0: never)
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_ARG An operation length does not fit in 32 bits
+ * @retval NHAL_ERR_BUFFER_FULL The list storage is full (operations converted so far are kept)
+ */
+static inline nhal_result_t nhal_i2c_packed_from_ops(struct nhal_i2c_packed_ops *ops, const nhal_i2c_transfer_op_t *transfer_ops,
+                                                    size_t num_ops, uint32_t inline_max)
+{
+    size_t i;
+
+    for (i = 0; i < num_ops; i++) {
+        const nhal_i2c_transfer_op_t *op = &transfer_ops[i];
+        uint8_t flags = (uint8_t)((op->flags << 1) & NHAL_I2C_PACKED_FLAGS_MASK);
+        nhal_result_t result;
+
+        if (op->type == NHAL_I2C_READ_OP) {
+            if (op->read.length > UINT32_MAX) {
+                return NHAL_ERR_INVALID_ARG;
+            }
+            result = nhal_i2c_packed_add_read(ops, flags, op->read.buffer, (uint32_t)op->read.length);
+        } else {
+            if (op->write.length > UINT32_MAX) {
+                return NHAL_ERR_INVALID_ARG;
+            }
+            if (op->write.length <= inline_max) {
+                result = nhal_i2c_packed_add_write_inline(ops, flags, op->write.bytes, (uint32_t)op->write.length);
+            } else {
+                result = nhal_i2c_packed_add_write(ops, flags, op->write.bytes, (uint32_t)op->write.length);
+            }
+        }
+        if (result != NHAL_OK) {
+            return result;
+        }
+    }
+    return NHAL_OK;
+}
+
+/**
+ * @brief Decode the operation at pos
+ *
+ * @param ops List
+ * @param pos Position of the operation, ops->data for the first one
+ * @param op Decoded operation
+ * @return Position of the next operation, or NULL at the end of the list
+ *         (or if the list is truncated)
+ */
+static inline const uint8_t *nhal_i2c_packed_next(const struct nhal_i2c_packed_ops *ops, const uint8_t *pos, nhal_i2c_packed_op_t *op)
+{
+    const uint8_t *end = ops->data + ops->size;
+    size_t body_size;
+
+    if ((size_t)(end - pos) < NHAL_I2C_PACKED_HEADER_SIZE) {
+        return NULL;
+    }
+    op->op = pos[0];
+    memcpy(&op->length, pos + 1, sizeof(op->length));
+    pos += NHAL_I2C_PACKED_HEADER_SIZE;
+
+    if ((op->op & NHAL_I2C_PACKED_INLINE) != 0) {
+        body_size = op->length;
+        op->bytes = pos;
+    } else {
+        body_size = sizeof(op->buffer);
+        if ((size_t)(end - pos) >= body_size) {
+            memcpy(&op->buffer, pos, sizeof(op->buffer));
+        }
+    }
+    if ((size_t)(end - pos) < body_size) {
+        return NULL;
+    }
+    return pos + body_size;
+}
+
+/**
+ * @brief Perform a packed list through nhal_i2c_master_perform_transfer()
+ *
+ * Generic nhal_i2c_master_perform_transfer_packed() for backends that only
+ * implement nhal_i2c_master_perform_transfer(). Operations are decoded into
+ * scratch and performed in batches; a batch only ends after an operation
+ * that sends a STOP, so repeated-start sequences are never split. When a
+ * batch fails, the batches before it have already been performed.
+ *
+ * @param ctx Pointer to I2C context structure
+ * @param dev_address Device address used by every operation
+ * @param ops Packed operation list
+ * @param scratch Operations the list is decoded into
+ * @param scratch_ops Number of operations scratch holds
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_ARG Malformed list, or scratch_ops is 0
+ * @retval NHAL_ERR_BUFFER_FULL Operations chained without STOP do not fit in scratch
+ */
+static inline nhal_result_t nhal_i2c_packed_perform_transfer(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                                             const struct nhal_i2c_packed_ops *ops,
+                                                             nhal_i2c_transfer_op_t *scratch, size_t scratch_ops)
+{
+    const uint8_t *end = ops->data + ops->size;
+    const uint8_t *pos = ops->data;
+    size_t count = 0;
+    size_t complete = 0;    /* Operations up to the last STOP */
+    nhal_i2c_packed_op_t op;
+    nhal_result_t result;
+
+    if (scratch_ops == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    while (pos != end) {
+        nhal_i2c_transfer_op_t *transfer_op;
+
+        pos = nhal_i2c_packed_next(ops, pos, &op);
+        if (pos == NULL) {
+            return NHAL_ERR_INVALID_ARG;
+        }
+        if (count == scratch_ops) {
+            if (complete == 0) {
+                return NHAL_ERR_BUFFER_FULL;
+            }
+            result = nhal_i2c_master_perform_transfer(ctx, dev_address, scratch, complete);
+            if (result != NHAL_OK) {
+                return result;
+            }
+            memmove(scratch, scratch + complete, (count - complete) * sizeof(*scratch));
+            count -= complete;
+            complete = 0;
+        }
+
+        transfer_op = &scratch[count++];
+        transfer_op->address = dev_address;
+        transfer_op->flags = (uint16_t)((op.op & NHAL_I2C_PACKED_FLAGS_MASK) >> 1);
+        if ((op.op & NHAL_I2C_PACKED_READ) != 0) {
+            transfer_op->type = NHAL_I2C_READ_OP;
+            transfer_op->read.buffer = op.buffer;
+            transfer_op->read.length = op.length;
+        } else {
+            transfer_op->type = NHAL_I2C_WRITE_OP;
+            transfer_op->write.bytes = op.bytes;
+            transfer_op->write.length = op.length;
+        }
+        if ((op.op & NHAL_I2C_PACKED_NO_STOP) == 0) {
+            complete = count;
+        }
+    }
+    if (count == 0) {
+        return NHAL_OK;
+    }
+    return nhal_i2c_master_perform_transfer(ctx, dev_address, scratch, count);
+}
+
+/**
+ * @brief Perform an I2C transfer described by a packed operation list
+ *
+ * Equivalent to nhal_i2c_master_perform_transfer() with the same operations.
+ *
+ * @param ctx Pointer to I2C context structure
+ * @param dev_address Device address used by every operation
+ * @param ops Packed operation list
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_ARG Malformed list
+ * @retval NHAL_ERR_NO_RESPONSE Device did not acknowledge
+ */
+nhal_result_t nhal_i2c_master_perform_transfer_packed(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const struct nhal_i2c_packed_ops *ops
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_I2C_TRANSFER_PACKED_H */
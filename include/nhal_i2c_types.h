@@ -11,6 +11,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "nhal_common.h"
+
 
 /**
  * @brief I2C context structure (implementation-defined)
@@ -33,7 +35,7 @@ struct nhal_i2c_context;
 /**
  * @brief I2C address type enumeration
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_I2C_7BIT_ADDR = 0,
     NHAL_I2C_10BIT_ADDR = 1
 }nhal_i2c_addr_type;
@@ -51,15 +53,34 @@ typedef struct nhal_i2c_address{
 
 /**
  * @brief I2C configuration structure
+ *
+ * Must be zero-initialized so config_id is never indeterminate.
  */
 struct nhal_i2c_config{
     struct nhal_i2c_impl_config * impl_config;
+    nhal_config_id_t config_id;     /**< Identity token, NHAL_CONFIG_ID_NONE if unused. */
 };
 
+/**
+ * @brief I2C configuration register image (implementation-defined)
+ *
+ * Precomputed hardware register values for one configuration, built once
+ * per device and applied with a few register writes when switching devices.
+ *
+ * @par Example content:
+ * @code
+ * struct nhal_i2c_config_image {
+ *     nhal_config_id_t config_id;
+ *     uint32_t timingr;
+ * };
+ * @endcode
+ */
+struct nhal_i2c_config_image;
+
 /**
  * @brief I2C operation type enumeration
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_I2C_WRITE_OP,
     NHAL_I2C_READ_OP
 }nhal_i2c_op_t;
@@ -69,7 +90,7 @@ typedef enum {
  *
  * These flags control I2C bus conditions and addressing behavior for individual transfer operations.
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_I2C_TRANSFER_MSG_NO_START     = 1, /**< Do not send a START condition before this message.
                                                                 *   Useful for subsequent messages in a combined transaction (e.g., after a repeated start). */
     NHAL_I2C_TRANSFER_MSG_NO_STOP      = 1<<1, /**< Do not send a STOP condition after this message.
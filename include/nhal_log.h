@@ -0,0 +1,391 @@
+/**
+ * @file nhal_log.h
+ * @brief Deferred binary logging with format-string IDs, drained over UART.
+ *
+ * Formatting text at the call site and writing it with nhal_uart_write()
+ * costs tens of microseconds per message and blocks on the wire. This header
+ * moves all the formatting to the host:
+ * - Every format string is placed, at compile time, into the `nhal_log_fmt`
+ *   linker section together with its level and source location. Its offset
+ *   inside that section is its ID.
+ * - A log call reserves a few words of a lock-free ring and stores the ID, a
+ *   timestamp and the raw arguments. No formatting, no locking, no I/O, so
+ *   it is safe from interrupt context and from several threads at once.
+ * - nhal_log_drain(), called from a background task or the idle loop, encodes
+ *   the records (varints, COBS framing) and writes them to a UART.
+ * - scripts/nhal_log_decode.py reads the format strings back from the ELF
+ *   file and turns the UART stream into text.
+ *
+ * Arguments are stored as 32-bit words: integers, characters and pointers
+ * can be passed directly, floats through nhal_log_float(). Strings (%s) cannot
+ * be deferred; only their address is logged. At most NHAL_LOG_MAX_ARGS
+ * arguments are supported per call.
+ *
+ * When the ring is full, records are dropped and counted; the count is
+ * reported in-band so the decoder shows where messages were lost.
+ *
+ * Requires GCC or Clang (section attribute, __atomic builtins). The linker
+ * provides the `__start_nhal_log_fmt` symbol for the orphan section; a linker
+ * script placing the section explicitly must KEEP() it and define that
+ * symbol at its start.
+ *
+ * Exactly one translation unit defines NHAL_LOG_IMPLEMENTATION before
+ * including this header, to emit the ring storage and the drain functions.
+ *
+ * @par Example usage:
+ * @code
+ * // Hot path: a reservation and a few stores
+ * NHAL_LOG_INFO("adc ch%u = %d mV", channel, millivolts);
+ * NHAL_LOG_DEBUG("pid out %f", nhal_log_float(output));
+ *
+ * // Background task
+ * for (;;) {
+ *     nhal_log_drain(&nhal_log_instance, debug_uart);
+ *     nhal_delay_milliseconds(10);
+ * }
+ * @endcode
+ *
+ * @code
+ * $ python3 scripts/nhal_log_decode.py firmware.elf /dev/ttyUSB0 --baud 921600
+ * @endcode
+ */
+#ifndef NHAL_LOG_H
+#define NHAL_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "nhal_common.h"
+#include "nhal_uart.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NHAL_LOG_LEVEL_NONE  0
+#define NHAL_LOG_LEVEL_ERROR 1
+#define NHAL_LOG_LEVEL_WARN  2
+#define NHAL_LOG_LEVEL_INFO  3
+#define NHAL_LOG_LEVEL_DEBUG 4
+
+/**
+ * @brief Most verbose level compiled in; calls above it compile to nothing
+ */
+#ifndef NHAL_LOG_LEVEL
+#define NHAL_LOG_LEVEL NHAL_LOG_LEVEL_INFO
+#endif
+
+/**
+ * @brief Ring size in 32-bit words (power of two)
+ *
+ * A record takes 2 words plus one per argument.
+ */
+#ifndef NHAL_LOG_BUFFER_WORDS
+#define NHAL_LOG_BUFFER_WORDS 256
+#endif
+
+/**
+ * @brief Timestamp stored with each record
+ *
+ * Defaults to the microsecond timestamp; may be redefined to a cheaper
+ * counter (e.g.: `(uint32_t)nhal_get_timestamp_ticks()`), in which case the
+ * decoder is given the counter frequency.
+ */
+#ifndef NHAL_LOG_TIMESTAMP
+#define NHAL_LOG_TIMESTAMP() ((uint32_t)nhal_get_timestamp_microseconds())
+#endif
+
+/**
+ * @brief Maximum arguments per log call
+ */
+#define NHAL_LOG_MAX_ARGS 8
+
+/**
+ * @brief Largest encoded record: COBS overhead, ID, timestamp, arguments, delimiter
+ */
+#define NHAL_LOG_FRAME_MAX (1 + 5 * (2 + NHAL_LOG_MAX_ARGS) + 1)
+
+/**
+ * @brief Record header word layout
+ *
+ * Bit 31 marks a published record, bits 27-24 hold the argument count and
+ * bits 23-0 the format string offset inside the section.
+ */
+#define NHAL_LOG_HEADER_VALID       UINT32_C(0x80000000)
+#define NHAL_LOG_HEADER_NARGS_SHIFT 24
+#define NHAL_LOG_HEADER_ID_MASK     UINT32_C(0x00FFFFFF)
+
+/**
+ * @brief Log ring
+ *
+ * Producers reserve words by advancing head and publish a record by writing
+ * its header word last. The single consumer (the drain) reads published
+ * records at tail, clears all their words and advances tail, so a word of
+ * the ring is either zero or part of a live record. Storage must start
+ * zeroed.
+ */
+struct nhal_log{
+    uint32_t *words;             /**< Ring storage. */
+    uint32_t mask;               /**< Ring size in words minus one. */
+    uint32_t head;               /**< Next word to reserve (free running). */
+    uint32_t tail;               /**< Next word to drain (free running). */
+    uint32_t dropped;            /**< Records dropped since last reported. */
+    uint32_t last_timestamp;     /**< Timestamp of the last drained record. */
+};
+
+/**
+ * @brief Ring used by the NHAL_LOG_* macros (defined by NHAL_LOG_IMPLEMENTATION)
+ */
+extern struct nhal_log nhal_log_instance;
+
+/**
+ * @brief Start of the format string section (provided by the linker)
+ */
+extern const char __start_nhal_log_fmt[];
+
+/**
+ * @brief Pass a float argument, for %f, %e and %g conversions
+ */
+static inline uint32_t nhal_log_float(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief Store a record in the ring (used by the NHAL_LOG_* macros)
+ *
+ * @param log Log ring
+ * @param fmt Format string entry inside the nhal_log_fmt section
+ * @param args Argument words
+ * @param nargs Number of arguments
+ */
+static inline void nhal_log_record(struct nhal_log *log, const char *fmt, const uint32_t *args, uint32_t nargs)
+{
+    uint32_t words = nargs + 2;
+    uint32_t head = __atomic_load_n(&log->head, __ATOMIC_RELAXED);
+    uint32_t i;
+
+    do {
+        if (head - __atomic_load_n(&log->tail, __ATOMIC_ACQUIRE) + words > log->mask + 1) {
+            __atomic_fetch_add(&log->dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&log->head, &head, head + words, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    log->words[(head + 1) & log->mask] = NHAL_LOG_TIMESTAMP();
+    for (i = 0; i < nargs; i++) {
+        log->words[(head + 2 + i) & log->mask] = args[i];
+    }
+    __atomic_store_n(&log->words[head & log->mask],
+                     NHAL_LOG_HEADER_VALID | (nargs << NHAL_LOG_HEADER_NARGS_SHIFT) |
+                     ((uint32_t)(fmt - __start_nhal_log_fmt) & NHAL_LOG_HEADER_ID_MASK),
+                     __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Encode drained records into a buffer
+ *
+ * Pops as many complete records as fit in out. Each record becomes one
+ * COBS frame terminated by a zero byte, holding the varint encoded format
+ * ID plus one, the zigzag varint timestamp delta to the previous record and
+ * the zigzag varint arguments. Dropped records are reported by a frame with
+ * ID 0 followed by the count.
+ *
+ * Only one context may drain a given ring.
+ *
+ * @param log Log ring
+ * @param out Output buffer (at least NHAL_LOG_FRAME_MAX bytes to make progress)
+ * @param out_size Output buffer size
+ * @return Number of bytes written to out (0 when nothing is pending)
+ */
+size_t nhal_log_encode(struct nhal_log *log, uint8_t *out, size_t out_size);
+
+/**
+ * @brief Drain all pending records to a UART
+ *
+ * @param log Log ring
+ * @param uart UART context to write to
+ * @return NHAL_OK when the ring is empty, or the UART write error
+ */
+nhal_result_t nhal_log_drain(struct nhal_log *log, struct nhal_uart_context *uart);
+
+/** @cond INTERNAL */
+#define NHAL_LOG_STR_(x) NHAL_LOG_STR_I_(x)
+#define NHAL_LOG_STR_I_(x) #x
+#define NHAL_LOG_CAT_(a, b) NHAL_LOG_CAT_I_(a, b)
+#define NHAL_LOG_CAT_I_(a, b) a##b
+
+/* Argument count, format string excluded */
+#define NHAL_LOG_NARGS_(...) NHAL_LOG_NARGS_I_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0, ~)
+#define NHAL_LOG_NARGS_I_(fmt, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+#define NHAL_LOG_FMT_(...) NHAL_LOG_FMT_I_(__VA_ARGS__, ~)
+#define NHAL_LOG_FMT_I_(fmt, ...) fmt
+
+/* Argument words, format string skipped */
+#define NHAL_LOG_ARG_(x) , (uint32_t)(uintptr_t)(x)
+#define NHAL_LOG_ARGS_0_(fmt)
+#define NHAL_LOG_ARGS_1_(fmt, a) NHAL_LOG_ARG_(a)
+#define NHAL_LOG_ARGS_2_(fmt, a, ...) NHAL_LOG_ARG_(a) NHAL_LOG_ARGS_1_(fmt, __VA_ARGS__)
+#define NHAL_LOG_ARGS_3_(fmt, a, ...) NHAL_LOG_ARG_(a) NHAL_LOG_ARGS_2_(fmt, __VA_ARGS__)
+#define NHAL_LOG_ARGS_4_(fmt, a, ...) NHAL_LOG_ARG_(a) NHAL_LOG_ARGS_3_(fmt, __VA_ARGS__)
+#define NHAL_LOG_ARGS_5_(fmt, a, ...) NHAL_LOG_ARG_(a) NHAL_LOG_ARGS_4_(fmt, __VA_ARGS__)
+#define NHAL_LOG_ARGS_6_(fmt, a, ...) NHAL_LOG_ARG_(a) NHAL_LOG_ARGS_5_(fmt, __VA_ARGS__)
+#define NHAL_LOG_ARGS_7_(fmt, a, ...) NHAL_LOG_ARG_(a) NHAL_LOG_ARGS_6_(fmt, __VA_ARGS__)
+#define NHAL_LOG_ARGS_8_(fmt, a, ...) NHAL_LOG_ARG_(a) NHAL_LOG_ARGS_7_(fmt, __VA_ARGS__)
+
+/* Section entry: level, file:line and format, separated by 0x1F */
+#define NHAL_LOG_RECORD_(level, ...)                                                          \
+    do {                                                                                      \
+        static const char nhal_log_fmt_[] __attribute__((section("nhal_log_fmt"), used, aligned(1))) = \
+            level "\x1f" __FILE__ ":" NHAL_LOG_STR_(__LINE__) "\x1f" NHAL_LOG_FMT_(__VA_ARGS__);   \
+        const uint32_t nhal_log_args_[NHAL_LOG_NARGS_(__VA_ARGS__) + 1] = {                   \
+            0 NHAL_LOG_CAT_(NHAL_LOG_ARGS_, NHAL_LOG_CAT_(NHAL_LOG_NARGS_(__VA_ARGS__), _))(__VA_ARGS__) \
+        };                                                                                    \
+        nhal_log_record(&nhal_log_instance, nhal_log_fmt_, nhal_log_args_ + 1,                \
+                        NHAL_LOG_NARGS_(__VA_ARGS__));                                        \
+    } while (0)
+/** @endcond */
+
+#if NHAL_LOG_LEVEL >= NHAL_LOG_LEVEL_ERROR
+#define NHAL_LOG_ERROR(...) NHAL_LOG_RECORD_("E", __VA_ARGS__)
+#else
+#define NHAL_LOG_ERROR(...) ((void)0)
+#endif
+
+#if NHAL_LOG_LEVEL >= NHAL_LOG_LEVEL_WARN
+#define NHAL_LOG_WARN(...) NHAL_LOG_RECORD_("W", __VA_ARGS__)
+#else
+#define NHAL_LOG_WARN(...) ((void)0)
+#endif
+
+#if NHAL_LOG_LEVEL >= NHAL_LOG_LEVEL_INFO
+#define NHAL_LOG_INFO(...) NHAL_LOG_RECORD_("I", __VA_ARGS__)
+#else
+#define NHAL_LOG_INFO(...) ((void)0)
+#endif
+
+#if NHAL_LOG_LEVEL >= NHAL_LOG_LEVEL_DEBUG
+#define NHAL_LOG_DEBUG(...) NHAL_LOG_RECORD_("D", __VA_ARGS__)
+#else
+#define NHAL_LOG_DEBUG(...) ((void)0)
+#endif
+
+#ifdef NHAL_LOG_IMPLEMENTATION
+
+#if (NHAL_LOG_BUFFER_WORDS & (NHAL_LOG_BUFFER_WORDS - 1)) != 0
+#error "NHAL_LOG_BUFFER_WORDS must be a power of two"
+#endif
+
+static uint32_t nhal_log_storage[NHAL_LOG_BUFFER_WORDS];
+
+struct nhal_log nhal_log_instance = { nhal_log_storage, NHAL_LOG_BUFFER_WORDS - 1, 0, 0, 0, 0 };
+
+static size_t nhal_log_put_varint(uint8_t *out, uint32_t value)
+{
+    size_t len = 0;
+
+    while (value >= 0x80) {
+        out[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[len++] = (uint8_t)value;
+    return len;
+}
+
+static uint32_t nhal_log_zigzag(uint32_t value)
+{
+    return (value << 1) ^ (uint32_t)-(int32_t)(value >> 31);
+}
+
+/* Payloads never exceed 254 bytes, so a single COBS block is enough */
+static size_t nhal_log_put_frame(uint8_t *out, const uint8_t *payload, size_t len)
+{
+    size_t code_pos = 0;
+    size_t pos = 1;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        if (payload[i] == 0) {
+            out[code_pos] = (uint8_t)(pos - code_pos);
+            code_pos = pos++;
+        } else {
+            out[pos++] = payload[i];
+        }
+    }
+    out[code_pos] = (uint8_t)(pos - code_pos);
+    out[pos++] = 0;
+    return pos;
+}
+
+size_t nhal_log_encode(struct nhal_log *log, uint8_t *out, size_t out_size)
+{
+    uint8_t payload[NHAL_LOG_FRAME_MAX];
+    size_t written = 0;
+
+    while (out_size - written >= NHAL_LOG_FRAME_MAX) {
+        uint32_t tail = log->tail;
+        uint32_t header = 0;
+        size_t len = 0;
+
+        /* A reserved record whose header is not written yet is still being
+         * filled by its producer: stop there and pick it up next time */
+        if (tail != __atomic_load_n(&log->head, __ATOMIC_ACQUIRE)) {
+            header = __atomic_load_n(&log->words[tail & log->mask], __ATOMIC_ACQUIRE);
+        }
+
+        if ((header & NHAL_LOG_HEADER_VALID) != 0) {
+            uint32_t nargs = (header >> NHAL_LOG_HEADER_NARGS_SHIFT) & 0x0F;
+            uint32_t timestamp = log->words[(tail + 1) & log->mask];
+            uint32_t i;
+
+            len += nhal_log_put_varint(payload + len, (header & NHAL_LOG_HEADER_ID_MASK) + 1);
+            len += nhal_log_put_varint(payload + len, nhal_log_zigzag(timestamp - log->last_timestamp));
+            for (i = 0; i < nargs; i++) {
+                len += nhal_log_put_varint(payload + len, nhal_log_zigzag(log->words[(tail + 2 + i) & log->mask]));
+            }
+            log->last_timestamp = timestamp;
+
+            /* Clear the whole record: an argument word left behind could
+             * otherwise pass for the header of a later, unpublished record */
+            for (i = 0; i < 2 + nargs; i++) {
+                log->words[(tail + i) & log->mask] = 0;
+            }
+            __atomic_store_n(&log->tail, tail + 2 + nargs, __ATOMIC_RELEASE);
+        } else {
+            /* Records are lost while the ring is full, so report them once it has drained */
+            uint32_t dropped = __atomic_exchange_n(&log->dropped, 0, __ATOMIC_RELAXED);
+            if (dropped == 0) {
+                break;
+            }
+            len += nhal_log_put_varint(payload + len, 0);
+            len += nhal_log_put_varint(payload + len, dropped);
+        }
+        written += nhal_log_put_frame(out + written, payload, len);
+    }
+    return written;
+}
+
+nhal_result_t nhal_log_drain(struct nhal_log *log, struct nhal_uart_context *uart)
+{
+    uint8_t chunk[4 * NHAL_LOG_FRAME_MAX];
+    size_t len;
+
+    while ((len = nhal_log_encode(log, chunk, sizeof(chunk))) != 0) {
+        nhal_result_t result = nhal_uart_write(uart, chunk, len);
+        if (result != NHAL_OK) {
+            return result;
+        }
+    }
+    return NHAL_OK;
+}
+
+#endif /* NHAL_LOG_IMPLEMENTATION */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_LOG_H */
@@ -0,0 +1,102 @@
+/**
+ * @file nhal_onewire.h
+ * @brief Hardware Abstraction Layer for synchronous 1-Wire master communication.
+ *
+ * This file defines the API for interacting with a 1-Wire bus as master.
+ * It provides functions for initialization, configuration, bus reset with
+ * presence detection, and bit/byte level reads and writes.
+ * All operations block until completion.
+ */
+#ifndef NHAL_ONEWIRE_H
+#define NHAL_ONEWIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "nhal_common.h"
+#include "nhal_onewire_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize 1-Wire context
+ * @param ctx Pointer to 1-Wire context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_onewire_init(struct nhal_onewire_context *ctx);
+
+/**
+ * @brief Deinitialize 1-Wire context
+ * @param ctx Pointer to 1-Wire context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_onewire_deinit(struct nhal_onewire_context *ctx);
+
+/**
+ * @brief Set 1-Wire configuration
+ * @param ctx Pointer to 1-Wire context structure
+ * @param config Pointer to configuration structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_onewire_set_config(struct nhal_onewire_context *ctx, struct nhal_onewire_config *config);
+
+/**
+ * @brief Get current 1-Wire configuration
+ * @param ctx Pointer to 1-Wire context structure
+ * @param config Pointer to configuration structure to fill
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_onewire_get_config(struct nhal_onewire_context *ctx, struct nhal_onewire_config *config);
+
+/**
+ * @brief Issue a bus reset and detect presence pulses (blocking)
+ * @param ctx Pointer to 1-Wire context structure
+ * @param presence Pointer to store whether at least one device answered
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_HW_FAILURE Bus is shorted (held low)
+ */
+nhal_result_t nhal_onewire_reset(struct nhal_onewire_context *ctx, bool *presence);
+
+/**
+ * @brief Write a single bit time slot (blocking)
+ * @param ctx Pointer to 1-Wire context structure
+ * @param bit Bit value to write
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_onewire_write_bit(struct nhal_onewire_context *ctx, bool bit);
+
+/**
+ * @brief Read a single bit time slot (blocking)
+ * @param ctx Pointer to 1-Wire context structure
+ * @param bit Pointer to store the bit value read
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_onewire_read_bit(struct nhal_onewire_context *ctx, bool *bit);
+
+/**
+ * @brief Write bytes to the bus, LSB first (blocking)
+ * @param ctx Pointer to 1-Wire context structure
+ * @param data Pointer to data to transmit
+ * @param len Number of bytes to transmit
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_onewire_write(struct nhal_onewire_context *ctx, const uint8_t *data, size_t len);
+
+/**
+ * @brief Read bytes from the bus, LSB first (blocking)
+ * @param ctx Pointer to 1-Wire context structure
+ * @param data Pointer to buffer for received data
+ * @param len Number of bytes to read
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_onewire_read(struct nhal_onewire_context *ctx, uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_ONEWIRE_H */
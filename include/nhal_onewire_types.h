@@ -0,0 +1,51 @@
+/**
+ * @file nhal_onewire_types.h
+ * @brief Defines common types and structures for the 1-Wire Hardware Abstraction Layer (HAL).
+ *
+ * This header file provides opaque types, enumerations, and structures used across
+ * the 1-Wire HAL API to facilitate communication over 1-Wire buses.
+ */
+#ifndef NHAL_ONEWIRE_TYPES_H
+#define NHAL_ONEWIRE_TYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "nhal_common.h"
+
+/**
+ * @brief 1-Wire context structure (implementation-defined)
+ *
+ * Contains platform-specific 1-Wire bus identification and runtime state.
+ * The bus may be backed by a dedicated peripheral, a UART, or a bit-banged
+ * open-drain pin.
+ *
+ * @par Example content:
+ * @code
+ * struct nhal_onewire_context {
+ *     // Bus identification: data pin context OR UART handle
+ *     struct nhal_pin_context *data_pin;
+ *     // Precomputed slot timings for the configured speed
+ *     uint16_t slot_timing_us[4];
+ * };
+ * @endcode
+ */
+struct nhal_onewire_context;
+
+/**
+ * @brief 1-Wire bus speed configuration
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_ONEWIRE_SPEED_STANDARD = 0,   /**< Standard speed (~15.4 kbit/s). */
+    NHAL_ONEWIRE_SPEED_OVERDRIVE,      /**< Overdrive speed (~125 kbit/s). */
+} nhal_onewire_speed_t;
+
+/**
+ * @brief 1-Wire configuration structure
+ */
+struct nhal_onewire_config{
+    nhal_onewire_speed_t speed;
+    struct nhal_onewire_impl_config * impl_config;
+};
+
+#endif /* NHAL_ONEWIRE_TYPES_H */
@@ -0,0 +1,126 @@
+/**
+ * @file nhal_pin_capture.h
+ * @brief Header for the Hardware Abstraction Layer (HAL) Pin Input Capture module.
+ *
+ * This module provides an interface to measure pulse periods, pulse widths and
+ * edge counts on an input pin using hardware timestamping (timer input capture,
+ * PIO, RMT, ...). Measurements accumulate in the background and are read in
+ * bulk, so no callback runs per edge and high frequency signals (PWM, tachometers,
+ * ultrasonic echoes) are measured with timer accuracy instead of interrupt latency.
+ *
+ * All functions are SYNCHRONOUS; nhal_pin_capture_read() never blocks waiting
+ * for new edges.
+ */
+#ifndef NHAL_PIN_CAPTURE_H
+#define NHAL_PIN_CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_pin_capture_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize pin input capture context
+ * @param ctx Pointer to capture context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_pin_capture_init(struct nhal_pin_capture_context *ctx);
+
+/**
+ * @brief Deinitialize pin input capture context
+ * @param ctx Pointer to capture context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_pin_capture_deinit(struct nhal_pin_capture_context *ctx);
+
+/**
+ * @brief Set pin input capture configuration
+ * @param ctx Pointer to capture context structure
+ * @param config Pointer to configuration structure
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_BUSY Capture is running, stop it first
+ * @retval NHAL_ERR_UNSUPPORTED Edge selection or prescaler not supported by hardware
+ */
+nhal_result_t nhal_pin_capture_set_config(struct nhal_pin_capture_context *ctx, struct nhal_pin_capture_config *config);
+
+/**
+ * @brief Get current pin input capture configuration
+ * @param ctx Pointer to capture context structure
+ * @param config Pointer to configuration structure to fill
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_pin_capture_get_config(struct nhal_pin_capture_context *ctx, struct nhal_pin_capture_config *config);
+
+/**
+ * @brief Get the frequency of the timer used to timestamp edges
+ * @param ctx Pointer to capture context structure
+ * @param frequency_hz Pointer to store the timer frequency in Hz
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_NOT_CONFIGURED Capture not configured
+ */
+nhal_result_t nhal_pin_capture_get_timer_frequency(struct nhal_pin_capture_context *ctx, uint32_t *frequency_hz);
+
+/**
+ * @brief Start capturing edges
+ *
+ * Resets the counters and the measurement buffer.
+ *
+ * @param ctx Pointer to capture context structure
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_NOT_CONFIGURED Capture not configured
+ * @retval NHAL_ERR_ALREADY_STARTED Capture already running
+ */
+nhal_result_t nhal_pin_capture_start(struct nhal_pin_capture_context *ctx);
+
+/**
+ * @brief Stop capturing edges
+ *
+ * Measurements already captured remain readable.
+ *
+ * @param ctx Pointer to capture context structure
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_NOT_STARTED Capture not running
+ */
+nhal_result_t nhal_pin_capture_stop(struct nhal_pin_capture_context *ctx);
+
+/**
+ * @brief Read the measurements accumulated since the last read (non-blocking)
+ *
+ * Returns the oldest pending measurements first. If fewer than max_samples
+ * are pending, only those are returned; zero pending measurements is not an error.
+ *
+ * @param ctx Pointer to capture context structure
+ * @param samples Array to fill with measurements
+ * @param max_samples Capacity of the samples array
+ * @param num_samples Pointer to store the number of measurements written
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_pin_capture_read(
+    struct nhal_pin_capture_context *ctx,
+    nhal_pin_capture_sample_t *samples,
+    size_t max_samples,
+    size_t *num_samples
+);
+
+/**
+ * @brief Get capture counters since the capture was started
+ * @param ctx Pointer to capture context structure
+ * @param stats Pointer to statistics structure to fill
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_pin_capture_get_stats(struct nhal_pin_capture_context *ctx, struct nhal_pin_capture_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_PIN_CAPTURE_H */
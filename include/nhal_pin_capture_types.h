@@ -0,0 +1,74 @@
+/**
+ * @file nhal_pin_capture_types.h
+ * @brief Defines the types and structures used by the Pin Input Capture HAL module.
+ *
+ * This header provides definitions for the input capture context, edge selection,
+ * configuration, and the pulse measurement records delivered by the module.
+ */
+#ifndef NHAL_PIN_CAPTURE_TYPES_H
+#define NHAL_PIN_CAPTURE_TYPES_H
+
+#include <stdint.h>
+
+#include "nhal_common.h"
+
+/**
+ * @brief Pin input capture context structure (implementation-defined)
+ *
+ * Contains platform-specific identification of the capture channel (timer +
+ * channel, PIO state machine, RMT channel...) and its runtime state,
+ * typically including a DMA/ring buffer where captured edges accumulate.
+ *
+ * @par Example content:
+ * @code
+ * struct nhal_pin_capture_context {
+ *     // Capture channel identification
+ *     TIM_TypeDef *timer;
+ *     uint8_t channel;
+ *     // Edge timestamp ring filled by DMA
+ *     uint32_t *dma_ring;
+ *     size_t ring_len;
+ * };
+ * @endcode
+ */
+struct nhal_pin_capture_context;
+
+/**
+ * @brief Edges used to delimit measured pulses
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_PIN_CAPTURE_EDGE_RISING,    /**< Period measured rising to rising, no width. */
+    NHAL_PIN_CAPTURE_EDGE_FALLING,   /**< Period measured falling to falling, no width. */
+    NHAL_PIN_CAPTURE_EDGE_BOTH,      /**< Period and high time (pulse width) measured. */
+    NHAL_PIN_CAPTURE_EDGE_TOTAL_NUM,
+} nhal_pin_capture_edge_t;
+
+/**
+ * @brief Pin input capture configuration structure
+ */
+struct nhal_pin_capture_config{
+    nhal_pin_capture_edge_t edge;    /**< Edges captured by the hardware. */
+    uint16_t prescaler;              /**< Capture one out of every N periods (0 or 1: all of them). */
+    struct nhal_pin_capture_impl_config * impl_config;
+};
+
+/**
+ * @brief Single pulse measurement
+ *
+ * Durations are expressed in capture timer ticks, see
+ * nhal_pin_capture_get_timer_frequency().
+ */
+typedef struct {
+    uint32_t period_ticks;           /**< Time between two consecutive active edges. */
+    uint32_t high_ticks;             /**< Time the pin stayed high within the period (0 if not measured). */
+} nhal_pin_capture_sample_t;
+
+/**
+ * @brief Input capture counters since the capture was started
+ */
+struct nhal_pin_capture_stats{
+    uint64_t edge_count;             /**< Number of edges seen by the hardware. */
+    uint32_t overrun_count;          /**< Measurements lost because they were not read in time. */
+};
+
+#endif /* NHAL_PIN_CAPTURE_TYPES_H */
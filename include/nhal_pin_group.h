@@ -0,0 +1,126 @@
+/**
+ * @file nhal_pin_group.h
+ * @brief Header for the Hardware Abstraction Layer (HAL) Pin Group module.
+ *
+ * This module provides a SYNCHRONOUS interface for driving and sampling several
+ * GPIO pins at once. It is intended for software (bit-banged) protocol engines
+ * such as SPI, I2C or 1-Wire over plain pins, where toggling pins one by one
+ * through nhal_pin_set_state() is too slow and introduces jitter.
+ *
+ * Bit-banged engines should precompute the pin transitions of a whole
+ * transfer (e.g.: SCK/MOSI states for every half clock period) and emit them
+ * with nhal_pin_group_run_sequence(), which lets the implementation play them
+ * back at a fixed step from a tight loop, a timer or DMA into the port
+ * registers.
+ */
+#ifndef NHAL_PIN_GROUP_H
+#define NHAL_PIN_GROUP_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_pin_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize pin group context
+ *
+ * Every pin of the group must be configured (direction, pull mode), either
+ * beforehand through the pin interface or, once the group is initialized,
+ * with nhal_pin_group_set_direction().
+ *
+ * @param ctx Pointer to pin group context structure
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_UNSUPPORTED Pins cannot be grouped (e.g.: different ports)
+ */
+nhal_result_t nhal_pin_group_init(struct nhal_pin_group_context *ctx);
+
+/**
+ * @brief Deinitialize pin group context
+ * @param ctx Pointer to pin group context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_pin_group_deinit(struct nhal_pin_group_context *ctx);
+
+/**
+ * @brief Set direction and pull mode of several pins at once
+ *
+ * Pins outside the mask keep their configuration. Equivalent to calling
+ * nhal_pin_set_direction() on every selected pin.
+ *
+ * @param ctx Pointer to pin group context structure
+ * @param mask Pins to configure
+ * @param direction Pin direction (input or output)
+ * @param pull_mode Pull resistor configuration
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_pin_group_set_direction(
+    struct nhal_pin_group_context *ctx,
+    nhal_pin_group_mask_t mask,
+    nhal_pin_dir_t direction,
+    nhal_pin_pull_mode_t pull_mode
+);
+
+/**
+ * @brief Set the state of several pins at once
+ *
+ * Pins selected by mask are set to the corresponding bit of values, pins
+ * outside the mask are left untouched. Implementations should update all
+ * selected pins simultaneously when the hardware allows it (e.g.: single
+ * write to a set/reset register).
+ *
+ * @param ctx Pointer to pin group context structure
+ * @param mask Pins to update
+ * @param values New pin states (1 = high, 0 = low)
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_pin_group_write(
+    struct nhal_pin_group_context *ctx,
+    nhal_pin_group_mask_t mask,
+    nhal_pin_group_mask_t values
+);
+
+/**
+ * @brief Sample the state of all pins of the group at once
+ * @param ctx Pointer to pin group context structure
+ * @param values Pointer to store the pin states (1 = high, 0 = low)
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_pin_group_read(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t *values);
+
+/**
+ * @brief Play back a precomputed sequence of pin states (blocking)
+ *
+ * For every step i, pins selected by mask are set to out_values[i], then
+ * after step_ns nanoseconds the whole group is sampled into in_values[i]
+ * (if in_values is not NULL) right before the next step is applied.
+ *
+ * @param ctx Pointer to pin group context structure
+ * @param mask Pins driven by the sequence
+ * @param out_values Array of pin states to apply, one per step
+ * @param in_values Array to store sampled pin states, one per step (may be NULL)
+ * @param count Number of steps
+ * @param step_ns Duration of each step in nanoseconds
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_UNSUPPORTED step_ns is shorter than the implementation can achieve
+ */
+nhal_result_t nhal_pin_group_run_sequence(
+    struct nhal_pin_group_context *ctx,
+    nhal_pin_group_mask_t mask,
+    const nhal_pin_group_mask_t *out_values,
+    nhal_pin_group_mask_t *in_values,
+    size_t count,
+    uint32_t step_ns
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_PIN_GROUP_H */
@@ -0,0 +1,310 @@
+/**
+ * @file nhal_pin_ops.h
+ * @brief Optional ops-table dispatch for the PIN Hardware Abstraction Layer (HAL).
+ *
+ * By default every nhal_pin function is a single global symbol provided by
+ * one implementation at link time. Defining NHAL_PIN_DISPATCH for the whole
+ * build switches to dispatch mode, where each context carries a pointer to
+ * the function table of its backend, so several pin implementations
+ * can coexist in one binary (e.g.: soc_gpio and io_expander).
+ * Consumers keep calling the regular C API.
+ *
+ * In dispatch mode:
+ * - struct nhal_pin_context and struct nhal_pin_group_context are defined
+ *   here, holding the ops table and the backend's own state pointer.
+ * - Backends implement the functions of struct nhal_pin_ops (and of struct
+ *   nhal_pin_group_ops for pin groups) under their own names. Ops receive
+ *   the generic context and retrieve their state from ctx->backend_ctx.
+ * - Exactly one translation unit defines NHAL_DISPATCH_IMPLEMENTATION
+ *   before including this header to emit the dispatching nhal_pin and
+ *   nhal_pin_group functions.
+ *   Missing (NULL) ops return NHAL_ERR_UNSUPPORTED.
+ *
+ * Each dispatched call costs one extra indirect call. Builds that do not
+ * define NHAL_PIN_DISPATCH are unaffected.
+ *
+ * @par Example usage:
+ * @code
+ * static const struct nhal_pin_ops soc_gpio_ops = { .init = soc_gpio_init, ... };
+ * static struct soc_gpio_state soc_gpio_state;
+ *
+ * struct nhal_pin_context ctx;
+ * nhal_pin_context_bind(&ctx, &soc_gpio_ops, &soc_gpio_state);
+ * nhal_pin_init(&ctx);
+ * @endcode
+ */
+#ifndef NHAL_PIN_OPS_H
+#define NHAL_PIN_OPS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_pin.h"
+#include "nhal_pin_group.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief PIN backend function table
+ *
+ * Each member has the signature of the matching nhal_pin_* function.
+ */
+struct nhal_pin_ops{
+    nhal_result_t (*init)(struct nhal_pin_context *ctx);
+    nhal_result_t (*deinit)(struct nhal_pin_context *ctx);
+    nhal_result_t (*set_config)(struct nhal_pin_context *ctx, struct nhal_pin_config *config);
+    nhal_result_t (*get_config)(struct nhal_pin_context *ctx, struct nhal_pin_config *config);
+    nhal_result_t (*set_state)(struct nhal_pin_context *ctx, nhal_pin_state_t value);
+    nhal_result_t (*get_state)(struct nhal_pin_context *ctx, nhal_pin_state_t *value);
+    nhal_result_t (*set_direction)(struct nhal_pin_context *ctx, nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode);
+    nhal_result_t (*set_interrupt_config)(struct nhal_pin_context *ctx, nhal_pin_int_trigger_t trigger, nhal_pin_callback_t callback, void *user_data);
+    nhal_result_t (*interrupt_enable)(struct nhal_pin_context *ctx);
+    nhal_result_t (*interrupt_disable)(struct nhal_pin_context *ctx);
+};
+
+/**
+ * @brief Pin group backend function table
+ *
+ * Each member has the signature of the matching nhal_pin_group_* function.
+ */
+struct nhal_pin_group_ops{
+    nhal_result_t (*init)(struct nhal_pin_group_context *ctx);
+    nhal_result_t (*deinit)(struct nhal_pin_group_context *ctx);
+    nhal_result_t (*set_direction)(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode);
+    nhal_result_t (*write)(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, nhal_pin_group_mask_t values);
+    nhal_result_t (*read)(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t *values);
+    nhal_result_t (*run_sequence)(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, const nhal_pin_group_mask_t *out_values, nhal_pin_group_mask_t *in_values, size_t count, uint32_t step_ns);
+};
+
+#ifdef NHAL_PIN_DISPATCH
+
+/**
+ * @brief PIN context structure in dispatch mode
+ */
+struct nhal_pin_context{
+    const struct nhal_pin_ops *ops;     /**< Function table of the backend serving this context. */
+    void *backend_ctx;                  /**< Backend-specific state. */
+};
+
+/**
+ * @brief Bind a context to a backend
+ * @param ctx Pointer to PIN context structure
+ * @param ops Backend function table
+ * @param backend_ctx Backend-specific state
+ */
+static inline void nhal_pin_context_bind(struct nhal_pin_context *ctx, const struct nhal_pin_ops *ops, void *backend_ctx)
+{
+    ctx->ops = ops;
+    ctx->backend_ctx = backend_ctx;
+}
+
+/**
+ * @brief Pin group context structure in dispatch mode
+ */
+struct nhal_pin_group_context{
+    const struct nhal_pin_group_ops *ops;   /**< Function table of the backend serving this group. */
+    void *backend_ctx;                      /**< Backend-specific state. */
+};
+
+/**
+ * @brief Bind a pin group context to a backend
+ * @param ctx Pointer to pin group context structure
+ * @param ops Backend function table
+ * @param backend_ctx Backend-specific state
+ */
+static inline void nhal_pin_group_context_bind(struct nhal_pin_group_context *ctx, const struct nhal_pin_group_ops *ops, void *backend_ctx)
+{
+    ctx->ops = ops;
+    ctx->backend_ctx = backend_ctx;
+}
+
+#ifdef NHAL_DISPATCH_IMPLEMENTATION
+
+nhal_result_t nhal_pin_init(struct nhal_pin_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->init == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->init(ctx);
+}
+
+nhal_result_t nhal_pin_deinit(struct nhal_pin_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->deinit == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->deinit(ctx);
+}
+
+nhal_result_t nhal_pin_set_config(struct nhal_pin_context *ctx, struct nhal_pin_config *config)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->set_config == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->set_config(ctx, config);
+}
+
+nhal_result_t nhal_pin_get_config(struct nhal_pin_context *ctx, struct nhal_pin_config *config)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->get_config == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->get_config(ctx, config);
+}
+
+nhal_result_t nhal_pin_set_state(struct nhal_pin_context *ctx, nhal_pin_state_t value)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->set_state == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->set_state(ctx, value);
+}
+
+nhal_result_t nhal_pin_get_state(struct nhal_pin_context *ctx, nhal_pin_state_t *value)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->get_state == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->get_state(ctx, value);
+}
+
+nhal_result_t nhal_pin_set_direction(struct nhal_pin_context *ctx, nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->set_direction == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->set_direction(ctx, direction, pull_mode);
+}
+
+nhal_result_t nhal_pin_set_interrupt_config(struct nhal_pin_context *ctx, nhal_pin_int_trigger_t trigger, nhal_pin_callback_t callback, void *user_data)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->set_interrupt_config == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->set_interrupt_config(ctx, trigger, callback, user_data);
+}
+
+nhal_result_t nhal_pin_interrupt_enable(struct nhal_pin_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->interrupt_enable == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->interrupt_enable(ctx);
+}
+
+nhal_result_t nhal_pin_interrupt_disable(struct nhal_pin_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->interrupt_disable == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->interrupt_disable(ctx);
+}
+
+nhal_result_t nhal_pin_group_init(struct nhal_pin_group_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->init == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->init(ctx);
+}
+
+nhal_result_t nhal_pin_group_deinit(struct nhal_pin_group_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->deinit == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->deinit(ctx);
+}
+
+nhal_result_t nhal_pin_group_set_direction(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->set_direction == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->set_direction(ctx, mask, direction, pull_mode);
+}
+
+nhal_result_t nhal_pin_group_write(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, nhal_pin_group_mask_t values)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->write == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->write(ctx, mask, values);
+}
+
+nhal_result_t nhal_pin_group_read(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t *values)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->read == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->read(ctx, values);
+}
+
+nhal_result_t nhal_pin_group_run_sequence(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, const nhal_pin_group_mask_t *out_values, nhal_pin_group_mask_t *in_values, size_t count, uint32_t step_ns)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->run_sequence == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->run_sequence(ctx, mask, out_values, in_values, count, step_ns);
+}
+
+#endif /* NHAL_DISPATCH_IMPLEMENTATION */
+
+#endif /* NHAL_PIN_DISPATCH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_PIN_OPS_H */
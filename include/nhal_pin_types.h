@@ -31,10 +31,34 @@
  */
 struct nhal_pin_context;
 
+/**
+ * @brief Pin group context structure (implementation-defined)
+ *
+ * Groups several pins (typically on the same port) so that they can be
+ * driven and sampled together with a single operation. Bit N of every
+ * group mask/value refers to the N-th pin of the group.
+ *
+ * @par Example content:
+ * @code
+ * struct nhal_pin_group_context {
+ *     // Port identification and per-bit pin numbers within the port
+ *     GPIO_TypeDef *port;
+ *     uint8_t pin_numbers[8];
+ *     uint8_t num_pins;
+ * };
+ * @endcode
+ */
+struct nhal_pin_group_context;
+
+/**
+ * @brief Pin group mask/value type, bit N refers to the N-th pin of the group
+ */
+typedef uint32_t nhal_pin_group_mask_t;
+
 /**
  * @brief Pin logic state enumeration
  */
-typedef enum nhal_pin_state_t{
+typedef enum NHAL_ENUM_PACKED nhal_pin_state_t{
     NHAL_PIN_LOW = 0,
     NHAL_PIN_HIGH
 }nhal_pin_state_t;
@@ -42,7 +66,7 @@ typedef enum nhal_pin_state_t{
 /**
  * @brief Pin direction enumeration
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_PIN_DIR_INPUT,
     NHAL_PIN_DIR_OUTPUT,
     NHAL_PIN_DIR_TOTAL_NUM,
@@ -51,14 +75,14 @@ typedef enum {
 /**
  * @brief Pin pull resistor mode enumeration
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_PIN_PMODE_NONE,
     NHAL_PIN_PMODE_PULL_UP,
     NHAL_PIN_PMODE_PULL_DOWN,
     NHAL_PIN_PMODE_TOTAL_NUM,
 } nhal_pin_pull_mode_t;
 
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_PIN_INT_TRIGGER_NONE,
     NHAL_PIN_INT_TRIGGER_RISING_EDGE,
     NHAL_PIN_INT_TRIGGER_FALLING_EDGE,
@@ -0,0 +1,163 @@
+/**
+ * @file nhal_qspi.h
+ * @brief Hardware Abstraction Layer for Quad/Octal SPI memory controllers.
+ *
+ * This file defines the API for external memories (NOR flash, PSRAM) attached
+ * to a QSPI/OSPI controller. Indirect mode issues single commands built from
+ * an nhal_qspi_command_t, with any combination of line widths (1-1-4, 1-4-4,
+ * 4-4-4, ...), dummy cycles and DDR. Memory-mapped mode programs a read
+ * command template into the controller, after which the memory is readable
+ * through a plain pointer (execute-in-place, zero-copy reads).
+ *
+ * All indirect operations block until completion or timeout.
+ *
+ * @par Example usage:
+ * @code
+ * // 1-4-4 fast read: 0xEB, 3 address bytes, 1 mode byte, 4 dummy cycles
+ * nhal_qspi_command_t quad_read = {
+ *     .instruction = 0xEB, .instruction_width = NHAL_QSPI_WIDTH_1,
+ *     .address_width = NHAL_QSPI_WIDTH_4, .address_bytes = 3,
+ *     .alternate = 0xF0, .alternate_width = NHAL_QSPI_WIDTH_4, .alternate_bytes = 1,
+ *     .dummy_cycles = 4,
+ *     .data_width = NHAL_QSPI_WIDTH_4,
+ * };
+ *
+ * quad_read.address = 0x1000;
+ * nhal_qspi_read(qspi_ctx, &quad_read, buf, sizeof(buf));
+ *
+ * const volatile uint8_t *flash;
+ * nhal_qspi_memory_map_enable(qspi_ctx, &quad_read, &flash);
+ * const struct font *font = (const struct font *)&flash[FONT_OFFSET];
+ * @endcode
+ */
+#ifndef NHAL_QSPI_H
+#define NHAL_QSPI_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_qspi_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize QSPI context
+ * @param ctx Pointer to QSPI context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_qspi_init(struct nhal_qspi_context *ctx);
+
+/**
+ * @brief Deinitialize QSPI context
+ * @param ctx Pointer to QSPI context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_qspi_deinit(struct nhal_qspi_context *ctx);
+
+/**
+ * @brief Set QSPI configuration
+ * @param ctx Pointer to QSPI context structure
+ * @param config Pointer to configuration structure
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_BUSY Memory-mapped mode is enabled
+ */
+nhal_result_t nhal_qspi_set_config(struct nhal_qspi_context *ctx, struct nhal_qspi_config *config);
+
+/**
+ * @brief Get current QSPI configuration
+ * @param ctx Pointer to QSPI context structure
+ * @param config Pointer to configuration structure to fill
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_qspi_get_config(struct nhal_qspi_context *ctx, struct nhal_qspi_config *config);
+
+/**
+ * @brief Issue a command without data phase (blocking)
+ * @param ctx Pointer to QSPI context structure
+ * @param cmd Command to issue (data_width must be NHAL_QSPI_WIDTH_NONE)
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_UNSUPPORTED Phase width, DDR or dummy cycle count not supported by the controller
+ * @retval NHAL_ERR_BUSY Memory-mapped mode is enabled
+ */
+nhal_result_t nhal_qspi_command(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd);
+
+/**
+ * @brief Issue a command followed by a write data phase (blocking)
+ * @param ctx Pointer to QSPI context structure
+ * @param cmd Command to issue
+ * @param data Pointer to data to transmit
+ * @param len Number of bytes to transmit
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_UNSUPPORTED Phase width, DDR or dummy cycle count not supported by the controller
+ * @retval NHAL_ERR_BUSY Memory-mapped mode is enabled
+ */
+nhal_result_t nhal_qspi_write(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd,
+                              const uint8_t *data, size_t len);
+
+/**
+ * @brief Issue a command followed by a read data phase (blocking)
+ * @param ctx Pointer to QSPI context structure
+ * @param cmd Command to issue
+ * @param data Pointer to buffer for received data
+ * @param len Number of bytes to read
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_UNSUPPORTED Phase width, DDR or dummy cycle count not supported by the controller
+ * @retval NHAL_ERR_BUSY Memory-mapped mode is enabled
+ */
+nhal_result_t nhal_qspi_read(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd,
+                             uint8_t *data, size_t len);
+
+/**
+ * @brief Poll a status register until (status & mask) == match (blocking)
+ *
+ * Uses the controller's automatic polling when available, otherwise repeats
+ * the read command. Typically used to wait for the end of a program or erase.
+ *
+ * @param ctx Pointer to QSPI context structure
+ * @param cmd Status read command (1 data byte)
+ * @param mask Status bits to check
+ * @param match Expected value of the masked bits
+ * @param timeout_ms Maximum time to wait
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_TIMEOUT Status did not match within timeout_ms
+ */
+nhal_result_t nhal_qspi_poll_status(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd,
+                                    uint8_t mask, uint8_t match, uint32_t timeout_ms);
+
+/**
+ * @brief Enable memory-mapped mode
+ *
+ * The controller issues read_cmd (with the accessed address) on every access
+ * to the mapped window. Indirect operations return NHAL_ERR_BUSY until the
+ * mapping is disabled.
+ *
+ * @param ctx Pointer to QSPI context structure
+ * @param read_cmd Read command template (address field ignored)
+ * @param base Pointer to store the base address of the mapped window
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_UNSUPPORTED Controller has no memory-mapped mode
+ */
+nhal_result_t nhal_qspi_memory_map_enable(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *read_cmd,
+                                          const volatile uint8_t **base);
+
+/**
+ * @brief Disable memory-mapped mode and return to indirect mode
+ * @param ctx Pointer to QSPI context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_qspi_memory_map_disable(struct nhal_qspi_context *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_QSPI_H */
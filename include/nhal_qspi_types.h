@@ -0,0 +1,91 @@
+/**
+ * @file nhal_qspi_types.h
+ * @brief Defines common types and structures for the Quad/Octal SPI Hardware Abstraction Layer (HAL).
+ *
+ * This header file provides opaque types, enumerations, and structures used across
+ * the QSPI HAL API to describe multi-line memory commands (instruction, address,
+ * alternate bytes, dummy cycles and data phases) and memory-mapped operation.
+ */
+#ifndef NHAL_QSPI_TYPES_H
+#define NHAL_QSPI_TYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "nhal_common.h"
+#include "nhal_spi_types.h"
+
+/**
+ * @brief QSPI context structure (implementation-defined)
+ *
+ * Contains platform-specific QSPI/OSPI controller identification and runtime
+ * state, including whether the memory-mapped window is currently enabled.
+ *
+ * @par Example content:
+ * @code
+ * struct nhal_qspi_context {
+ *     // Controller identification: peripheral base address
+ *     QUADSPI_TypeDef *regs;
+ *     // Base address of the memory-mapped window
+ *     const volatile uint8_t *mmap_base;
+ *     bool mapped;
+ * };
+ * @endcode
+ */
+struct nhal_qspi_context;
+
+/**
+ * @brief Number of lines used by one command phase
+ *
+ * Commands are usually named after the widths of their instruction, address
+ * and data phases: 1-1-4 (quad output read), 1-4-4 (quad I/O read),
+ * 4-4-4 (QPI), 8-8-8 (octal).
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_QSPI_WIDTH_NONE = 0,   /**< Phase skipped */
+    NHAL_QSPI_WIDTH_1,          /**< Single line */
+    NHAL_QSPI_WIDTH_2,          /**< Dual lines */
+    NHAL_QSPI_WIDTH_4,          /**< Quad lines */
+    NHAL_QSPI_WIDTH_8,          /**< Octal lines */
+} nhal_qspi_width_t;
+
+/**
+ * @brief QSPI command flags
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_QSPI_CMD_DDR = 1,      /**< Address, alternate and data phases transfer on both clock edges. */
+} nhal_qspi_cmd_bit_flags_t;
+
+/**
+ * @brief QSPI memory command
+ *
+ * Phases are sent in order: instruction, address, alternate bytes (mode bits),
+ * dummy cycles, data. A phase with width NHAL_QSPI_WIDTH_NONE is skipped.
+ */
+typedef struct {
+    uint16_t instruction;                 /**< Instruction opcode. */
+    nhal_qspi_width_t instruction_width;
+    uint8_t instruction_bytes;            /**< 1, or 2 for octal memories (0: 1). */
+    uint32_t address;                     /**< Memory address (ignored in memory-mapped mode). */
+    nhal_qspi_width_t address_width;
+    uint8_t address_bytes;                /**< 1 to 4. */
+    uint32_t alternate;                   /**< Alternate bytes (mode bits), sent MSB first. */
+    nhal_qspi_width_t alternate_width;
+    uint8_t alternate_bytes;              /**< 0 to 4. */
+    uint8_t dummy_cycles;                 /**< Clock cycles between the address/alternate and data phases. */
+    nhal_qspi_width_t data_width;
+    uint16_t flags;                       /**< Combination of #nhal_qspi_cmd_bit_flags_t. */
+} nhal_qspi_command_t;
+
+/**
+ * @brief QSPI configuration structure
+ */
+struct nhal_qspi_config{
+    uint32_t clock_hz;                    /**< Maximum clock frequency, 0 for the implementation default. */
+    nhal_spi_mode_t mode;                 /**< NHAL_SPI_MODE_0 or NHAL_SPI_MODE_3. */
+    uint8_t memory_size_log2;             /**< Memory size as a power of two (e.g. 24 for 16 MiB). */
+    struct nhal_qspi_impl_config * impl_config;
+    nhal_config_id_t config_id;           /**< Identity token, NHAL_CONFIG_ID_NONE if unused. */
+};
+
+#endif /* NHAL_QSPI_TYPES_H */
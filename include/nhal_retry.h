@@ -0,0 +1,229 @@
+/**
+ * @file nhal_retry.h
+ * @brief Automatic retry policies and error statistics for NHAL operations.
+ *
+ * This header provides a small, header-only retry layer that can wrap any
+ * NHAL call returning nhal_result_t (I2C, SPI, UART, ...). Each bus context
+ * the application uses gets its own nhal_retry_context holding:
+ * - a policy: maximum attempts, exponential backoff with jitter, and which
+ *   result codes are worth retrying,
+ * - error counters the application can query to spot degraded buses.
+ *
+ * Backoff delays are performed with nhal_delay_microseconds().
+ *
+ * @par Example usage:
+ * @code
+ * static struct nhal_retry_context sensor_bus_retry;
+ *
+ * nhal_retry_policy_t policy = {
+ *     .max_attempts = 4,
+ *     .base_delay_us = 100,
+ *     .max_delay_us = 2000,
+ *     .jitter_percent = 50,
+ *     .retryable_mask = NHAL_RETRY_DEFAULT_MASK,
+ * };
+ * nhal_retry_init(&sensor_bus_retry, &policy, 0x1234);
+ *
+ * nhal_result_t result;
+ * NHAL_RETRY(&sensor_bus_retry, result,
+ *     nhal_i2c_master_write_read_reg(i2c_ctx, addr, &reg, 1, buf, sizeof(buf)));
+ *
+ * if (sensor_bus_retry.stats.consecutive_failures > 10) {
+ *     // Bus is degraded, reset it
+ * }
+ * @endcode
+ */
+#ifndef NHAL_RETRY_H
+#define NHAL_RETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nhal_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of distinct nhal_result_t values
+ */
+#define NHAL_RESULT_COUNT ((size_t)NHAL_ERR_OTHER + 1)
+
+/**
+ * @brief Bit of a result code inside a retryable result mask
+ */
+#define NHAL_RESULT_MASK(result) ((uint32_t)1u << (uint32_t)(result))
+
+/**
+ * @brief Result codes that usually clear up by themselves on a noisy bus
+ */
+#define NHAL_RETRY_DEFAULT_MASK (NHAL_RESULT_MASK(NHAL_ERR_TIMEOUT) | \
+                                 NHAL_RESULT_MASK(NHAL_ERR_NO_RESPONSE) | \
+                                 NHAL_RESULT_MASK(NHAL_ERR_BUSY) | \
+                                 NHAL_RESULT_MASK(NHAL_ERR_TRANSMISSION_ERROR))
+
+/**
+ * @brief Retry policy
+ */
+typedef struct {
+    uint8_t max_attempts;        /**< Total attempts including the first one (0 or 1: no retries). */
+    uint32_t base_delay_us;      /**< Delay before the first retry, doubled on every further retry. */
+    uint32_t max_delay_us;       /**< Upper bound for the backoff delay (0: no bound). */
+    uint8_t jitter_percent;      /**< Up to this percentage of each delay is randomly removed (0-100). */
+    uint32_t retryable_mask;     /**< Combination of NHAL_RESULT_MASK() values worth retrying. */
+} nhal_retry_policy_t;
+
+/**
+ * @brief Error statistics accumulated by a retry context
+ */
+struct nhal_error_stats{
+    uint32_t operations;                          /**< Wrapped operations performed. */
+    uint32_t attempts;                            /**< Underlying calls performed, retries included. */
+    uint32_t retries;                             /**< Attempts beyond the first one. */
+    uint32_t failures;                            /**< Operations that still failed after all attempts. */
+    uint32_t consecutive_failures;                /**< Failed operations since the last success. */
+    uint32_t result_counts[NHAL_RESULT_COUNT];    /**< Per attempt count of every result code. */
+};
+
+/**
+ * @brief Retry state for one bus/device context
+ */
+struct nhal_retry_context{
+    nhal_retry_policy_t policy;
+    struct nhal_error_stats stats;
+    uint32_t rng_state;          /**< Jitter generator state. */
+};
+
+/**
+ * @brief Initialize a retry context
+ * @param rctx Pointer to retry context
+ * @param policy Pointer to policy to copy into the context
+ * @param seed Jitter generator seed (any value)
+ */
+static inline void nhal_retry_init(struct nhal_retry_context *rctx, const nhal_retry_policy_t *policy, uint32_t seed)
+{
+    rctx->policy = *policy;
+    memset(&rctx->stats, 0, sizeof(rctx->stats));
+    rctx->rng_state = seed != 0 ? seed : 1;
+}
+
+/**
+ * @brief Reset the error statistics of a retry context
+ * @param rctx Pointer to retry context
+ */
+static inline void nhal_retry_reset_stats(struct nhal_retry_context *rctx)
+{
+    memset(&rctx->stats, 0, sizeof(rctx->stats));
+}
+
+/**
+ * @brief Check whether a result code is retryable under a policy
+ * @param policy Pointer to retry policy
+ * @param result Result code to check
+ * @return true if the operation should be attempted again
+ */
+static inline bool nhal_retry_is_retryable(const nhal_retry_policy_t *policy, nhal_result_t result)
+{
+    return result != NHAL_OK &&
+           (size_t)result < NHAL_RESULT_COUNT &&
+           (policy->retryable_mask & NHAL_RESULT_MASK(result)) != 0;
+}
+
+/**
+ * @brief Compute the backoff delay before a given retry
+ * @param rctx Pointer to retry context
+ * @param retry Retry number, starting at 1
+ * @return Delay in microseconds
+ */
+static inline uint32_t nhal_retry_backoff_us(struct nhal_retry_context *rctx, uint8_t retry)
+{
+    uint64_t delay = rctx->policy.base_delay_us;
+    uint8_t i;
+
+    for (i = 1; i < retry && delay <= UINT32_MAX; i++) {
+        delay <<= 1;
+    }
+    if (rctx->policy.max_delay_us != 0 && delay > rctx->policy.max_delay_us) {
+        delay = rctx->policy.max_delay_us;
+    }
+    if (delay > UINT32_MAX) {
+        delay = UINT32_MAX;
+    }
+
+    if (rctx->policy.jitter_percent != 0 && delay != 0) {
+        uint64_t jitter_span = delay * (rctx->policy.jitter_percent > 100 ? 100 : rctx->policy.jitter_percent) / 100;
+        rctx->rng_state ^= rctx->rng_state << 13;
+        rctx->rng_state ^= rctx->rng_state >> 17;
+        rctx->rng_state ^= rctx->rng_state << 5;
+        delay -= rctx->rng_state % (jitter_span + 1);
+    }
+    return (uint32_t)delay;
+}
+
+/**
+ * @brief Record an attempt and decide whether to retry it
+ *
+ * Updates the statistics with the attempt result and, if another attempt is
+ * due, performs the backoff delay before returning.
+ *
+ * @param rctx Pointer to retry context
+ * @param result Result of the attempt just performed
+ * @param attempt Pointer to the attempt counter of the current operation (start at 0)
+ * @return true if the operation must be attempted again
+ */
+static inline bool nhal_retry_next_attempt(struct nhal_retry_context *rctx, nhal_result_t result, uint8_t *attempt)
+{
+    struct nhal_error_stats *stats = &rctx->stats;
+
+    (*attempt)++;
+    stats->attempts++;
+    if (*attempt > 1) {
+        stats->retries++;
+    }
+    if ((size_t)result < NHAL_RESULT_COUNT) {
+        stats->result_counts[result]++;
+    }
+
+    if (result != NHAL_OK &&
+        *attempt < rctx->policy.max_attempts &&
+        nhal_retry_is_retryable(&rctx->policy, result)) {
+        uint32_t delay_us = nhal_retry_backoff_us(rctx, *attempt);
+        if (delay_us != 0) {
+            nhal_delay_microseconds(delay_us);
+        }
+        return true;
+    }
+
+    stats->operations++;
+    if (result == NHAL_OK) {
+        stats->consecutive_failures = 0;
+    } else {
+        stats->failures++;
+        stats->consecutive_failures++;
+    }
+    return false;
+}
+
+/**
+ * @brief Perform an NHAL call under the policy of a retry context
+ *
+ * @param rctx Pointer to retry context
+ * @param result nhal_result_t lvalue receiving the final result
+ * @param call Expression performing the NHAL call, evaluated once per attempt
+ */
+#define NHAL_RETRY(rctx, result, call)                                        \
+    do {                                                                      \
+        uint8_t nhal_retry_attempt_ = 0;                                      \
+        do {                                                                  \
+            (result) = (call);                                                \
+        } while (nhal_retry_next_attempt((rctx), (result), &nhal_retry_attempt_)); \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_RETRY_H */
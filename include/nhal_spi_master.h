@@ -42,6 +42,18 @@ nhal_result_t nhal_spi_master_deinit(struct nhal_spi_context * ctx);
 
 /**
  * @brief Set SPI master configuration
+ *
+ * If the identity token of config->config_id (see NHAL_CONFIG_ID_TOKEN) is not
+ * NHAL_CONFIG_ID_NONE and, together with config->impl_config, matches the
+ * configuration currently applied, implementations may return NHAL_OK
+ * without reprogramming the hardware (see nhal_config_id_t).
+ *
+ * For configurations flagged NHAL_CONFIG_ID_PREVALIDATED, validation of the
+ * portable fields may be skipped; impl_config is always validated.
+ *
+ * Implementations that cannot provide the requested word size, or any SCK
+ * frequency not above a non-zero clock_hz, return NHAL_ERR_UNSUPPORTED.
+ *
  * @param ctx Pointer to SPI context structure
  * @param config Pointer to configuration structure
  * @return NHAL_OK on success, error code otherwise
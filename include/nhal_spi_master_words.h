@@ -0,0 +1,111 @@
+/**
+ * @file nhal_spi_master_words.h
+ * @brief Hardware Abstraction Layer for typed 16/32-bit SPI master transfers.
+ *
+ * Peripherals with 16 or 32-bit words (ADCs, DACs, displays) are configured
+ * with NHAL_SPI_WORD_SIZE_16 or NHAL_SPI_WORD_SIZE_32, and streamed with the
+ * typed functions below. Words are native-endian in memory and shifted out in
+ * the configured bit order as whole words, so the hardware frame size does the
+ * repacking: no byte swapping by the CPU before or after the transfer.
+ *
+ * All operations block until completion or timeout.
+ *
+ * @par Example usage:
+ * @code
+ * struct nhal_spi_config adc_config = {
+ *     .mode = NHAL_SPI_MODE_1,
+ *     .clock_hz = 20000000,
+ *     .word_size = NHAL_SPI_WORD_SIZE_16,
+ * };
+ * uint16_t samples[256];
+ *
+ * nhal_spi_master_set_config(spi_ctx, &adc_config);
+ * nhal_spi_master_read_words16(spi_ctx, samples, 256);   // samples[] ready to use
+ * @endcode
+ */
+#ifndef NHAL_SPI_MASTER_WORDS_H
+#define NHAL_SPI_MASTER_WORDS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_spi_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Write 16-bit words to SPI device (blocking)
+ * @param ctx Pointer to SPI context structure (configured with NHAL_SPI_WORD_SIZE_16)
+ * @param data Pointer to words to transmit
+ * @param count Number of words to transmit
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_CONFIG Current word size is not 16 bits
+ */
+nhal_result_t nhal_spi_master_write_words16(struct nhal_spi_context *ctx, const uint16_t *data, size_t count);
+
+/**
+ * @brief Read 16-bit words from SPI device (blocking)
+ * @param ctx Pointer to SPI context structure (configured with NHAL_SPI_WORD_SIZE_16)
+ * @param data Pointer to buffer for received words
+ * @param count Number of words to read
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_CONFIG Current word size is not 16 bits
+ */
+nhal_result_t nhal_spi_master_read_words16(struct nhal_spi_context *ctx, uint16_t *data, size_t count);
+
+/**
+ * @brief Simultaneous write and read of 16-bit words on SPI device (blocking)
+ * @param ctx Pointer to SPI context structure (configured with NHAL_SPI_WORD_SIZE_16)
+ * @param tx_data Pointer to words to transmit
+ * @param rx_data Pointer to buffer for received words
+ * @param count Number of words to exchange
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_CONFIG Current word size is not 16 bits
+ */
+nhal_result_t nhal_spi_master_exchange_words16(struct nhal_spi_context *ctx, const uint16_t *tx_data, uint16_t *rx_data, size_t count);
+
+/**
+ * @brief Write 32-bit words to SPI device (blocking)
+ * @param ctx Pointer to SPI context structure (configured with NHAL_SPI_WORD_SIZE_32)
+ * @param data Pointer to words to transmit
+ * @param count Number of words to transmit
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_CONFIG Current word size is not 32 bits
+ */
+nhal_result_t nhal_spi_master_write_words32(struct nhal_spi_context *ctx, const uint32_t *data, size_t count);
+
+/**
+ * @brief Read 32-bit words from SPI device (blocking)
+ * @param ctx Pointer to SPI context structure (configured with NHAL_SPI_WORD_SIZE_32)
+ * @param data Pointer to buffer for received words
+ * @param count Number of words to read
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_CONFIG Current word size is not 32 bits
+ */
+nhal_result_t nhal_spi_master_read_words32(struct nhal_spi_context *ctx, uint32_t *data, size_t count);
+
+/**
+ * @brief Simultaneous write and read of 32-bit words on SPI device (blocking)
+ * @param ctx Pointer to SPI context structure (configured with NHAL_SPI_WORD_SIZE_32)
+ * @param tx_data Pointer to words to transmit
+ * @param rx_data Pointer to buffer for received words
+ * @param count Number of words to exchange
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_CONFIG Current word size is not 32 bits
+ */
+nhal_result_t nhal_spi_master_exchange_words32(struct nhal_spi_context *ctx, const uint32_t *tx_data, uint32_t *rx_data, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_SPI_MASTER_WORDS_H */
@@ -0,0 +1,581 @@
+/**
+ * @file nhal_spi_nor.h
+ * @brief Block device layer for SPI NOR flash and EEPROM memories.
+ *
+ * This layer sits on top of the SPI master interface and turns byte-granular
+ * reads and writes into efficient memory commands:
+ * - Writes go to a page-sized write-back buffer and are coalesced into a
+ *   single page program when the page is full, when a write lands elsewhere,
+ *   or on nhal_spi_nor_sync(). Small records written one after the other cost
+ *   one write-enable/program/busy-poll cycle per page instead of per record.
+ * - Small reads are served from an LRU cache of fixed-size lines. A miss that
+ *   continues the previous read also fetches the following lines (readahead)
+ *   with the same read command. Reads covering whole lines bypass the cache.
+ *
+ * All buffers are provided by the application, nothing is allocated.
+ * Commands use the standard 0x03 read, 0x02 page program, 0x05 status,
+ * 0x06 write enable, 0x20 erase and 0xC7 chip erase opcodes, shared by NOR
+ * flash and SPI EEPROMs. Command and data phases are issued with
+ * nhal_spi_master_write()/nhal_spi_master_write_read(), which must keep chip
+ * select asserted for the whole call.
+ *
+ * The layer is generic: exactly one translation unit defines
+ * NHAL_SPI_NOR_IMPLEMENTATION before including this header to emit it.
+ * All operations block until completion or timeout.
+ *
+ * @par Example usage:
+ * @code
+ * static uint8_t write_buffer[NHAL_SPI_NOR_WRITE_BUFFER_SIZE(256)];
+ * static uint8_t cache_buffer[8 * 64];
+ * static struct nhal_spi_nor_cache_line cache_lines[8];
+ * static const struct nhal_spi_nor_config flash_config = {
+ *     .size = 8 * 1024 * 1024, .page_size = 256, .erase_size = 4096, .address_bytes = 3,
+ *     .busy_timeout_ms = 500,
+ *     .write_buffer = write_buffer,
+ *     .cache_buffer = cache_buffer, .cache_lines = cache_lines,
+ *     .num_cache_lines = 8, .cache_line_size = 64, .readahead_lines = 3,
+ * };
+ * static struct nhal_spi_nor flash;
+ *
+ * nhal_spi_nor_init(&flash, spi_ctx, &flash_config);
+ * nhal_spi_nor_program(&flash, log_offset, (const uint8_t *)&record, sizeof(record));
+ * nhal_spi_nor_sync(&flash);
+ * @endcode
+ */
+#ifndef NHAL_SPI_NOR_H
+#define NHAL_SPI_NOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nhal_common.h"
+#include "nhal_spi_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Room reserved in front of the write buffer for the program command
+ */
+#define NHAL_SPI_NOR_CMD_HEADER_MAX 5
+
+/**
+ * @brief Size of the write buffer for a given page size
+ */
+#define NHAL_SPI_NOR_WRITE_BUFFER_SIZE(page_size) ((size_t)(page_size) + NHAL_SPI_NOR_CMD_HEADER_MAX)
+
+/**
+ * @brief Interval between two status polls while the memory is busy
+ */
+#ifndef NHAL_SPI_NOR_POLL_INTERVAL_US
+#define NHAL_SPI_NOR_POLL_INTERVAL_US 20
+#endif
+
+/**
+ * @brief Read cache line descriptor
+ */
+struct nhal_spi_nor_cache_line{
+    uint32_t address;            /**< Memory address of the first byte of the line. */
+    uint32_t last_use;           /**< LRU stamp, 0 if the line holds no data. */
+};
+
+/**
+ * @brief Memory geometry and buffers
+ */
+struct nhal_spi_nor_config{
+    uint32_t size;                               /**< Memory size in bytes. */
+    uint16_t page_size;                          /**< Program page size in bytes. */
+    uint32_t erase_size;                         /**< Erase unit (0x20 command) in bytes, 0 for EEPROMs. */
+    uint8_t address_bytes;                       /**< 2, 3 or 4. */
+    uint32_t busy_timeout_ms;                    /**< Longest program/erase duration. */
+    uint8_t *write_buffer;                       /**< NHAL_SPI_NOR_WRITE_BUFFER_SIZE(page_size) bytes. */
+    uint8_t *cache_buffer;                       /**< num_cache_lines * cache_line_size bytes, NULL for no read cache. */
+    struct nhal_spi_nor_cache_line *cache_lines; /**< num_cache_lines descriptors. */
+    uint16_t num_cache_lines;
+    uint16_t cache_line_size;                    /**< Bytes per cache line, power of two. */
+    uint8_t readahead_lines;                     /**< Lines fetched past a sequential miss (< num_cache_lines). */
+};
+
+/**
+ * @brief Block device counters
+ */
+struct nhal_spi_nor_stats{
+    uint32_t page_programs;      /**< Program commands issued. */
+    uint32_t erases;             /**< Erase commands issued. */
+    uint32_t bus_reads;          /**< Read commands issued. */
+    uint32_t cache_hits;
+    uint32_t cache_misses;
+    uint32_t readahead_lines;    /**< Lines fetched ahead of a sequential miss. */
+    uint64_t bytes_written;      /**< Bytes passed to nhal_spi_nor_program(). */
+    uint64_t bytes_programmed;   /**< Bytes sent in program commands. */
+};
+
+/**
+ * @brief Block device state
+ */
+struct nhal_spi_nor{
+    struct nhal_spi_context *spi;
+    struct nhal_spi_nor_config config;
+    uint32_t pending_page;       /**< Page held by the write buffer. */
+    uint16_t dirty_start;        /**< Dirty range of the write buffer, empty when start == end. */
+    uint16_t dirty_end;
+    uint32_t use_counter;
+    uint32_t next_read_address;  /**< Address following the last read, for sequential detection. */
+    struct nhal_spi_nor_stats stats;
+};
+
+/**
+ * @brief Initialize a block device
+ * @param dev Pointer to block device state
+ * @param spi SPI context, already initialized and configured for the memory
+ * @param config Geometry and buffers (copied)
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_CONFIG Inconsistent geometry or missing buffers
+ */
+nhal_result_t nhal_spi_nor_init(struct nhal_spi_nor *dev, struct nhal_spi_context *spi,
+                                const struct nhal_spi_nor_config *config);
+
+/**
+ * @brief Read memory content, including data still in the write buffer
+ * @param dev Pointer to block device state
+ * @param address Memory address
+ * @param data Pointer to buffer for read data
+ * @param len Number of bytes to read
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_spi_nor_read(struct nhal_spi_nor *dev, uint32_t address, uint8_t *data, size_t len);
+
+/**
+ * @brief Write memory content through the write-back buffer
+ *
+ * On NOR flash the target range must have been erased: like the memory
+ * itself, programming can only clear bits.
+ *
+ * @param dev Pointer to block device state
+ * @param address Memory address
+ * @param data Pointer to data to write
+ * @param len Number of bytes to write
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_spi_nor_program(struct nhal_spi_nor *dev, uint32_t address, const uint8_t *data, size_t len);
+
+/**
+ * @brief Erase a range of erase units (all bits set)
+ * @param dev Pointer to block device state
+ * @param address Memory address, aligned to the erase unit
+ * @param len Number of bytes, multiple of the erase unit
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_UNSUPPORTED Memory without erase command (EEPROM)
+ */
+nhal_result_t nhal_spi_nor_erase(struct nhal_spi_nor *dev, uint32_t address, size_t len);
+
+/**
+ * @brief Program the pending write buffer content, if any
+ *
+ * If the program command cannot be sent, the pending data stays in the
+ * write buffer and a later sync retries it.
+ *
+ * @param dev Pointer to block device state
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_spi_nor_sync(struct nhal_spi_nor *dev);
+
+#ifdef NHAL_SPI_NOR_IMPLEMENTATION
+
+static size_t nhal_spi_nor_header_(const struct nhal_spi_nor *dev, uint8_t opcode, uint32_t address, uint8_t *header)
+{
+    uint8_t i;
+
+    header[0] = opcode;
+    for (i = 0; i < dev->config.address_bytes; i++) {
+        header[1 + i] = (uint8_t)(address >> (8 * (dev->config.address_bytes - 1 - i)));
+    }
+    return 1u + dev->config.address_bytes;
+}
+
+static nhal_result_t nhal_spi_nor_wait_ready_(struct nhal_spi_nor *dev)
+{
+    const uint8_t read_status = 0x05;
+    uint32_t start = nhal_get_timestamp_milliseconds();
+
+    for (;;) {
+        uint8_t status = 0;
+        nhal_result_t result = nhal_spi_master_write_read(dev->spi, &read_status, 1, &status, 1);
+        if (result != NHAL_OK) {
+            return result;
+        }
+        if ((status & 0x01) == 0) {
+            return NHAL_OK;
+        }
+        if (nhal_get_timestamp_milliseconds() - start > dev->config.busy_timeout_ms) {
+            return NHAL_ERR_TIMEOUT;
+        }
+        nhal_delay_microseconds(NHAL_SPI_NOR_POLL_INTERVAL_US);
+    }
+}
+
+static nhal_result_t nhal_spi_nor_write_enable_(struct nhal_spi_nor *dev)
+{
+    const uint8_t write_enable = 0x06;
+    return nhal_spi_master_write(dev->spi, &write_enable, 1);
+}
+
+static void nhal_spi_nor_invalidate_(struct nhal_spi_nor *dev, uint32_t address, size_t len)
+{
+    uint16_t i;
+
+    for (i = 0; i < dev->config.num_cache_lines; i++) {
+        struct nhal_spi_nor_cache_line *line = &dev->config.cache_lines[i];
+        if (line->last_use != 0 &&
+            line->address < address + len &&
+            address < line->address + dev->config.cache_line_size) {
+            line->last_use = 0;
+        }
+    }
+}
+
+// Make room for count LRU stamps. A stamp of 0 marks an empty line, so
+// rather than let the counter wrap, the cache is emptied once every 2^32 uses
+static void nhal_spi_nor_reserve_uses_(struct nhal_spi_nor *dev, uint16_t count)
+{
+    if (dev->use_counter > UINT32_MAX - count) {
+        nhal_spi_nor_invalidate_(dev, 0, dev->config.size);
+        dev->use_counter = 0;
+    }
+}
+
+static nhal_result_t nhal_spi_nor_bus_read_(struct nhal_spi_nor *dev, uint32_t address, uint8_t *data, size_t len)
+{
+    uint8_t header[NHAL_SPI_NOR_CMD_HEADER_MAX];
+    size_t header_len = nhal_spi_nor_header_(dev, 0x03, address, header);
+
+    dev->stats.bus_reads++;
+    return nhal_spi_master_write_read(dev->spi, header, header_len, data, len);
+}
+
+nhal_result_t nhal_spi_nor_init(struct nhal_spi_nor *dev, struct nhal_spi_context *spi,
+                                const struct nhal_spi_nor_config *config)
+{
+    if (dev == NULL || spi == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (config->size == 0 || config->page_size == 0 || config->write_buffer == NULL ||
+        config->address_bytes < 2 || config->address_bytes > 4 ||
+        (config->erase_size != 0 && config->erase_size % config->page_size != 0) ||
+        (config->cache_buffer != NULL &&
+         (config->cache_lines == NULL || config->num_cache_lines == 0 ||
+          config->cache_line_size == 0 || (config->cache_line_size & (config->cache_line_size - 1)) != 0 ||
+          config->readahead_lines >= config->num_cache_lines))) {
+        return NHAL_ERR_INVALID_CONFIG;
+    }
+
+    memset(dev, 0, sizeof(*dev));
+    dev->spi = spi;
+    dev->config = *config;
+    if (dev->config.cache_buffer == NULL) {
+        dev->config.num_cache_lines = 0;
+    }
+    // No read yet: the first one is not sequential, even at address 0
+    dev->next_read_address = UINT32_MAX;
+    memset(dev->config.write_buffer, 0xFF, NHAL_SPI_NOR_WRITE_BUFFER_SIZE(dev->config.page_size));
+    nhal_spi_nor_invalidate_(dev, 0, dev->config.size);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_spi_nor_sync(struct nhal_spi_nor *dev)
+{
+    uint8_t header[NHAL_SPI_NOR_CMD_HEADER_MAX];
+    uint8_t *frame;
+    uint32_t address;
+    size_t header_len;
+    size_t len;
+    nhal_result_t result;
+
+    if (dev == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (dev->dirty_start == dev->dirty_end) {
+        return NHAL_OK;
+    }
+
+    result = nhal_spi_nor_write_enable_(dev);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    // The command header goes right in front of the dirty data, over bytes
+    // of the buffer that are not part of the program
+    address = dev->pending_page + dev->dirty_start;
+    len = (size_t)(dev->dirty_end - dev->dirty_start);
+    header_len = nhal_spi_nor_header_(dev, 0x02, address, header);
+    frame = dev->config.write_buffer + NHAL_SPI_NOR_CMD_HEADER_MAX + dev->dirty_start - header_len;
+    memcpy(frame, header, header_len);
+
+    result = nhal_spi_master_write(dev->spi, frame, header_len + len);
+    nhal_spi_nor_invalidate_(dev, address, len);
+    if (result != NHAL_OK) {
+        // Keep the pending data for a retry; only the header bytes, which are
+        // clean (erased) page bytes or reserved room, go back to 0xFF
+        memset(frame, 0xFF, header_len);
+        return result;
+    }
+    memset(dev->config.write_buffer, 0xFF, NHAL_SPI_NOR_WRITE_BUFFER_SIZE(dev->config.page_size));
+    dev->dirty_start = 0;
+    dev->dirty_end = 0;
+
+    dev->stats.page_programs++;
+    dev->stats.bytes_programmed += len;
+    return nhal_spi_nor_wait_ready_(dev);
+}
+
+nhal_result_t nhal_spi_nor_program(struct nhal_spi_nor *dev, uint32_t address, const uint8_t *data, size_t len)
+{
+    if (dev == NULL || (data == NULL && len != 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (address > dev->config.size || len > dev->config.size - address) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    dev->stats.bytes_written += len;
+    while (len > 0) {
+        uint16_t page_size = dev->config.page_size;
+        uint32_t page = address - address % page_size;
+        uint16_t start = (uint16_t)(address % page_size);
+        uint16_t end = (uint16_t)(len < (size_t)(page_size - start) ? start + len : page_size);
+        uint8_t *buffer = dev->config.write_buffer + NHAL_SPI_NOR_CMD_HEADER_MAX;
+        uint16_t i;
+
+        // Coalesce only contiguous or overlapping writes to the same page
+        if (dev->dirty_start != dev->dirty_end &&
+            (page != dev->pending_page || start > dev->dirty_end || end < dev->dirty_start)) {
+            nhal_result_t result = nhal_spi_nor_sync(dev);
+            if (result != NHAL_OK) {
+                return result;
+            }
+        }
+        if (dev->dirty_start == dev->dirty_end) {
+            dev->pending_page = page;
+            dev->dirty_start = start;
+            dev->dirty_end = end;
+        } else {
+            dev->dirty_start = start < dev->dirty_start ? start : dev->dirty_start;
+            dev->dirty_end = end > dev->dirty_end ? end : dev->dirty_end;
+        }
+
+        for (i = start; i < end; i++) {
+            // NOR cells can only be cleared, EEPROM bytes are replaced
+            buffer[i] = dev->config.erase_size != 0 ? (uint8_t)(buffer[i] & *data) : *data;
+            data++;
+        }
+        address += (uint32_t)(end - start);
+        len -= (size_t)(end - start);
+
+        if (dev->dirty_start == 0 && dev->dirty_end == page_size) {
+            nhal_result_t result = nhal_spi_nor_sync(dev);
+            if (result != NHAL_OK) {
+                return result;
+            }
+        }
+    }
+    return NHAL_OK;
+}
+
+static nhal_result_t nhal_spi_nor_fill_(struct nhal_spi_nor *dev, uint32_t line_address, bool sequential, uint16_t *slot)
+{
+    uint16_t line_size = dev->config.cache_line_size;
+    uint16_t count = 1;
+    uint16_t best = 0;
+    uint32_t best_age = UINT32_MAX;
+    uint16_t i;
+    uint16_t j;
+    nhal_result_t result;
+
+    if (sequential) {
+        count = (uint16_t)(1 + dev->config.readahead_lines);
+        while (count > 1 && line_address + (uint32_t)count * line_size > dev->config.size) {
+            count--;
+        }
+    }
+
+    // Stale copies of the fetched lines are dropped first so their slots are reused.
+    // Victims: the run of adjacent slots whose most recent use is the oldest,
+    // so the line and its readahead are fetched with a single read command
+    nhal_spi_nor_invalidate_(dev, line_address, (size_t)count * line_size);
+    for (i = 0; i + count <= dev->config.num_cache_lines; i++) {
+        uint32_t age = 0;
+        for (j = i; j < i + count; j++) {
+            if (dev->config.cache_lines[j].last_use > age) {
+                age = dev->config.cache_lines[j].last_use;
+            }
+        }
+        if (age < best_age) {
+            best_age = age;
+            best = i;
+        }
+    }
+
+    for (j = best; j < best + count; j++) {
+        dev->config.cache_lines[j].last_use = 0;
+    }
+    result = nhal_spi_nor_bus_read_(dev, line_address,
+                                    dev->config.cache_buffer + (size_t)best * line_size,
+                                    (size_t)count * line_size);
+    if (result != NHAL_OK) {
+        return result;
+    }
+    nhal_spi_nor_reserve_uses_(dev, count);
+    for (j = 0; j < count; j++) {
+        dev->config.cache_lines[best + j].address = line_address + (uint32_t)j * line_size;
+        dev->config.cache_lines[best + j].last_use = ++dev->use_counter;
+    }
+    dev->stats.readahead_lines += (uint32_t)(count - 1);
+    *slot = best;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_spi_nor_read(struct nhal_spi_nor *dev, uint32_t address, uint8_t *data, size_t len)
+{
+    bool sequential;
+    nhal_result_t result;
+
+    if (dev == NULL || (data == NULL && len != 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (address > dev->config.size || len > dev->config.size - address) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    // Pending data must reach the memory before it can be read back
+    if (dev->dirty_start != dev->dirty_end &&
+        dev->pending_page + dev->dirty_start < address + len &&
+        address < dev->pending_page + dev->dirty_end) {
+        result = nhal_spi_nor_sync(dev);
+        if (result != NHAL_OK) {
+            return result;
+        }
+    }
+
+    if (dev->config.num_cache_lines == 0) {
+        return len != 0 ? nhal_spi_nor_bus_read_(dev, address, data, len) : NHAL_OK;
+    }
+
+    sequential = (address == dev->next_read_address);
+    dev->next_read_address = address + (uint32_t)len;
+
+    while (len > 0) {
+        uint16_t line_size = dev->config.cache_line_size;
+        uint32_t offset = address & (uint32_t)(line_size - 1);
+        uint32_t line_address = address - offset;
+        size_t chunk = len < (size_t)(line_size - offset) ? len : (size_t)(line_size - offset);
+        uint16_t slot = dev->config.num_cache_lines;
+        uint16_t i;
+
+        // Whole lines are read straight into the caller's buffer
+        if (offset == 0 && len >= line_size) {
+            size_t direct = len - len % line_size;
+            result = nhal_spi_nor_bus_read_(dev, address, data, direct);
+            if (result != NHAL_OK) {
+                return result;
+            }
+            address += (uint32_t)direct;
+            data += direct;
+            len -= direct;
+            continue;
+        }
+
+        for (i = 0; i < dev->config.num_cache_lines; i++) {
+            if (dev->config.cache_lines[i].last_use != 0 && dev->config.cache_lines[i].address == line_address) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < dev->config.num_cache_lines) {
+            dev->stats.cache_hits++;
+            nhal_spi_nor_reserve_uses_(dev, 1);
+            dev->config.cache_lines[slot].last_use = ++dev->use_counter;
+        } else {
+            dev->stats.cache_misses++;
+            result = nhal_spi_nor_fill_(dev, line_address, sequential, &slot);
+            if (result != NHAL_OK) {
+                return result;
+            }
+        }
+
+        memcpy(data, dev->config.cache_buffer + (size_t)slot * line_size + offset, chunk);
+        address += (uint32_t)chunk;
+        data += chunk;
+        len -= chunk;
+        sequential = true;
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_spi_nor_erase(struct nhal_spi_nor *dev, uint32_t address, size_t len)
+{
+    uint8_t header[NHAL_SPI_NOR_CMD_HEADER_MAX];
+    uint32_t erase_size;
+    nhal_result_t result;
+
+    if (dev == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    erase_size = dev->config.erase_size;
+    if (erase_size == 0) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    if (address % erase_size != 0 || len % erase_size != 0 ||
+        address > dev->config.size || len > dev->config.size - address) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    result = nhal_spi_nor_sync(dev);
+    if (result != NHAL_OK) {
+        return result;
+    }
+    nhal_spi_nor_invalidate_(dev, address, len);
+
+    if (address == 0 && len == dev->config.size) {
+        header[0] = 0xC7;
+        result = nhal_spi_nor_write_enable_(dev);
+        if (result == NHAL_OK) {
+            result = nhal_spi_master_write(dev->spi, header, 1);
+        }
+        if (result == NHAL_OK) {
+            dev->stats.erases++;
+            result = nhal_spi_nor_wait_ready_(dev);
+        }
+        return result;
+    }
+
+    while (len > 0) {
+        size_t header_len = nhal_spi_nor_header_(dev, 0x20, address, header);
+        result = nhal_spi_nor_write_enable_(dev);
+        if (result == NHAL_OK) {
+            result = nhal_spi_master_write(dev->spi, header, header_len);
+        }
+        if (result == NHAL_OK) {
+            dev->stats.erases++;
+            result = nhal_spi_nor_wait_ready_(dev);
+        }
+        if (result != NHAL_OK) {
+            return result;
+        }
+        address += erase_size;
+        len -= erase_size;
+    }
+    return NHAL_OK;
+}
+
+#endif /* NHAL_SPI_NOR_IMPLEMENTATION */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_SPI_NOR_H */
@@ -0,0 +1,307 @@
+/**
+ * @file nhal_spi_ops.h
+ * @brief Optional ops-table dispatch for the SPI Hardware Abstraction Layer (HAL).
+ *
+ * By default every nhal_spi function is a single global symbol provided by
+ * one implementation at link time. Defining NHAL_SPI_DISPATCH for the whole
+ * build switches to dispatch mode, where each context carries a pointer to
+ * the function table of its backend, so several SPI master implementations
+ * can coexist in one binary (e.g.: hw_spi and bitbang_spi).
+ * Consumers keep calling the regular C API.
+ *
+ * In dispatch mode:
+ * - struct nhal_spi_context is defined here, holding the ops table and the
+ *   backend's own state pointer.
+ * - Backends implement the functions of struct nhal_spi_master_ops under their own
+ *   names. Ops receive the generic context and retrieve their state from
+ *   ctx->backend_ctx.
+ * - Exactly one translation unit defines NHAL_DISPATCH_IMPLEMENTATION
+ *   before including this header to emit the dispatching nhal_spi functions.
+ *   Missing (NULL) ops return NHAL_ERR_UNSUPPORTED.
+ *
+ * Each dispatched call costs one extra indirect call. Builds that do not
+ * define NHAL_SPI_DISPATCH are unaffected.
+ *
+ * @par Example usage:
+ * @code
+ * static const struct nhal_spi_master_ops hw_spi_ops = { .init = hw_spi_init, ... };
+ * static struct hw_spi_state hw_spi_state;
+ *
+ * struct nhal_spi_context ctx;
+ * nhal_spi_context_bind(&ctx, &hw_spi_ops, &hw_spi_state);
+ * nhal_spi_master_init(&ctx);
+ * @endcode
+ */
+#ifndef NHAL_SPI_OPS_H
+#define NHAL_SPI_OPS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_spi_master.h"
+#include "nhal_spi_plan.h"
+#include "nhal_spi_config_image.h"
+#include "nhal_spi_master_words.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief SPI backend function table
+ *
+ * Each member has the signature of the matching nhal_spi_master_* function.
+ */
+struct nhal_spi_master_ops{
+    nhal_result_t (*init)(struct nhal_spi_context *ctx);
+    nhal_result_t (*deinit)(struct nhal_spi_context *ctx);
+    nhal_result_t (*set_config)(struct nhal_spi_context *ctx, struct nhal_spi_config *config);
+    nhal_result_t (*get_config)(struct nhal_spi_context *ctx, struct nhal_spi_config *config);
+    nhal_result_t (*write)(struct nhal_spi_context *ctx, const uint8_t *data, size_t len);
+    nhal_result_t (*read)(struct nhal_spi_context *ctx, uint8_t *data, size_t len);
+    nhal_result_t (*write_read)(struct nhal_spi_context *ctx, const uint8_t *tx_data, size_t tx_len, uint8_t *rx_data, size_t rx_len);
+    nhal_result_t (*plan_prepare)(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan, const struct nhal_spi_config *config, const nhal_spi_segment_t *segments, size_t num_segments);
+    nhal_result_t (*plan_execute)(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan);
+    nhal_result_t (*plan_release)(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan);
+    nhal_result_t (*config_image_build)(struct nhal_spi_context *ctx, const struct nhal_spi_config *config, struct nhal_spi_config_image *image);
+    nhal_result_t (*config_image_apply)(struct nhal_spi_context *ctx, const struct nhal_spi_config_image *image);
+    nhal_result_t (*write_words16)(struct nhal_spi_context *ctx, const uint16_t *data, size_t count);
+    nhal_result_t (*read_words16)(struct nhal_spi_context *ctx, uint16_t *data, size_t count);
+    nhal_result_t (*exchange_words16)(struct nhal_spi_context *ctx, const uint16_t *tx_data, uint16_t *rx_data, size_t count);
+    nhal_result_t (*write_words32)(struct nhal_spi_context *ctx, const uint32_t *data, size_t count);
+    nhal_result_t (*read_words32)(struct nhal_spi_context *ctx, uint32_t *data, size_t count);
+    nhal_result_t (*exchange_words32)(struct nhal_spi_context *ctx, const uint32_t *tx_data, uint32_t *rx_data, size_t count);
+};
+
+#ifdef NHAL_SPI_DISPATCH
+
+/**
+ * @brief SPI context structure in dispatch mode
+ */
+struct nhal_spi_context{
+    const struct nhal_spi_master_ops *ops;     /**< Function table of the backend serving this context. */
+    void *backend_ctx;                         /**< Backend-specific state. */
+};
+
+/**
+ * @brief Bind a context to a backend
+ * @param ctx Pointer to SPI context structure
+ * @param ops Backend function table
+ * @param backend_ctx Backend-specific state
+ */
+static inline void nhal_spi_context_bind(struct nhal_spi_context *ctx, const struct nhal_spi_master_ops *ops, void *backend_ctx)
+{
+    ctx->ops = ops;
+    ctx->backend_ctx = backend_ctx;
+}
+
+#ifdef NHAL_DISPATCH_IMPLEMENTATION
+
+nhal_result_t nhal_spi_master_init(struct nhal_spi_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->init == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->init(ctx);
+}
+
+nhal_result_t nhal_spi_master_deinit(struct nhal_spi_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->deinit == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->deinit(ctx);
+}
+
+nhal_result_t nhal_spi_master_set_config(struct nhal_spi_context *ctx, struct nhal_spi_config *config)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->set_config == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->set_config(ctx, config);
+}
+
+nhal_result_t nhal_spi_master_get_config(struct nhal_spi_context *ctx, struct nhal_spi_config *config)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->get_config == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->get_config(ctx, config);
+}
+
+nhal_result_t nhal_spi_master_write(struct nhal_spi_context *ctx, const uint8_t *data, size_t len)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->write == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->write(ctx, data, len);
+}
+
+nhal_result_t nhal_spi_master_read(struct nhal_spi_context *ctx, uint8_t *data, size_t len)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->read == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->read(ctx, data, len);
+}
+
+nhal_result_t nhal_spi_master_write_read(struct nhal_spi_context *ctx, const uint8_t *tx_data, size_t tx_len, uint8_t *rx_data, size_t rx_len)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->write_read == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->write_read(ctx, tx_data, tx_len, rx_data, rx_len);
+}
+
+nhal_result_t nhal_spi_master_plan_prepare(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan, const struct nhal_spi_config *config, const nhal_spi_segment_t *segments, size_t num_segments)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->plan_prepare == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->plan_prepare(ctx, plan, config, segments, num_segments);
+}
+
+nhal_result_t nhal_spi_master_plan_execute(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->plan_execute == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->plan_execute(ctx, plan);
+}
+
+nhal_result_t nhal_spi_master_plan_release(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->plan_release == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->plan_release(ctx, plan);
+}
+
+nhal_result_t nhal_spi_master_config_image_build(struct nhal_spi_context *ctx, const struct nhal_spi_config *config, struct nhal_spi_config_image *image)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->config_image_build == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->config_image_build(ctx, config, image);
+}
+
+nhal_result_t nhal_spi_master_config_image_apply(struct nhal_spi_context *ctx, const struct nhal_spi_config_image *image)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->config_image_apply == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->config_image_apply(ctx, image);
+}
+
+nhal_result_t nhal_spi_master_write_words16(struct nhal_spi_context *ctx, const uint16_t *data, size_t count)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->write_words16 == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->write_words16(ctx, data, count);
+}
+
+nhal_result_t nhal_spi_master_read_words16(struct nhal_spi_context *ctx, uint16_t *data, size_t count)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->read_words16 == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->read_words16(ctx, data, count);
+}
+
+nhal_result_t nhal_spi_master_exchange_words16(struct nhal_spi_context *ctx, const uint16_t *tx_data, uint16_t *rx_data, size_t count)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->exchange_words16 == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->exchange_words16(ctx, tx_data, rx_data, count);
+}
+
+nhal_result_t nhal_spi_master_write_words32(struct nhal_spi_context *ctx, const uint32_t *data, size_t count)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->write_words32 == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->write_words32(ctx, data, count);
+}
+
+nhal_result_t nhal_spi_master_read_words32(struct nhal_spi_context *ctx, uint32_t *data, size_t count)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->read_words32 == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->read_words32(ctx, data, count);
+}
+
+nhal_result_t nhal_spi_master_exchange_words32(struct nhal_spi_context *ctx, const uint32_t *tx_data, uint32_t *rx_data, size_t count)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->exchange_words32 == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->exchange_words32(ctx, tx_data, rx_data, count);
+}
+
+#endif /* NHAL_DISPATCH_IMPLEMENTATION */
+
+#endif /* NHAL_SPI_DISPATCH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_SPI_OPS_H */
@@ -0,0 +1,95 @@
+/**
+ * @file nhal_spi_plan.h
+ * @brief Hardware Abstraction Layer for precompiled, reusable SPI transaction plans.
+ *
+ * A transaction plan describes a fixed sequence of SPI segments (e.g.: command,
+ * address, pixel data) bound to one configuration. The plan is validated and
+ * prepared ONCE, then executed repeatedly with only the segment data pointers
+ * changing between executions. Execution skips argument/state validation and
+ * configuration lookup, so per-transaction overhead approaches the raw
+ * transfer time.
+ *
+ * All operations block until completion or timeout.
+ *
+ * @par Example usage:
+ * @code
+ * static const uint8_t ramwr = 0x2C;
+ * nhal_spi_segment_t segments[] = {
+ *     { &ramwr, NULL, 1, NHAL_SPI_SEGMENT_RELEASE_CS },
+ *     { NULL,   NULL, FRAME_SIZE, 0 },
+ * };
+ * struct nhal_spi_plan plan;
+ * nhal_spi_master_plan_prepare(spi_ctx, &plan, &display_config, segments, 2);
+ *
+ * for (;;) {
+ *     segments[1].tx_data = next_frame();
+ *     nhal_spi_master_plan_execute(spi_ctx, &plan);
+ * }
+ * @endcode
+ */
+#ifndef NHAL_SPI_PLAN_H
+#define NHAL_SPI_PLAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_spi_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Validate and prepare an SPI transaction plan
+ *
+ * Performs all argument, state and configuration validation for the plan.
+ * The plan keeps a reference to the segments array, which must remain valid
+ * until the plan is released. Segment lengths and flags must not change after
+ * this call; data pointers may change between executions.
+ *
+ * @param ctx Pointer to SPI context structure (configured)
+ * @param plan Pointer to plan structure to prepare
+ * @param config Configuration the plan executes with
+ * @param segments Array of segments forming the transaction
+ * @param num_segments Number of segments in the array
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_CONFIG Configuration not supported
+ * @retval NHAL_ERR_OUT_OF_MEMORY Not enough resources (e.g.: DMA descriptors) for the plan
+ */
+nhal_result_t nhal_spi_master_plan_prepare(
+    struct nhal_spi_context *ctx,
+    struct nhal_spi_plan *plan,
+    const struct nhal_spi_config *config,
+    const nhal_spi_segment_t *segments,
+    size_t num_segments
+);
+
+/**
+ * @brief Execute a prepared SPI transaction plan (blocking)
+ *
+ * Applies the plan's configuration if the bus is not already using it, then
+ * runs every segment in order with minimal validation.
+ *
+ * @param ctx Pointer to SPI context structure the plan was prepared for
+ * @param plan Pointer to prepared plan
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_NOT_CONFIGURED Plan not prepared or already released
+ */
+nhal_result_t nhal_spi_master_plan_execute(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan);
+
+/**
+ * @brief Release resources held by a prepared plan
+ * @param ctx Pointer to SPI context structure the plan was prepared for
+ * @param plan Pointer to prepared plan
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_spi_master_plan_release(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_SPI_PLAN_H */
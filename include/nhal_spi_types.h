@@ -34,7 +34,7 @@ struct nhal_spi_context;
 /**
  * @brief SPI duplex mode configuration
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_SPI_FULL_DUPLEX = 0, /**< Most platforms use FULL by default, but they also expose HALF */
     NHAL_SPI_HALF_DUPLEX,
 } nhal_spi_duplex_t;
@@ -42,7 +42,7 @@ typedef enum {
 /**
  * @brief SPI clock polarity and phase mode configuration
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_SPI_MODE_0 = 0,    /**< CPOL=0, CPHA=0: Clock idle low, data sampled on rising edge */
     NHAL_SPI_MODE_1,        /**< CPOL=0, CPHA=1: Clock idle low, data sampled on falling edge */
     NHAL_SPI_MODE_2,        /**< CPOL=1, CPHA=0: Clock idle high, data sampled on falling edge */
@@ -52,19 +52,95 @@ typedef enum {
 /**
  * @brief SPI bit transmission order configuration
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_SPI_BIT_ORDER_MSB_FIRST = 0,    /**< Most significant bit first */
     NHAL_SPI_BIT_ORDER_LSB_FIRST,        /**< Least significant bit first */
 } nhal_spi_bit_order_t;
 
+/**
+ * @brief SPI word (frame) size configuration
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_SPI_WORD_SIZE_8 = 0,    /**< 8-bit words */
+    NHAL_SPI_WORD_SIZE_16,       /**< 16-bit words */
+    NHAL_SPI_WORD_SIZE_32,       /**< 32-bit words */
+} nhal_spi_word_size_t;
+
 /**
  * @brief SPI configuration structure
+ *
+ * Fields after config_id default to the implementation's own settings when
+ * left zero, so existing initializers keep their behavior. The structure
+ * must therefore be zero-initialized: an uninitialized local leaves them,
+ * and config_id, indeterminate.
  */
 struct nhal_spi_config{
     nhal_spi_duplex_t duplex;
     nhal_spi_mode_t mode;
     nhal_spi_bit_order_t bit_order;
     struct nhal_spi_impl_config * impl_config;
+    nhal_config_id_t config_id;     /**< Identity token, NHAL_CONFIG_ID_NONE if unused. */
+    uint32_t clock_hz;              /**< Maximum SCK frequency, the closest lower one available is used. 0 for the implementation default. */
+    nhal_spi_word_size_t word_size; /**< Word size on the wire. Byte-stream transfers use buffers of native-endian
+                                     *   words of this size; their length must be a multiple of it. */
 };
 
+/**
+ * @brief SPI configuration register image (implementation-defined)
+ *
+ * Precomputed hardware register values for one configuration, built once
+ * per device and applied with a few register writes when switching devices.
+ *
+ * @par Example content:
+ * @code
+ * struct nhal_spi_config_image {
+ *     nhal_config_id_t config_id;
+ *     uint32_t cr1;
+ *     uint32_t cr2;
+ * };
+ * @endcode
+ */
+struct nhal_spi_config_image;
+
+/**
+ * @brief SPI transaction plan structure (implementation-defined)
+ *
+ * Holds everything an implementation precomputes when a plan is prepared:
+ * validated segment layout, chip select sequencing, hardware register
+ * images for the bound configuration, DMA descriptors, etc.
+ * Allocated by the application, filled by nhal_spi_master_plan_prepare().
+ *
+ * @par Example content:
+ * @code
+ * struct nhal_spi_plan {
+ *     const nhal_spi_segment_t *segments;
+ *     size_t num_segments;
+ *     uint32_t cr1_image;
+ *     dma_descriptor_t descriptors[4];
+ * };
+ * @endcode
+ */
+struct nhal_spi_plan;
+
+/**
+ * @brief SPI plan segment flags
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_SPI_SEGMENT_RELEASE_CS = 1,    /**< Deassert chip select after this segment and assert it again
+                                         *   before the next one. CS is always released after the last segment. */
+} nhal_spi_segment_bit_flags_t;
+
+/**
+ * @brief SPI transaction plan segment
+ *
+ * Describes one contiguous transfer within a plan. Lengths and flags are
+ * frozen when the plan is prepared, data pointers are read on every execution.
+ */
+typedef struct {
+    const uint8_t *tx_data;     /**< Data to transmit, NULL to clock out dummy bytes. */
+    uint8_t *rx_data;           /**< Buffer for received data, NULL to discard it. */
+    size_t len;                 /**< Number of bytes transferred in this segment. */
+    uint16_t flags;             /**< Combination of #nhal_spi_segment_bit_flags_t. */
+} nhal_spi_segment_t;
+
 #endif /* NHAL_SPI_TYPES_H */
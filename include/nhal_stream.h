@@ -0,0 +1,145 @@
+/**
+ * @file nhal_stream.h
+ * @brief Header for the Hardware Abstraction Layer (HAL) continuous streaming module.
+ *
+ * This module provides an interface for gap-free continuous acquisition from
+ * streaming sources (ADC, I2S microphones, SPI ADCs clocked by a timer). The
+ * hardware fills a ring of equally sized blocks in the background, usually
+ * with a circular DMA; with 2 blocks this is classic ping-pong buffering on
+ * the half/full transfer interrupts, more blocks give the consumer more slack.
+ *
+ * Completed blocks are handed to the consumer either through the completion
+ * callback or with nhal_stream_acquire(), and must be given back with
+ * nhal_stream_release(). When the hardware reaches a block the consumer still
+ * owns, that block's worth of samples is dropped and accounted for in the
+ * statistics instead of corrupting data being processed.
+ *
+ * @par Example usage:
+ * @code
+ * static uint8_t ring[4 * 256 * sizeof(int16_t)];
+ * struct nhal_stream_config config = {
+ *     .sample_rate_hz = 16000, .sample_size = sizeof(int16_t),
+ *     .buffer = ring, .buffer_size = sizeof(ring), .num_blocks = 4,
+ * };
+ * nhal_stream_set_config(mic_ctx, &config);
+ * nhal_stream_start(mic_ctx);
+ *
+ * for (;;) {
+ *     nhal_stream_block_t block;
+ *     if (nhal_stream_acquire(mic_ctx, &block, 100) == NHAL_OK) {
+ *         process_audio((const int16_t *)block.data, block.len / sizeof(int16_t));
+ *         nhal_stream_release(mic_ctx, &block);
+ *     }
+ * }
+ * @endcode
+ */
+#ifndef NHAL_STREAM_H
+#define NHAL_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_stream_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize stream context
+ * @param ctx Pointer to stream context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_stream_init(struct nhal_stream_context *ctx);
+
+/**
+ * @brief Deinitialize stream context
+ * @param ctx Pointer to stream context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_stream_deinit(struct nhal_stream_context *ctx);
+
+/**
+ * @brief Set stream configuration
+ *
+ * If the identity token of config->config_id (see NHAL_CONFIG_ID_TOKEN) is
+ * not NHAL_CONFIG_ID_NONE and, together with config->impl_config, matches
+ * the configuration currently applied, implementations may return NHAL_OK
+ * without reprogramming the hardware (see nhal_config_id_t).
+ *
+ * @param ctx Pointer to stream context structure
+ * @param config Pointer to configuration structure
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_BUSY Stream is running, stop it first
+ * @retval NHAL_ERR_UNSUPPORTED Sample rate, sample size or block layout not supported by hardware
+ */
+nhal_result_t nhal_stream_set_config(struct nhal_stream_context *ctx, struct nhal_stream_config *config);
+
+/**
+ * @brief Get current stream configuration
+ * @param ctx Pointer to stream context structure
+ * @param config Pointer to configuration structure to fill
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_stream_get_config(struct nhal_stream_context *ctx, struct nhal_stream_config *config);
+
+/**
+ * @brief Start continuous acquisition into the ring
+ *
+ * Resets the statistics and the ring: every block is owned by the hardware.
+ *
+ * @param ctx Pointer to stream context structure
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_ALREADY_STARTED Stream already running
+ */
+nhal_result_t nhal_stream_start(struct nhal_stream_context *ctx);
+
+/**
+ * @brief Stop continuous acquisition
+ * @param ctx Pointer to stream context structure
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_stream_stop(struct nhal_stream_context *ctx);
+
+/**
+ * @brief Take ownership of the oldest completed block
+ *
+ * Alternative to the completion callback for consumers running in thread
+ * context. Blocks are delivered in completion order.
+ *
+ * @param ctx Pointer to stream context structure
+ * @param block Pointer to store the block descriptor
+ * @param timeout_ms Maximum time to wait for a block (0: do not wait)
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_TIMEOUT No block completed within timeout_ms
+ * @retval NHAL_ERR_NOT_STARTED Stream not running
+ */
+nhal_result_t nhal_stream_acquire(struct nhal_stream_context *ctx, nhal_stream_block_t *block, uint32_t timeout_ms);
+
+/**
+ * @brief Give a block back to the hardware
+ * @param ctx Pointer to stream context structure
+ * @param block Block descriptor received from the callback or nhal_stream_acquire()
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_ARG Block not owned by the consumer
+ */
+nhal_result_t nhal_stream_release(struct nhal_stream_context *ctx, const nhal_stream_block_t *block);
+
+/**
+ * @brief Get stream statistics
+ * @param ctx Pointer to stream context structure
+ * @param stats Pointer to statistics structure to fill
+ * @return NHAL_OK on success, error code otherwise
+ */
+nhal_result_t nhal_stream_get_stats(struct nhal_stream_context *ctx, struct nhal_stream_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_STREAM_H */
@@ -0,0 +1,94 @@
+/**
+ * @file nhal_stream_types.h
+ * @brief Defines the types and structures used by the continuous streaming HAL module.
+ *
+ * This header provides definitions for the stream context, the buffer ring
+ * configuration, the block descriptors handed to consumers and the stream
+ * statistics.
+ */
+#ifndef NHAL_STREAM_TYPES_H
+#define NHAL_STREAM_TYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "nhal_common.h"
+
+/**
+ * @brief Stream context structure (implementation-defined)
+ *
+ * Contains platform-specific identification of the streaming source (ADC,
+ * I2S, SPI + timer...) and its runtime state, typically a circular DMA
+ * channel and the ownership state of every block of the ring.
+ *
+ * @par Example content:
+ * @code
+ * struct nhal_stream_context {
+ *     // Source identification
+ *     I2S_TypeDef *i2s;
+ *     DMA_Stream_TypeDef *dma;
+ *     // Ring state: block owned by the consumer, next block to hand out
+ *     uint32_t released_mask;
+ *     uint16_t next_block;
+ * };
+ * @endcode
+ */
+struct nhal_stream_context;
+
+/**
+ * @brief Completed block of samples
+ */
+typedef struct {
+    const uint8_t *data;             /**< First sample of the block. */
+    size_t len;                      /**< Block size in bytes. */
+    uint16_t index;                  /**< Position in the ring (with 2 blocks: 0 = half, 1 = full transfer). */
+    uint32_t sequence;               /**< Block sequence number since start, gaps reveal dropped blocks. */
+    uint64_t timestamp_ticks;        /**< Completion time (nhal_get_timestamp_ticks()), 0 if not available. */
+} nhal_stream_block_t;
+
+/**
+ * @brief Stream block completion callback function type
+ *
+ * Called when a block is complete. The consumer owns the block until it
+ * calls nhal_stream_release().
+ *
+ * @param ctx Stream context
+ * @param block Completed block
+ * @param user_data User data pointer provided in the configuration
+ *
+ * @note This executes in interrupt context - keep it fast and minimal
+ */
+typedef void (*nhal_stream_callback_t)(struct nhal_stream_context *ctx, const nhal_stream_block_t *block, void *user_data);
+
+/**
+ * @brief Stream configuration structure
+ *
+ * The buffer is split into num_blocks blocks of equal size, filled in turn.
+ * With 2 blocks this is ping-pong operation driven by the half and full
+ * transfer interrupts of a circular DMA.
+ *
+ * Must be zero-initialized so config_id is never indeterminate.
+ */
+struct nhal_stream_config{
+    uint32_t sample_rate_hz;         /**< Samples per second. */
+    uint8_t sample_size;             /**< Bytes per sample (all channels of one frame). */
+    uint8_t *buffer;                 /**< Ring memory, DMA-capable. */
+    size_t buffer_size;              /**< Ring size in bytes, multiple of num_blocks * sample_size. */
+    uint16_t num_blocks;             /**< Number of blocks in the ring (2 or more). */
+    nhal_stream_callback_t callback; /**< Block completion callback, NULL to use nhal_stream_acquire() only. */
+    void *user_data;                 /**< Passed to the callback. */
+    struct nhal_stream_impl_config * impl_config;
+    nhal_config_id_t config_id;      /**< Identity token, NHAL_CONFIG_ID_NONE if unused. */
+};
+
+/**
+ * @brief Stream counters since the stream was started
+ */
+struct nhal_stream_stats{
+    uint32_t blocks_completed;       /**< Blocks filled by the hardware. */
+    uint32_t blocks_dropped;         /**< Blocks lost because the next block was still owned by the consumer. */
+    uint64_t samples_dropped;        /**< Samples lost with the dropped blocks. */
+    uint16_t max_blocks_owned;       /**< Highest number of blocks owned by the consumer at once. */
+};
+
+#endif /* NHAL_STREAM_TYPES_H */
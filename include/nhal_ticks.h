@@ -0,0 +1,139 @@
+/**
+ * @file nhal_ticks.h
+ * @brief High-resolution monotonic tick counter for the NEXUS Hardware Abstraction Layer (HAL).
+ *
+ * This header defines an OPTIONAL timing interface that complements the
+ * microsecond/millisecond timestamps of nhal_common.h. It exposes a raw,
+ * free-running monotonic counter (cycle counter, TSC, CNTVCT, DWT CYCCNT,
+ * hardware timer...) together with its frequency, so that short events such
+ * as single bus transactions can be profiled with sub-microsecond resolution.
+ *
+ * Reading the counter is expected to be as cheap as the platform allows
+ * (ideally a single register/instruction read, no system call). Any
+ * calibration the platform needs is performed ONCE by the implementation,
+ * and the result is published through nhal_get_tick_calibration(). Tick to
+ * nanosecond conversion is then done inline with a multiply and a shift.
+ *
+ * @par Example usage:
+ * @code
+ * struct nhal_tick_calibration cal;
+ * nhal_get_tick_calibration(&cal);
+ *
+ * uint64_t start = nhal_get_timestamp_ticks();
+ * nhal_spi_master_write(spi_ctx, cmd, sizeof(cmd));
+ * uint64_t elapsed_ns = nhal_ticks_to_nanoseconds(&cal, nhal_get_timestamp_ticks() - start);
+ * @endcode
+ */
+#ifndef NHAL_TICKS_H
+#define NHAL_TICKS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "nhal_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Tick counter calibration data
+ *
+ * Describes how raw ticks map to nanoseconds:
+ * `ns = (ticks * mult) >> shift`. The values are fixed for the lifetime
+ * of the program, so consumers may fetch them once and cache them.
+ */
+struct nhal_tick_calibration{
+    uint64_t frequency_hz;  /**< Tick counter frequency in Hz (ticks per second). */
+    uint32_t mult;          /**< Fixed-point multiplier for tick to nanosecond conversion. */
+    uint8_t shift;          /**< Fixed-point shift for tick to nanosecond conversion (0-32). */
+};
+
+/**
+ * @brief Get raw monotonic tick counter value
+ *
+ * Returns the current value of the platform's high-resolution monotonic
+ * counter. The counter never goes backwards and is consistent across all
+ * cores/threads of the system. Unsigned arithmetic handles rollover
+ * correctly for interval calculations.
+ *
+ * @note Must be callable from interrupt context.
+ *
+ * @return Current tick counter value
+ */
+uint64_t nhal_get_timestamp_ticks(void);
+
+/**
+ * @brief Get tick counter calibration data
+ *
+ * Implementations that need to measure the counter frequency at runtime
+ * (e.g.: an invariant TSC with no advertised frequency) must perform that
+ * calibration only once, on first use or at startup, and return the cached
+ * result on every subsequent call.
+ *
+ * @param cal Pointer to calibration structure to fill
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_ARG cal is NULL
+ * @retval NHAL_ERR_HW_FAILURE Counter could not be calibrated
+ */
+nhal_result_t nhal_get_tick_calibration(struct nhal_tick_calibration *cal);
+
+/**
+ * @brief Fill calibration data from a known counter frequency
+ *
+ * Helper for implementations: computes the largest precision multiplier
+ * and shift pair for the given frequency.
+ *
+ * @param cal Pointer to calibration structure to fill
+ * @param frequency_hz Tick counter frequency in Hz
+ * @return NHAL_OK on success, NHAL_ERR_INVALID_ARG on NULL/zero frequency
+ */
+static inline nhal_result_t nhal_tick_calibration_from_frequency(
+    struct nhal_tick_calibration *cal,
+    uint64_t frequency_hz
+){
+    uint8_t shift;
+    uint64_t mult = 0;
+
+    if (cal == NULL || frequency_hz == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    for (shift = 32; shift > 0; shift--) {
+        mult = (UINT64_C(1000000000) << shift) / frequency_hz;
+        if (mult <= UINT32_MAX) {
+            break;
+        }
+    }
+    if (shift == 0) {
+        mult = UINT64_C(1000000000) / frequency_hz;
+    }
+
+    cal->frequency_hz = frequency_hz;
+    cal->mult = (uint32_t)mult;
+    cal->shift = shift;
+    return NHAL_OK;
+}
+
+/**
+ * @brief Convert a tick count into nanoseconds
+ *
+ * The conversion is split into a high and a low part so that it does not
+ * overflow for intervals up to the full 64-bit nanosecond range.
+ *
+ * @param cal Pointer to calibration data obtained from nhal_get_tick_calibration()
+ * @param ticks Number of ticks (typically a difference of two timestamps)
+ * @return Equivalent duration in nanoseconds
+ */
+static inline uint64_t nhal_ticks_to_nanoseconds(const struct nhal_tick_calibration *cal, uint64_t ticks)
+{
+    uint64_t low_mask = (UINT64_C(1) << cal->shift) - 1;
+    return ((ticks >> cal->shift) * cal->mult) + (((ticks & low_mask) * cal->mult) >> cal->shift);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_TICKS_H */
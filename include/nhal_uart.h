@@ -41,6 +41,18 @@ nhal_result_t nhal_uart_deinit(struct nhal_uart_context * ctx);
 
 /**
  * @brief Set UART configuration
+ *
+ * If the identity token of cfg->config_id (see NHAL_CONFIG_ID_TOKEN) is not
+ * NHAL_CONFIG_ID_NONE and, together with cfg->impl_config, matches the
+ * configuration currently applied, implementations may return NHAL_OK
+ * without reprogramming the hardware (see nhal_config_id_t).
+ *
+ * For configurations flagged NHAL_CONFIG_ID_PREVALIDATED, validation of the
+ * portable fields may be skipped; impl_config is always validated.
+ *
+ * Implementations without the requested flow control mode, or unable to honor
+ * a non-zero rx_fifo_threshold/rx_idle_timeout_bits, return NHAL_ERR_UNSUPPORTED.
+ *
  * @param ctx Pointer to UART context structure
  * @param cfg Pointer to configuration structure
  * @return NHAL_OK on success, error code otherwise
@@ -0,0 +1,185 @@
+/**
+ * @file nhal_uart_ops.h
+ * @brief Optional ops-table dispatch for the UART Hardware Abstraction Layer (HAL).
+ *
+ * By default every nhal_uart function is a single global symbol provided by
+ * one implementation at link time. Defining NHAL_UART_DISPATCH for the whole
+ * build switches to dispatch mode, where each context carries a pointer to
+ * the function table of its backend, so several UART implementations
+ * can coexist in one binary (e.g.: hw_uart and usb_cdc).
+ * Consumers keep calling the regular C API.
+ *
+ * In dispatch mode:
+ * - struct nhal_uart_context is defined here, holding the ops table and the
+ *   backend's own state pointer.
+ * - Backends implement the functions of struct nhal_uart_ops under their own
+ *   names. Ops receive the generic context and retrieve their state from
+ *   ctx->backend_ctx.
+ * - Exactly one translation unit defines NHAL_DISPATCH_IMPLEMENTATION
+ *   before including this header to emit the dispatching nhal_uart functions.
+ *   Missing (NULL) ops return NHAL_ERR_UNSUPPORTED.
+ *
+ * Each dispatched call costs one extra indirect call. Builds that do not
+ * define NHAL_UART_DISPATCH are unaffected.
+ *
+ * @par Example usage:
+ * @code
+ * static const struct nhal_uart_ops hw_uart_ops = { .init = hw_uart_init, ... };
+ * static struct hw_uart_state hw_uart_state;
+ *
+ * struct nhal_uart_context ctx;
+ * nhal_uart_context_bind(&ctx, &hw_uart_ops, &hw_uart_state);
+ * nhal_uart_init(&ctx);
+ * @endcode
+ */
+#ifndef NHAL_UART_OPS_H
+#define NHAL_UART_OPS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_uart.h"
+#include "nhal_uart_rs485.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief UART backend function table
+ *
+ * Each member has the signature of the matching nhal_uart_* function.
+ */
+struct nhal_uart_ops{
+    nhal_result_t (*init)(struct nhal_uart_context *ctx);
+    nhal_result_t (*deinit)(struct nhal_uart_context *ctx);
+    nhal_result_t (*set_config)(struct nhal_uart_context *ctx, struct nhal_uart_config *cfg);
+    nhal_result_t (*get_config)(struct nhal_uart_context *ctx, struct nhal_uart_config *cfg);
+    nhal_result_t (*write)(struct nhal_uart_context *ctx, const uint8_t *data, size_t len);
+    nhal_result_t (*read)(struct nhal_uart_context *ctx, uint8_t *data, size_t len);
+    nhal_result_t (*rs485_set_config)(struct nhal_uart_context *ctx, const struct nhal_uart_rs485_config *rs485);
+    nhal_result_t (*rs485_transaction)(struct nhal_uart_context *ctx, const uint8_t *request, size_t request_len, uint8_t *response, size_t response_max, size_t *response_len, uint32_t timeout_ms);
+};
+
+#ifdef NHAL_UART_DISPATCH
+
+/**
+ * @brief UART context structure in dispatch mode
+ */
+struct nhal_uart_context{
+    const struct nhal_uart_ops *ops;     /**< Function table of the backend serving this context. */
+    void *backend_ctx;                   /**< Backend-specific state. */
+};
+
+/**
+ * @brief Bind a context to a backend
+ * @param ctx Pointer to UART context structure
+ * @param ops Backend function table
+ * @param backend_ctx Backend-specific state
+ */
+static inline void nhal_uart_context_bind(struct nhal_uart_context *ctx, const struct nhal_uart_ops *ops, void *backend_ctx)
+{
+    ctx->ops = ops;
+    ctx->backend_ctx = backend_ctx;
+}
+
+#ifdef NHAL_DISPATCH_IMPLEMENTATION
+
+nhal_result_t nhal_uart_init(struct nhal_uart_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->init == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->init(ctx);
+}
+
+nhal_result_t nhal_uart_deinit(struct nhal_uart_context *ctx)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->deinit == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->deinit(ctx);
+}
+
+nhal_result_t nhal_uart_set_config(struct nhal_uart_context *ctx, struct nhal_uart_config *cfg)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->set_config == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->set_config(ctx, cfg);
+}
+
+nhal_result_t nhal_uart_get_config(struct nhal_uart_context *ctx, struct nhal_uart_config *cfg)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->get_config == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->get_config(ctx, cfg);
+}
+
+nhal_result_t nhal_uart_write(struct nhal_uart_context *ctx, const uint8_t *data, size_t len)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->write == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->write(ctx, data, len);
+}
+
+nhal_result_t nhal_uart_read(struct nhal_uart_context *ctx, uint8_t *data, size_t len)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->read == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->read(ctx, data, len);
+}
+
+nhal_result_t nhal_uart_rs485_set_config(struct nhal_uart_context *ctx, const struct nhal_uart_rs485_config *rs485)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->rs485_set_config == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->rs485_set_config(ctx, rs485);
+}
+
+nhal_result_t nhal_uart_rs485_transaction(struct nhal_uart_context *ctx, const uint8_t *request, size_t request_len, uint8_t *response, size_t response_max, size_t *response_len, uint32_t timeout_ms)
+{
+    if (ctx == NULL || ctx->ops == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->ops->rs485_transaction == NULL) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    return ctx->ops->rs485_transaction(ctx, request, request_len, response, response_max, response_len, timeout_ms);
+}
+
+#endif /* NHAL_DISPATCH_IMPLEMENTATION */
+
+#endif /* NHAL_UART_DISPATCH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_UART_OPS_H */
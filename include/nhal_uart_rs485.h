@@ -0,0 +1,132 @@
+/**
+ * @file nhal_uart_rs485.h
+ * @brief Hardware Abstraction Layer for RS-485 half-duplex UART operation.
+ *
+ * In RS-485 mode the implementation drives the transceiver driver-enable (DE)
+ * line itself: DE is asserted just before the first start bit and released
+ * exactly when the last stop bit has left the shift register (transmission
+ * complete, not FIFO empty). Frames are delimited by bus silence, and the
+ * implementation never starts a frame before the inter-frame silence has
+ * elapsed since the end of the previous one (3.5 character times by default,
+ * as required by Modbus RTU).
+ *
+ * nhal_uart_rs485_transaction() performs a whole request/response exchange,
+ * so master polling loops need no manual DE toggling or safety delays.
+ *
+ * All operations block until completion or timeout.
+ *
+ * @par Example usage:
+ * @code
+ * struct nhal_uart_rs485_config rs485 = { .de_active_high = true };
+ * nhal_uart_rs485_set_config(uart_ctx, &rs485);
+ *
+ * for (;;) {
+ *     size_t response_len;
+ *     nhal_result_t result = nhal_uart_rs485_transaction(uart_ctx, request, request_len,
+ *                                                        response, sizeof(response), &response_len, 100);
+ *     if (result == NHAL_ERR_NO_RESPONSE) {
+ *         // Slave did not answer within 100 ms
+ *     }
+ * }
+ * @endcode
+ */
+#ifndef NHAL_UART_RS485_H
+#define NHAL_UART_RS485_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nhal_common.h"
+#include "nhal_uart_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of bit times one character takes on the line
+ * @param cfg Pointer to UART configuration
+ * @return Start bit + data bits + parity bit + stop bits
+ */
+static inline uint32_t nhal_uart_char_bits(const struct nhal_uart_config *cfg)
+{
+    return 1u +
+           (cfg->data_bits == NHAL_UART_DATA_BITS_7 ? 7u : 8u) +
+           (cfg->parity == NHAL_UART_PARITY_NONE ? 0u : 1u) +
+           (cfg->stop_bits == NHAL_UART_STOP_BITS_2 ? 2u : 1u);
+}
+
+/**
+ * @brief Convert a number of bit times to microseconds, rounded up
+ * @param cfg Pointer to UART configuration
+ * @param bits Number of bit times
+ * @return Duration in microseconds
+ */
+static inline uint32_t nhal_uart_bits_to_us(const struct nhal_uart_config *cfg, uint32_t bits)
+{
+    if (cfg->baudrate == 0) {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)bits * 1000000u + cfg->baudrate - 1) / cfg->baudrate);
+}
+
+/**
+ * @brief Inter-frame silence, in bit times, applied under an RS-485 configuration
+ * @param cfg Pointer to UART configuration
+ * @param rs485 Pointer to RS-485 configuration
+ * @return inter_frame_bits, or 3.5 character times (rounded up) when it is 0
+ */
+static inline uint32_t nhal_uart_rs485_inter_frame_bits(const struct nhal_uart_config *cfg,
+                                                        const struct nhal_uart_rs485_config *rs485)
+{
+    if (rs485->inter_frame_bits != 0) {
+        return rs485->inter_frame_bits;
+    }
+    return (nhal_uart_char_bits(cfg) * 7u + 1u) / 2u;
+}
+
+/**
+ * @brief Enable RS-485 half-duplex mode
+ *
+ * Switches the UART flow control to NHAL_UART_FLOW_CONTROL_RS485_DE and
+ * applies the driver-enable polarity and turnaround timings. The UART must
+ * already be configured with nhal_uart_set_config().
+ *
+ * @param ctx Pointer to UART context structure
+ * @param rs485 Pointer to RS-485 configuration
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_UNSUPPORTED No hardware or driver-managed DE line available
+ */
+nhal_result_t nhal_uart_rs485_set_config(struct nhal_uart_context *ctx, const struct nhal_uart_rs485_config *rs485);
+
+/**
+ * @brief Perform an RS-485 request/response exchange (blocking)
+ *
+ * Waits for the inter-frame silence since the last frame on the bus, sends
+ * the request with DE asserted, releases DE at the end of the last stop bit,
+ * then receives the response until the inter-frame silence is detected.
+ *
+ * @param ctx Pointer to UART context structure (RS-485 mode enabled)
+ * @param request Request frame to transmit
+ * @param request_len Request length in bytes
+ * @param response Buffer for the response frame (may be NULL for broadcast requests)
+ * @param response_max Size of the response buffer
+ * @param response_len Pointer to store the response length (may be NULL)
+ * @param timeout_ms Maximum wait for the first response byte
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_NO_RESPONSE No response byte received within timeout_ms
+ * @retval NHAL_ERR_BUFFER_OVERFLOW Response longer than response_max (truncated)
+ * @retval NHAL_ERR_TRANSMISSION_ERROR Framing, parity or overrun error while receiving
+ */
+nhal_result_t nhal_uart_rs485_transaction(struct nhal_uart_context *ctx,
+                                          const uint8_t *request, size_t request_len,
+                                          uint8_t *response, size_t response_max,
+                                          size_t *response_len, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_UART_RS485_H */
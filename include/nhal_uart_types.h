@@ -14,6 +14,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "nhal_common.h"
 
@@ -38,7 +39,7 @@ struct nhal_uart_context;
 /**
  * @brief UART parity bit configuration
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_UART_PARITY_NONE,   /**< No parity bit is used. */
     NHAL_UART_PARITY_EVEN,   /**< Parity bit is set such that the total number of '1' bits is even. */
     NHAL_UART_PARITY_ODD,    /**< Parity bit is set such that the total number of '1' bits is odd. */
@@ -47,7 +48,7 @@ typedef enum {
 /**
  * @brief UART stop bits configuration
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_UART_STOP_BITS_1,       /**< 1 stop bit is used. */
     NHAL_UART_STOP_BITS_2,       /**< 2 stop bits are used. */
 } nhal_uart_stop_bits_t;
@@ -55,13 +56,27 @@ typedef enum {
 /**
  * @brief UART data bits configuration
  */
-typedef enum {
+typedef enum NHAL_ENUM_PACKED {
     NHAL_UART_DATA_BITS_7,       /**< 7 data bits are used. */
     NHAL_UART_DATA_BITS_8,       /**< 8 data bits are used. */
 } nhal_uart_data_bits_t;
 
+/**
+ * @brief UART flow control configuration
+ */
+typedef enum NHAL_ENUM_PACKED {
+    NHAL_UART_FLOW_CONTROL_NONE = 0,   /**< No flow control. */
+    NHAL_UART_FLOW_CONTROL_RTS_CTS,    /**< Hardware RTS/CTS handshake: RTS is deasserted when the RX FIFO threshold is reached, transmission pauses while CTS is deasserted. */
+    NHAL_UART_FLOW_CONTROL_RS485_DE,   /**< RS-485 driver enable: the RTS/DE line is asserted by hardware while transmitting only. */
+} nhal_uart_flow_control_t;
+
 /**
  * @brief UART configuration structure
+ *
+ * Fields after config_id default to the implementation's own settings when
+ * left zero, so existing initializers keep their behavior. The structure
+ * must therefore be zero-initialized: an uninitialized local leaves them,
+ * and config_id, indeterminate.
  */
 struct nhal_uart_config{
     uint32_t baudrate;              /**< The baud rate for communication (bits per second). */
@@ -69,6 +84,22 @@ struct nhal_uart_config{
     nhal_uart_stop_bits_t stop_bits; /**< The number of stop bits (e.g., 1 or 2). */
     nhal_uart_data_bits_t data_bits; /**< The number of data bits (e.g., 7 or 8). */
     struct nhal_uart_impl_config * impl_config;
+    nhal_config_id_t config_id;      /**< Identity token, NHAL_CONFIG_ID_NONE if unused. */
+    nhal_uart_flow_control_t flow_control; /**< Flow control mode. */
+    uint16_t rx_fifo_threshold;      /**< RX FIFO level (bytes) at which received data is serviced and RTS is deasserted, 0 for the implementation default. */
+    uint16_t rx_idle_timeout_bits;   /**< Line idle time (bit times) after which a partially filled RX FIFO is serviced, 0 for the implementation default. */
+};
+
+/**
+ * @brief RS-485 half-duplex configuration (see nhal_uart_rs485.h)
+ *
+ * Timings are expressed in bit times so they scale with the baud rate.
+ */
+struct nhal_uart_rs485_config{
+    bool de_active_high;             /**< Driver-enable polarity. */
+    uint16_t de_assert_bits;         /**< Time DE is asserted before the first start bit. */
+    uint16_t de_release_bits;        /**< Time DE stays asserted after the last stop bit. */
+    uint16_t inter_frame_bits;       /**< Minimum bus silence delimiting frames, 0 for 3.5 character times. */
 };
 
 #endif /* NHAL_UART_TYPES_H */
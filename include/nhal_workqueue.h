@@ -0,0 +1,314 @@
+/**
+ * @file nhal_workqueue.h
+ * @brief Deferred work queue (bottom halves) for interrupt-context callbacks.
+ *
+ * NHAL callbacks (nhal_pin_callback_t, stream and capture callbacks...) run
+ * in interrupt context. Instead of doing the work there, or polling flags set
+ * by the ISR, drivers post a work item and return; a worker context runs
+ * the item's handler later at thread level.
+ *
+ * - Work items are statically allocated by their owner, so posting never
+ *   allocates. Posting an item that is already pending is coalesced: it runs
+ *   once, like a hardware interrupt flag.
+ * - Posting is lock-free (one compare-and-swap) and safe from any number of
+ *   interrupts and threads at once. Each queue is drained by one worker
+ *   context; use one queue per worker for several workers.
+ * - Items run highest priority first (0 is the highest) and in posting order
+ *   within a priority. Higher priority items posted while the worker runs are
+ *   picked up before the next lower priority item.
+ * - Per-priority statistics record the post-to-run latency and handler run
+ *   time, measured with NHAL_WORKQUEUE_TIMESTAMP().
+ *
+ * Requires GCC or Clang (__atomic builtins).
+ *
+ * @par Example usage:
+ * @code
+ * static struct nhal_workqueue wq;
+ * static struct nhal_work button_work;
+ *
+ * static void button_handler(struct nhal_work *work) {
+ *     debounce_and_report((struct button *)work->arg);   // Thread context
+ * }
+ *
+ * static void button_isr(struct nhal_pin_context *pin_ctx, void *user_data) {
+ *     nhal_workqueue_post(&wq, (struct nhal_work *)user_data);   // Interrupt context
+ * }
+ *
+ * nhal_workqueue_init(&wq, rtos_give_semaphore, &wq_sem);
+ * nhal_work_init(&button_work, button_handler, &button, 1);
+ * nhal_pin_set_interrupt_config(button_pin, NHAL_PIN_INT_TRIGGER_FALLING_EDGE, button_isr, &button_work);
+ *
+ * // Worker thread
+ * for (;;) {
+ *     rtos_take_semaphore(&wq_sem);
+ *     nhal_workqueue_run(&wq, 0);
+ * }
+ * @endcode
+ */
+#ifndef NHAL_WORKQUEUE_H
+#define NHAL_WORKQUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nhal_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of priority levels
+ */
+#ifndef NHAL_WORKQUEUE_PRIORITIES
+#define NHAL_WORKQUEUE_PRIORITIES 4
+#endif
+
+/**
+ * @brief Timestamp used for latency statistics
+ *
+ * Defaults to the microsecond timestamp; may be redefined to a cheaper
+ * counter (e.g.: `(uint32_t)nhal_get_timestamp_ticks()`), statistics are then
+ * in that counter's unit.
+ */
+#ifndef NHAL_WORKQUEUE_TIMESTAMP
+#define NHAL_WORKQUEUE_TIMESTAMP() ((uint32_t)nhal_get_timestamp_microseconds())
+#endif
+
+struct nhal_work;
+
+/**
+ * @brief Work handler, runs in the worker context
+ *
+ * @param work The work item, already re-armed: posting it again from the
+ *             handler (or from an ISR meanwhile) runs it once more.
+ */
+typedef void (*nhal_work_handler_t)(struct nhal_work *work);
+
+/**
+ * @brief Work queue notification, called when work is posted to an idle priority
+ *
+ * Typically gives a semaphore or sets an event flag the worker waits on.
+ *
+ * @note This executes in the posting context, possibly interrupt context - keep it fast and minimal
+ */
+typedef void (*nhal_workqueue_notify_t)(void *arg);
+
+/**
+ * @brief Work item
+ *
+ * Fields after priority are owned by the queue.
+ */
+struct nhal_work{
+    nhal_work_handler_t handler;
+    void *arg;                   /**< Free for the owner, e.g.: driver context. */
+    uint8_t priority;            /**< 0 (highest) to NHAL_WORKQUEUE_PRIORITIES - 1. */
+    struct nhal_work *next;
+    uint32_t pending;            /**< Non-zero from post until the handler starts. */
+    uint32_t post_time;
+};
+
+/**
+ * @brief Statistics of one priority level
+ */
+struct nhal_workqueue_stats{
+    uint32_t posted;             /**< Posts that queued the item. */
+    uint32_t coalesced;          /**< Posts of an item that was already pending. */
+    uint32_t executed;           /**< Handlers run. */
+    uint32_t latency_max;        /**< Longest post-to-run latency. */
+    uint64_t latency_total;      /**< Sum of post-to-run latencies (mean: latency_total / executed). */
+    uint32_t run_time_max;       /**< Longest handler run time. */
+};
+
+/**
+ * @brief Work queue
+ *
+ * Interrupts and threads push onto one lock-free LIFO per priority; the
+ * worker takes each LIFO whole, and moves it in posting order to its
+ * private ready list.
+ */
+struct nhal_workqueue{
+    struct nhal_work *posted[NHAL_WORKQUEUE_PRIORITIES];
+    struct nhal_work *ready_head[NHAL_WORKQUEUE_PRIORITIES];
+    struct nhal_work *ready_tail[NHAL_WORKQUEUE_PRIORITIES];
+    nhal_workqueue_notify_t notify;
+    void *notify_arg;
+    struct nhal_workqueue_stats stats[NHAL_WORKQUEUE_PRIORITIES];
+};
+
+/**
+ * @brief Initialize a work queue
+ * @param wq Pointer to work queue
+ * @param notify Called when work is posted to an idle priority (may be NULL)
+ * @param notify_arg Argument passed to notify
+ */
+static inline void nhal_workqueue_init(struct nhal_workqueue *wq, nhal_workqueue_notify_t notify, void *notify_arg)
+{
+    memset(wq, 0, sizeof(*wq));
+    wq->notify = notify;
+    wq->notify_arg = notify_arg;
+}
+
+/**
+ * @brief Initialize a work item
+ * @param work Pointer to work item
+ * @param handler Handler run by the worker
+ * @param arg Free argument for the handler
+ * @param priority 0 (highest) to NHAL_WORKQUEUE_PRIORITIES - 1, clamped
+ */
+static inline void nhal_work_init(struct nhal_work *work, nhal_work_handler_t handler, void *arg, uint8_t priority)
+{
+    memset(work, 0, sizeof(*work));
+    work->handler = handler;
+    work->arg = arg;
+    work->priority = priority < NHAL_WORKQUEUE_PRIORITIES ? priority : NHAL_WORKQUEUE_PRIORITIES - 1;
+}
+
+/**
+ * @brief Post a work item
+ *
+ * @note Safe from interrupt context and from several contexts at once.
+ *
+ * @param wq Pointer to work queue
+ * @param work Pointer to work item (must not be posted to another queue)
+ * @return true if the item was queued, false if it was already pending (coalesced)
+ */
+static inline bool nhal_workqueue_post(struct nhal_workqueue *wq, struct nhal_work *work)
+{
+    struct nhal_work **posted = &wq->posted[work->priority];
+    struct nhal_work *head;
+
+    if (__atomic_exchange_n(&work->pending, 1, __ATOMIC_ACQUIRE) != 0) {
+        __atomic_fetch_add(&wq->stats[work->priority].coalesced, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    /* The item is now owned by this post until the worker takes it */
+    work->post_time = NHAL_WORKQUEUE_TIMESTAMP();
+    head = __atomic_load_n(posted, __ATOMIC_RELAXED);
+    do {
+        work->next = head;
+    } while (!__atomic_compare_exchange_n(posted, &head, work, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    __atomic_fetch_add(&wq->stats[work->priority].posted, 1, __ATOMIC_RELAXED);
+
+    if (head == NULL && wq->notify != NULL) {
+        wq->notify(wq->notify_arg);
+    }
+    return true;
+}
+
+/**
+ * @brief Move posted items of every priority to the ready lists (worker only)
+ * @param wq Pointer to work queue
+ */
+static inline void nhal_workqueue_collect(struct nhal_workqueue *wq)
+{
+    unsigned priority;
+
+    for (priority = 0; priority < NHAL_WORKQUEUE_PRIORITIES; priority++) {
+        struct nhal_work *lifo;
+        struct nhal_work *fifo = NULL;
+        struct nhal_work *last;
+
+        if (__atomic_load_n(&wq->posted[priority], __ATOMIC_RELAXED) == NULL) {
+            continue;
+        }
+        lifo = __atomic_exchange_n(&wq->posted[priority], NULL, __ATOMIC_ACQUIRE);
+        last = lifo;
+        while (lifo != NULL) {
+            struct nhal_work *next = lifo->next;
+            lifo->next = fifo;
+            fifo = lifo;
+            lifo = next;
+        }
+        if (fifo == NULL) {
+            continue;
+        }
+        if (wq->ready_tail[priority] != NULL) {
+            wq->ready_tail[priority]->next = fifo;
+        } else {
+            wq->ready_head[priority] = fifo;
+        }
+        wq->ready_tail[priority] = last;
+    }
+}
+
+/**
+ * @brief Run pending work items (worker only)
+ *
+ * Runs items highest priority first, checking for newly posted items before
+ * each one.
+ *
+ * @param wq Pointer to work queue
+ * @param max_items Maximum number of handlers to run (0: until the queue is empty)
+ * @return Number of handlers run
+ */
+static inline size_t nhal_workqueue_run(struct nhal_workqueue *wq, size_t max_items)
+{
+    size_t count = 0;
+
+    while (max_items == 0 || count < max_items) {
+        struct nhal_workqueue_stats *stats;
+        struct nhal_work *work = NULL;
+        uint32_t start;
+        uint32_t latency;
+        uint32_t run_time;
+        unsigned priority;
+
+        nhal_workqueue_collect(wq);
+        for (priority = 0; priority < NHAL_WORKQUEUE_PRIORITIES; priority++) {
+            work = wq->ready_head[priority];
+            if (work != NULL) {
+                wq->ready_head[priority] = work->next;
+                if (work->next == NULL) {
+                    wq->ready_tail[priority] = NULL;
+                }
+                break;
+            }
+        }
+        if (work == NULL) {
+            break;
+        }
+
+        stats = &wq->stats[priority];
+        start = NHAL_WORKQUEUE_TIMESTAMP();
+        latency = start - work->post_time;
+
+        /* Re-arm before running so posts during the handler are not lost */
+        __atomic_store_n(&work->pending, 0, __ATOMIC_RELEASE);
+        work->handler(work);
+
+        run_time = NHAL_WORKQUEUE_TIMESTAMP() - start;
+        stats->executed++;
+        stats->latency_total += latency;
+        if (latency > stats->latency_max) {
+            stats->latency_max = latency;
+        }
+        if (run_time > stats->run_time_max) {
+            stats->run_time_max = run_time;
+        }
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Reset the statistics of a work queue
+ *
+ * posted and coalesced are updated by posting contexts; resetting them
+ * while work is posted may lose a few counts.
+ *
+ * @param wq Pointer to work queue
+ */
+static inline void nhal_workqueue_reset_stats(struct nhal_workqueue *wq)
+{
+    memset(wq->stats, 0, sizeof(wq->stats));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_WORKQUEUE_H */
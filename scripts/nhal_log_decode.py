@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+"""
+Host decoder for nhal_log.h binary logs
+
+Reads the format strings from the nhal_log_fmt section of the firmware ELF
+file and turns the COBS framed records drained by nhal_log_drain() back
+into text.
+
+Usage:
+    nhal_log_decode.py firmware.elf capture.bin
+    nhal_log_decode.py firmware.elf /dev/ttyUSB0 --baud 921600
+    cat capture.bin | nhal_log_decode.py firmware.elf
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SECTION_NAME = 'nhal_log_fmt'
+LEVEL_NAMES = {'E': 'ERROR', 'W': 'WARN', 'I': 'INFO', 'D': 'DEBUG'}
+
+CONVERSION = re.compile(r'%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(?:hh|h|ll|l|j|z|t|L)?([diouxXcspfFeEgGaA%])')
+
+
+def read_section(elf_path, name):
+    """Return the contents of an ELF section (ELF32/ELF64, either endianness)"""
+    with open(elf_path, 'rb') as f:
+        data = f.read()
+
+    if data[:4] != b'\x7fELF':
+        raise ValueError(f'{elf_path}: not an ELF file')
+    is_64 = data[4] == 2
+    endian = '<' if data[5] == 1 else '>'
+
+    if is_64:
+        shoff, = struct.unpack_from(endian + 'Q', data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', data, 0x3A)
+        header = endian + 'IIQQQQIIQQ'
+    else:
+        shoff, = struct.unpack_from(endian + 'I', data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', data, 0x2E)
+        header = endian + 'IIIIIIIIII'
+
+    sections = [struct.unpack_from(header, data, shoff + i * shentsize) for i in range(shnum)]
+    strtab_offset, strtab_size = sections[shstrndx][4], sections[shstrndx][5]
+    strtab = data[strtab_offset:strtab_offset + strtab_size]
+
+    for section in sections:
+        name_offset = section[0]
+        section_name = strtab[name_offset:strtab.index(b'\0', name_offset)].decode()
+        if section_name == name:
+            return data[section[4]:section[4] + section[5]]
+    raise ValueError(f'{elf_path}: no {name} section (no NHAL_LOG_* calls linked in?)')
+
+
+def load_formats(elf_path):
+    """Map format IDs (section offsets) to (level, location, format)"""
+    section = read_section(elf_path, SECTION_NAME)
+    formats = {}
+    offset = 0
+    while offset < len(section):
+        end = section.find(b'\0', offset)
+        if end < 0:
+            end = len(section)
+        entry = section[offset:end].decode(errors='replace')
+        if entry.count('\x1f') >= 2:
+            level, location, fmt = entry.split('\x1f', 2)
+            formats[offset] = (LEVEL_NAMES.get(level, level), location, fmt)
+        offset = end + 1
+        # Entries may be padded to their alignment
+        while offset < len(section) and section[offset] == 0:
+            offset += 1
+    return formats
+
+
+def cobs_frames(stream):
+    """Yield decoded COBS frames from a byte stream"""
+    frame = bytearray()
+    while True:
+        chunk = stream.read(1)
+        if not chunk:
+            return
+        if chunk[0] != 0:
+            frame += chunk
+            continue
+        decoded = bytearray()
+        pos = 0
+        valid = True
+        while pos < len(frame):
+            code = frame[pos]
+            if code == 0 or pos + code > len(frame):
+                valid = False
+                break
+            decoded += frame[pos + 1:pos + code]
+            pos += code
+            if code < 0xFF and pos < len(frame):
+                decoded.append(0)
+        if valid and frame:
+            yield bytes(decoded)
+        frame = bytearray()
+
+
+def varints(payload):
+    """Decode a sequence of LEB128 varints"""
+    values = []
+    value = 0
+    shift = 0
+    for byte in payload:
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            values.append(value)
+            value = 0
+            shift = 0
+    if shift != 0:
+        raise ValueError('truncated varint')
+    return values
+
+
+def unzigzag(value):
+    """Zigzag to raw 32-bit word"""
+    return ((value >> 1) ^ -(value & 1)) & 0xFFFFFFFF
+
+
+def signed32(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def render(fmt, args):
+    """Apply a C printf format to raw 32-bit argument words"""
+    args = list(args)
+
+    def take():
+        return args.pop(0) if args else 0
+
+    def convert(match):
+        flags, width, precision, conv = match.groups()
+        if conv == '%':
+            return '%'
+        if width == '*':
+            width = str(signed32(take()))
+        if precision == '*':
+            precision = str(signed32(take()))
+        spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '')
+        word = take()
+        if conv in 'di':
+            return (spec + 'd') % signed32(word)
+        if conv == 'u':
+            return (spec + 'd') % word
+        if conv in 'oxX':
+            return (spec + conv) % word
+        if conv == 'c':
+            return (spec + 'c') % chr(word & 0xFF)
+        if conv == 'p':
+            return (spec + 's') % f'0x{word:08x}'
+        if conv == 's':
+            return (spec + 's') % f'<str@0x{word:08x}>'
+        value = struct.unpack('<f', struct.pack('<I', word))[0]
+        if conv in 'aA':
+            return value.hex()
+        return (spec + conv) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode(formats, stream, out, tick_hz):
+    time_ticks = 0
+    for payload in cobs_frames(stream):
+        try:
+            values = varints(payload)
+        except ValueError:
+            out.write('<corrupted frame>\n')
+            continue
+        if not values:
+            continue
+        if values[0] == 0:
+            count = values[1] if len(values) > 1 else 0
+            out.write(f'<{count} records dropped>\n')
+            continue
+        if len(values) < 2:
+            out.write('<corrupted frame>\n')
+            continue
+
+        time_ticks += signed32(unzigzag(values[1]))
+        entry = formats.get(values[0] - 1)
+        if entry is None:
+            out.write(f'<unknown format id {values[0] - 1}: ELF file does not match the firmware?>\n')
+            continue
+        level, location, fmt = entry
+        text = render(fmt, [unzigzag(v) for v in values[2:]])
+        out.write(f'[{time_ticks / tick_hz:12.6f}] {level:<5} {location}: {text}\n')
+        out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode nhal_log binary logs')
+    parser.add_argument('elf', help='firmware ELF file the log was produced by')
+    parser.add_argument('input', nargs='?', default='-', help='capture file or serial device (default: stdin)')
+    parser.add_argument('--baud', type=int, help='open input as a serial port at this baud rate (requires pyserial)')
+    parser.add_argument('--tick-hz', type=float, default=1e6,
+                        help='NHAL_LOG_TIMESTAMP() frequency (default: 1000000, microseconds)')
+    args = parser.parse_args()
+
+    try:
+        formats = load_formats(args.elf)
+    except (OSError, ValueError) as e:
+        print(f'error: {e}', file=sys.stderr)
+        return 1
+
+    if args.baud:
+        import serial
+        stream = serial.Serial(args.input, args.baud)
+    elif args.input == '-':
+        stream = sys.stdin.buffer
+    else:
+        stream = open(args.input, 'rb')
+
+    try:
+        decode(formats, stream, sys.stdout, args.tick_hz)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+Footprint report and regression check for the NHAL interfaces
+
+Reads the symbol sizes of the footprint probe object files (one per
+interface) and reports, per function and per structure instance, the bytes
+of code, read-only data, initialized data and zero-initialized data they
+cost. Flash is code + rodata + data, RAM is data + bss.
+
+Usage:
+    nhal_footprint.py --nm arm-none-eabi-nm nhal_footprint_uart.c.obj ...
+    nhal_footprint.py --nm nm --baseline baselines/GNU-x86_64-default.json --check *.o
+    nhal_footprint.py --nm nm --baseline baselines/GNU-x86_64-default.json --update *.o
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+CATEGORIES = ('code', 'rodata', 'data', 'bss')
+
+# nm symbol types, lower case for local symbols
+SYMBOL_CATEGORY = {
+    't': 'code', 'w': 'code',
+    'r': 'rodata',
+    'd': 'data', 'g': 'data',
+    'b': 'bss', 's': 'bss', 'c': 'bss',
+}
+
+PROBE_PREFIX = 'nhal_footprint_'
+KEEP_PREFIX = 'nhal_footprint_keep_'
+
+
+def interface_name(path):
+    """nhal_footprint_uart.c.o -> uart"""
+    name = os.path.basename(path).split('.')[0]
+    return name[len(PROBE_PREFIX):] if name.startswith(PROBE_PREFIX) else name
+
+
+def read_symbols(nm, path):
+    """Return {symbol: {category: size}} for the sized symbols of an object file"""
+    output = subprocess.run([nm, '--print-size', '--defined-only', path],
+                            check=True, capture_output=True, text=True).stdout
+    symbols = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) != 4:
+            continue
+        _, size, kind, name = fields
+        category = SYMBOL_CATEGORY.get(kind.lower())
+        if category is None or name.startswith(KEEP_PREFIX) or name.startswith('.'):
+            continue
+        if name.startswith(PROBE_PREFIX):
+            name = '(' + name[len(PROBE_PREFIX):] + ')'
+        entry = symbols.setdefault(name, {})
+        entry[category] = entry.get(category, 0) + int(size, 16)
+    return symbols
+
+
+def totals(symbols):
+    total = {category: 0 for category in CATEGORIES}
+    for sizes in symbols.values():
+        for category, size in sizes.items():
+            total[category] += size
+    return total
+
+
+def flash_ram(sizes):
+    flash = sizes.get('code', 0) + sizes.get('rodata', 0) + sizes.get('data', 0)
+    ram = sizes.get('data', 0) + sizes.get('bss', 0)
+    return flash, ram
+
+
+def print_report(report, out):
+    row = '{:<44} {:>7} {:>7} {:>7} {:>7} {:>7} {:>7}'
+    out.write(row.format('symbol', 'code', 'rodata', 'data', 'bss', 'flash', 'ram') + '\n')
+    for interface, symbols in sorted(report['interfaces'].items()):
+        out.write(f'\n[{interface}]\n')
+        for name, sizes in sorted(symbols.items()):
+            out.write(row.format(name, *(sizes.get(c, 0) for c in CATEGORIES), *flash_ram(sizes)) + '\n')
+        total = totals(symbols)
+        out.write(row.format('total', *(total[c] for c in CATEGORIES), *flash_ram(total)) + '\n')
+
+
+def compare(report, baseline, tolerance, out):
+    """Print size changes against the baseline, return the number of regressions"""
+    regressions = 0
+    interfaces = set(report['interfaces']) | set(baseline['interfaces'])
+    for interface in sorted(interfaces):
+        current = report['interfaces'].get(interface, {})
+        previous = baseline['interfaces'].get(interface, {})
+        for name in sorted(set(current) | set(previous)):
+            for category in CATEGORIES:
+                new = current.get(name, {}).get(category, 0)
+                old = previous.get(name, {}).get(category, 0)
+                if new == old:
+                    continue
+                grown = new - old > tolerance
+                regressions += grown
+                out.write(f'{"FAIL" if grown else "note"} {interface}: {name} {category} '
+                          f'{old} -> {new} ({new - old:+d})\n')
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='NHAL footprint report')
+    parser.add_argument('objects', nargs='+', help='footprint probe object files')
+    parser.add_argument('--nm', default='nm', help='nm of the target toolchain (default: nm)')
+    parser.add_argument('--profile', default='default', help='profile name recorded in the report')
+    parser.add_argument('--output', help='write the report as JSON to this file')
+    parser.add_argument('--baseline', help='baseline JSON file')
+    parser.add_argument('--check', action='store_true', help='fail if a symbol grew against the baseline')
+    parser.add_argument('--update', action='store_true', help='write the report as the new baseline')
+    parser.add_argument('--tolerance', type=int, default=0, help='bytes a symbol may grow per category (default: 0)')
+    args = parser.parse_args()
+
+    report = {'profile': args.profile, 'interfaces': {}}
+    try:
+        for path in args.objects:
+            report['interfaces'][interface_name(path)] = read_symbols(args.nm, path)
+    except (OSError, subprocess.CalledProcessError) as e:
+        print(f'error: {e}', file=sys.stderr)
+        return 1
+
+    print_report(report, sys.stdout)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(report, f, indent=2, sort_keys=True)
+            f.write('\n')
+
+    if args.update:
+        if not args.baseline:
+            print('error: --update requires --baseline', file=sys.stderr)
+            return 1
+        with open(args.baseline, 'w') as f:
+            json.dump(report, f, indent=2, sort_keys=True)
+            f.write('\n')
+        print(f'\nbaseline written to {args.baseline}')
+
+    elif args.check:
+        if not args.baseline or not os.path.exists(args.baseline):
+            print(f'error: no baseline {args.baseline}, create it with --update', file=sys.stderr)
+            return 1
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        print(f'\nchanges against {args.baseline}:')
+        regressions = compare(report, baseline, args.tolerance, sys.stdout)
+        if regressions:
+            print(f'{regressions} size regression(s)')
+            return 1
+        print('no size regressions')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
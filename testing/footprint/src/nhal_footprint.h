@@ -0,0 +1,27 @@
+/**
+ * @file nhal_footprint.h
+ * @brief Helpers of the footprint probes
+ *
+ * Each probe translation unit instantiates the code one interface ships in
+ * its headers and one instance of its public structures. The probes are
+ * compiled, never linked: nhal_footprint.py reads the symbol sizes of the
+ * object files.
+ */
+#ifndef NHAL_FOOTPRINT_H
+#define NHAL_FOOTPRINT_H
+
+/**
+ * @brief Emit a static inline function out of line so its size is measured
+ *
+ * The pointer itself is not reported.
+ */
+#define NHAL_FOOTPRINT_FUNCTION(fn) \
+    void (*const nhal_footprint_keep_##fn)(void) __attribute__((used)) = (void (*)(void))(fn)
+
+/**
+ * @brief One instance of a structure, reported as RAM under its name
+ */
+#define NHAL_FOOTPRINT_OBJECT(type, name) \
+    type nhal_footprint_##name __attribute__((used))
+
+#endif /* NHAL_FOOTPRINT_H */
@@ -0,0 +1,19 @@
+/**
+ * @file nhal_footprint_common.c
+ * @brief Common helpers footprint probe: retry policy, tick conversion
+ */
+
+#include "nhal_footprint.h"
+#include "nhal_retry.h"
+#include "nhal_ticks.h"
+
+NHAL_FOOTPRINT_FUNCTION(nhal_retry_init);
+NHAL_FOOTPRINT_FUNCTION(nhal_retry_reset_stats);
+NHAL_FOOTPRINT_FUNCTION(nhal_retry_is_retryable);
+NHAL_FOOTPRINT_FUNCTION(nhal_retry_backoff_us);
+NHAL_FOOTPRINT_FUNCTION(nhal_retry_next_attempt);
+NHAL_FOOTPRINT_FUNCTION(nhal_tick_calibration_from_frequency);
+NHAL_FOOTPRINT_FUNCTION(nhal_ticks_to_nanoseconds);
+
+NHAL_FOOTPRINT_OBJECT(struct nhal_retry_context, retry_context);
+NHAL_FOOTPRINT_OBJECT(struct nhal_tick_calibration, tick_calibration);
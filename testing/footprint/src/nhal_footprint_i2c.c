@@ -0,0 +1,24 @@
+/**
+ * @file nhal_footprint_i2c.c
+ * @brief I2C footprint probe: dispatch layer, packed transfer lists, configuration
+ */
+
+#define NHAL_I2C_DISPATCH
+#define NHAL_DISPATCH_IMPLEMENTATION
+
+#include "nhal_footprint.h"
+#include "nhal_i2c_ops.h"
+#include "nhal_i2c_transfer_packed.h"
+
+NHAL_FOOTPRINT_FUNCTION(nhal_i2c_context_bind);
+NHAL_FOOTPRINT_FUNCTION(nhal_i2c_packed_init);
+NHAL_FOOTPRINT_FUNCTION(nhal_i2c_packed_add_write);
+NHAL_FOOTPRINT_FUNCTION(nhal_i2c_packed_add_write_inline);
+NHAL_FOOTPRINT_FUNCTION(nhal_i2c_packed_add_read);
+NHAL_FOOTPRINT_FUNCTION(nhal_i2c_packed_from_ops);
+NHAL_FOOTPRINT_FUNCTION(nhal_i2c_packed_next);
+
+NHAL_FOOTPRINT_OBJECT(struct nhal_i2c_context, i2c_context);
+NHAL_FOOTPRINT_OBJECT(struct nhal_i2c_config, i2c_config);
+NHAL_FOOTPRINT_OBJECT(nhal_i2c_transfer_op_t, i2c_transfer_op);
+NHAL_FOOTPRINT_OBJECT(struct nhal_i2c_packed_ops, i2c_packed_ops);
@@ -0,0 +1,12 @@
+/**
+ * @file nhal_footprint_log.c
+ * @brief Deferred binary logging footprint probe (ring buffer included)
+ */
+
+#define NHAL_LOG_IMPLEMENTATION
+
+#include "nhal_footprint.h"
+#include "nhal_log.h"
+
+NHAL_FOOTPRINT_FUNCTION(nhal_log_float);
+NHAL_FOOTPRINT_FUNCTION(nhal_log_record);
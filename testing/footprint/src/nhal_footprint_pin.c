@@ -0,0 +1,17 @@
+/**
+ * @file nhal_footprint_pin.c
+ * @brief Pin footprint probe: dispatch layer including pin groups, configuration
+ */
+
+#define NHAL_PIN_DISPATCH
+#define NHAL_DISPATCH_IMPLEMENTATION
+
+#include "nhal_footprint.h"
+#include "nhal_pin_ops.h"
+
+NHAL_FOOTPRINT_FUNCTION(nhal_pin_context_bind);
+NHAL_FOOTPRINT_FUNCTION(nhal_pin_group_context_bind);
+
+NHAL_FOOTPRINT_OBJECT(struct nhal_pin_context, pin_context);
+NHAL_FOOTPRINT_OBJECT(struct nhal_pin_config, pin_config);
+NHAL_FOOTPRINT_OBJECT(struct nhal_pin_group_context, pin_group_context);
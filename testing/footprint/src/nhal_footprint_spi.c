@@ -0,0 +1,18 @@
+/**
+ * @file nhal_footprint_spi.c
+ * @brief SPI footprint probe: dispatch layer, NOR flash driver, configuration
+ */
+
+#define NHAL_SPI_DISPATCH
+#define NHAL_DISPATCH_IMPLEMENTATION
+#define NHAL_SPI_NOR_IMPLEMENTATION
+
+#include "nhal_footprint.h"
+#include "nhal_spi_ops.h"
+#include "nhal_spi_nor.h"
+
+NHAL_FOOTPRINT_FUNCTION(nhal_spi_context_bind);
+
+NHAL_FOOTPRINT_OBJECT(struct nhal_spi_context, spi_context);
+NHAL_FOOTPRINT_OBJECT(struct nhal_spi_config, spi_config);
+NHAL_FOOTPRINT_OBJECT(struct nhal_spi_nor, spi_nor);
@@ -0,0 +1,20 @@
+/**
+ * @file nhal_footprint_uart.c
+ * @brief UART footprint probe: dispatch layer, RS-485 helpers, configuration
+ */
+
+#define NHAL_UART_DISPATCH
+#define NHAL_DISPATCH_IMPLEMENTATION
+
+#include "nhal_footprint.h"
+#include "nhal_uart_ops.h"
+#include "nhal_uart_rs485.h"
+
+NHAL_FOOTPRINT_FUNCTION(nhal_uart_context_bind);
+NHAL_FOOTPRINT_FUNCTION(nhal_uart_char_bits);
+NHAL_FOOTPRINT_FUNCTION(nhal_uart_bits_to_us);
+NHAL_FOOTPRINT_FUNCTION(nhal_uart_rs485_inter_frame_bits);
+
+NHAL_FOOTPRINT_OBJECT(struct nhal_uart_context, uart_context);
+NHAL_FOOTPRINT_OBJECT(struct nhal_uart_config, uart_config);
+NHAL_FOOTPRINT_OBJECT(struct nhal_uart_rs485_config, uart_rs485_config);
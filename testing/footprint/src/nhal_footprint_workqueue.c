@@ -0,0 +1,17 @@
+/**
+ * @file nhal_footprint_workqueue.c
+ * @brief Deferred work queue footprint probe
+ */
+
+#include "nhal_footprint.h"
+#include "nhal_workqueue.h"
+
+NHAL_FOOTPRINT_FUNCTION(nhal_workqueue_init);
+NHAL_FOOTPRINT_FUNCTION(nhal_work_init);
+NHAL_FOOTPRINT_FUNCTION(nhal_workqueue_post);
+NHAL_FOOTPRINT_FUNCTION(nhal_workqueue_collect);
+NHAL_FOOTPRINT_FUNCTION(nhal_workqueue_run);
+NHAL_FOOTPRINT_FUNCTION(nhal_workqueue_reset_stats);
+
+NHAL_FOOTPRINT_OBJECT(struct nhal_workqueue, workqueue);
+NHAL_FOOTPRINT_OBJECT(struct nhal_work, work);
@@ -0,0 +1,210 @@
+/**
+ * @file nhal_can_bus_sim.hpp
+ * @brief Simulated CAN bus for controller and protocol stack tests
+ */
+
+#ifndef NHAL_CAN_BUS_SIM_HPP
+#define NHAL_CAN_BUS_SIM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "nhal_can.h"
+#include "nhal_virtual_clock.hpp"
+
+/**
+ * @brief CAN bus model behind the CAN interface
+ *
+ * Every nhal_can_context used with the handlers is a controller on one shared
+ * bus. Controllers have TX mailboxes, acceptance filter banks and RX FIFOs of
+ * configurable size; pending frames are arbitrated bit-exactly (lowest
+ * identifier wins, standard before extended, data before remote) and occupy
+ * the bus for their real length, bit stuffing included. Delivered frames go
+ * through each controller's filter table into its FIFOs, overrunning them when
+ * the consumer is too slow.
+ *
+ * Traffic from the rest of the network comes from inject(), periodic sources
+ * or saturate(), which keeps the bus at 100% load: the worst case a filter
+ * configuration and a FIFO consumer must sustain. Frames are always
+ * acknowledged, so error counters stay at 0.
+ *
+ * Time comes from the NhalVirtualClock bound to the calling thread: frames
+ * take bus time as virtual time advances, and transmit()/receive() advance it
+ * while they wait. Without a clock, frames are only sent by step().
+ *
+ * The handler signatures match the C interface so they can be used directly
+ * as mock actions:
+ * @code
+ * NhalVirtualClock clock;
+ * NhalCanBusSim bus(1000000);
+ * NhalCanMock &can = NhalCanMock::instance();
+ * ON_CALL(can, nhal_can_set_config(_, _)).WillByDefault(Invoke(&bus, &NhalCanBusSim::set_config));
+ * ON_CALL(can, nhal_can_set_filters(_, _, _)).WillByDefault(Invoke(&bus, &NhalCanBusSim::set_filters));
+ * ON_CALL(can, nhal_can_start(_)).WillByDefault(Invoke(&bus, &NhalCanBusSim::start));
+ * ON_CALL(can, nhal_can_receive(_, _, _, _, _, _)).WillByDefault(Invoke(&bus, &NhalCanBusSim::receive));
+ *
+ * bus.saturate([](uint64_t n) { return NhalCanBusSim::make_frame(0x080 + n % 0x700, 8); });
+ * run_gateway_for(std::chrono::seconds(1));      // Runs in virtual time
+ * EXPECT_EQ(0u, bus.node_stats(&gateway_ctx).rx_overruns);
+ * EXPECT_GT(bus.filter_efficiency(&gateway_ctx), 0.95);
+ * @endcode
+ */
+class NhalCanBusSim {
+public:
+    /** @brief Controller resources */
+    struct NodeConfig {
+        size_t tx_mailboxes;
+        size_t filter_banks;
+        size_t num_fifos;
+        size_t fifo_depth;
+
+        NodeConfig() : tx_mailboxes(3), filter_banks(14), num_fifos(2), fifo_depth(3) {}
+    };
+
+    /** @brief Per-controller counters since start(), beyond nhal_can_stats */
+    struct NodeStats {
+        uint64_t frames_seen;        /**< Frames from other nodes that crossed the bus. */
+        uint64_t frames_accepted;    /**< Frames passing the filters (stored or overrun). */
+        uint64_t frames_rejected;    /**< Frames dropped by the hardware filters. */
+        uint64_t frames_unwanted;    /**< Accepted frames the set_wanted() predicate refuses. */
+        uint64_t rx_overruns;
+        uint64_t rx_callbacks;
+        uint64_t receive_calls;      /**< receive() calls returning frames. */
+        uint64_t frames_read;        /**< Frames returned by receive(). */
+    };
+
+    /** @brief Bus counters since construction or reset_stats() */
+    struct BusStats {
+        uint64_t frames;
+        uint64_t bits;               /**< Bits on the wire, stuffing and interframe space included. */
+        uint64_t busy_ns;
+        uint64_t start_ns;
+    };
+
+    typedef std::function<nhal_can_frame_t(uint64_t index)> FrameGenerator;
+    typedef std::function<bool(const nhal_can_frame_t &frame)> FramePredicate;
+
+    explicit NhalCanBusSim(uint32_t bitrate = 500000);
+    ~NhalCanBusSim();
+
+    NhalCanBusSim(const NhalCanBusSim &) = delete;
+    NhalCanBusSim &operator=(const NhalCanBusSim &) = delete;
+
+    /** @brief Give a controller non-default resources (before init()) */
+    void attach(struct nhal_can_context *ctx, const NodeConfig &config);
+
+    /** @brief Software acceptance test of the application, to count frames the filters let through needlessly */
+    void set_wanted(struct nhal_can_context *ctx, FramePredicate wanted);
+
+    // Traffic from the rest of the network
+    void inject(const nhal_can_frame_t &frame);
+    void add_periodic(const nhal_can_frame_t &frame, uint64_t period_ns, uint64_t offset_ns = 0);
+    /** @brief Keep a frame from generator(0, 1, ...) always pending: 100% bus load */
+    void saturate(FrameGenerator generator);
+    void stop_traffic();
+
+    // Handlers matching the C interface
+    nhal_result_t init(struct nhal_can_context *ctx);
+    nhal_result_t deinit(struct nhal_can_context *ctx);
+    nhal_result_t set_config(struct nhal_can_context *ctx, struct nhal_can_config *config);
+    nhal_result_t get_config(struct nhal_can_context *ctx, struct nhal_can_config *config);
+    nhal_result_t set_filters(struct nhal_can_context *ctx, const nhal_can_filter_t *filters, size_t num_filters);
+    nhal_result_t start(struct nhal_can_context *ctx);
+    nhal_result_t stop(struct nhal_can_context *ctx);
+    nhal_result_t transmit(struct nhal_can_context *ctx, const nhal_can_frame_t *frame, uint32_t timeout_ms);
+    nhal_result_t receive(struct nhal_can_context *ctx, uint8_t fifo, nhal_can_frame_t *frames, size_t max_frames,
+                          size_t *received, uint32_t timeout_ms);
+    nhal_result_t get_stats(struct nhal_can_context *ctx, struct nhal_can_stats *stats);
+
+    /** @brief Arbitrate and send the next pending frame now, false if none is pending */
+    bool step();
+
+    /** @brief Length of a frame on the wire in bits, stuffing and interframe space included */
+    static uint32_t frame_bits(const nhal_can_frame_t &frame);
+
+    /** @brief Data frame with a standard id and a counting payload */
+    static nhal_can_frame_t make_frame(uint32_t id, uint8_t dlc, uint8_t flags = 0);
+
+    uint32_t bitrate() const { return bitrate_; }
+    const BusStats &stats() const { return stats_; }
+    void reset_stats();
+
+    /** @brief Frames per second delivered since the last reset (virtual time) */
+    double frames_per_second() const;
+    /** @brief Fraction of the time the bus was busy since the last reset */
+    double bus_load() const;
+
+    NodeStats node_stats(struct nhal_can_context *ctx) const;
+    /** @brief Fraction of the frames seen that the hardware filters kept away from software */
+    double filter_efficiency(struct nhal_can_context *ctx) const;
+
+private:
+    struct Mailbox {
+        nhal_can_frame_t frame;
+        uint64_t sequence;
+    };
+
+    struct Node {
+        NodeConfig resources;
+        struct nhal_can_config config;
+        bool initialized;
+        bool configured;
+        bool started;
+        std::vector<nhal_can_filter_t> filters;
+        std::vector<std::deque<nhal_can_frame_t> > fifos;
+        std::vector<Mailbox> mailboxes;
+        uint64_t next_sequence;
+        struct nhal_can_stats stats;
+        NodeStats sim_stats;
+        FramePredicate wanted;
+    };
+
+    struct Periodic {
+        nhal_can_frame_t frame;
+        uint64_t period_ns;
+        uint64_t next_ns;
+        NhalVirtualClock::EventId event;
+    };
+
+    /** @brief Winner of an arbitration round */
+    struct Candidate {
+        nhal_can_frame_t frame;
+        int source;
+        Node *node;                  /**< nullptr for external traffic. */
+        size_t index;                /**< Injected frame index. */
+        uint64_t sequence;           /**< Mailbox sequence or saturate index. */
+    };
+
+    static uint64_t arbitration_key(const nhal_can_frame_t &frame);
+
+    Node *find(struct nhal_can_context *ctx);
+    const Node *find(struct nhal_can_context *ctx) const;
+    bool arbitrate(Candidate *winner);
+    void begin_frame();
+    void complete_frame(const Candidate &winner);
+    void deliver(struct nhal_can_context *ctx, Node &node, const nhal_can_frame_t &frame);
+    void schedule_periodic(Periodic *source, uint64_t time_ns);
+    void kick();
+    /** @brief Advance the clock to the next bus activity, or deadline_ns; false at the deadline */
+    bool wait_activity(uint64_t deadline_ns);
+
+    uint32_t bitrate_;
+    std::map<struct nhal_can_context *, Node> nodes_;
+    std::deque<nhal_can_frame_t> injected_;
+    std::vector<Periodic *> periodic_;
+    FrameGenerator saturate_;
+    uint64_t saturate_index_;
+    bool saturate_pending_;
+    nhal_can_frame_t saturate_frame_;
+    NhalVirtualClock *clock_;
+    bool busy_;
+    uint64_t busy_until_ns_;
+    NhalVirtualClock::EventId bus_event_;
+    BusStats stats_;
+};
+
+#endif /* NHAL_CAN_BUS_SIM_HPP */
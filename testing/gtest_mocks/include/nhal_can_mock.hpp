@@ -0,0 +1,43 @@
+/**
+ * @file nhal_can_mock.hpp
+ * @brief Google Mock implementation for CAN HAL interface
+ */
+
+#ifndef NHAL_CAN_MOCK_HPP
+#define NHAL_CAN_MOCK_HPP
+
+#include <gmock/gmock.h>
+#include "nhal_mock_scope.hpp"
+#include "nhal_can.h"
+
+/**
+ * @brief Mock class for CAN HAL interface
+ */
+class NhalCanMock {
+public:
+    // CAN operations
+    MOCK_METHOD(nhal_result_t, nhal_can_init, (struct nhal_can_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_can_deinit, (struct nhal_can_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_can_set_config, (struct nhal_can_context *ctx, struct nhal_can_config *config));
+    MOCK_METHOD(nhal_result_t, nhal_can_get_config, (struct nhal_can_context *ctx, struct nhal_can_config *config));
+    MOCK_METHOD(nhal_result_t, nhal_can_set_filters, (struct nhal_can_context *ctx, const nhal_can_filter_t *filters, size_t num_filters));
+    MOCK_METHOD(nhal_result_t, nhal_can_start, (struct nhal_can_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_can_stop, (struct nhal_can_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_can_transmit, (struct nhal_can_context *ctx, const nhal_can_frame_t *frame, uint32_t timeout_ms));
+    MOCK_METHOD(nhal_result_t, nhal_can_receive, (struct nhal_can_context *ctx, uint8_t fifo, nhal_can_frame_t *frames,
+                                                  size_t max_frames, size_t *received, uint32_t timeout_ms));
+    MOCK_METHOD(nhal_result_t, nhal_can_get_stats, (struct nhal_can_context *ctx, struct nhal_can_stats *stats));
+
+    // Instance the C interface dispatches to: the mock bound to the calling
+    // thread (see NhalMockScope), or the process-wide singleton otherwise
+    static NhalCanMock& instance() {
+        NhalCanMock *bound = NhalMockBinding<NhalCanMock>::current();
+        if (bound != nullptr) {
+            return *bound;
+        }
+        static NhalCanMock mock;
+        return mock;
+    }
+};
+
+#endif /* NHAL_CAN_MOCK_HPP */
@@ -7,7 +7,9 @@
 #define NHAL_COMMON_MOCK_HPP
 
 #include <gmock/gmock.h>
+#include "nhal_mock_scope.hpp"
 #include "nhal_common.h"
+#include "nhal_ticks.h"
 
 /**
  * @brief Mock class for common NHAL timing functions
@@ -29,6 +31,9 @@
  *     EXPECT_EQ(NHAL_ERR_TIMEOUT, dht11_read_sensor(&sensor_ctx));
  * }
  * @endcode
+ *
+ * @note While a NhalVirtualClock is bound to the calling thread, timing calls
+ *       are served by the clock and never reach this mock.
  */
 class NhalCommonMock {
 public:
@@ -38,8 +43,17 @@ public:
     MOCK_METHOD(uint64_t, nhal_get_timestamp_microseconds, ());
     MOCK_METHOD(uint32_t, nhal_get_timestamp_milliseconds, ());
 
-    // Singleton instance for C interface
+    // High-resolution tick counter
+    MOCK_METHOD(uint64_t, nhal_get_timestamp_ticks, ());
+    MOCK_METHOD(nhal_result_t, nhal_get_tick_calibration, (struct nhal_tick_calibration *cal));
+
+    // Instance the C interface dispatches to: the mock bound to the calling
+    // thread (see NhalMockScope), or the process-wide singleton otherwise
     static NhalCommonMock& instance() {
+        NhalCommonMock *bound = NhalMockBinding<NhalCommonMock>::current();
+        if (bound != nullptr) {
+            return *bound;
+        }
         static NhalCommonMock mock;
         return mock;
     }
@@ -7,8 +7,11 @@
 #define NHAL_I2C_MOCK_HPP
 
 #include <gmock/gmock.h>
+#include "nhal_mock_scope.hpp"
 #include "nhal_i2c_master.h"
+#include "nhal_i2c_config_image.h"
 #include "nhal_i2c_transfer.h"
+#include "nhal_i2c_transfer_packed.h"
 
 /**
  * @brief Mock class for I2C HAL interface
@@ -26,9 +29,19 @@ public:
 
     // Transfer operations
     MOCK_METHOD(nhal_result_t, nhal_i2c_master_perform_transfer, (struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, nhal_i2c_transfer_op_t *ops, size_t num_ops));
+    MOCK_METHOD(nhal_result_t, nhal_i2c_master_perform_transfer_packed, (struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const struct nhal_i2c_packed_ops *ops));
 
-    // Singleton instance for C interface
+    // Configuration image operations
+    MOCK_METHOD(nhal_result_t, nhal_i2c_master_config_image_build, (struct nhal_i2c_context *ctx, const struct nhal_i2c_config *config, struct nhal_i2c_config_image *image));
+    MOCK_METHOD(nhal_result_t, nhal_i2c_master_config_image_apply, (struct nhal_i2c_context *ctx, const struct nhal_i2c_config_image *image));
+
+    // Instance the C interface dispatches to: the mock bound to the calling
+    // thread (see NhalMockScope), or the process-wide singleton otherwise
     static NhalI2cMock& instance() {
+        NhalI2cMock *bound = NhalMockBinding<NhalI2cMock>::current();
+        if (bound != nullptr) {
+            return *bound;
+        }
         static NhalI2cMock mock;
         return mock;
     }
@@ -0,0 +1,80 @@
+/**
+ * @file nhal_mock_scope.hpp
+ * @brief Per-thread mock instances for the NHAL C interface bridges
+ */
+
+#ifndef NHAL_MOCK_SCOPE_HPP
+#define NHAL_MOCK_SCOPE_HPP
+
+/**
+ * @brief Binds an existing mock object to the calling thread
+ *
+ * While the binding is alive, every NHAL C function of that mock's interface
+ * called from this thread is dispatched to the bound mock instead of the
+ * process-wide MockT::instance() default. Bindings nest; destroying one
+ * restores the previous mock of the thread.
+ *
+ * Use it to share a test's mock with worker threads spawned by the code
+ * under test:
+ * @code
+ * std::thread worker([&] {
+ *     NhalMockBinding<NhalUartMock> bind(uart_scope.mock());
+ *     driver_rx_loop(&driver);
+ * });
+ * @endcode
+ */
+template <typename MockT>
+class NhalMockBinding {
+public:
+    explicit NhalMockBinding(MockT &mock) : previous_(current()) {
+        current() = &mock;
+    }
+
+    ~NhalMockBinding() {
+        current() = previous_;
+    }
+
+    NhalMockBinding(const NhalMockBinding &) = delete;
+    NhalMockBinding &operator=(const NhalMockBinding &) = delete;
+
+    /** @brief Mock bound to the calling thread, nullptr if none */
+    static MockT *&current() {
+        static thread_local MockT *mock = nullptr;
+        return mock;
+    }
+
+private:
+    MockT *previous_;
+};
+
+/**
+ * @brief Owns a mock object and binds it to the calling thread
+ *
+ * Gives every test its own independent mock, so test shards can run in
+ * parallel threads of one process without sharing mock state.
+ *
+ * @tparam MockT Mock class (e.g.: NhalI2cMock)
+ * @tparam HolderT Mock object actually instantiated, e.g.: testing::NiceMock<MockT>
+ *
+ * @code
+ * TEST(Bme280Test, ReadsChipId) {
+ *     NhalMockScope<NhalI2cMock> i2c;
+ *     EXPECT_CALL(i2c.mock(), nhal_i2c_master_write_read_reg(_, _, _, _, _, _))
+ *         .WillOnce(Return(NHAL_OK));
+ *     EXPECT_EQ(NHAL_OK, bme280_init(&sensor));
+ * }
+ * @endcode
+ */
+template <typename MockT, typename HolderT = MockT>
+class NhalMockScope {
+public:
+    NhalMockScope() : mock_(), binding_(mock_) {}
+
+    HolderT &mock() { return mock_; }
+
+private:
+    HolderT mock_;
+    NhalMockBinding<MockT> binding_;
+};
+
+#endif /* NHAL_MOCK_SCOPE_HPP */
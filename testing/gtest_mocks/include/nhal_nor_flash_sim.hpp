@@ -0,0 +1,194 @@
+/**
+ * @file nhal_nor_flash_sim.hpp
+ * @brief Simulated serial NOR flash for QSPI tests
+ */
+
+#ifndef NHAL_NOR_FLASH_SIM_HPP
+#define NHAL_NOR_FLASH_SIM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nhal_qspi.h"
+#include "nhal_spi_types.h"
+
+/**
+ * @brief Serial NOR flash model behind the QSPI interface
+ *
+ * Models a JEDEC-style NOR flash (Winbond/Macronix command set): status
+ * register with write-enable latch, page program with page wrap-around, 4 KiB
+ * sector / 64 KiB block / chip erase, JEDEC ID, and the single, dual, quad,
+ * QPI (4-4-4) and DTR read commands. Program operations can only clear bits,
+ * like real NOR cells.
+ *
+ * Every command is checked against the datasheet sequencing: phase widths,
+ * address bytes, mode + dummy cycles, DDR and data direction. Violations are
+ * counted and reported as NHAL_ERR_INVALID_ARG, so driver sequencing bugs
+ * surface as test failures. Stats::bus_cycles accumulates the QSPI clock
+ * cycles every command would take on the wire, to compare command modes
+ * (1-1-1 vs 1-4-4 vs 4-4-4, SDR vs DDR) on host. With set_bus_clock_hz(),
+ * those cycles also take time on the bound NhalVirtualClock.
+ *
+ * In memory-mapped mode the controller turns every access into a read
+ * command of its own: mapped_read() models such a burst with the command
+ * given to memory_map_enable(), counting it in the stats and on the clock.
+ * Plain loads through the returned base pointer bypass the model.
+ *
+ * Program and erase operations take the time given by Timing. While a
+ * NhalVirtualClock is bound to the calling thread, the status register reports
+ * WIP until that time has elapsed on the virtual clock, commands issued
+ * meanwhile are rejected with NHAL_ERR_BUSY, and poll_status() advances the
+ * clock to the end of the operation. Without a clock, operations complete
+ * instantly. Either way the busy time is accumulated in Stats::busy_ns, and
+ * erase cycles are counted per sector to check wear leveling.
+ *
+ * The flash can also sit behind the SPI master mock (single line commands
+ * only), with a command and its data in one nhal_spi_master_write() or
+ * nhal_spi_master_write_read() call, as the nhal_spi_nor.h block device does.
+ *
+ * The handler signatures match the C interface so they can be used directly
+ * as mock actions:
+ * @code
+ * NhalNorFlashSim flash(16 * 1024 * 1024);
+ * NhalQspiMock &qspi = NhalQspiMock::instance();
+ * ON_CALL(qspi, nhal_qspi_command(_, _)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::command));
+ * ON_CALL(qspi, nhal_qspi_write(_, _, _, _)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::write));
+ * ON_CALL(qspi, nhal_qspi_read(_, _, _, _)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::read));
+ * ON_CALL(qspi, nhal_qspi_poll_status(_, _, _, _, _)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::poll_status));
+ * ON_CALL(qspi, nhal_qspi_memory_map_enable(_, _, _)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::memory_map_enable));
+ * ON_CALL(qspi, nhal_qspi_memory_map_disable(_)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::memory_map_disable));
+ *
+ * NhalSpiMock &spi = NhalSpiMock::instance();
+ * ON_CALL(spi, nhal_spi_master_write(_, _, _)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::spi_write));
+ * ON_CALL(spi, nhal_spi_master_write_read(_, _, _, _, _)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::spi_write_read));
+ * @endcode
+ */
+class NhalNorFlashSim {
+public:
+    static const size_t PAGE_SIZE = 256;
+    static const size_t SECTOR_SIZE = 4096;
+    static const size_t BLOCK_SIZE = 65536;
+
+    static const uint8_t STATUS_WIP = 0x01;   /**< Write in progress */
+    static const uint8_t STATUS_WEL = 0x02;   /**< Write enable latch */
+
+    struct Stats {
+        uint32_t commands;           /**< Commands accepted. */
+        uint32_t protocol_errors;    /**< Commands rejected for wrong sequencing. */
+        uint32_t ignored_writes;     /**< Program/erase commands ignored because WEL was not set. */
+        uint64_t bytes_read;
+        uint64_t bytes_programmed;
+        uint32_t sector_erases;
+        uint32_t block_erases;
+        uint32_t chip_erases;
+        uint64_t bus_cycles;         /**< QSPI clock cycles of all accepted commands. */
+        uint32_t busy_violations;    /**< Commands rejected because a program/erase was in progress. */
+        uint32_t program_conflicts;  /**< Programmed bytes trying to set bits that were not erased. */
+        uint64_t busy_ns;            /**< Total program/erase time. */
+        uint32_t map_sessions;       /**< Successful memory_map_enable() calls. */
+        uint64_t mapped_reads;       /**< Bursts read through mapped_read(). */
+        uint64_t mapped_bytes_read;
+    };
+
+    struct Timing {
+        uint64_t page_program_ns;
+        uint64_t sector_erase_ns;
+        uint64_t block_erase_ns;
+        uint64_t chip_erase_ns;
+    };
+
+    /**
+     * @param size Memory size in bytes; an erase of a last sector or block cut short by the end of memory stops there
+     * @param jedec_id Manufacturer, memory type and capacity bytes
+     */
+    explicit NhalNorFlashSim(size_t size = 16u * 1024u * 1024u, uint32_t jedec_id = 0xEF4018);
+
+    // Handlers matching the C interface
+    nhal_result_t command(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd);
+    nhal_result_t write(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd, const uint8_t *data, size_t len);
+    nhal_result_t read(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd, uint8_t *data, size_t len);
+    nhal_result_t poll_status(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd,
+                              uint8_t mask, uint8_t match, uint32_t timeout_ms);
+    nhal_result_t memory_map_enable(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *read_cmd,
+                                    const volatile uint8_t **base);
+    nhal_result_t memory_map_disable(struct nhal_qspi_context *ctx);
+
+    /**
+     * @brief Read through the memory-mapped window as one controller burst
+     * @return NHAL_ERR_NOT_CONFIGURED outside memory-mapped mode
+     */
+    nhal_result_t mapped_read(uint32_t address, uint8_t *data, size_t len);
+
+    // Handlers matching the SPI master interface
+    nhal_result_t spi_write(struct nhal_spi_context *ctx, const uint8_t *data, size_t len);
+    nhal_result_t spi_write_read(struct nhal_spi_context *ctx, const uint8_t *tx_data, size_t tx_len,
+                                 uint8_t *rx_data, size_t rx_len);
+
+    /** @brief Program/erase durations (typical datasheet values by default) */
+    void set_timing(const Timing &timing) { timing_ = timing; }
+
+    /** @brief QSPI clock the bus cycles are charged at on the virtual clock, 0 (default) for none */
+    void set_bus_clock_hz(uint32_t hz) { bus_clock_hz_ = hz; }
+
+    /** @brief Erase cycles endured by the sector holding address */
+    uint32_t erase_count(uint32_t address) const { return erase_counts_[(address % memory_.size()) / SECTOR_SIZE]; }
+    uint32_t max_erase_count() const;
+
+    /** @brief Preload memory content, bypassing program semantics */
+    void load(uint32_t address, const uint8_t *data, size_t len);
+
+    const uint8_t *data() const { return memory_.data(); }
+    size_t size() const { return memory_.size(); }
+    uint8_t status() const;
+    bool qpi_mode() const { return qpi_; }
+    bool mapped() const { return mapped_; }
+
+    const Stats &stats() const { return stats_; }
+    void reset_stats();
+
+private:
+    enum Op {
+        OP_READ_ID, OP_READ_STATUS, OP_WRITE_ENABLE, OP_WRITE_DISABLE,
+        OP_READ, OP_PROGRAM, OP_ERASE_SECTOR, OP_ERASE_BLOCK, OP_ERASE_CHIP,
+        OP_ENTER_QPI, OP_EXIT_QPI,
+    };
+
+    enum Direction { DIR_NONE, DIR_WRITE, DIR_READ };
+
+    struct Opcode {
+        uint8_t instruction;
+        Op op;
+        uint8_t address_width;       /**< Lines, 0 if no address phase. */
+        uint8_t data_width;          /**< Lines, 0 if no data phase. */
+        uint8_t wait_cycles;         /**< Mode (alternate) + dummy cycles. */
+        bool ddr;
+    };
+
+    const Opcode *find_opcode(uint16_t instruction) const;
+    bool decode(const nhal_qspi_command_t *cmd, Direction dir, size_t len, Opcode *decoded) const;
+    bool busy() const;
+    void start_busy(uint64_t duration_ns);
+    uint64_t command_cycles(const nhal_qspi_command_t *cmd, const Opcode &opcode, size_t len) const;
+    void charge_bus(uint64_t cycles);
+    nhal_result_t execute(const nhal_qspi_command_t *cmd, Direction dir, const uint8_t *tx, uint8_t *rx, size_t len);
+
+    /** @brief Apply a decoded operation to the memory array */
+    void perform(Op op, uint32_t address, const uint8_t *tx, uint8_t *rx, size_t len);
+
+    std::vector<uint8_t> memory_;
+    std::vector<uint32_t> erase_counts_;
+    Timing timing_;
+    uint64_t busy_until_ns_;
+    uint32_t jedec_id_;
+    uint8_t address_bytes_;
+    uint8_t status_;
+    bool qpi_;
+    bool mapped_;
+    nhal_qspi_command_t map_cmd_;
+    Opcode map_opcode_;
+    uint32_t bus_clock_hz_;
+    Stats stats_;
+};
+
+#endif /* NHAL_NOR_FLASH_SIM_HPP */
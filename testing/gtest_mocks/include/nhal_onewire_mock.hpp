@@ -0,0 +1,41 @@
+/**
+ * @file nhal_onewire_mock.hpp
+ * @brief Google Mock implementation for 1-Wire HAL interface
+ */
+
+#ifndef NHAL_ONEWIRE_MOCK_HPP
+#define NHAL_ONEWIRE_MOCK_HPP
+
+#include <gmock/gmock.h>
+#include "nhal_mock_scope.hpp"
+#include "nhal_onewire.h"
+
+/**
+ * @brief Mock class for 1-Wire HAL interface
+ */
+class NhalOnewireMock {
+public:
+    // 1-Wire operations
+    MOCK_METHOD(nhal_result_t, nhal_onewire_init, (struct nhal_onewire_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_onewire_deinit, (struct nhal_onewire_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_onewire_set_config, (struct nhal_onewire_context *ctx, struct nhal_onewire_config *config));
+    MOCK_METHOD(nhal_result_t, nhal_onewire_get_config, (struct nhal_onewire_context *ctx, struct nhal_onewire_config *config));
+    MOCK_METHOD(nhal_result_t, nhal_onewire_reset, (struct nhal_onewire_context *ctx, bool *presence));
+    MOCK_METHOD(nhal_result_t, nhal_onewire_write_bit, (struct nhal_onewire_context *ctx, bool bit));
+    MOCK_METHOD(nhal_result_t, nhal_onewire_read_bit, (struct nhal_onewire_context *ctx, bool *bit));
+    MOCK_METHOD(nhal_result_t, nhal_onewire_write, (struct nhal_onewire_context *ctx, const uint8_t *data, size_t len));
+    MOCK_METHOD(nhal_result_t, nhal_onewire_read, (struct nhal_onewire_context *ctx, uint8_t *data, size_t len));
+
+    // Instance the C interface dispatches to: the mock bound to the calling
+    // thread (see NhalMockScope), or the process-wide singleton otherwise
+    static NhalOnewireMock& instance() {
+        NhalOnewireMock *bound = NhalMockBinding<NhalOnewireMock>::current();
+        if (bound != nullptr) {
+            return *bound;
+        }
+        static NhalOnewireMock mock;
+        return mock;
+    }
+};
+
+#endif /* NHAL_ONEWIRE_MOCK_HPP */
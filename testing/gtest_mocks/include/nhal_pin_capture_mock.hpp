@@ -0,0 +1,48 @@
+/**
+ * @file nhal_pin_capture_mock.hpp
+ * @brief Google Mock implementation for Pin Input Capture HAL interface
+ */
+
+#ifndef NHAL_PIN_CAPTURE_MOCK_HPP
+#define NHAL_PIN_CAPTURE_MOCK_HPP
+
+#include <gmock/gmock.h>
+#include "nhal_mock_scope.hpp"
+#include "nhal_pin_capture.h"
+
+/**
+ * @brief Mock class for Pin Input Capture HAL interface
+ *
+ * Combine with NhalPulseTrain to feed deterministic measurements:
+ * @code
+ * NhalPulseTrain train(1000, 250);   // 25% duty cycle, 1000 tick period
+ * EXPECT_CALL(NhalPinCaptureMock::instance(), nhal_pin_capture_read(_, _, _, _))
+ *     .WillRepeatedly(Invoke(&train, &NhalPulseTrain::read));
+ * @endcode
+ */
+class NhalPinCaptureMock {
+public:
+    // Pin input capture operations
+    MOCK_METHOD(nhal_result_t, nhal_pin_capture_init, (struct nhal_pin_capture_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_pin_capture_deinit, (struct nhal_pin_capture_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_pin_capture_set_config, (struct nhal_pin_capture_context *ctx, struct nhal_pin_capture_config *config));
+    MOCK_METHOD(nhal_result_t, nhal_pin_capture_get_config, (struct nhal_pin_capture_context *ctx, struct nhal_pin_capture_config *config));
+    MOCK_METHOD(nhal_result_t, nhal_pin_capture_get_timer_frequency, (struct nhal_pin_capture_context *ctx, uint32_t *frequency_hz));
+    MOCK_METHOD(nhal_result_t, nhal_pin_capture_start, (struct nhal_pin_capture_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_pin_capture_stop, (struct nhal_pin_capture_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_pin_capture_read, (struct nhal_pin_capture_context *ctx, nhal_pin_capture_sample_t *samples, size_t max_samples, size_t *num_samples));
+    MOCK_METHOD(nhal_result_t, nhal_pin_capture_get_stats, (struct nhal_pin_capture_context *ctx, struct nhal_pin_capture_stats *stats));
+
+    // Instance the C interface dispatches to: the mock bound to the calling
+    // thread (see NhalMockScope), or the process-wide singleton otherwise
+    static NhalPinCaptureMock& instance() {
+        NhalPinCaptureMock *bound = NhalMockBinding<NhalPinCaptureMock>::current();
+        if (bound != nullptr) {
+            return *bound;
+        }
+        static NhalPinCaptureMock mock;
+        return mock;
+    }
+};
+
+#endif /* NHAL_PIN_CAPTURE_MOCK_HPP */
@@ -7,10 +7,32 @@
 #define NHAL_PIN_MOCK_HPP
 
 #include <gmock/gmock.h>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include "nhal_mock_scope.hpp"
 #include "nhal_pin.h"
+#include "nhal_pin_group.h"
 
 /**
  * @brief Mock class for Pin HAL interface
+ *
+ * Besides the mocked calls, the C bridge records every successful interrupt
+ * registration, enable and disable, so tests can inject edges that fire the
+ * driver's nhal_pin_callback_t as the hardware would. Interrupts start
+ * disabled after nhal_pin_set_interrupt_config() until nhal_pin_interrupt_enable().
+ *
+ * @code
+ * TEST(ButtonTest, CountsPresses) {
+ *     NhalMockScope<NhalPinMock, NiceMock<NhalPinMock>> pin;
+ *     ON_CALL(pin.mock(), nhal_pin_set_interrupt_config(_, _, _, _)).WillByDefault(Return(NHAL_OK));
+ *     ON_CALL(pin.mock(), nhal_pin_interrupt_enable(_)).WillByDefault(Return(NHAL_OK));
+ *     button_init(&button, &button_pin_ctx);
+ *
+ *     EXPECT_EQ(100000u, pin.mock().inject_pulses(&button_pin_ctx, 100000));
+ *     EXPECT_EQ(100000u, button_press_count(&button));
+ * }
+ * @endcode
  */
 class NhalPinMock {
 public:
@@ -21,14 +43,71 @@ public:
     MOCK_METHOD(nhal_result_t, nhal_pin_get_config, (struct nhal_pin_context *ctx, struct nhal_pin_config *config));
     MOCK_METHOD(nhal_result_t, nhal_pin_set_state, (struct nhal_pin_context *ctx, nhal_pin_state_t value));
     MOCK_METHOD(nhal_result_t, nhal_pin_get_state, (struct nhal_pin_context *ctx, nhal_pin_state_t *value));
-    MOCK_METHOD(nhal_result_t, nhal_pin_set_callback, (struct nhal_pin_context *ctx, nhal_pin_callback_t callback));
     MOCK_METHOD(nhal_result_t, nhal_pin_set_direction, (struct nhal_pin_context *ctx, nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode));
 
-    // Singleton instance for C interface
+    // Pin interrupt operations
+    MOCK_METHOD(nhal_result_t, nhal_pin_set_interrupt_config, (struct nhal_pin_context *ctx, nhal_pin_int_trigger_t trigger, nhal_pin_callback_t callback, void *user_data));
+    MOCK_METHOD(nhal_result_t, nhal_pin_interrupt_enable, (struct nhal_pin_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_pin_interrupt_disable, (struct nhal_pin_context *ctx));
+
+    // Pin group operations
+    MOCK_METHOD(nhal_result_t, nhal_pin_group_init, (struct nhal_pin_group_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_pin_group_deinit, (struct nhal_pin_group_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_pin_group_set_direction, (struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode));
+    MOCK_METHOD(nhal_result_t, nhal_pin_group_write, (struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, nhal_pin_group_mask_t values));
+    MOCK_METHOD(nhal_result_t, nhal_pin_group_read, (struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t *values));
+    MOCK_METHOD(nhal_result_t, nhal_pin_group_run_sequence, (struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, const nhal_pin_group_mask_t *out_values, nhal_pin_group_mask_t *in_values, size_t count, uint32_t step_ns));
+
+    // Edge injection
+
+    /**
+     * @brief Simulate the pin changing to a new level
+     *
+     * Runs the registered callback (in the calling thread) if the pin's
+     * interrupt is enabled and its trigger matches the transition.
+     *
+     * @return true if the callback ran
+     */
+    bool inject_edge(struct nhal_pin_context *ctx, nhal_pin_state_t level);
+
+    /**
+     * @brief Simulate count low-high-low pulses on the pin
+     * @return Number of callback invocations
+     */
+    size_t inject_pulses(struct nhal_pin_context *ctx, size_t count);
+
+    /** @brief Whether the pin has an enabled interrupt registration */
+    bool interrupt_enabled(struct nhal_pin_context *ctx);
+
+    /** @brief Forget every recorded interrupt registration */
+    void clear_interrupts();
+
+    // Bookkeeping used by the C bridge
+    void record_interrupt_config(struct nhal_pin_context *ctx, nhal_pin_int_trigger_t trigger, nhal_pin_callback_t callback, void *user_data);
+    void record_interrupt_enabled(struct nhal_pin_context *ctx, bool enabled);
+
+    // Instance the C interface dispatches to: the mock bound to the calling
+    // thread (see NhalMockScope), or the process-wide singleton otherwise
     static NhalPinMock& instance() {
+        NhalPinMock *bound = NhalMockBinding<NhalPinMock>::current();
+        if (bound != nullptr) {
+            return *bound;
+        }
         static NhalPinMock mock;
         return mock;
     }
+
+private:
+    struct InterruptRegistration {
+        nhal_pin_int_trigger_t trigger;
+        nhal_pin_callback_t callback;
+        void *user_data;
+        bool enabled;
+        nhal_pin_state_t level;
+    };
+
+    std::mutex interrupts_lock_;
+    std::map<struct nhal_pin_context *, InterruptRegistration> interrupts_;
 };
 
 #endif /* NHAL_PIN_MOCK_HPP */
\ No newline at end of file
@@ -0,0 +1,157 @@
+/**
+ * @file nhal_pulse_train.hpp
+ * @brief Deterministic pulse train generator for Pin Input Capture tests
+ */
+
+#ifndef NHAL_PULSE_TRAIN_HPP
+#define NHAL_PULSE_TRAIN_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "nhal_pin_capture.h"
+
+/**
+ * @brief Simulated input signal for the Pin Input Capture interface
+ *
+ * Generates a reproducible sequence of pulse measurements with an optional
+ * bounded jitter (driven by a seeded xorshift generator, so every run yields
+ * the same sequence). Every call to read() simulates the arrival of
+ * pulses_per_read new pulses; pulses that do not fit in the simulated
+ * hardware buffer are dropped and counted as overruns.
+ *
+ * Like the hardware, only NHAL_PIN_CAPTURE_EDGE_BOTH measures the pulse
+ * width: in the single edge modes high_ticks is reported as 0. With a
+ * prescaler of N, one measurement is made every N pulses and its period spans
+ * all N of them, while edge_count still counts every edge on the pin.
+ *
+ * The read(), get_stats() and set_config() signatures match the C interface
+ * so they can be used directly as mock actions:
+ * @code
+ * NhalPulseTrain train(1000, 250, 5);   // period 1000, width 250, +/-5 ticks jitter
+ * train.set_pulses_per_read(64);
+ * EXPECT_CALL(NhalPinCaptureMock::instance(), nhal_pin_capture_read(_, _, _, _))
+ *     .WillRepeatedly(Invoke(&train, &NhalPulseTrain::read));
+ * @endcode
+ */
+class NhalPulseTrain {
+public:
+    NhalPulseTrain(uint32_t period_ticks, uint32_t high_ticks, uint32_t jitter_ticks = 0, uint32_t seed = 1)
+        : period_ticks_(period_ticks), high_ticks_(high_ticks), jitter_ticks_(jitter_ticks),
+          rng_state_(seed != 0 ? seed : 1), edge_(NHAL_PIN_CAPTURE_EDGE_BOTH), prescaler_(1), pulses_per_read_(1),
+          buffer_capacity_(SIZE_MAX),
+          pending_(0), phase_(0), edge_count_(0), overrun_count_(0) {}
+
+    /** @brief Number of new pulses arriving between two reads */
+    void set_pulses_per_read(size_t pulses) { pulses_per_read_ = pulses; }
+
+    /** @brief Number of measurements the simulated hardware can buffer */
+    void set_buffer_capacity(size_t capacity) { buffer_capacity_ = capacity; }
+
+    /** @brief Edges captured by the simulated hardware */
+    void set_edge(nhal_pin_capture_edge_t edge) { edge_ = edge; }
+
+    /** @brief Capture one out of every prescaler periods (0 or 1: all of them) */
+    void set_prescaler(uint16_t prescaler) {
+        prescaler_ = prescaler > 1 ? prescaler : 1;
+        phase_ = 0;
+    }
+
+    /** @brief Generate the next pulse measurement of the train */
+    nhal_pin_capture_sample_t next() {
+        nhal_pin_capture_sample_t sample;
+        uint32_t last_period = 0;
+        sample.period_ticks = 0;
+        for (uint16_t i = 0; i < prescaler_; i++) {
+            last_period = apply_jitter(period_ticks_);
+            sample.period_ticks += last_period;
+        }
+        if (edge_ != NHAL_PIN_CAPTURE_EDGE_BOTH) {
+            sample.high_ticks = 0;
+            return sample;
+        }
+        sample.high_ticks = apply_jitter(high_ticks_);
+        if (sample.high_ticks >= last_period) {
+            sample.high_ticks = last_period - 1;
+        }
+        return sample;
+    }
+
+    nhal_result_t read(struct nhal_pin_capture_context *ctx, nhal_pin_capture_sample_t *samples,
+                       size_t max_samples, size_t *num_samples) {
+        (void)ctx;
+        if (samples == nullptr || num_samples == nullptr) {
+            return NHAL_ERR_INVALID_ARG;
+        }
+        arrive(pulses_per_read_);
+        size_t count = pending_ < max_samples ? pending_ : max_samples;
+        for (size_t i = 0; i < count; i++) {
+            samples[i] = next();
+        }
+        pending_ -= count;
+        *num_samples = count;
+        return NHAL_OK;
+    }
+
+    nhal_result_t get_stats(struct nhal_pin_capture_context *ctx, struct nhal_pin_capture_stats *stats) {
+        (void)ctx;
+        if (stats == nullptr) {
+            return NHAL_ERR_INVALID_ARG;
+        }
+        stats->edge_count = edge_count_;
+        stats->overrun_count = overrun_count_;
+        return NHAL_OK;
+    }
+
+    nhal_result_t set_config(struct nhal_pin_capture_context *ctx, struct nhal_pin_capture_config *config) {
+        (void)ctx;
+        if (config == nullptr || config->edge >= NHAL_PIN_CAPTURE_EDGE_TOTAL_NUM) {
+            return NHAL_ERR_INVALID_ARG;
+        }
+        edge_ = config->edge;
+        set_prescaler(config->prescaler);
+        return NHAL_OK;
+    }
+
+private:
+    void arrive(size_t pulses) {
+        uint64_t edges_per_pulse = edge_ == NHAL_PIN_CAPTURE_EDGE_BOTH ? 2 : 1;
+        edge_count_ += edges_per_pulse * static_cast<uint64_t>(pulses);
+        phase_ += pulses;
+        pulses = phase_ / prescaler_;
+        phase_ %= prescaler_;
+        size_t room = buffer_capacity_ - pending_;
+        if (pulses > room) {
+            overrun_count_ += static_cast<uint32_t>(pulses - room);
+            pulses = room;
+        }
+        pending_ += pulses;
+    }
+
+    uint32_t apply_jitter(uint32_t ticks) {
+        if (jitter_ticks_ == 0) {
+            return ticks;
+        }
+        rng_state_ ^= rng_state_ << 13;
+        rng_state_ ^= rng_state_ >> 17;
+        rng_state_ ^= rng_state_ << 5;
+        int64_t offset = static_cast<int64_t>(rng_state_ % (2 * jitter_ticks_ + 1)) - jitter_ticks_;
+        int64_t jittered = static_cast<int64_t>(ticks) + offset;
+        return jittered > 1 ? static_cast<uint32_t>(jittered) : 1;
+    }
+
+    uint32_t period_ticks_;
+    uint32_t high_ticks_;
+    uint32_t jitter_ticks_;
+    uint32_t rng_state_;
+    nhal_pin_capture_edge_t edge_;
+    uint16_t prescaler_;
+    size_t pulses_per_read_;
+    size_t buffer_capacity_;
+    size_t pending_;
+    size_t phase_;                   /**< Pulses since the last captured one. */
+    uint64_t edge_count_;
+    uint32_t overrun_count_;
+};
+
+#endif /* NHAL_PULSE_TRAIN_HPP */
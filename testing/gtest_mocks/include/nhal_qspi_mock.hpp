@@ -0,0 +1,44 @@
+/**
+ * @file nhal_qspi_mock.hpp
+ * @brief Google Mock implementation for QSPI HAL interface
+ */
+
+#ifndef NHAL_QSPI_MOCK_HPP
+#define NHAL_QSPI_MOCK_HPP
+
+#include <gmock/gmock.h>
+#include "nhal_mock_scope.hpp"
+#include "nhal_qspi.h"
+
+/**
+ * @brief Mock class for QSPI HAL interface
+ */
+class NhalQspiMock {
+public:
+    // QSPI operations
+    MOCK_METHOD(nhal_result_t, nhal_qspi_init, (struct nhal_qspi_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_qspi_deinit, (struct nhal_qspi_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_qspi_set_config, (struct nhal_qspi_context *ctx, struct nhal_qspi_config *config));
+    MOCK_METHOD(nhal_result_t, nhal_qspi_get_config, (struct nhal_qspi_context *ctx, struct nhal_qspi_config *config));
+    MOCK_METHOD(nhal_result_t, nhal_qspi_command, (struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd));
+    MOCK_METHOD(nhal_result_t, nhal_qspi_write, (struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd, const uint8_t *data, size_t len));
+    MOCK_METHOD(nhal_result_t, nhal_qspi_read, (struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd, uint8_t *data, size_t len));
+    MOCK_METHOD(nhal_result_t, nhal_qspi_poll_status, (struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd, uint8_t mask, uint8_t match, uint32_t timeout_ms));
+
+    // Memory-mapped mode operations
+    MOCK_METHOD(nhal_result_t, nhal_qspi_memory_map_enable, (struct nhal_qspi_context *ctx, const nhal_qspi_command_t *read_cmd, const volatile uint8_t **base));
+    MOCK_METHOD(nhal_result_t, nhal_qspi_memory_map_disable, (struct nhal_qspi_context *ctx));
+
+    // Instance the C interface dispatches to: the mock bound to the calling
+    // thread (see NhalMockScope), or the process-wide singleton otherwise
+    static NhalQspiMock& instance() {
+        NhalQspiMock *bound = NhalMockBinding<NhalQspiMock>::current();
+        if (bound != nullptr) {
+            return *bound;
+        }
+        static NhalQspiMock mock;
+        return mock;
+    }
+};
+
+#endif /* NHAL_QSPI_MOCK_HPP */
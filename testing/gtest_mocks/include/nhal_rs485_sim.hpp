@@ -0,0 +1,125 @@
+/**
+ * @file nhal_rs485_sim.hpp
+ * @brief Simulated RS-485 half-duplex link for Modbus RTU style master tests
+ */
+
+#ifndef NHAL_RS485_SIM_HPP
+#define NHAL_RS485_SIM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "nhal_uart_rs485.h"
+#include "nhal_virtual_clock.hpp"
+
+/**
+ * @brief RS-485 master UART and its slave behind the UART interface
+ *
+ * Models what nhal_uart_rs485.h asks of an implementation, in virtual time:
+ * - a transaction first waits for the inter-frame silence since the end of
+ *   the last frame on the bus, whoever sent it;
+ * - DE is asserted de_assert_bits before the first start bit and released
+ *   de_release_bits after the last stop bit;
+ * - the slave answers once it has seen the inter-frame silence after the
+ *   request, plus its own response delay; the response is complete when the
+ *   line has then been silent for the inter-frame time again.
+ * Characters take nhal_uart_char_bits() bit times each, back to back.
+ *
+ * Every line and DE change is recorded in events() with its virtual time, so
+ * tests can check the turnaround and the gaps. A slave starting to drive the
+ * bus while the master still holds DE is counted as a collision.
+ *
+ * Time comes from the NhalVirtualClock bound to the calling thread, which
+ * transaction() advances to the instant it returns; without a clock,
+ * transaction() returns NHAL_ERR_NOT_INITIALIZED.
+ *
+ * The handler signatures match the C interface so they can be used directly
+ * as mock actions:
+ * @code
+ * NhalVirtualClock clock;
+ * NhalRs485Sim link;
+ * link.set_slave([](const std::vector<uint8_t> &request) { return modbus_slave.answer(request); });
+ * NhalUartMock &uart = NhalUartMock::instance();
+ * ON_CALL(uart, nhal_uart_set_config(_, _)).WillByDefault(Invoke(&link, &NhalRs485Sim::set_config));
+ * ON_CALL(uart, nhal_uart_rs485_set_config(_, _)).WillByDefault(Invoke(&link, &NhalRs485Sim::rs485_set_config));
+ * ON_CALL(uart, nhal_uart_rs485_transaction(_, _, _, _, _, _, _))
+ *     .WillByDefault(Invoke(&link, &NhalRs485Sim::transaction));
+ *
+ * poll_meters_for(std::chrono::seconds(1));       // Runs in virtual time
+ * EXPECT_EQ(0u, link.collisions());
+ * @endcode
+ */
+class NhalRs485Sim {
+public:
+    /** @brief Answers a request frame, no bytes for no answer */
+    typedef std::function<std::vector<uint8_t>(const std::vector<uint8_t> &request)> Slave;
+
+    enum EventKind {
+        DE_ASSERT,
+        TX_START,       /**< First start bit of the request. */
+        TX_END,         /**< End of the last stop bit of the request. */
+        DE_RELEASE,
+        RX_START,       /**< First start bit of the response. */
+        RX_END,         /**< End of the last stop bit of the response. */
+        FRAME_DONE      /**< Inter-frame silence after the response seen: transaction returns. */
+    };
+
+    struct Event {
+        uint64_t time_ns;
+        EventKind kind;
+    };
+
+    NhalRs485Sim();
+
+    /** @brief Slave on the bus and its extra delay before answering, on top of the inter-frame silence */
+    void set_slave(Slave slave, uint32_t response_delay_us = 0) {
+        slave_ = std::move(slave);
+        response_delay_ns_ = (uint64_t)response_delay_us * 1000u;
+    }
+
+    // Handlers matching the C interface
+    nhal_result_t set_config(struct nhal_uart_context *ctx, struct nhal_uart_config *cfg);
+    nhal_result_t rs485_set_config(struct nhal_uart_context *ctx, const struct nhal_uart_rs485_config *rs485);
+    nhal_result_t transaction(struct nhal_uart_context *ctx, const uint8_t *request, size_t request_len,
+                              uint8_t *response, size_t response_max, size_t *response_len, uint32_t timeout_ms);
+
+    /** @brief Duration of a number of bit times at the configured baud rate, rounded up */
+    uint64_t bits_to_ns(uint64_t bits) const;
+
+    /** @brief Inter-frame silence of the current configuration, in ns */
+    uint64_t inter_frame_ns() const;
+
+    const std::vector<Event> &events() const { return events_; }
+    void clear_events() { events_.clear(); }
+
+    /** @brief Time of the most recent event of a kind, UINT64_MAX if none */
+    uint64_t last(EventKind kind) const;
+
+    /** @brief Requests the slave received */
+    const std::vector<std::vector<uint8_t> > &requests() const { return requests_; }
+
+    uint64_t collisions() const { return collisions_; }
+
+private:
+    void record(uint64_t time_ns, EventKind kind) {
+        Event event = { time_ns, kind };
+        events_.push_back(event);
+    }
+
+    struct nhal_uart_config config_;
+    struct nhal_uart_rs485_config rs485_;
+    bool configured_;
+    bool rs485_enabled_;
+    Slave slave_;
+    uint64_t response_delay_ns_;
+    bool bus_used_;
+    uint64_t bus_idle_since_ns_;
+    std::vector<Event> events_;
+    std::vector<std::vector<uint8_t> > requests_;
+    uint64_t collisions_;
+};
+
+#endif /* NHAL_RS485_SIM_HPP */
@@ -7,7 +7,11 @@
 #define NHAL_SPI_MOCK_HPP
 
 #include <gmock/gmock.h>
+#include "nhal_mock_scope.hpp"
 #include "nhal_spi_master.h"
+#include "nhal_spi_config_image.h"
+#include "nhal_spi_plan.h"
+#include "nhal_spi_master_words.h"
 
 /**
  * @brief Mock class for SPI HAL interface
@@ -23,8 +27,30 @@ public:
     MOCK_METHOD(nhal_result_t, nhal_spi_master_read, (struct nhal_spi_context *ctx, uint8_t *data, size_t len));
     MOCK_METHOD(nhal_result_t, nhal_spi_master_write_read, (struct nhal_spi_context *ctx, const uint8_t *tx_data, size_t tx_len, uint8_t *rx_data, size_t rx_len));
 
-    // Singleton instance for C interface
+    // Typed word operations
+    MOCK_METHOD(nhal_result_t, nhal_spi_master_write_words16, (struct nhal_spi_context *ctx, const uint16_t *data, size_t count));
+    MOCK_METHOD(nhal_result_t, nhal_spi_master_read_words16, (struct nhal_spi_context *ctx, uint16_t *data, size_t count));
+    MOCK_METHOD(nhal_result_t, nhal_spi_master_exchange_words16, (struct nhal_spi_context *ctx, const uint16_t *tx_data, uint16_t *rx_data, size_t count));
+    MOCK_METHOD(nhal_result_t, nhal_spi_master_write_words32, (struct nhal_spi_context *ctx, const uint32_t *data, size_t count));
+    MOCK_METHOD(nhal_result_t, nhal_spi_master_read_words32, (struct nhal_spi_context *ctx, uint32_t *data, size_t count));
+    MOCK_METHOD(nhal_result_t, nhal_spi_master_exchange_words32, (struct nhal_spi_context *ctx, const uint32_t *tx_data, uint32_t *rx_data, size_t count));
+
+    // Transaction plan operations
+    MOCK_METHOD(nhal_result_t, nhal_spi_master_plan_prepare, (struct nhal_spi_context *ctx, struct nhal_spi_plan *plan, const struct nhal_spi_config *config, const nhal_spi_segment_t *segments, size_t num_segments));
+    MOCK_METHOD(nhal_result_t, nhal_spi_master_plan_execute, (struct nhal_spi_context *ctx, struct nhal_spi_plan *plan));
+    MOCK_METHOD(nhal_result_t, nhal_spi_master_plan_release, (struct nhal_spi_context *ctx, struct nhal_spi_plan *plan));
+
+    // Configuration image operations
+    MOCK_METHOD(nhal_result_t, nhal_spi_master_config_image_build, (struct nhal_spi_context *ctx, const struct nhal_spi_config *config, struct nhal_spi_config_image *image));
+    MOCK_METHOD(nhal_result_t, nhal_spi_master_config_image_apply, (struct nhal_spi_context *ctx, const struct nhal_spi_config_image *image));
+
+    // Instance the C interface dispatches to: the mock bound to the calling
+    // thread (see NhalMockScope), or the process-wide singleton otherwise
     static NhalSpiMock& instance() {
+        NhalSpiMock *bound = NhalMockBinding<NhalSpiMock>::current();
+        if (bound != nullptr) {
+            return *bound;
+        }
         static NhalSpiMock mock;
         return mock;
     }
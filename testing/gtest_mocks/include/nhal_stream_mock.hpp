@@ -0,0 +1,41 @@
+/**
+ * @file nhal_stream_mock.hpp
+ * @brief Google Mock implementation for Stream HAL interface
+ */
+
+#ifndef NHAL_STREAM_MOCK_HPP
+#define NHAL_STREAM_MOCK_HPP
+
+#include <gmock/gmock.h>
+#include "nhal_mock_scope.hpp"
+#include "nhal_stream.h"
+
+/**
+ * @brief Mock class for Stream HAL interface
+ */
+class NhalStreamMock {
+public:
+    // Stream operations
+    MOCK_METHOD(nhal_result_t, nhal_stream_init, (struct nhal_stream_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_stream_deinit, (struct nhal_stream_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_stream_set_config, (struct nhal_stream_context *ctx, struct nhal_stream_config *config));
+    MOCK_METHOD(nhal_result_t, nhal_stream_get_config, (struct nhal_stream_context *ctx, struct nhal_stream_config *config));
+    MOCK_METHOD(nhal_result_t, nhal_stream_start, (struct nhal_stream_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_stream_stop, (struct nhal_stream_context *ctx));
+    MOCK_METHOD(nhal_result_t, nhal_stream_acquire, (struct nhal_stream_context *ctx, nhal_stream_block_t *block, uint32_t timeout_ms));
+    MOCK_METHOD(nhal_result_t, nhal_stream_release, (struct nhal_stream_context *ctx, const nhal_stream_block_t *block));
+    MOCK_METHOD(nhal_result_t, nhal_stream_get_stats, (struct nhal_stream_context *ctx, struct nhal_stream_stats *stats));
+
+    // Instance the C interface dispatches to: the mock bound to the calling
+    // thread (see NhalMockScope), or the process-wide singleton otherwise
+    static NhalStreamMock& instance() {
+        NhalStreamMock *bound = NhalMockBinding<NhalStreamMock>::current();
+        if (bound != nullptr) {
+            return *bound;
+        }
+        static NhalStreamMock mock;
+        return mock;
+    }
+};
+
+#endif /* NHAL_STREAM_MOCK_HPP */
@@ -0,0 +1,112 @@
+/**
+ * @file nhal_stream_sim.hpp
+ * @brief Simulated streaming source for continuous acquisition tests
+ */
+
+#ifndef NHAL_STREAM_SIM_HPP
+#define NHAL_STREAM_SIM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "nhal_stream.h"
+#include "nhal_virtual_clock.hpp"
+
+/**
+ * @brief Streaming source model behind the stream interface
+ *
+ * Fills the configured block ring at the configured sample rate, following
+ * the interface ownership rules: blocks are delivered through the callback or
+ * acquire(), and a block still owned by the consumer when its turn comes is
+ * dropped and accounted for in the statistics.
+ *
+ * Time comes from the NhalVirtualClock bound to the thread calling start():
+ * blocks complete as virtual time advances, so a consumer that spends its
+ * processing time with nhal_delay_microseconds() runs exactly as fast as it
+ * would on target, and its throughput limit shows up as dropped blocks.
+ * acquire() advances virtual time up to the next completion or the timeout.
+ *
+ * Without a clock bound when start() is called, the sample rate is not
+ * simulated at all: no block is ever produced on its own, acquire() returns
+ * NHAL_ERR_TIMEOUT at once whatever its timeout, and blocks only complete
+ * when the test calls complete_block().
+ *
+ * Samples default to a little-endian running sample counter, so consumers
+ * can check continuity; set_generator() installs any other waveform.
+ *
+ * The handler signatures match the C interface so they can be used directly
+ * as mock actions:
+ * @code
+ * NhalVirtualClock clock;
+ * NhalStreamSim mic;
+ * NhalStreamMock &stream = NhalStreamMock::instance();
+ * ON_CALL(stream, nhal_stream_set_config(_, _)).WillByDefault(Invoke(&mic, &NhalStreamSim::set_config));
+ * ON_CALL(stream, nhal_stream_start(_)).WillByDefault(Invoke(&mic, &NhalStreamSim::start));
+ * ON_CALL(stream, nhal_stream_acquire(_, _, _)).WillByDefault(Invoke(&mic, &NhalStreamSim::acquire));
+ * ON_CALL(stream, nhal_stream_release(_, _)).WillByDefault(Invoke(&mic, &NhalStreamSim::release));
+ * ON_CALL(stream, nhal_stream_get_stats(_, _)).WillByDefault(Invoke(&mic, &NhalStreamSim::get_stats));
+ *
+ * run_audio_pipeline_for(std::chrono::seconds(10));   // Runs in virtual time
+ * EXPECT_EQ(0u, mic.stats().blocks_dropped);
+ * @endcode
+ */
+class NhalStreamSim {
+public:
+    /** @brief Fills one sample of sample_size bytes */
+    typedef std::function<void(uint64_t sample_index, uint8_t *sample, size_t sample_size)> Generator;
+
+    NhalStreamSim();
+    ~NhalStreamSim();
+
+    NhalStreamSim(const NhalStreamSim &) = delete;
+    NhalStreamSim &operator=(const NhalStreamSim &) = delete;
+
+    void set_generator(Generator generator) { generator_ = std::move(generator); }
+
+    // Handlers matching the C interface
+    nhal_result_t set_config(struct nhal_stream_context *ctx, struct nhal_stream_config *config);
+    nhal_result_t get_config(struct nhal_stream_context *ctx, struct nhal_stream_config *config);
+    /** @brief Start the stream, paced by the calling thread's NhalVirtualClock if any (see class documentation) */
+    nhal_result_t start(struct nhal_stream_context *ctx);
+    nhal_result_t stop(struct nhal_stream_context *ctx);
+    nhal_result_t acquire(struct nhal_stream_context *ctx, nhal_stream_block_t *block, uint32_t timeout_ms);
+    nhal_result_t release(struct nhal_stream_context *ctx, const nhal_stream_block_t *block);
+    nhal_result_t get_stats(struct nhal_stream_context *ctx, struct nhal_stream_stats *stats);
+
+    /** @brief Complete the next block of the ring now, the only source of blocks without a clock */
+    void complete_block();
+
+    /** @brief Samples per block for the current configuration */
+    size_t block_samples() const;
+
+    /** @brief Blocks currently owned by the consumer */
+    size_t blocks_owned() const;
+
+    const struct nhal_stream_stats &stats() const { return stats_; }
+    bool running() const { return running_; }
+
+private:
+    uint64_t completion_time_ns(uint64_t block_number) const;
+    void schedule_next();
+
+    struct nhal_stream_context *ctx_;
+    struct nhal_stream_config config_;
+    bool configured_;
+    bool running_;
+    Generator generator_;
+    std::vector<bool> owned_;
+    std::deque<nhal_stream_block_t> ready_;
+    uint16_t next_block_;
+    uint32_t sequence_;
+    uint64_t sample_index_;
+    struct nhal_stream_stats stats_;
+    NhalVirtualClock *clock_;
+    NhalVirtualClock::EventId event_;
+    uint64_t start_ns_;
+    uint64_t next_completion_ns_;
+};
+
+#endif /* NHAL_STREAM_SIM_HPP */
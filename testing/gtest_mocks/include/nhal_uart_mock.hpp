@@ -7,7 +7,9 @@
 #define NHAL_UART_MOCK_HPP
 
 #include <gmock/gmock.h>
+#include "nhal_mock_scope.hpp"
 #include "nhal_uart.h"
+#include "nhal_uart_rs485.h"
 
 /**
  * @brief Mock class for UART HAL interface
@@ -22,8 +24,17 @@ public:
     MOCK_METHOD(nhal_result_t, nhal_uart_write, (struct nhal_uart_context *ctx, const uint8_t *data, size_t len));
     MOCK_METHOD(nhal_result_t, nhal_uart_read, (struct nhal_uart_context *ctx, uint8_t *data, size_t len));
 
-    // Singleton instance for C interface
+    // RS-485 operations
+    MOCK_METHOD(nhal_result_t, nhal_uart_rs485_set_config, (struct nhal_uart_context *ctx, const struct nhal_uart_rs485_config *rs485));
+    MOCK_METHOD(nhal_result_t, nhal_uart_rs485_transaction, (struct nhal_uart_context *ctx, const uint8_t *request, size_t request_len, uint8_t *response, size_t response_max, size_t *response_len, uint32_t timeout_ms));
+
+    // Instance the C interface dispatches to: the mock bound to the calling
+    // thread (see NhalMockScope), or the process-wide singleton otherwise
     static NhalUartMock& instance() {
+        NhalUartMock *bound = NhalMockBinding<NhalUartMock>::current();
+        if (bound != nullptr) {
+            return *bound;
+        }
         static NhalUartMock mock;
         return mock;
     }
@@ -0,0 +1,254 @@
+/**
+ * @file nhal_vcd_recorder.hpp
+ * @brief Streaming VCD waveform recorder for pin and bus activity
+ */
+
+#ifndef NHAL_VCD_RECORDER_HPP
+#define NHAL_VCD_RECORDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "nhal_pin.h"
+#include "nhal_spi_master.h"
+#include "nhal_i2c_master.h"
+#include "nhal_uart.h"
+
+/**
+ * @brief Logic analyzer for host tests
+ *
+ * Records pin transitions and synthesized SPI (SCK/MOSI/MISO/CS), I2C
+ * (SCL/SDA) and UART (TX/RX) waveforms into a Value Change Dump file, readable
+ * with GTKWave, PulseView or sigrok. Values are written out as they change
+ * through a fixed-size buffer, so memory stays constant however long the
+ * capture is; unchanged values are not written.
+ *
+ * Timestamps come from the NhalVirtualClock bound to the calling thread. The
+ * bus handlers start the synthesized waveform at the current virtual time
+ * and, as the blocking call would on hardware, advance the clock to its end.
+ * Without a clock, an internal time cursor advances instead. The file uses a
+ * 1 ps timescale so bit periods of fast buses are not rounded.
+ *
+ * UART frames follow the line's format: 7 or 8 data bits, optional parity
+ * and 1 or 2 stop bits, set when the line is added or by uart_set_config().
+ *
+ * Signals are declared before the first value change. The handler signatures
+ * match the C interface so they can be used directly as mock actions. With a
+ * device model answering the calls, wrap the model with recording(): the
+ * model runs first, so the recorded MISO/SDA/RX data is its answer, the
+ * waveform is only recorded when it returns NHAL_OK, and its result is
+ * returned to the caller:
+ * @code
+ * NhalVirtualClock clock;
+ * NhalVcdRecorder vcd("flash.vcd");
+ * NhalVcdRecorder::SpiBus spi = vcd.add_spi_bus("spi1", 8000000, NHAL_SPI_MODE_0);
+ * NhalVcdRecorder::Signal led = vcd.add_signal("gpio", "led");
+ * vcd.attach_spi(spi_ctx, spi);
+ * vcd.attach_pin(led_ctx, led);
+ *
+ * ON_CALL(NhalPinMock::instance(), nhal_pin_set_state(_, _)).WillByDefault(Invoke(&vcd, &NhalVcdRecorder::pin_set_state));
+ * ON_CALL(NhalSpiMock::instance(), nhal_spi_master_write_read(_, _, _, _, _)).WillByDefault(Invoke(
+ *     vcd.recording(&NhalVcdRecorder::spi_write_read, &flash, &NhalNorFlashSim::spi_write_read)));
+ * @endcode
+ */
+class NhalVcdRecorder {
+public:
+    typedef size_t Signal;
+
+    static const uint64_t VALUE_X = UINT64_MAX - 1;    /**< Unknown. */
+    static const uint64_t VALUE_Z = UINT64_MAX;        /**< High impedance. */
+
+    struct SpiBus {
+        Signal sck;
+        Signal mosi;
+        Signal miso;
+        Signal cs;
+        uint32_t clock_hz;
+        nhal_spi_mode_t mode;
+        nhal_spi_bit_order_t bit_order;
+    };
+
+    struct I2cBus {
+        Signal scl;
+        Signal sda;
+        uint32_t clock_hz;
+    };
+
+    /** @brief UART line and its frame format, LSB first */
+    struct UartLine {
+        Signal line;
+        uint32_t baud;
+        nhal_uart_data_bits_t data_bits;
+        nhal_uart_parity_t parity;
+        nhal_uart_stop_bits_t stop_bits;
+    };
+
+    /**
+     * @brief Mock action running a device model, then recording its call
+     *
+     * Returns the model's result; the call is recorded only when it is NHAL_OK.
+     */
+    template <typename Model, typename... Args>
+    class Recording {
+    public:
+        Recording(NhalVcdRecorder *recorder, nhal_result_t (NhalVcdRecorder::*handler)(Args...), Model model)
+            : recorder_(recorder), handler_(handler), model_(model) {}
+
+        nhal_result_t operator()(Args... args) {
+            nhal_result_t result = model_(args...);
+            if (result == NHAL_OK) {
+                (recorder_->*handler_)(args...);
+            }
+            return result;
+        }
+
+    private:
+        NhalVcdRecorder *recorder_;
+        nhal_result_t (NhalVcdRecorder::*handler_)(Args...);
+        Model model_;
+    };
+
+    /** @brief Member function of a device model, callable as a Recording model */
+    template <typename T, typename... Args>
+    class MemberModel {
+    public:
+        MemberModel(T *object, nhal_result_t (T::*method)(Args...)) : object_(object), method_(method) {}
+
+        nhal_result_t operator()(Args... args) { return (object_->*method_)(args...); }
+
+    private:
+        T *object_;
+        nhal_result_t (T::*method_)(Args...);
+    };
+
+    /**
+     * @param path Output VCD file
+     * @param buffer_size Output buffer size in bytes
+     */
+    explicit NhalVcdRecorder(const std::string &path, size_t buffer_size = 64 * 1024);
+    ~NhalVcdRecorder();
+
+    NhalVcdRecorder(const NhalVcdRecorder &) = delete;
+    NhalVcdRecorder &operator=(const NhalVcdRecorder &) = delete;
+
+    bool is_open() const { return file_ != nullptr; }
+
+    /** @brief Declare a signal (throws std::logic_error after the first value change) */
+    Signal add_signal(const std::string &scope, const std::string &name, unsigned width = 1, uint64_t initial = VALUE_X);
+
+    SpiBus add_spi_bus(const std::string &scope, uint32_t clock_hz, nhal_spi_mode_t mode,
+                       nhal_spi_bit_order_t bit_order = NHAL_SPI_BIT_ORDER_MSB_FIRST);
+    I2cBus add_i2c_bus(const std::string &scope, uint32_t clock_hz);
+    /** @brief UART line with 8N1 frames */
+    UartLine add_uart_line(const std::string &scope, const std::string &name, uint32_t baud);
+    /** @brief UART line with the baud rate and frame format of a configuration */
+    UartLine add_uart_line(const std::string &scope, const std::string &name, const struct nhal_uart_config &cfg);
+
+    /** @brief Current recording time: virtual clock, or internal cursor */
+    uint64_t now_ns() const;
+
+    /** @brief Change a signal now */
+    void change(Signal signal, uint64_t value);
+
+    /** @brief Change a signal at a given time (clamped to the last written time) */
+    void change_at(uint64_t time_ns, Signal signal, uint64_t value);
+
+    // Waveform synthesis, returning the end time in ns. NULL data is recorded
+    // as 0xFF on MOSI and high impedance on MISO.
+    uint64_t spi_transfer(const SpiBus &bus, uint64_t start_ns, const uint8_t *mosi, const uint8_t *miso, size_t len);
+    uint64_t i2c_write(const I2cBus &bus, uint64_t start_ns, nhal_i2c_address_t address, const uint8_t *data, size_t len);
+    uint64_t i2c_read(const I2cBus &bus, uint64_t start_ns, nhal_i2c_address_t address, const uint8_t *data, size_t len);
+    uint64_t i2c_write_read(const I2cBus &bus, uint64_t start_ns, nhal_i2c_address_t address,
+                            const uint8_t *tx, size_t tx_len, const uint8_t *rx, size_t rx_len);
+    uint64_t uart_frames(const UartLine &uart, uint64_t start_ns, const uint8_t *data, size_t len);
+
+    // Routing of the C contexts to signals for the handlers below
+    void attach_pin(struct nhal_pin_context *ctx, Signal signal) { pins_[ctx] = signal; }
+    void attach_spi(struct nhal_spi_context *ctx, const SpiBus &bus) { spi_buses_[ctx] = bus; }
+    void attach_i2c(struct nhal_i2c_context *ctx, const I2cBus &bus) { i2c_buses_[ctx] = bus; }
+    void attach_uart(struct nhal_uart_context *ctx, const UartLine &tx) { uart_lines_[ctx] = tx; }
+    void attach_uart_rx(struct nhal_uart_context *ctx, const UartLine &rx) { uart_rx_lines_[ctx] = rx; }
+
+    // Handlers matching the C interface (unattached contexts are ignored)
+    /** @brief Baud rate and frame format of the lines attached to the context */
+    nhal_result_t uart_set_config(struct nhal_uart_context *ctx, struct nhal_uart_config *cfg);
+    nhal_result_t pin_set_state(struct nhal_pin_context *ctx, nhal_pin_state_t value);
+    nhal_result_t spi_write(struct nhal_spi_context *ctx, const uint8_t *data, size_t len);
+    nhal_result_t spi_read(struct nhal_spi_context *ctx, uint8_t *data, size_t len);
+    nhal_result_t spi_write_read(struct nhal_spi_context *ctx, const uint8_t *tx_data, size_t tx_len,
+                                 uint8_t *rx_data, size_t rx_len);
+    nhal_result_t i2c_master_write(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                   const uint8_t *data, size_t len);
+    nhal_result_t i2c_master_read(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, uint8_t *data, size_t len);
+    nhal_result_t i2c_master_write_read_reg(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                            const uint8_t *reg_address, size_t reg_len, uint8_t *data, size_t data_len);
+    nhal_result_t uart_write(struct nhal_uart_context *ctx, const uint8_t *data, size_t len);
+    /** @brief Frames of the bytes read, received before the read returned */
+    nhal_result_t uart_read(struct nhal_uart_context *ctx, uint8_t *data, size_t len);
+
+    /** @brief Mock action running model, then the handler (see Recording) */
+    template <typename Model, typename... Args>
+    Recording<Model, Args...> recording(nhal_result_t (NhalVcdRecorder::*handler)(Args...), Model model) {
+        return Recording<Model, Args...>(this, handler, model);
+    }
+
+    /** @brief Mock action running a model's member function, then the handler (see Recording) */
+    template <typename T, typename... Args>
+    Recording<MemberModel<T, Args...>, Args...> recording(nhal_result_t (NhalVcdRecorder::*handler)(Args...), T *object,
+                                                          nhal_result_t (T::*method)(Args...)) {
+        return Recording<MemberModel<T, Args...>, Args...>(this, handler, MemberModel<T, Args...>(object, method));
+    }
+
+    /** @brief Write buffered output to the file */
+    void flush();
+
+    /** @brief Value changes written so far */
+    uint64_t transitions() const { return transitions_; }
+
+private:
+    struct SignalInfo {
+        std::string scope;
+        std::string name;
+        unsigned width;
+        uint64_t value;
+        std::string id;
+    };
+
+    void write_header();
+    void emit(uint64_t time_ps, Signal signal, uint64_t value);
+    void append(const char *data, size_t len);
+
+    /** @brief Start time of a handler-driven waveform, in ps */
+    uint64_t handler_start_ps() const;
+    /** @brief Account for a handler-driven waveform ending at end_ps */
+    void handler_end(uint64_t end_ps);
+
+    uint64_t spi_bytes(const SpiBus &bus, uint64_t t, const uint8_t *mosi, const uint8_t *miso, size_t len);
+    uint64_t spi_begin(const SpiBus &bus, uint64_t t);
+    uint64_t spi_end(const SpiBus &bus, uint64_t t);
+    uint64_t i2c_start(const I2cBus &bus, uint64_t t);
+    uint64_t i2c_stop(const I2cBus &bus, uint64_t t);
+    uint64_t i2c_bit(const I2cBus &bus, uint64_t t, bool bit);
+    uint64_t i2c_byte(const I2cBus &bus, uint64_t t, uint8_t byte, bool ack);
+    uint64_t i2c_address(const I2cBus &bus, uint64_t t, nhal_i2c_address_t address, bool read, bool repeated);
+
+    std::FILE *file_;
+    std::vector<char> buffer_;
+    size_t buffered_;
+    std::vector<SignalInfo> signals_;
+    bool header_written_;
+    uint64_t time_ps_;
+    uint64_t cursor_ps_;
+    uint64_t transitions_;
+    std::map<struct nhal_pin_context *, Signal> pins_;
+    std::map<struct nhal_spi_context *, SpiBus> spi_buses_;
+    std::map<struct nhal_i2c_context *, I2cBus> i2c_buses_;
+    std::map<struct nhal_uart_context *, UartLine> uart_lines_;
+    std::map<struct nhal_uart_context *, UartLine> uart_rx_lines_;
+};
+
+#endif /* NHAL_VCD_RECORDER_HPP */
@@ -0,0 +1,108 @@
+/**
+ * @file nhal_virtual_clock.hpp
+ * @brief Discrete-event virtual clock backend for common NHAL timing functions
+ */
+
+#ifndef NHAL_VIRTUAL_CLOCK_HPP
+#define NHAL_VIRTUAL_CLOCK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "nhal_common.h"
+#include "nhal_mock_scope.hpp"
+
+/**
+ * @brief Simulated time source for nhal_common.h and nhal_ticks.h
+ *
+ * While a virtual clock is alive, the timing functions called from the thread
+ * that created it are served by the clock instead of NhalCommonMock:
+ * - nhal_delay_microseconds()/nhal_delay_milliseconds() advance simulated time
+ *   immediately instead of waiting,
+ * - nhal_get_timestamp_*() return simulated time, consistent for every peripheral,
+ * - nhal_get_timestamp_ticks() counts nanoseconds (1 GHz calibration).
+ *
+ * Device models schedule events at virtual instants; they fire, in time order,
+ * when a delay or an explicit advance moves time past them. Other threads can
+ * share the clock with NhalMockBinding<NhalVirtualClock>.
+ *
+ * Code that busy-waits on timestamps without calling a delay would never see
+ * time move; set_timestamp_step_ns() makes every timestamp read advance time.
+ *
+ * @code
+ * TEST(Dht11Test, HandlesTimeout) {
+ *     NhalVirtualClock clock;
+ *     clock.set_timestamp_step_ns(1000);    // Polling loops progress 1us per read
+ *     EXPECT_EQ(NHAL_ERR_TIMEOUT, dht11_read_sensor(&sensor_ctx));   // 2s timeout, runs instantly
+ *     EXPECT_GE(clock.now_us(), 2000000u);
+ * }
+ *
+ * TEST(ModemTest, ReadsResponseAfterBoot) {
+ *     NhalVirtualClock clock;
+ *     clock.schedule_in_us(500000, [&] { modem_model.set_ready(); });
+ *     nhal_delay_milliseconds(600);         // Fires the event at t = 500ms, returns immediately
+ * }
+ * @endcode
+ */
+class NhalVirtualClock {
+public:
+    typedef uint64_t EventId;
+
+    /** @brief Create a clock at start_ns and bind it to the calling thread */
+    explicit NhalVirtualClock(uint64_t start_ns = 0);
+
+    NhalVirtualClock(const NhalVirtualClock &) = delete;
+    NhalVirtualClock &operator=(const NhalVirtualClock &) = delete;
+
+    /** @brief Clock bound to the calling thread, nullptr if none */
+    static NhalVirtualClock *current() { return NhalMockBinding<NhalVirtualClock>::current(); }
+
+    uint64_t now_ns();
+    uint64_t now_us() { return now_ns() / 1000u; }
+
+    /** @brief Move time forward, firing every event due on the way */
+    void advance_ns(uint64_t ns);
+    void advance_us(uint64_t us) { advance_ns(us * 1000u); }
+
+    /** @brief Move time forward to an absolute instant (no-op if already past it) */
+    void advance_to_ns(uint64_t time_ns);
+
+    /** @brief Move time to the next pending event and fire it, false if none is pending */
+    bool run_next_event();
+
+    /** @brief Schedule fn to run at an absolute virtual instant */
+    EventId schedule_at_ns(uint64_t time_ns, std::function<void()> fn);
+    EventId schedule_in_us(uint64_t delay_us, std::function<void()> fn) {
+        return schedule_at_ns(now_ns() + delay_us * 1000u, std::move(fn));
+    }
+
+    /** @brief Cancel a pending event, false if it already fired or does not exist */
+    bool cancel(EventId id);
+
+    size_t pending_events();
+
+    /** @brief Time added on every timestamp read (0 by default) */
+    void set_timestamp_step_ns(uint64_t step_ns);
+
+    // Timing functions served to the C bridges
+    uint64_t read_timestamp_ns();
+
+private:
+    typedef std::pair<uint64_t, EventId> EventKey;
+
+    bool pop_due_event(uint64_t limit_ns, std::function<void()> *fn);
+
+    std::mutex lock_;
+    uint64_t now_ns_;
+    uint64_t timestamp_step_ns_;
+    EventId next_id_;
+    std::map<EventKey, std::function<void()> > events_;
+    std::map<EventId, uint64_t> event_times_;
+    NhalMockBinding<NhalVirtualClock> binding_;
+};
+
+#endif /* NHAL_VIRTUAL_CLOCK_HPP */
@@ -0,0 +1,652 @@
+/**
+ * @file nhal_can_bus_sim.cpp
+ * @brief Simulated CAN bus implementation
+ */
+
+#include "nhal_can_bus_sim.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+enum FrameSource {
+    SOURCE_NODE,
+    SOURCE_INJECTED,
+    SOURCE_SATURATE,
+};
+
+bool frame_valid(const nhal_can_frame_t &frame) {
+    uint32_t id_mask = (frame.flags & NHAL_CAN_FRAME_EXTENDED) ? NHAL_CAN_EXT_ID_MASK : NHAL_CAN_STD_ID_MASK;
+    return frame.dlc <= NHAL_CAN_MAX_DLC && (frame.id & ~id_mask) == 0;
+}
+
+bool filter_matches(const nhal_can_filter_t &filter, const nhal_can_frame_t &frame) {
+    bool extended = (frame.flags & NHAL_CAN_FRAME_EXTENDED) != 0;
+    if (extended != ((filter.flags & NHAL_CAN_FILTER_EXTENDED) != 0)) {
+        return false;
+    }
+    return ((frame.id ^ filter.id) & filter.mask) == 0;
+}
+
+}  // namespace
+
+NhalCanBusSim::NhalCanBusSim(uint32_t bitrate)
+    : bitrate_(bitrate), saturate_index_(0), saturate_pending_(false), clock_(NhalVirtualClock::current()),
+      busy_(false), busy_until_ns_(0), bus_event_(0) {
+    std::memset(&saturate_frame_, 0, sizeof(saturate_frame_));
+    std::memset(&stats_, 0, sizeof(stats_));
+    stats_.start_ns = clock_ != nullptr ? clock_->now_ns() : 0;
+}
+
+NhalCanBusSim::~NhalCanBusSim() {
+    stop_traffic();
+    if (clock_ != nullptr && bus_event_ != 0) {
+        clock_->cancel(bus_event_);
+    }
+}
+
+NhalCanBusSim::Node *NhalCanBusSim::find(struct nhal_can_context *ctx) {
+    auto it = nodes_.find(ctx);
+    return it != nodes_.end() && it->second.initialized ? &it->second : nullptr;
+}
+
+const NhalCanBusSim::Node *NhalCanBusSim::find(struct nhal_can_context *ctx) const {
+    auto it = nodes_.find(ctx);
+    return it != nodes_.end() ? &it->second : nullptr;
+}
+
+void NhalCanBusSim::attach(struct nhal_can_context *ctx, const NodeConfig &config) {
+    nodes_[ctx].resources = config;
+}
+
+void NhalCanBusSim::set_wanted(struct nhal_can_context *ctx, FramePredicate wanted) {
+    nodes_[ctx].wanted = std::move(wanted);
+}
+
+// ---------------------------------------------------------------------------
+// Frame timing and arbitration
+// ---------------------------------------------------------------------------
+
+uint32_t NhalCanBusSim::frame_bits(const nhal_can_frame_t &frame) {
+    std::vector<uint8_t> bits;
+    auto put = [&bits](uint32_t value, int count) {
+        for (int i = count - 1; i >= 0; i--) {
+            bits.push_back(static_cast<uint8_t>((value >> i) & 1u));
+        }
+    };
+    bool extended = (frame.flags & NHAL_CAN_FRAME_EXTENDED) != 0;
+    bool remote = (frame.flags & NHAL_CAN_FRAME_REMOTE) != 0;
+    uint8_t dlc = frame.dlc > 15 ? 15 : frame.dlc;
+
+    put(0, 1);                                  // SOF
+    if (extended) {
+        put(frame.id >> 18, 11);
+        put(1, 1);                              // SRR
+        put(1, 1);                              // IDE
+        put(frame.id & 0x3FFFFu, 18);
+        put(remote, 1);
+        put(0, 2);                              // r1, r0
+    } else {
+        put(frame.id, 11);
+        put(remote, 1);
+        put(0, 1);                              // IDE
+        put(0, 1);                              // r0
+    }
+    put(dlc, 4);
+    if (!remote) {
+        for (uint8_t i = 0; i < std::min<uint8_t>(dlc, NHAL_CAN_MAX_DLC); i++) {
+            put(frame.data[i], 8);
+        }
+    }
+
+    uint16_t crc = 0;
+    for (uint8_t bit : bits) {
+        bool next = (bit ^ ((crc >> 14) & 1u)) != 0;
+        crc = static_cast<uint16_t>((crc << 1) & 0x7FFFu);
+        if (next) {
+            crc ^= 0x4599u;
+        }
+    }
+    put(crc, 15);
+
+    // A bit of opposite value follows five identical ones, SOF to CRC
+    uint32_t stuff = 0;
+    int last = -1;
+    int run = 0;
+    for (uint8_t bit : bits) {
+        if (bit == last) {
+            run++;
+        } else {
+            last = bit;
+            run = 1;
+        }
+        if (run == 5) {
+            stuff++;
+            last = !bit;
+            run = 1;
+        }
+    }
+
+    // CRC delimiter, ACK slot and delimiter, EOF, interframe space
+    return static_cast<uint32_t>(bits.size()) + stuff + 3 + 7 + 3;
+}
+
+nhal_can_frame_t NhalCanBusSim::make_frame(uint32_t id, uint8_t dlc, uint8_t flags) {
+    nhal_can_frame_t frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.id = id;
+    frame.flags = flags;
+    frame.dlc = dlc;
+    for (uint8_t i = 0; i < NHAL_CAN_MAX_DLC; i++) {
+        frame.data[i] = static_cast<uint8_t>(id + i);
+    }
+    return frame;
+}
+
+uint64_t NhalCanBusSim::arbitration_key(const nhal_can_frame_t &frame) {
+    // Bits in wire order, lower wins: standard beats extended with the same
+    // base id (RTR/SRR, IDE), data beats remote
+    uint64_t remote = (frame.flags & NHAL_CAN_FRAME_REMOTE) ? 1u : 0u;
+    if (frame.flags & NHAL_CAN_FRAME_EXTENDED) {
+        uint64_t base = (frame.id >> 18) & NHAL_CAN_STD_ID_MASK;
+        return (base << 21) | (1u << 20) | (1u << 19) | (static_cast<uint64_t>(frame.id & 0x3FFFFu) << 1) | remote;
+    }
+    return (static_cast<uint64_t>(frame.id & NHAL_CAN_STD_ID_MASK) << 21) | (remote << 20);
+}
+
+bool NhalCanBusSim::arbitrate(Candidate *winner) {
+    bool found = false;
+    uint64_t best = 0;
+    auto offer = [&](const nhal_can_frame_t &frame, int source, Node *node, size_t index, uint64_t sequence) {
+        uint64_t key = arbitration_key(frame);
+        if (!found || key < best) {
+            found = true;
+            best = key;
+            winner->frame = frame;
+            winner->source = source;
+            winner->node = node;
+            winner->index = index;
+            winner->sequence = sequence;
+        }
+    };
+
+    for (auto &entry : nodes_) {
+        Node &node = entry.second;
+        if (!node.started || node.mailboxes.empty()) {
+            continue;
+        }
+        // The controller offers one mailbox per arbitration round
+        size_t pick = 0;
+        for (size_t i = 1; i < node.mailboxes.size(); i++) {
+            bool better = node.config.tx_priority == NHAL_CAN_TX_PRIORITY_FIFO
+                ? node.mailboxes[i].sequence < node.mailboxes[pick].sequence
+                : arbitration_key(node.mailboxes[i].frame) < arbitration_key(node.mailboxes[pick].frame);
+            if (better) {
+                pick = i;
+            }
+        }
+        offer(node.mailboxes[pick].frame, SOURCE_NODE, &node, pick, node.mailboxes[pick].sequence);
+    }
+
+    // External traffic: one node per pending frame
+    for (size_t i = 0; i < injected_.size(); i++) {
+        offer(injected_[i], SOURCE_INJECTED, nullptr, i, 0);
+    }
+
+    if (saturate_) {
+        if (!saturate_pending_) {
+            saturate_frame_ = saturate_(saturate_index_);
+            saturate_pending_ = true;
+        }
+        offer(saturate_frame_, SOURCE_SATURATE, nullptr, 0, saturate_index_);
+    }
+    return found;
+}
+
+void NhalCanBusSim::kick() {
+    if (clock_ == nullptr) {
+        clock_ = NhalVirtualClock::current();
+        if (clock_ == nullptr) {
+            return;
+        }
+        stats_.start_ns = clock_->now_ns();
+    }
+    if (busy_ || bus_event_ != 0) {
+        return;
+    }
+    // Arbitrate once everything queued at this instant has been queued
+    bus_event_ = clock_->schedule_at_ns(clock_->now_ns(), [this] {
+        bus_event_ = 0;
+        begin_frame();
+    });
+}
+
+void NhalCanBusSim::begin_frame() {
+    Candidate winner;
+    if (!arbitrate(&winner)) {
+        return;
+    }
+    uint64_t duration_ns = static_cast<uint64_t>(frame_bits(winner.frame)) * 1000000000u / bitrate_;
+    busy_ = true;
+    busy_until_ns_ = clock_->now_ns() + duration_ns;
+    bus_event_ = clock_->schedule_at_ns(busy_until_ns_, [this, winner] {
+        bus_event_ = 0;
+        busy_ = false;
+        complete_frame(winner);
+        begin_frame();
+    });
+}
+
+void NhalCanBusSim::complete_frame(const Candidate &winner) {
+    uint32_t bits = frame_bits(winner.frame);
+    stats_.frames++;
+    stats_.bits += bits;
+    stats_.busy_ns += static_cast<uint64_t>(bits) * 1000000000u / bitrate_;
+
+    switch (winner.source) {
+    case SOURCE_NODE: {
+        // The frame was on the wire even if the controller was stopped meanwhile
+        std::vector<Mailbox> &mailboxes = winner.node->mailboxes;
+        for (size_t i = 0; i < mailboxes.size(); i++) {
+            if (mailboxes[i].sequence == winner.sequence) {
+                mailboxes.erase(mailboxes.begin() + static_cast<std::ptrdiff_t>(i));
+                winner.node->stats.frames_transmitted++;
+                break;
+            }
+        }
+        break;
+    }
+    case SOURCE_INJECTED:
+        if (winner.index < injected_.size()) {
+            injected_.erase(injected_.begin() + static_cast<std::ptrdiff_t>(winner.index));
+        }
+        break;
+    case SOURCE_SATURATE:
+        if (saturate_pending_ && winner.sequence == saturate_index_) {
+            saturate_pending_ = false;
+            saturate_index_++;
+        }
+        break;
+    }
+
+    for (auto &entry : nodes_) {
+        Node &node = entry.second;
+        if (!node.started) {
+            continue;
+        }
+        if (&node == winner.node && node.config.mode != NHAL_CAN_MODE_LOOPBACK) {
+            continue;
+        }
+        deliver(entry.first, node, winner.frame);
+    }
+}
+
+void NhalCanBusSim::deliver(struct nhal_can_context *ctx, Node &node, const nhal_can_frame_t &frame) {
+    node.sim_stats.frames_seen++;
+
+    // An empty table matches nothing, as on the controllers it models
+    size_t match = 0;
+    while (match < node.filters.size() && !filter_matches(node.filters[match], frame)) {
+        match++;
+    }
+    if (match == node.filters.size()) {
+        node.sim_stats.frames_rejected++;
+        return;
+    }
+    uint8_t fifo = node.filters[match].fifo;
+
+    node.sim_stats.frames_accepted++;
+    if (node.wanted && !node.wanted(frame)) {
+        node.sim_stats.frames_unwanted++;
+    }
+
+    std::deque<nhal_can_frame_t> &queue = node.fifos[fifo];
+    if (queue.size() >= node.resources.fifo_depth) {
+        node.stats.rx_overruns++;
+        node.sim_stats.rx_overruns++;
+        return;
+    }
+    nhal_can_frame_t received = frame;
+    received.filter_index = static_cast<uint8_t>(match);
+    received.timestamp_ticks = clock_ != nullptr ? clock_->now_ns() : 0;
+    queue.push_back(received);
+    node.stats.frames_received++;
+
+    size_t watermark = node.config.rx_watermark != 0 ? node.config.rx_watermark : 1;
+    if (node.config.rx_callback != nullptr && queue.size() == watermark) {
+        node.sim_stats.rx_callbacks++;
+        node.config.rx_callback(ctx, fifo, node.config.user_data);
+    }
+}
+
+bool NhalCanBusSim::wait_activity(uint64_t deadline_ns) {
+    if (clock_ == nullptr) {
+        return false;
+    }
+    uint64_t now = clock_->now_ns();
+    if (now >= deadline_ns) {
+        return false;
+    }
+    uint64_t next = deadline_ns;
+    if (busy_) {
+        next = std::min(next, busy_until_ns_);
+    } else if (bus_event_ != 0) {
+        next = now;
+    }
+    for (size_t i = 0; i < periodic_.size(); i++) {
+        next = std::min(next, std::max(now, periodic_[i]->next_ns));
+    }
+    clock_->advance_to_ns(next);
+    return clock_->now_ns() < deadline_ns;
+}
+
+bool NhalCanBusSim::step() {
+    if (clock_ == nullptr) {
+        Candidate winner;
+        if (!arbitrate(&winner)) {
+            return false;
+        }
+        complete_frame(winner);
+        return true;
+    }
+    if (!busy_) {
+        if (bus_event_ != 0) {
+            clock_->cancel(bus_event_);
+            bus_event_ = 0;
+        }
+        begin_frame();
+        if (!busy_) {
+            return false;
+        }
+    }
+    clock_->advance_to_ns(busy_until_ns_);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// External traffic
+// ---------------------------------------------------------------------------
+
+void NhalCanBusSim::inject(const nhal_can_frame_t &frame) {
+    injected_.push_back(frame);
+    kick();
+}
+
+void NhalCanBusSim::add_periodic(const nhal_can_frame_t &frame, uint64_t period_ns, uint64_t offset_ns) {
+    if (clock_ == nullptr) {
+        clock_ = NhalVirtualClock::current();
+    }
+    if (clock_ == nullptr || period_ns == 0) {
+        return;
+    }
+    Periodic *source = new Periodic;
+    source->frame = frame;
+    source->period_ns = period_ns;
+    source->event = 0;
+    periodic_.push_back(source);
+    schedule_periodic(source, clock_->now_ns() + offset_ns);
+}
+
+void NhalCanBusSim::schedule_periodic(Periodic *source, uint64_t time_ns) {
+    source->next_ns = time_ns;
+    source->event = clock_->schedule_at_ns(time_ns, [this, source] {
+        source->event = 0;
+        inject(source->frame);
+        schedule_periodic(source, source->next_ns + source->period_ns);
+    });
+}
+
+void NhalCanBusSim::saturate(FrameGenerator generator) {
+    saturate_ = std::move(generator);
+    saturate_index_ = 0;
+    saturate_pending_ = false;
+    kick();
+}
+
+void NhalCanBusSim::stop_traffic() {
+    for (size_t i = 0; i < periodic_.size(); i++) {
+        if (clock_ != nullptr && periodic_[i]->event != 0) {
+            clock_->cancel(periodic_[i]->event);
+        }
+        delete periodic_[i];
+    }
+    periodic_.clear();
+    injected_.clear();
+    saturate_ = nullptr;
+    saturate_pending_ = false;
+}
+
+// ---------------------------------------------------------------------------
+// Statistics
+// ---------------------------------------------------------------------------
+
+void NhalCanBusSim::reset_stats() {
+    std::memset(&stats_, 0, sizeof(stats_));
+    stats_.start_ns = clock_ != nullptr ? clock_->now_ns() : 0;
+}
+
+double NhalCanBusSim::frames_per_second() const {
+    uint64_t elapsed = clock_ != nullptr ? clock_->now_ns() - stats_.start_ns : stats_.busy_ns;
+    return elapsed != 0 ? static_cast<double>(stats_.frames) * 1e9 / static_cast<double>(elapsed) : 0.0;
+}
+
+double NhalCanBusSim::bus_load() const {
+    uint64_t elapsed = clock_ != nullptr ? clock_->now_ns() - stats_.start_ns : stats_.busy_ns;
+    return elapsed != 0 ? static_cast<double>(stats_.busy_ns) / static_cast<double>(elapsed) : 0.0;
+}
+
+NhalCanBusSim::NodeStats NhalCanBusSim::node_stats(struct nhal_can_context *ctx) const {
+    const Node *node = find(ctx);
+    if (node == nullptr) {
+        NodeStats empty;
+        std::memset(&empty, 0, sizeof(empty));
+        return empty;
+    }
+    return node->sim_stats;
+}
+
+double NhalCanBusSim::filter_efficiency(struct nhal_can_context *ctx) const {
+    NodeStats stats = node_stats(ctx);
+    return stats.frames_seen != 0 ? static_cast<double>(stats.frames_rejected) / static_cast<double>(stats.frames_seen) : 0.0;
+}
+
+// ---------------------------------------------------------------------------
+// Handlers
+// ---------------------------------------------------------------------------
+
+nhal_result_t NhalCanBusSim::init(struct nhal_can_context *ctx) {
+    Node &node = nodes_[ctx];
+    if (node.initialized) {
+        return NHAL_ERR_ALREADY_INITIALIZED;
+    }
+    node.initialized = true;
+    node.configured = false;
+    node.started = false;
+    node.filters.clear();
+    node.fifos.assign(node.resources.num_fifos, std::deque<nhal_can_frame_t>());
+    node.mailboxes.clear();
+    return NHAL_OK;
+}
+
+nhal_result_t NhalCanBusSim::deinit(struct nhal_can_context *ctx) {
+    Node *node = find(ctx);
+    if (node == nullptr) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    stop(ctx);
+    node->initialized = false;
+    node->configured = false;
+    return NHAL_OK;
+}
+
+nhal_result_t NhalCanBusSim::set_config(struct nhal_can_context *ctx, struct nhal_can_config *config) {
+    if (config == nullptr) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    Node *node = find(ctx);
+    if (node == nullptr) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    if (node->started) {
+        return NHAL_ERR_BUSY;
+    }
+    if (config->mode > NHAL_CAN_MODE_LOOPBACK || config->tx_priority > NHAL_CAN_TX_PRIORITY_FIFO ||
+        config->rx_watermark > node->resources.fifo_depth) {
+        return NHAL_ERR_INVALID_CONFIG;
+    }
+    // Every controller of the bus runs at the bus bit rate
+    if (config->bitrate != bitrate_) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    node->config = *config;
+    node->configured = true;
+    return NHAL_OK;
+}
+
+nhal_result_t NhalCanBusSim::get_config(struct nhal_can_context *ctx, struct nhal_can_config *config) {
+    if (config == nullptr) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    Node *node = find(ctx);
+    if (node == nullptr) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    if (!node->configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+    *config = node->config;
+    return NHAL_OK;
+}
+
+nhal_result_t NhalCanBusSim::set_filters(struct nhal_can_context *ctx, const nhal_can_filter_t *filters, size_t num_filters) {
+    if (filters == nullptr && num_filters != 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    Node *node = find(ctx);
+    if (node == nullptr) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    if (num_filters > node->resources.filter_banks) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    for (size_t i = 0; i < num_filters; i++) {
+        if (filters[i].fifo >= node->resources.num_fifos) {
+            return NHAL_ERR_INVALID_CONFIG;
+        }
+    }
+    node->filters.assign(filters, filters + num_filters);
+    return NHAL_OK;
+}
+
+nhal_result_t NhalCanBusSim::start(struct nhal_can_context *ctx) {
+    Node *node = find(ctx);
+    if (node == nullptr) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    if (!node->configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+    if (node->started) {
+        return NHAL_ERR_ALREADY_STARTED;
+    }
+    node->fifos.assign(node->resources.num_fifos, std::deque<nhal_can_frame_t>());
+    std::memset(&node->stats, 0, sizeof(node->stats));
+    std::memset(&node->sim_stats, 0, sizeof(node->sim_stats));
+    node->started = true;
+    kick();
+    return NHAL_OK;
+}
+
+nhal_result_t NhalCanBusSim::stop(struct nhal_can_context *ctx) {
+    Node *node = find(ctx);
+    if (node == nullptr) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    node->started = false;
+    node->mailboxes.clear();
+    return NHAL_OK;
+}
+
+nhal_result_t NhalCanBusSim::transmit(struct nhal_can_context *ctx, const nhal_can_frame_t *frame, uint32_t timeout_ms) {
+    if (frame == nullptr || !frame_valid(*frame)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    Node *node = find(ctx);
+    if (node == nullptr) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    if (!node->started) {
+        return NHAL_ERR_NOT_STARTED;
+    }
+    if (node->config.mode == NHAL_CAN_MODE_LISTEN_ONLY) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+
+    if (node->mailboxes.size() >= node->resources.tx_mailboxes && clock_ != nullptr && timeout_ms != 0) {
+        uint64_t deadline_ns = clock_->now_ns() + static_cast<uint64_t>(timeout_ms) * 1000000u;
+        while (node->mailboxes.size() >= node->resources.tx_mailboxes && node->started && wait_activity(deadline_ns)) {
+        }
+    }
+    if (!node->started) {
+        return NHAL_ERR_NOT_STARTED;
+    }
+    if (node->mailboxes.size() >= node->resources.tx_mailboxes) {
+        return NHAL_ERR_TIMEOUT;
+    }
+
+    Mailbox mailbox;
+    mailbox.frame = *frame;
+    mailbox.sequence = node->next_sequence++;
+    node->mailboxes.push_back(mailbox);
+    kick();
+    return NHAL_OK;
+}
+
+nhal_result_t NhalCanBusSim::receive(struct nhal_can_context *ctx, uint8_t fifo, nhal_can_frame_t *frames, size_t max_frames,
+                                     size_t *received, uint32_t timeout_ms) {
+    if (frames == nullptr || received == nullptr || max_frames == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    *received = 0;
+    Node *node = find(ctx);
+    if (node == nullptr) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    if (fifo >= node->fifos.size()) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!node->started) {
+        return NHAL_ERR_NOT_STARTED;
+    }
+
+    std::deque<nhal_can_frame_t> &queue = node->fifos[fifo];
+    if (queue.empty() && clock_ != nullptr && timeout_ms != 0) {
+        uint64_t deadline_ns = clock_->now_ns() + static_cast<uint64_t>(timeout_ms) * 1000000u;
+        while (queue.empty() && node->started && wait_activity(deadline_ns)) {
+        }
+    }
+    if (queue.empty()) {
+        return NHAL_ERR_TIMEOUT;
+    }
+
+    size_t count = std::min(max_frames, queue.size());
+    std::copy(queue.begin(), queue.begin() + static_cast<std::ptrdiff_t>(count), frames);
+    queue.erase(queue.begin(), queue.begin() + static_cast<std::ptrdiff_t>(count));
+    *received = count;
+    node->sim_stats.receive_calls++;
+    node->sim_stats.frames_read += count;
+    return NHAL_OK;
+}
+
+nhal_result_t NhalCanBusSim::get_stats(struct nhal_can_context *ctx, struct nhal_can_stats *stats) {
+    if (stats == nullptr) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    Node *node = find(ctx);
+    if (node == nullptr) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    *stats = node->stats;
+    return NHAL_OK;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file nhal_can_mock.cpp
+ * @brief C interface bridge for CAN mock
+ */
+
+#include "nhal_can_mock.hpp"
+
+extern "C" {
+    nhal_result_t nhal_can_init(struct nhal_can_context *ctx) {
+        return NhalCanMock::instance().nhal_can_init(ctx);
+    }
+
+    nhal_result_t nhal_can_deinit(struct nhal_can_context *ctx) {
+        return NhalCanMock::instance().nhal_can_deinit(ctx);
+    }
+
+    nhal_result_t nhal_can_set_config(struct nhal_can_context *ctx, struct nhal_can_config *config) {
+        return NhalCanMock::instance().nhal_can_set_config(ctx, config);
+    }
+
+    nhal_result_t nhal_can_get_config(struct nhal_can_context *ctx, struct nhal_can_config *config) {
+        return NhalCanMock::instance().nhal_can_get_config(ctx, config);
+    }
+
+    nhal_result_t nhal_can_set_filters(struct nhal_can_context *ctx, const nhal_can_filter_t *filters, size_t num_filters) {
+        return NhalCanMock::instance().nhal_can_set_filters(ctx, filters, num_filters);
+    }
+
+    nhal_result_t nhal_can_start(struct nhal_can_context *ctx) {
+        return NhalCanMock::instance().nhal_can_start(ctx);
+    }
+
+    nhal_result_t nhal_can_stop(struct nhal_can_context *ctx) {
+        return NhalCanMock::instance().nhal_can_stop(ctx);
+    }
+
+    nhal_result_t nhal_can_transmit(struct nhal_can_context *ctx, const nhal_can_frame_t *frame, uint32_t timeout_ms) {
+        return NhalCanMock::instance().nhal_can_transmit(ctx, frame, timeout_ms);
+    }
+
+    nhal_result_t nhal_can_receive(struct nhal_can_context *ctx, uint8_t fifo, nhal_can_frame_t *frames, size_t max_frames,
+                                   size_t *received, uint32_t timeout_ms) {
+        return NhalCanMock::instance().nhal_can_receive(ctx, fifo, frames, max_frames, received, timeout_ms);
+    }
+
+    nhal_result_t nhal_can_get_stats(struct nhal_can_context *ctx, struct nhal_can_stats *stats) {
+        return NhalCanMock::instance().nhal_can_get_stats(ctx, stats);
+    }
+}
@@ -4,22 +4,57 @@
  */
 
 #include "nhal_common_mock.hpp"
+#include "nhal_virtual_clock.hpp"
 
-// C interface implementations that delegate to the mock
+// C interface implementations that delegate to the virtual clock bound to the
+// calling thread if there is one, or to the mock otherwise
 extern "C" {
     void nhal_delay_microseconds(uint32_t microseconds) {
+        NhalVirtualClock *clock = NhalVirtualClock::current();
+        if (clock != nullptr) {
+            clock->advance_us(microseconds);
+            return;
+        }
         NhalCommonMock::instance().nhal_delay_microseconds(microseconds);
     }
 
     void nhal_delay_milliseconds(uint32_t milliseconds) {
+        NhalVirtualClock *clock = NhalVirtualClock::current();
+        if (clock != nullptr) {
+            clock->advance_us(static_cast<uint64_t>(milliseconds) * 1000u);
+            return;
+        }
         NhalCommonMock::instance().nhal_delay_milliseconds(milliseconds);
     }
 
     uint64_t nhal_get_timestamp_microseconds(void) {
+        NhalVirtualClock *clock = NhalVirtualClock::current();
+        if (clock != nullptr) {
+            return clock->read_timestamp_ns() / 1000u;
+        }
         return NhalCommonMock::instance().nhal_get_timestamp_microseconds();
     }
 
     uint32_t nhal_get_timestamp_milliseconds(void) {
+        NhalVirtualClock *clock = NhalVirtualClock::current();
+        if (clock != nullptr) {
+            return static_cast<uint32_t>(clock->read_timestamp_ns() / 1000000u);
+        }
         return NhalCommonMock::instance().nhal_get_timestamp_milliseconds();
     }
-}
\ No newline at end of file
+
+    uint64_t nhal_get_timestamp_ticks(void) {
+        NhalVirtualClock *clock = NhalVirtualClock::current();
+        if (clock != nullptr) {
+            return clock->read_timestamp_ns();
+        }
+        return NhalCommonMock::instance().nhal_get_timestamp_ticks();
+    }
+
+    nhal_result_t nhal_get_tick_calibration(struct nhal_tick_calibration *cal) {
+        if (NhalVirtualClock::current() != nullptr) {
+            return nhal_tick_calibration_from_frequency(cal, 1000000000u);
+        }
+        return NhalCommonMock::instance().nhal_get_tick_calibration(cal);
+    }
+}
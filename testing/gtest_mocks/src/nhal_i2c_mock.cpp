@@ -39,4 +39,16 @@ extern "C" {
     nhal_result_t nhal_i2c_master_perform_transfer(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, nhal_i2c_transfer_op_t *ops, size_t num_ops) {
         return NhalI2cMock::instance().nhal_i2c_master_perform_transfer(ctx, dev_address, ops, num_ops);
     }
+
+    nhal_result_t nhal_i2c_master_perform_transfer_packed(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const struct nhal_i2c_packed_ops *ops) {
+        return NhalI2cMock::instance().nhal_i2c_master_perform_transfer_packed(ctx, dev_address, ops);
+    }
+    // I2C configuration image interface implementations
+    nhal_result_t nhal_i2c_master_config_image_build(struct nhal_i2c_context *ctx, const struct nhal_i2c_config *config, struct nhal_i2c_config_image *image) {
+        return NhalI2cMock::instance().nhal_i2c_master_config_image_build(ctx, config, image);
+    }
+
+    nhal_result_t nhal_i2c_master_config_image_apply(struct nhal_i2c_context *ctx, const struct nhal_i2c_config_image *image) {
+        return NhalI2cMock::instance().nhal_i2c_master_config_image_apply(ctx, image);
+    }
 }
@@ -0,0 +1,428 @@
+/**
+ * @file nhal_nor_flash_sim.cpp
+ * @brief Simulated serial NOR flash implementation
+ */
+
+#include "nhal_nor_flash_sim.hpp"
+#include "nhal_virtual_clock.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+const size_t NhalNorFlashSim::PAGE_SIZE;
+const size_t NhalNorFlashSim::SECTOR_SIZE;
+const size_t NhalNorFlashSim::BLOCK_SIZE;
+const uint8_t NhalNorFlashSim::STATUS_WIP;
+const uint8_t NhalNorFlashSim::STATUS_WEL;
+
+namespace {
+
+uint8_t lines(nhal_qspi_width_t width) {
+    switch (width) {
+    case NHAL_QSPI_WIDTH_1: return 1;
+    case NHAL_QSPI_WIDTH_2: return 2;
+    case NHAL_QSPI_WIDTH_4: return 4;
+    case NHAL_QSPI_WIDTH_8: return 8;
+    default: return 0;
+    }
+}
+
+uint64_t phase_cycles(uint64_t bytes, uint8_t width, bool ddr) {
+    if (width == 0 || bytes == 0) {
+        return 0;
+    }
+    uint64_t per_cycle = ddr ? 2u * width : width;
+    return (bytes * 8u + per_cycle - 1) / per_cycle;
+}
+
+} // namespace
+
+NhalNorFlashSim::NhalNorFlashSim(size_t size, uint32_t jedec_id)
+    : memory_(size, 0xFF), erase_counts_((size + SECTOR_SIZE - 1) / SECTOR_SIZE, 0), busy_until_ns_(0), jedec_id_(jedec_id), address_bytes_(size > (1u << 24) ? 4 : 3),
+      status_(0), qpi_(false), mapped_(false), bus_clock_hz_(0) {
+    std::memset(&map_cmd_, 0, sizeof(map_cmd_));
+    std::memset(&map_opcode_, 0, sizeof(map_opcode_));
+    timing_.page_program_ns = 700000;
+    timing_.sector_erase_ns = 45000000;
+    timing_.block_erase_ns = 150000000;
+    timing_.chip_erase_ns = 25000000000ull;
+    reset_stats();
+}
+
+uint8_t NhalNorFlashSim::status() const {
+    return static_cast<uint8_t>(status_ | (busy() ? STATUS_WIP : 0));
+}
+
+uint32_t NhalNorFlashSim::max_erase_count() const {
+    return erase_counts_.empty() ? 0 : *std::max_element(erase_counts_.begin(), erase_counts_.end());
+}
+
+bool NhalNorFlashSim::busy() const {
+    NhalVirtualClock *clock = NhalVirtualClock::current();
+    return clock != nullptr && clock->now_ns() < busy_until_ns_;
+}
+
+void NhalNorFlashSim::start_busy(uint64_t duration_ns) {
+    NhalVirtualClock *clock = NhalVirtualClock::current();
+    stats_.busy_ns += duration_ns;
+    if (clock != nullptr) {
+        busy_until_ns_ = clock->now_ns() + duration_ns;
+    }
+}
+
+uint64_t NhalNorFlashSim::command_cycles(const nhal_qspi_command_t *cmd, const Opcode &opcode, size_t len) const {
+    bool ddr = (cmd->flags & NHAL_QSPI_CMD_DDR) != 0;
+    uint8_t alternate_lines = lines(cmd->alternate_width);
+    return phase_cycles(1, lines(cmd->instruction_width), false) +
+           phase_cycles(opcode.address_width ? cmd->address_bytes : 0, opcode.address_width, ddr) +
+           phase_cycles(alternate_lines ? cmd->alternate_bytes : 0, alternate_lines, ddr) +
+           cmd->dummy_cycles +
+           phase_cycles(len, opcode.data_width, ddr);
+}
+
+void NhalNorFlashSim::charge_bus(uint64_t cycles) {
+    NhalVirtualClock *clock = NhalVirtualClock::current();
+    stats_.bus_cycles += cycles;
+    if (clock != nullptr && bus_clock_hz_ != 0) {
+        clock->advance_ns((cycles * 1000000000u + bus_clock_hz_ - 1) / bus_clock_hz_);
+    }
+}
+
+void NhalNorFlashSim::reset_stats() {
+    std::memset(&stats_, 0, sizeof(stats_));
+}
+
+void NhalNorFlashSim::load(uint32_t address, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        memory_[(address + i) % memory_.size()] = data[i];
+    }
+}
+
+const NhalNorFlashSim::Opcode *NhalNorFlashSim::find_opcode(uint16_t instruction) const {
+    // Command set in SPI mode: instruction always on 1 line
+    static const Opcode spi_opcodes[] = {
+        { 0x9F, OP_READ_ID,       0, 1, 0, false },  // Read JEDEC ID
+        { 0x05, OP_READ_STATUS,   0, 1, 0, false },  // Read status register
+        { 0x06, OP_WRITE_ENABLE,  0, 0, 0, false },
+        { 0x04, OP_WRITE_DISABLE, 0, 0, 0, false },
+        { 0x03, OP_READ,          1, 1, 0, false },  // Read (1-1-1)
+        { 0x0B, OP_READ,          1, 1, 8, false },  // Fast read (1-1-1)
+        { 0x3B, OP_READ,          1, 2, 8, false },  // Dual output read (1-1-2)
+        { 0xBB, OP_READ,          2, 2, 4, false },  // Dual I/O read (1-2-2)
+        { 0x6B, OP_READ,          1, 4, 8, false },  // Quad output read (1-1-4)
+        { 0xEB, OP_READ,          4, 4, 6, false },  // Quad I/O read (1-4-4)
+        { 0x0D, OP_READ,          1, 1, 6, true },   // DTR fast read (1-1-1)
+        { 0xED, OP_READ,          4, 4, 8, true },   // DTR quad I/O read (1-4-4)
+        { 0x02, OP_PROGRAM,       1, 1, 0, false },  // Page program (1-1-1)
+        { 0x32, OP_PROGRAM,       1, 4, 0, false },  // Quad page program (1-1-4)
+        { 0x20, OP_ERASE_SECTOR,  1, 0, 0, false },
+        { 0xD8, OP_ERASE_BLOCK,   1, 0, 0, false },
+        { 0xC7, OP_ERASE_CHIP,    0, 0, 0, false },
+        { 0x60, OP_ERASE_CHIP,    0, 0, 0, false },
+        { 0x38, OP_ENTER_QPI,     0, 0, 0, false },
+    };
+    // Command set in QPI mode: every phase on 4 lines
+    static const Opcode qpi_opcodes[] = {
+        { 0x9F, OP_READ_ID,       0, 4, 0, false },
+        { 0x05, OP_READ_STATUS,   0, 4, 0, false },
+        { 0x06, OP_WRITE_ENABLE,  0, 0, 0, false },
+        { 0x04, OP_WRITE_DISABLE, 0, 0, 0, false },
+        { 0x0B, OP_READ,          4, 4, 6, false },  // Fast read (4-4-4)
+        { 0xEB, OP_READ,          4, 4, 6, false },  // Quad I/O read (4-4-4)
+        { 0x0D, OP_READ,          4, 4, 6, true },   // DTR fast read (4-4-4)
+        { 0xED, OP_READ,          4, 4, 8, true },   // DTR quad I/O read (4-4-4)
+        { 0x02, OP_PROGRAM,       4, 4, 0, false },
+        { 0x20, OP_ERASE_SECTOR,  4, 0, 0, false },
+        { 0xD8, OP_ERASE_BLOCK,   4, 0, 0, false },
+        { 0xC7, OP_ERASE_CHIP,    0, 0, 0, false },
+        { 0x60, OP_ERASE_CHIP,    0, 0, 0, false },
+        { 0xFF, OP_EXIT_QPI,      0, 0, 0, false },
+    };
+
+    const Opcode *table = qpi_ ? qpi_opcodes : spi_opcodes;
+    size_t count = qpi_ ? sizeof(qpi_opcodes) / sizeof(qpi_opcodes[0]) : sizeof(spi_opcodes) / sizeof(spi_opcodes[0]);
+    const Opcode *opcode = nullptr;
+    for (size_t i = 0; i < count && opcode == nullptr; i++) {
+        if (table[i].instruction == instruction) {
+            opcode = &table[i];
+        }
+    }
+    return opcode;
+}
+
+bool NhalNorFlashSim::decode(const nhal_qspi_command_t *cmd, Direction dir, size_t len, Opcode *decoded) const {
+    const Opcode *opcode = find_opcode(cmd->instruction);
+    if (opcode == nullptr) {
+        return false;
+    }
+
+    bool ddr = (cmd->flags & NHAL_QSPI_CMD_DDR) != 0;
+    uint8_t alternate_lines = lines(cmd->alternate_width);
+    uint64_t wait = cmd->dummy_cycles + phase_cycles(alternate_lines ? cmd->alternate_bytes : 0, alternate_lines, ddr);
+    Direction expected_dir = opcode->data_width == 0 ? DIR_NONE
+                           : (opcode->op == OP_PROGRAM ? DIR_WRITE : DIR_READ);
+
+    if (lines(cmd->instruction_width) != (qpi_ ? 4 : 1) ||
+        cmd->instruction_bytes > 1 ||
+        lines(cmd->address_width) != opcode->address_width ||
+        (opcode->address_width != 0 && cmd->address_bytes != address_bytes_) ||
+        (alternate_lines != 0 && alternate_lines != opcode->address_width) ||
+        wait != opcode->wait_cycles ||
+        lines(cmd->data_width) != opcode->data_width ||
+        ddr != opcode->ddr ||
+        dir != expected_dir ||
+        (dir != DIR_NONE && len == 0)) {
+        return false;
+    }
+    *decoded = *opcode;
+    return true;
+}
+
+nhal_result_t NhalNorFlashSim::execute(const nhal_qspi_command_t *cmd, Direction dir,
+                                       const uint8_t *tx, uint8_t *rx, size_t len) {
+    if (cmd == nullptr || (dir == DIR_WRITE && tx == nullptr) || (dir == DIR_READ && rx == nullptr)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (mapped_) {
+        return NHAL_ERR_BUSY;
+    }
+
+    Opcode opcode;
+    if (!decode(cmd, dir, len, &opcode)) {
+        stats_.protocol_errors++;
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (opcode.op != OP_READ_STATUS && busy()) {
+        stats_.busy_violations++;
+        return NHAL_ERR_BUSY;
+    }
+
+    stats_.commands++;
+    charge_bus(command_cycles(cmd, opcode, len));
+
+    perform(opcode.op, cmd->address, tx, rx, len);
+    return NHAL_OK;
+}
+
+void NhalNorFlashSim::perform(Op op, uint32_t address, const uint8_t *tx, uint8_t *rx, size_t len) {
+    size_t size = memory_.size();
+    address = static_cast<uint32_t>(address % size);
+
+    switch (op) {
+    case OP_READ_ID:
+        for (size_t i = 0; i < len; i++) {
+            rx[i] = i < 3 ? static_cast<uint8_t>(jedec_id_ >> (8 * (2 - i))) : 0;
+        }
+        break;
+    case OP_READ_STATUS:
+        std::memset(rx, status(), len);
+        break;
+    case OP_WRITE_ENABLE:
+        status_ |= STATUS_WEL;
+        break;
+    case OP_WRITE_DISABLE:
+        status_ &= static_cast<uint8_t>(~STATUS_WEL);
+        break;
+    case OP_READ:
+        for (size_t i = 0; i < len; i++) {
+            rx[i] = memory_[(address + i) % size];
+        }
+        stats_.bytes_read += len;
+        break;
+    case OP_PROGRAM:
+    case OP_ERASE_SECTOR:
+    case OP_ERASE_BLOCK:
+    case OP_ERASE_CHIP:
+        if ((status_ & STATUS_WEL) == 0) {
+            stats_.ignored_writes++;
+            break;
+        }
+        status_ &= static_cast<uint8_t>(~STATUS_WEL);
+        if (op == OP_PROGRAM) {
+            // Data beyond the page boundary wraps to the start of the page
+            size_t page = address - address % PAGE_SIZE;
+            for (size_t i = 0; i < len; i++) {
+                uint8_t &cell = memory_[page + (address + i) % PAGE_SIZE];
+                if ((tx[i] & ~cell) != 0) {
+                    stats_.program_conflicts++;
+                }
+                cell &= tx[i];
+            }
+            stats_.bytes_programmed += len;
+            start_busy(timing_.page_program_ns);
+        } else {
+            size_t unit = op == OP_ERASE_SECTOR ? SECTOR_SIZE : (op == OP_ERASE_BLOCK ? BLOCK_SIZE : size);
+            size_t start = address - address % unit;
+            // A last sector or block cut short by the end of memory
+            unit = std::min(unit, size - start);
+            std::fill_n(memory_.begin() + start, unit, 0xFF);
+            for (size_t sector = start / SECTOR_SIZE; sector < (start + unit + SECTOR_SIZE - 1) / SECTOR_SIZE; sector++) {
+                erase_counts_[sector]++;
+            }
+            if (op == OP_ERASE_SECTOR) {
+                stats_.sector_erases++;
+                start_busy(timing_.sector_erase_ns);
+            } else if (op == OP_ERASE_BLOCK) {
+                stats_.block_erases++;
+                start_busy(timing_.block_erase_ns);
+            } else {
+                stats_.chip_erases++;
+                start_busy(timing_.chip_erase_ns);
+            }
+        }
+        break;
+    case OP_ENTER_QPI:
+        qpi_ = true;
+        break;
+    case OP_EXIT_QPI:
+        qpi_ = false;
+        break;
+    }
+}
+
+nhal_result_t NhalNorFlashSim::command(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd) {
+    (void)ctx;
+    return execute(cmd, DIR_NONE, nullptr, nullptr, 0);
+}
+
+nhal_result_t NhalNorFlashSim::write(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd,
+                                     const uint8_t *data, size_t len) {
+    (void)ctx;
+    return execute(cmd, DIR_WRITE, data, nullptr, len);
+}
+
+nhal_result_t NhalNorFlashSim::read(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd,
+                                    uint8_t *data, size_t len) {
+    (void)ctx;
+    return execute(cmd, DIR_READ, nullptr, data, len);
+}
+
+nhal_result_t NhalNorFlashSim::poll_status(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd,
+                                           uint8_t mask, uint8_t match, uint32_t timeout_ms) {
+    NhalVirtualClock *clock = NhalVirtualClock::current();
+    uint64_t deadline_ns = clock != nullptr ? clock->now_ns() + static_cast<uint64_t>(timeout_ms) * 1000000u : 0;
+
+    for (;;) {
+        uint8_t status = 0;
+        nhal_result_t result = read(ctx, cmd, &status, 1);
+        if (result != NHAL_OK) {
+            return result;
+        }
+        if ((status & mask) == match) {
+            return NHAL_OK;
+        }
+        // The status only changes when a pending operation ends
+        if (!busy()) {
+            return NHAL_ERR_TIMEOUT;
+        }
+        if (busy_until_ns_ > deadline_ns) {
+            clock->advance_to_ns(deadline_ns);
+            return NHAL_ERR_TIMEOUT;
+        }
+        clock->advance_to_ns(busy_until_ns_);
+    }
+}
+
+nhal_result_t NhalNorFlashSim::memory_map_enable(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *read_cmd,
+                                                 const volatile uint8_t **base) {
+    (void)ctx;
+    if (read_cmd == nullptr || base == nullptr) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (mapped_) {
+        return NHAL_ERR_BUSY;
+    }
+    Opcode opcode;
+    if (!decode(read_cmd, DIR_READ, 1, &opcode) || opcode.op != OP_READ) {
+        stats_.protocol_errors++;
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (busy()) {
+        stats_.busy_violations++;
+        return NHAL_ERR_BUSY;
+    }
+    mapped_ = true;
+    map_cmd_ = *read_cmd;
+    map_opcode_ = opcode;
+    stats_.map_sessions++;
+    *base = memory_.data();
+    return NHAL_OK;
+}
+
+nhal_result_t NhalNorFlashSim::mapped_read(uint32_t address, uint8_t *data, size_t len) {
+    if (data == nullptr || len == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!mapped_) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+    size_t size = memory_.size();
+    charge_bus(command_cycles(&map_cmd_, map_opcode_, len));
+    for (size_t i = 0; i < len; i++) {
+        data[i] = memory_[(address + i) % size];
+    }
+    stats_.mapped_reads++;
+    stats_.mapped_bytes_read += len;
+    return NHAL_OK;
+}
+
+nhal_result_t NhalNorFlashSim::memory_map_disable(struct nhal_qspi_context *ctx) {
+    (void)ctx;
+    mapped_ = false;
+    return NHAL_OK;
+}
+
+nhal_result_t NhalNorFlashSim::spi_write(struct nhal_spi_context *ctx, const uint8_t *data, size_t len) {
+    return spi_write_read(ctx, data, len, nullptr, 0);
+}
+
+nhal_result_t NhalNorFlashSim::spi_write_read(struct nhal_spi_context *ctx, const uint8_t *tx_data, size_t tx_len,
+                                              uint8_t *rx_data, size_t rx_len) {
+    (void)ctx;
+    if (tx_data == nullptr || tx_len == 0) {
+        stats_.protocol_errors++;
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    // Only single line SDR commands can travel over a plain SPI bus
+    const Opcode *opcode = find_opcode(tx_data[0]);
+    if (qpi_ || opcode == nullptr || opcode->address_width > 1 || opcode->data_width > 1 || opcode->ddr) {
+        stats_.protocol_errors++;
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_qspi_command_t cmd;
+    std::memset(&cmd, 0, sizeof(cmd));
+    cmd.instruction = tx_data[0];
+    cmd.instruction_width = NHAL_QSPI_WIDTH_1;
+    size_t header_len = 1;
+    if (opcode->address_width != 0) {
+        if (tx_len < 1u + address_bytes_) {
+            stats_.protocol_errors++;
+            return NHAL_ERR_INVALID_ARG;
+        }
+        cmd.address_width = NHAL_QSPI_WIDTH_1;
+        cmd.address_bytes = address_bytes_;
+        for (uint8_t i = 0; i < address_bytes_; i++) {
+            cmd.address = (cmd.address << 8) | tx_data[1 + i];
+        }
+        header_len += address_bytes_;
+    }
+    cmd.dummy_cycles = opcode->wait_cycles;
+    header_len += opcode->wait_cycles / 8u;
+    if (opcode->data_width != 0) {
+        cmd.data_width = NHAL_QSPI_WIDTH_1;
+    }
+    if (tx_len < header_len || (tx_len > header_len && rx_len != 0)) {
+        stats_.protocol_errors++;
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (tx_len > header_len) {
+        return execute(&cmd, DIR_WRITE, tx_data + header_len, nullptr, tx_len - header_len);
+    }
+    if (rx_len != 0) {
+        return execute(&cmd, DIR_READ, nullptr, rx_data, rx_len);
+    }
+    return execute(&cmd, DIR_NONE, nullptr, nullptr, 0);
+}
@@ -0,0 +1,44 @@
+/**
+ * @file nhal_onewire_mock.cpp
+ * @brief C interface bridge for 1-Wire mock
+ */
+
+#include "nhal_onewire_mock.hpp"
+
+extern "C" {
+    nhal_result_t nhal_onewire_init(struct nhal_onewire_context *ctx) {
+        return NhalOnewireMock::instance().nhal_onewire_init(ctx);
+    }
+
+    nhal_result_t nhal_onewire_deinit(struct nhal_onewire_context *ctx) {
+        return NhalOnewireMock::instance().nhal_onewire_deinit(ctx);
+    }
+
+    nhal_result_t nhal_onewire_set_config(struct nhal_onewire_context *ctx, struct nhal_onewire_config *config) {
+        return NhalOnewireMock::instance().nhal_onewire_set_config(ctx, config);
+    }
+
+    nhal_result_t nhal_onewire_get_config(struct nhal_onewire_context *ctx, struct nhal_onewire_config *config) {
+        return NhalOnewireMock::instance().nhal_onewire_get_config(ctx, config);
+    }
+
+    nhal_result_t nhal_onewire_reset(struct nhal_onewire_context *ctx, bool *presence) {
+        return NhalOnewireMock::instance().nhal_onewire_reset(ctx, presence);
+    }
+
+    nhal_result_t nhal_onewire_write_bit(struct nhal_onewire_context *ctx, bool bit) {
+        return NhalOnewireMock::instance().nhal_onewire_write_bit(ctx, bit);
+    }
+
+    nhal_result_t nhal_onewire_read_bit(struct nhal_onewire_context *ctx, bool *bit) {
+        return NhalOnewireMock::instance().nhal_onewire_read_bit(ctx, bit);
+    }
+
+    nhal_result_t nhal_onewire_write(struct nhal_onewire_context *ctx, const uint8_t *data, size_t len) {
+        return NhalOnewireMock::instance().nhal_onewire_write(ctx, data, len);
+    }
+
+    nhal_result_t nhal_onewire_read(struct nhal_onewire_context *ctx, uint8_t *data, size_t len) {
+        return NhalOnewireMock::instance().nhal_onewire_read(ctx, data, len);
+    }
+}
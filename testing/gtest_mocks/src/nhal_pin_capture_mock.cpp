@@ -0,0 +1,44 @@
+/**
+ * @file nhal_pin_capture_mock.cpp
+ * @brief C interface bridge for Pin Input Capture mock
+ */
+
+#include "nhal_pin_capture_mock.hpp"
+
+extern "C" {
+    nhal_result_t nhal_pin_capture_init(struct nhal_pin_capture_context *ctx) {
+        return NhalPinCaptureMock::instance().nhal_pin_capture_init(ctx);
+    }
+
+    nhal_result_t nhal_pin_capture_deinit(struct nhal_pin_capture_context *ctx) {
+        return NhalPinCaptureMock::instance().nhal_pin_capture_deinit(ctx);
+    }
+
+    nhal_result_t nhal_pin_capture_set_config(struct nhal_pin_capture_context *ctx, struct nhal_pin_capture_config *config) {
+        return NhalPinCaptureMock::instance().nhal_pin_capture_set_config(ctx, config);
+    }
+
+    nhal_result_t nhal_pin_capture_get_config(struct nhal_pin_capture_context *ctx, struct nhal_pin_capture_config *config) {
+        return NhalPinCaptureMock::instance().nhal_pin_capture_get_config(ctx, config);
+    }
+
+    nhal_result_t nhal_pin_capture_get_timer_frequency(struct nhal_pin_capture_context *ctx, uint32_t *frequency_hz) {
+        return NhalPinCaptureMock::instance().nhal_pin_capture_get_timer_frequency(ctx, frequency_hz);
+    }
+
+    nhal_result_t nhal_pin_capture_start(struct nhal_pin_capture_context *ctx) {
+        return NhalPinCaptureMock::instance().nhal_pin_capture_start(ctx);
+    }
+
+    nhal_result_t nhal_pin_capture_stop(struct nhal_pin_capture_context *ctx) {
+        return NhalPinCaptureMock::instance().nhal_pin_capture_stop(ctx);
+    }
+
+    nhal_result_t nhal_pin_capture_read(struct nhal_pin_capture_context *ctx, nhal_pin_capture_sample_t *samples, size_t max_samples, size_t *num_samples) {
+        return NhalPinCaptureMock::instance().nhal_pin_capture_read(ctx, samples, max_samples, num_samples);
+    }
+
+    nhal_result_t nhal_pin_capture_get_stats(struct nhal_pin_capture_context *ctx, struct nhal_pin_capture_stats *stats) {
+        return NhalPinCaptureMock::instance().nhal_pin_capture_get_stats(ctx, stats);
+    }
+}
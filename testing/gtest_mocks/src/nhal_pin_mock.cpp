@@ -5,6 +5,83 @@
 
 #include "nhal_pin_mock.hpp"
 
+static bool trigger_matches(nhal_pin_int_trigger_t trigger, nhal_pin_state_t previous, nhal_pin_state_t level) {
+    switch (trigger) {
+        case NHAL_PIN_INT_TRIGGER_RISING_EDGE:  return previous == NHAL_PIN_LOW && level == NHAL_PIN_HIGH;
+        case NHAL_PIN_INT_TRIGGER_FALLING_EDGE: return previous == NHAL_PIN_HIGH && level == NHAL_PIN_LOW;
+        case NHAL_PIN_INT_TRIGGER_BOTH_EDGES:   return previous != level;
+        case NHAL_PIN_INT_TRIGGER_HIGH_LEVEL:   return level == NHAL_PIN_HIGH;
+        case NHAL_PIN_INT_TRIGGER_LOW_LEVEL:    return level == NHAL_PIN_LOW;
+        default:                                return false;
+    }
+}
+
+bool NhalPinMock::inject_edge(struct nhal_pin_context *ctx, nhal_pin_state_t level) {
+    nhal_pin_callback_t callback = nullptr;
+    void *user_data = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(interrupts_lock_);
+        auto it = interrupts_.find(ctx);
+        if (it == interrupts_.end()) {
+            return false;
+        }
+        InterruptRegistration &reg = it->second;
+        nhal_pin_state_t previous = reg.level;
+        reg.level = level;
+        if (!reg.enabled || reg.callback == nullptr || !trigger_matches(reg.trigger, previous, level)) {
+            return false;
+        }
+        callback = reg.callback;
+        user_data = reg.user_data;
+    }
+    // Run outside the lock, the callback may reconfigure the interrupt
+    callback(ctx, user_data);
+    return true;
+}
+
+size_t NhalPinMock::inject_pulses(struct nhal_pin_context *ctx, size_t count) {
+    size_t fired = 0;
+    for (size_t i = 0; i < count; i++) {
+        fired += inject_edge(ctx, NHAL_PIN_HIGH) ? 1 : 0;
+        fired += inject_edge(ctx, NHAL_PIN_LOW) ? 1 : 0;
+    }
+    return fired;
+}
+
+bool NhalPinMock::interrupt_enabled(struct nhal_pin_context *ctx) {
+    std::lock_guard<std::mutex> guard(interrupts_lock_);
+    auto it = interrupts_.find(ctx);
+    return it != interrupts_.end() && it->second.enabled;
+}
+
+void NhalPinMock::clear_interrupts() {
+    std::lock_guard<std::mutex> guard(interrupts_lock_);
+    interrupts_.clear();
+}
+
+void NhalPinMock::record_interrupt_config(struct nhal_pin_context *ctx, nhal_pin_int_trigger_t trigger, nhal_pin_callback_t callback, void *user_data) {
+    std::lock_guard<std::mutex> guard(interrupts_lock_);
+    auto it = interrupts_.find(ctx);
+    if (it == interrupts_.end()) {
+        InterruptRegistration reg = { trigger, callback, user_data, false, NHAL_PIN_LOW };
+        interrupts_[ctx] = reg;
+    } else {
+        it->second.trigger = trigger;
+        it->second.callback = callback;
+        it->second.user_data = user_data;
+        // Reconfiguring disables the interrupt until it is enabled again
+        it->second.enabled = false;
+    }
+}
+
+void NhalPinMock::record_interrupt_enabled(struct nhal_pin_context *ctx, bool enabled) {
+    std::lock_guard<std::mutex> guard(interrupts_lock_);
+    auto it = interrupts_.find(ctx);
+    if (it != interrupts_.end()) {
+        it->second.enabled = enabled;
+    }
+}
+
 extern "C" {
     nhal_result_t nhal_pin_init(struct nhal_pin_context *ctx) {
         return NhalPinMock::instance().nhal_pin_init(ctx);
@@ -30,11 +107,60 @@ extern "C" {
         return NhalPinMock::instance().nhal_pin_get_state(ctx, value);
     }
 
-    nhal_result_t nhal_pin_set_callback(struct nhal_pin_context *ctx, nhal_pin_callback_t callback) {
-        return NhalPinMock::instance().nhal_pin_set_callback(ctx, callback);
-    }
-
     nhal_result_t nhal_pin_set_direction(struct nhal_pin_context *ctx, nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode) {
         return NhalPinMock::instance().nhal_pin_set_direction(ctx, direction, pull_mode);
     }
+
+    // Pin interrupt interface implementations, recording successful calls for edge injection
+    nhal_result_t nhal_pin_set_interrupt_config(struct nhal_pin_context *ctx, nhal_pin_int_trigger_t trigger, nhal_pin_callback_t callback, void *user_data) {
+        NhalPinMock &mock = NhalPinMock::instance();
+        nhal_result_t result = mock.nhal_pin_set_interrupt_config(ctx, trigger, callback, user_data);
+        if (result == NHAL_OK) {
+            mock.record_interrupt_config(ctx, trigger, callback, user_data);
+        }
+        return result;
+    }
+
+    nhal_result_t nhal_pin_interrupt_enable(struct nhal_pin_context *ctx) {
+        NhalPinMock &mock = NhalPinMock::instance();
+        nhal_result_t result = mock.nhal_pin_interrupt_enable(ctx);
+        if (result == NHAL_OK) {
+            mock.record_interrupt_enabled(ctx, true);
+        }
+        return result;
+    }
+
+    nhal_result_t nhal_pin_interrupt_disable(struct nhal_pin_context *ctx) {
+        NhalPinMock &mock = NhalPinMock::instance();
+        nhal_result_t result = mock.nhal_pin_interrupt_disable(ctx);
+        if (result == NHAL_OK) {
+            mock.record_interrupt_enabled(ctx, false);
+        }
+        return result;
+    }
+
+    // Pin group interface implementations
+    nhal_result_t nhal_pin_group_init(struct nhal_pin_group_context *ctx) {
+        return NhalPinMock::instance().nhal_pin_group_init(ctx);
+    }
+
+    nhal_result_t nhal_pin_group_deinit(struct nhal_pin_group_context *ctx) {
+        return NhalPinMock::instance().nhal_pin_group_deinit(ctx);
+    }
+
+    nhal_result_t nhal_pin_group_set_direction(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode) {
+        return NhalPinMock::instance().nhal_pin_group_set_direction(ctx, mask, direction, pull_mode);
+    }
+
+    nhal_result_t nhal_pin_group_write(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, nhal_pin_group_mask_t values) {
+        return NhalPinMock::instance().nhal_pin_group_write(ctx, mask, values);
+    }
+
+    nhal_result_t nhal_pin_group_read(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t *values) {
+        return NhalPinMock::instance().nhal_pin_group_read(ctx, values);
+    }
+
+    nhal_result_t nhal_pin_group_run_sequence(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, const nhal_pin_group_mask_t *out_values, nhal_pin_group_mask_t *in_values, size_t count, uint32_t step_ns) {
+        return NhalPinMock::instance().nhal_pin_group_run_sequence(ctx, mask, out_values, in_values, count, step_ns);
+    }
 }
\ No newline at end of file
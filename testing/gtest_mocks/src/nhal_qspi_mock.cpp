@@ -0,0 +1,52 @@
+/**
+ * @file nhal_qspi_mock.cpp
+ * @brief C interface bridge for QSPI mock
+ */
+
+#include "nhal_qspi_mock.hpp"
+
+extern "C" {
+    nhal_result_t nhal_qspi_init(struct nhal_qspi_context *ctx) {
+        return NhalQspiMock::instance().nhal_qspi_init(ctx);
+    }
+
+    nhal_result_t nhal_qspi_deinit(struct nhal_qspi_context *ctx) {
+        return NhalQspiMock::instance().nhal_qspi_deinit(ctx);
+    }
+
+    nhal_result_t nhal_qspi_set_config(struct nhal_qspi_context *ctx, struct nhal_qspi_config *config) {
+        return NhalQspiMock::instance().nhal_qspi_set_config(ctx, config);
+    }
+
+    nhal_result_t nhal_qspi_get_config(struct nhal_qspi_context *ctx, struct nhal_qspi_config *config) {
+        return NhalQspiMock::instance().nhal_qspi_get_config(ctx, config);
+    }
+
+    nhal_result_t nhal_qspi_command(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd) {
+        return NhalQspiMock::instance().nhal_qspi_command(ctx, cmd);
+    }
+
+    nhal_result_t nhal_qspi_write(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd,
+                                  const uint8_t *data, size_t len) {
+        return NhalQspiMock::instance().nhal_qspi_write(ctx, cmd, data, len);
+    }
+
+    nhal_result_t nhal_qspi_read(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd,
+                                 uint8_t *data, size_t len) {
+        return NhalQspiMock::instance().nhal_qspi_read(ctx, cmd, data, len);
+    }
+
+    nhal_result_t nhal_qspi_poll_status(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *cmd,
+                                        uint8_t mask, uint8_t match, uint32_t timeout_ms) {
+        return NhalQspiMock::instance().nhal_qspi_poll_status(ctx, cmd, mask, match, timeout_ms);
+    }
+
+    nhal_result_t nhal_qspi_memory_map_enable(struct nhal_qspi_context *ctx, const nhal_qspi_command_t *read_cmd,
+                                              const volatile uint8_t **base) {
+        return NhalQspiMock::instance().nhal_qspi_memory_map_enable(ctx, read_cmd, base);
+    }
+
+    nhal_result_t nhal_qspi_memory_map_disable(struct nhal_qspi_context *ctx) {
+        return NhalQspiMock::instance().nhal_qspi_memory_map_disable(ctx);
+    }
+}
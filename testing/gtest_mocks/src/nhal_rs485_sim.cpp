@@ -0,0 +1,135 @@
+/**
+ * @file nhal_rs485_sim.cpp
+ * @brief Simulated RS-485 half-duplex link implementation
+ */
+
+#include "nhal_rs485_sim.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+NhalRs485Sim::NhalRs485Sim()
+    : configured_(false), rs485_enabled_(false), response_delay_ns_(0), bus_used_(false), bus_idle_since_ns_(0),
+      collisions_(0) {
+    std::memset(&config_, 0, sizeof(config_));
+    std::memset(&rs485_, 0, sizeof(rs485_));
+}
+
+nhal_result_t NhalRs485Sim::set_config(struct nhal_uart_context *ctx, struct nhal_uart_config *cfg) {
+    (void)ctx;
+    if (cfg == nullptr) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (cfg->baudrate == 0) {
+        return NHAL_ERR_INVALID_CONFIG;
+    }
+    config_ = *cfg;
+    configured_ = true;
+    rs485_enabled_ = cfg->flow_control == NHAL_UART_FLOW_CONTROL_RS485_DE;
+    return NHAL_OK;
+}
+
+nhal_result_t NhalRs485Sim::rs485_set_config(struct nhal_uart_context *ctx,
+                                             const struct nhal_uart_rs485_config *rs485) {
+    (void)ctx;
+    if (rs485 == nullptr) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!configured_) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+    rs485_ = *rs485;
+    config_.flow_control = NHAL_UART_FLOW_CONTROL_RS485_DE;
+    rs485_enabled_ = true;
+    return NHAL_OK;
+}
+
+uint64_t NhalRs485Sim::bits_to_ns(uint64_t bits) const {
+    return (bits * 1000000000u + config_.baudrate - 1) / config_.baudrate;
+}
+
+uint64_t NhalRs485Sim::inter_frame_ns() const {
+    return bits_to_ns(nhal_uart_rs485_inter_frame_bits(&config_, &rs485_));
+}
+
+uint64_t NhalRs485Sim::last(EventKind kind) const {
+    for (size_t i = events_.size(); i > 0; i--) {
+        if (events_[i - 1].kind == kind) {
+            return events_[i - 1].time_ns;
+        }
+    }
+    return UINT64_MAX;
+}
+
+nhal_result_t NhalRs485Sim::transaction(struct nhal_uart_context *ctx, const uint8_t *request, size_t request_len,
+                                        uint8_t *response, size_t response_max, size_t *response_len,
+                                        uint32_t timeout_ms) {
+    (void)ctx;
+    if ((request == nullptr && request_len != 0) || (response == nullptr && response_max != 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!rs485_enabled_) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+    NhalVirtualClock *clock = NhalVirtualClock::current();
+    if (clock == nullptr) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    if (response_len != nullptr) {
+        *response_len = 0;
+    }
+
+    // Never start a frame before the bus has been silent for the inter-frame time
+    uint64_t start_ns = clock->now_ns();
+    if (bus_used_) {
+        start_ns = std::max(start_ns, bus_idle_since_ns_ + inter_frame_ns());
+    }
+    uint64_t tx_start_ns = start_ns + bits_to_ns(rs485_.de_assert_bits);
+    uint64_t tx_end_ns = tx_start_ns + bits_to_ns((uint64_t)request_len * nhal_uart_char_bits(&config_));
+    uint64_t release_ns = tx_end_ns + bits_to_ns(rs485_.de_release_bits);
+    record(start_ns, DE_ASSERT);
+    record(tx_start_ns, TX_START);
+    record(tx_end_ns, TX_END);
+    record(release_ns, DE_RELEASE);
+    bus_used_ = true;
+    bus_idle_since_ns_ = tx_end_ns;
+
+    std::vector<uint8_t> frame(request, request + request_len);
+    requests_.push_back(frame);
+    std::vector<uint8_t> answer;
+    if (slave_) {
+        answer = slave_(frame);
+    }
+
+    // Broadcast: nobody answers, the master only waits for the end of its own frame
+    if (response == nullptr) {
+        clock->advance_to_ns(release_ns);
+        return NHAL_OK;
+    }
+
+    // The slave detects the end of the request from the inter-frame silence
+    uint64_t rx_start_ns = tx_end_ns + inter_frame_ns() + response_delay_ns_;
+    uint64_t give_up_ns = release_ns + (uint64_t)timeout_ms * 1000000u;
+    if (answer.empty() || rx_start_ns > give_up_ns) {
+        clock->advance_to_ns(give_up_ns);
+        return NHAL_ERR_NO_RESPONSE;
+    }
+    if (rx_start_ns < release_ns) {
+        collisions_++;
+    }
+
+    uint64_t rx_end_ns = rx_start_ns + bits_to_ns((uint64_t)answer.size() * nhal_uart_char_bits(&config_));
+    uint64_t done_ns = rx_end_ns + inter_frame_ns();
+    record(rx_start_ns, RX_START);
+    record(rx_end_ns, RX_END);
+    record(done_ns, FRAME_DONE);
+    bus_idle_since_ns_ = rx_end_ns;
+    clock->advance_to_ns(done_ns);
+
+    size_t stored = std::min(answer.size(), response_max);
+    std::memcpy(response, answer.data(), stored);
+    if (response_len != nullptr) {
+        *response_len = stored;
+    }
+    return answer.size() > response_max ? NHAL_ERR_BUFFER_OVERFLOW : NHAL_OK;
+}
@@ -34,4 +34,49 @@ extern "C" {
     nhal_result_t nhal_spi_master_write_read(struct nhal_spi_context *ctx, const uint8_t *tx_data, size_t tx_len, uint8_t *rx_data, size_t rx_len) {
         return NhalSpiMock::instance().nhal_spi_master_write_read(ctx, tx_data, tx_len, rx_data, rx_len);
     }
+
+    // SPI typed word interface implementations
+    nhal_result_t nhal_spi_master_write_words16(struct nhal_spi_context *ctx, const uint16_t *data, size_t count) {
+        return NhalSpiMock::instance().nhal_spi_master_write_words16(ctx, data, count);
+    }
+
+    nhal_result_t nhal_spi_master_read_words16(struct nhal_spi_context *ctx, uint16_t *data, size_t count) {
+        return NhalSpiMock::instance().nhal_spi_master_read_words16(ctx, data, count);
+    }
+
+    nhal_result_t nhal_spi_master_exchange_words16(struct nhal_spi_context *ctx, const uint16_t *tx_data, uint16_t *rx_data, size_t count) {
+        return NhalSpiMock::instance().nhal_spi_master_exchange_words16(ctx, tx_data, rx_data, count);
+    }
+
+    nhal_result_t nhal_spi_master_write_words32(struct nhal_spi_context *ctx, const uint32_t *data, size_t count) {
+        return NhalSpiMock::instance().nhal_spi_master_write_words32(ctx, data, count);
+    }
+
+    nhal_result_t nhal_spi_master_read_words32(struct nhal_spi_context *ctx, uint32_t *data, size_t count) {
+        return NhalSpiMock::instance().nhal_spi_master_read_words32(ctx, data, count);
+    }
+
+    nhal_result_t nhal_spi_master_exchange_words32(struct nhal_spi_context *ctx, const uint32_t *tx_data, uint32_t *rx_data, size_t count) {
+        return NhalSpiMock::instance().nhal_spi_master_exchange_words32(ctx, tx_data, rx_data, count);
+    }
+    // SPI transaction plan interface implementations
+    nhal_result_t nhal_spi_master_plan_prepare(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan, const struct nhal_spi_config *config, const nhal_spi_segment_t *segments, size_t num_segments) {
+        return NhalSpiMock::instance().nhal_spi_master_plan_prepare(ctx, plan, config, segments, num_segments);
+    }
+
+    nhal_result_t nhal_spi_master_plan_execute(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan) {
+        return NhalSpiMock::instance().nhal_spi_master_plan_execute(ctx, plan);
+    }
+
+    nhal_result_t nhal_spi_master_plan_release(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan) {
+        return NhalSpiMock::instance().nhal_spi_master_plan_release(ctx, plan);
+    }
+    // SPI configuration image interface implementations
+    nhal_result_t nhal_spi_master_config_image_build(struct nhal_spi_context *ctx, const struct nhal_spi_config *config, struct nhal_spi_config_image *image) {
+        return NhalSpiMock::instance().nhal_spi_master_config_image_build(ctx, config, image);
+    }
+
+    nhal_result_t nhal_spi_master_config_image_apply(struct nhal_spi_context *ctx, const struct nhal_spi_config_image *image) {
+        return NhalSpiMock::instance().nhal_spi_master_config_image_apply(ctx, image);
+    }
 }
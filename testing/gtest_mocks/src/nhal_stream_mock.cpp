@@ -0,0 +1,44 @@
+/**
+ * @file nhal_stream_mock.cpp
+ * @brief C interface bridge for Stream mock
+ */
+
+#include "nhal_stream_mock.hpp"
+
+extern "C" {
+    nhal_result_t nhal_stream_init(struct nhal_stream_context *ctx) {
+        return NhalStreamMock::instance().nhal_stream_init(ctx);
+    }
+
+    nhal_result_t nhal_stream_deinit(struct nhal_stream_context *ctx) {
+        return NhalStreamMock::instance().nhal_stream_deinit(ctx);
+    }
+
+    nhal_result_t nhal_stream_set_config(struct nhal_stream_context *ctx, struct nhal_stream_config *config) {
+        return NhalStreamMock::instance().nhal_stream_set_config(ctx, config);
+    }
+
+    nhal_result_t nhal_stream_get_config(struct nhal_stream_context *ctx, struct nhal_stream_config *config) {
+        return NhalStreamMock::instance().nhal_stream_get_config(ctx, config);
+    }
+
+    nhal_result_t nhal_stream_start(struct nhal_stream_context *ctx) {
+        return NhalStreamMock::instance().nhal_stream_start(ctx);
+    }
+
+    nhal_result_t nhal_stream_stop(struct nhal_stream_context *ctx) {
+        return NhalStreamMock::instance().nhal_stream_stop(ctx);
+    }
+
+    nhal_result_t nhal_stream_acquire(struct nhal_stream_context *ctx, nhal_stream_block_t *block, uint32_t timeout_ms) {
+        return NhalStreamMock::instance().nhal_stream_acquire(ctx, block, timeout_ms);
+    }
+
+    nhal_result_t nhal_stream_release(struct nhal_stream_context *ctx, const nhal_stream_block_t *block) {
+        return NhalStreamMock::instance().nhal_stream_release(ctx, block);
+    }
+
+    nhal_result_t nhal_stream_get_stats(struct nhal_stream_context *ctx, struct nhal_stream_stats *stats) {
+        return NhalStreamMock::instance().nhal_stream_get_stats(ctx, stats);
+    }
+}
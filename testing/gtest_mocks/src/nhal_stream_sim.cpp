@@ -0,0 +1,215 @@
+/**
+ * @file nhal_stream_sim.cpp
+ * @brief Simulated streaming source implementation
+ */
+
+#include "nhal_stream_sim.hpp"
+
+#include <cstring>
+
+NhalStreamSim::NhalStreamSim()
+    : ctx_(nullptr), configured_(false), running_(false), next_block_(0), sequence_(0), sample_index_(0),
+      clock_(nullptr), event_(0), start_ns_(0), next_completion_ns_(0) {
+    std::memset(&config_, 0, sizeof(config_));
+    std::memset(&stats_, 0, sizeof(stats_));
+    generator_ = [](uint64_t sample_index, uint8_t *sample, size_t sample_size) {
+        for (size_t i = 0; i < sample_size; i++) {
+            sample[i] = i < 8 ? static_cast<uint8_t>(sample_index >> (8 * i)) : 0;
+        }
+    };
+}
+
+NhalStreamSim::~NhalStreamSim() {
+    stop(ctx_);
+}
+
+size_t NhalStreamSim::block_samples() const {
+    if (!configured_) {
+        return 0;
+    }
+    return config_.buffer_size / config_.num_blocks / config_.sample_size;
+}
+
+size_t NhalStreamSim::blocks_owned() const {
+    size_t owned = 0;
+    for (size_t i = 0; i < owned_.size(); i++) {
+        owned += owned_[i] ? 1 : 0;
+    }
+    return owned;
+}
+
+nhal_result_t NhalStreamSim::set_config(struct nhal_stream_context *ctx, struct nhal_stream_config *config) {
+    if (config == nullptr) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (running_) {
+        return NHAL_ERR_BUSY;
+    }
+    if (config->buffer == nullptr || config->num_blocks < 2 || config->sample_size == 0 ||
+        config->sample_rate_hz == 0 ||
+        config->buffer_size == 0 || config->buffer_size % (static_cast<size_t>(config->num_blocks) * config->sample_size) != 0) {
+        return NHAL_ERR_INVALID_CONFIG;
+    }
+    ctx_ = ctx;
+    config_ = *config;
+    configured_ = true;
+    return NHAL_OK;
+}
+
+nhal_result_t NhalStreamSim::get_config(struct nhal_stream_context *ctx, struct nhal_stream_config *config) {
+    (void)ctx;
+    if (config == nullptr) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!configured_) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+    *config = config_;
+    return NHAL_OK;
+}
+
+nhal_result_t NhalStreamSim::start(struct nhal_stream_context *ctx) {
+    if (!configured_) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+    if (running_) {
+        return NHAL_ERR_ALREADY_STARTED;
+    }
+    ctx_ = ctx;
+    owned_.assign(config_.num_blocks, false);
+    ready_.clear();
+    next_block_ = 0;
+    sequence_ = 0;
+    sample_index_ = 0;
+    std::memset(&stats_, 0, sizeof(stats_));
+    running_ = true;
+
+    clock_ = NhalVirtualClock::current();
+    if (clock_ != nullptr) {
+        start_ns_ = clock_->now_ns();
+        schedule_next();
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t NhalStreamSim::stop(struct nhal_stream_context *ctx) {
+    (void)ctx;
+    if (clock_ != nullptr && event_ != 0) {
+        clock_->cancel(event_);
+    }
+    event_ = 0;
+    clock_ = nullptr;
+    running_ = false;
+    return NHAL_OK;
+}
+
+uint64_t NhalStreamSim::completion_time_ns(uint64_t block_number) const {
+    // Computed from the start time so rounding never accumulates
+    uint64_t samples = (block_number + 1) * block_samples();
+    return start_ns_ + (samples / config_.sample_rate_hz) * 1000000000u +
+           (samples % config_.sample_rate_hz) * 1000000000u / config_.sample_rate_hz;
+}
+
+void NhalStreamSim::schedule_next() {
+    next_completion_ns_ = completion_time_ns(sequence_);
+    event_ = clock_->schedule_at_ns(next_completion_ns_, [this] {
+        event_ = 0;
+        complete_block();
+        if (running_ && clock_ != nullptr) {
+            schedule_next();
+        }
+    });
+}
+
+void NhalStreamSim::complete_block() {
+    if (!running_) {
+        return;
+    }
+    size_t samples = block_samples();
+    size_t block_len = samples * config_.sample_size;
+    uint16_t index = next_block_;
+
+    if (owned_[index]) {
+        // The hardware keeps the consumer's block intact and discards the samples
+        stats_.blocks_dropped++;
+        stats_.samples_dropped += samples;
+        sample_index_ += samples;
+        sequence_++;
+        return;
+    }
+
+    uint8_t *data = config_.buffer + static_cast<size_t>(index) * block_len;
+    for (size_t i = 0; i < samples; i++) {
+        generator_(sample_index_ + i, data + i * config_.sample_size, config_.sample_size);
+    }
+
+    nhal_stream_block_t block;
+    block.data = data;
+    block.len = block_len;
+    block.index = index;
+    block.sequence = sequence_;
+    block.timestamp_ticks = clock_ != nullptr ? clock_->now_ns() : 0;
+
+    owned_[index] = true;
+    sample_index_ += samples;
+    sequence_++;
+    next_block_ = static_cast<uint16_t>((index + 1) % config_.num_blocks);
+    stats_.blocks_completed++;
+    size_t owned = blocks_owned();
+    if (owned > stats_.max_blocks_owned) {
+        stats_.max_blocks_owned = static_cast<uint16_t>(owned);
+    }
+
+    if (config_.callback != nullptr) {
+        config_.callback(ctx_, &block, config_.user_data);
+    } else {
+        ready_.push_back(block);
+    }
+}
+
+nhal_result_t NhalStreamSim::acquire(struct nhal_stream_context *ctx, nhal_stream_block_t *block, uint32_t timeout_ms) {
+    (void)ctx;
+    if (block == nullptr) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!running_) {
+        return NHAL_ERR_NOT_STARTED;
+    }
+
+    if (ready_.empty() && clock_ != nullptr && timeout_ms != 0) {
+        uint64_t deadline_ns = clock_->now_ns() + static_cast<uint64_t>(timeout_ms) * 1000000u;
+        while (ready_.empty() && running_ && clock_ != nullptr && clock_->now_ns() < deadline_ns) {
+            clock_->advance_to_ns(next_completion_ns_ < deadline_ns ? next_completion_ns_ : deadline_ns);
+        }
+    }
+    if (ready_.empty()) {
+        return NHAL_ERR_TIMEOUT;
+    }
+    *block = ready_.front();
+    ready_.pop_front();
+    return NHAL_OK;
+}
+
+nhal_result_t NhalStreamSim::release(struct nhal_stream_context *ctx, const nhal_stream_block_t *block) {
+    (void)ctx;
+    if (block == nullptr || block->index >= owned_.size() || !owned_[block->index]) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < ready_.size(); i++) {
+        if (ready_[i].index == block->index) {
+            // Not acquired yet
+            return NHAL_ERR_INVALID_ARG;
+        }
+    }
+    owned_[block->index] = false;
+    return NHAL_OK;
+}
+
+nhal_result_t NhalStreamSim::get_stats(struct nhal_stream_context *ctx, struct nhal_stream_stats *stats) {
+    (void)ctx;
+    if (stats == nullptr) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    *stats = stats_;
+    return NHAL_OK;
+}
@@ -29,4 +29,17 @@ extern "C" {
     nhal_result_t nhal_uart_read(struct nhal_uart_context *ctx, uint8_t *data, size_t len) {
         return NhalUartMock::instance().nhal_uart_read(ctx, data, len);
     }
+
+    nhal_result_t nhal_uart_rs485_set_config(struct nhal_uart_context *ctx, const struct nhal_uart_rs485_config *rs485) {
+        return NhalUartMock::instance().nhal_uart_rs485_set_config(ctx, rs485);
+    }
+
+    nhal_result_t nhal_uart_rs485_transaction(struct nhal_uart_context *ctx,
+                                              const uint8_t *request, size_t request_len,
+                                              uint8_t *response, size_t response_max,
+                                              size_t *response_len, uint32_t timeout_ms) {
+        return NhalUartMock::instance().nhal_uart_rs485_transaction(ctx, request, request_len,
+                                                                    response, response_max,
+                                                                    response_len, timeout_ms);
+    }
 }
@@ -0,0 +1,496 @@
+/**
+ * @file nhal_vcd_recorder.cpp
+ * @brief Streaming VCD waveform recorder implementation
+ */
+
+#include "nhal_vcd_recorder.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "nhal_virtual_clock.hpp"
+
+namespace {
+
+const uint64_t PS_PER_NS = 1000u;
+
+uint64_t period_ps(uint32_t rate_hz, uint32_t divider) {
+    uint64_t ps = 1000000000000ull / (static_cast<uint64_t>(rate_hz != 0 ? rate_hz : 1) * divider);
+    return ps != 0 ? ps : 1;
+}
+
+uint64_t ps_to_ns_ceil(uint64_t ps) {
+    return (ps + PS_PER_NS - 1) / PS_PER_NS;
+}
+
+// Printable identifier codes, base 94
+std::string make_id(size_t index) {
+    std::string id;
+    do {
+        id += static_cast<char>('!' + index % 94);
+        index /= 94;
+    } while (index != 0);
+    return id;
+}
+
+} // namespace
+
+NhalVcdRecorder::NhalVcdRecorder(const std::string &path, size_t buffer_size)
+    : file_(std::fopen(path.c_str(), "w")), buffer_(buffer_size < 256 ? 256 : buffer_size), buffered_(0),
+      header_written_(false), time_ps_(0), cursor_ps_(0), transitions_(0) {}
+
+NhalVcdRecorder::~NhalVcdRecorder() {
+    if (file_ != nullptr) {
+        if (!header_written_) {
+            write_header();
+        }
+        flush();
+        std::fclose(file_);
+    }
+}
+
+NhalVcdRecorder::Signal NhalVcdRecorder::add_signal(const std::string &scope, const std::string &name, unsigned width,
+                                                    uint64_t initial) {
+    if (header_written_) {
+        throw std::logic_error("NhalVcdRecorder: signals must be declared before the first value change");
+    }
+    SignalInfo info;
+    info.scope = scope;
+    info.name = name;
+    info.width = width != 0 && width <= 64 ? width : 1;
+    info.value = initial;
+    info.id = make_id(signals_.size());
+    signals_.push_back(info);
+    return signals_.size() - 1;
+}
+
+NhalVcdRecorder::SpiBus NhalVcdRecorder::add_spi_bus(const std::string &scope, uint32_t clock_hz, nhal_spi_mode_t mode,
+                                                     nhal_spi_bit_order_t bit_order) {
+    bool cpol = mode == NHAL_SPI_MODE_2 || mode == NHAL_SPI_MODE_3;
+    SpiBus bus;
+    bus.sck = add_signal(scope, "sck", 1, cpol ? 1 : 0);
+    bus.mosi = add_signal(scope, "mosi", 1, VALUE_X);
+    bus.miso = add_signal(scope, "miso", 1, VALUE_Z);
+    bus.cs = add_signal(scope, "cs", 1, 1);
+    bus.clock_hz = clock_hz;
+    bus.mode = mode;
+    bus.bit_order = bit_order;
+    return bus;
+}
+
+NhalVcdRecorder::I2cBus NhalVcdRecorder::add_i2c_bus(const std::string &scope, uint32_t clock_hz) {
+    I2cBus bus;
+    bus.scl = add_signal(scope, "scl", 1, 1);
+    bus.sda = add_signal(scope, "sda", 1, 1);
+    bus.clock_hz = clock_hz;
+    return bus;
+}
+
+NhalVcdRecorder::UartLine NhalVcdRecorder::add_uart_line(const std::string &scope, const std::string &name, uint32_t baud) {
+    UartLine uart;
+    uart.line = add_signal(scope, name, 1, 1);
+    uart.baud = baud;
+    uart.data_bits = NHAL_UART_DATA_BITS_8;
+    uart.parity = NHAL_UART_PARITY_NONE;
+    uart.stop_bits = NHAL_UART_STOP_BITS_1;
+    return uart;
+}
+
+NhalVcdRecorder::UartLine NhalVcdRecorder::add_uart_line(const std::string &scope, const std::string &name,
+                                                         const struct nhal_uart_config &cfg) {
+    UartLine uart = add_uart_line(scope, name, cfg.baudrate);
+    uart.data_bits = cfg.data_bits;
+    uart.parity = cfg.parity;
+    uart.stop_bits = cfg.stop_bits;
+    return uart;
+}
+
+uint64_t NhalVcdRecorder::now_ns() const {
+    NhalVirtualClock *clock = NhalVirtualClock::current();
+    return clock != nullptr ? clock->now_ns() : ps_to_ns_ceil(cursor_ps_);
+}
+
+void NhalVcdRecorder::change(Signal signal, uint64_t value) {
+    change_at(now_ns(), signal, value);
+}
+
+void NhalVcdRecorder::change_at(uint64_t time_ns, Signal signal, uint64_t value) {
+    emit(time_ns * PS_PER_NS, signal, value);
+}
+
+void NhalVcdRecorder::append(const char *data, size_t len) {
+    if (file_ == nullptr) {
+        return;
+    }
+    if (buffer_.size() - buffered_ < len) {
+        flush();
+    }
+    if (len > buffer_.size()) {
+        std::fwrite(data, 1, len, file_);
+        return;
+    }
+    std::memcpy(&buffer_[buffered_], data, len);
+    buffered_ += len;
+}
+
+void NhalVcdRecorder::flush() {
+    if (file_ != nullptr && buffered_ != 0) {
+        std::fwrite(buffer_.data(), 1, buffered_, file_);
+        std::fflush(file_);
+    }
+    buffered_ = 0;
+}
+
+void NhalVcdRecorder::write_header() {
+    header_written_ = true;
+    std::string header = "$comment nhal_vcd_recorder $end\n$timescale 1ps $end\n";
+
+    // Scopes in declaration order, each listed once
+    std::vector<std::string> scopes;
+    for (size_t i = 0; i < signals_.size(); i++) {
+        bool known = false;
+        for (size_t j = 0; j < scopes.size(); j++) {
+            known = known || scopes[j] == signals_[i].scope;
+        }
+        if (!known) {
+            scopes.push_back(signals_[i].scope);
+        }
+    }
+    for (size_t s = 0; s < scopes.size(); s++) {
+        header += "$scope module " + scopes[s] + " $end\n";
+        for (size_t i = 0; i < signals_.size(); i++) {
+            if (signals_[i].scope == scopes[s]) {
+                header += "$var wire " + std::to_string(signals_[i].width) + " " + signals_[i].id + " " +
+                          signals_[i].name + " $end\n";
+            }
+        }
+        header += "$upscope $end\n";
+    }
+    header += "$enddefinitions $end\n#0\n$dumpvars\n";
+    append(header.data(), header.size());
+
+    for (size_t i = 0; i < signals_.size(); i++) {
+        uint64_t value = signals_[i].value;
+        signals_[i].value = ~value;    // Force the initial value out
+        emit(0, i, value);
+    }
+    append("$end\n", 5);
+}
+
+void NhalVcdRecorder::emit(uint64_t time_ps, Signal signal, uint64_t value) {
+    if (!header_written_) {
+        write_header();
+    }
+    if (signal >= signals_.size() || signals_[signal].value == value) {
+        return;
+    }
+    SignalInfo &info = signals_[signal];
+    info.value = value;
+    transitions_++;
+
+    char line[96];
+    int len = 0;
+    if (time_ps > time_ps_) {
+        time_ps_ = time_ps;
+        len = std::snprintf(line, sizeof(line), "#%llu\n", static_cast<unsigned long long>(time_ps_));
+        append(line, static_cast<size_t>(len));
+    }
+    if (time_ps_ > cursor_ps_) {
+        cursor_ps_ = time_ps_;
+    }
+
+    if (info.width == 1) {
+        char state = value == VALUE_X ? 'x' : value == VALUE_Z ? 'z' : (value != 0 ? '1' : '0');
+        len = std::snprintf(line, sizeof(line), "%c%s\n", state, info.id.c_str());
+    } else if (value == VALUE_X || value == VALUE_Z) {
+        len = std::snprintf(line, sizeof(line), "b%c %s\n", value == VALUE_X ? 'x' : 'z', info.id.c_str());
+    } else {
+        char bits[65];
+        unsigned n = 0;
+        for (unsigned bit = info.width; bit-- > 0;) {
+            bits[n++] = ((value >> bit) & 1u) != 0 ? '1' : '0';
+        }
+        bits[n] = '\0';
+        len = std::snprintf(line, sizeof(line), "b%s %s\n", bits, info.id.c_str());
+    }
+    append(line, static_cast<size_t>(len));
+}
+
+uint64_t NhalVcdRecorder::handler_start_ps() const {
+    uint64_t now_ps = now_ns() * PS_PER_NS;
+    return now_ps > time_ps_ ? now_ps : time_ps_;
+}
+
+void NhalVcdRecorder::handler_end(uint64_t end_ps) {
+    NhalVirtualClock *clock = NhalVirtualClock::current();
+    if (clock != nullptr) {
+        clock->advance_to_ns(ps_to_ns_ceil(end_ps));
+    }
+    if (end_ps > cursor_ps_) {
+        cursor_ps_ = end_ps;
+    }
+}
+
+// SPI
+
+uint64_t NhalVcdRecorder::spi_begin(const SpiBus &bus, uint64_t t) {
+    emit(t, bus.cs, 0);
+    return t + period_ps(bus.clock_hz, 2);
+}
+
+uint64_t NhalVcdRecorder::spi_end(const SpiBus &bus, uint64_t t) {
+    bool cpol = bus.mode == NHAL_SPI_MODE_2 || bus.mode == NHAL_SPI_MODE_3;
+    emit(t, bus.sck, cpol ? 1 : 0);
+    t += period_ps(bus.clock_hz, 2);
+    emit(t, bus.cs, 1);
+    emit(t, bus.miso, VALUE_Z);
+    return t;
+}
+
+uint64_t NhalVcdRecorder::spi_bytes(const SpiBus &bus, uint64_t t, const uint8_t *mosi, const uint8_t *miso, size_t len) {
+    bool cpol = bus.mode == NHAL_SPI_MODE_2 || bus.mode == NHAL_SPI_MODE_3;
+    bool cpha = bus.mode == NHAL_SPI_MODE_1 || bus.mode == NHAL_SPI_MODE_3;
+    uint64_t half = period_ps(bus.clock_hz, 2);
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t out = mosi != nullptr ? mosi[i] : 0xFF;
+        for (unsigned n = 0; n < 8; n++) {
+            unsigned bit = bus.bit_order == NHAL_SPI_BIT_ORDER_LSB_FIRST ? n : 7 - n;
+            uint64_t miso_value = miso != nullptr ? (miso[i] >> bit) & 1u : VALUE_Z;
+            if (cpha) {
+                // Data shifted out on the leading edge, sampled on the trailing one
+                emit(t, bus.sck, cpol ? 0 : 1);
+            }
+            emit(t, bus.mosi, (out >> bit) & 1u);
+            emit(t, bus.miso, miso_value);
+            t += half;
+            emit(t, bus.sck, cpha ? (cpol ? 1 : 0) : (cpol ? 0 : 1));
+            t += half;
+            if (!cpha) {
+                emit(t, bus.sck, cpol ? 1 : 0);
+            }
+        }
+    }
+    return t;
+}
+
+uint64_t NhalVcdRecorder::spi_transfer(const SpiBus &bus, uint64_t start_ns, const uint8_t *mosi, const uint8_t *miso,
+                                       size_t len) {
+    uint64_t t = spi_begin(bus, start_ns * PS_PER_NS);
+    t = spi_bytes(bus, t, mosi, miso, len);
+    return ps_to_ns_ceil(spi_end(bus, t));
+}
+
+// I2C: four quarter periods per bit, SDA changing while SCL is low
+
+uint64_t NhalVcdRecorder::i2c_start(const I2cBus &bus, uint64_t t) {
+    uint64_t quarter = period_ps(bus.clock_hz, 4);
+    emit(t, bus.sda, 1);
+    t += quarter;
+    emit(t, bus.scl, 1);
+    t += quarter;
+    emit(t, bus.sda, 0);
+    t += quarter;
+    emit(t, bus.scl, 0);
+    return t + quarter;
+}
+
+uint64_t NhalVcdRecorder::i2c_stop(const I2cBus &bus, uint64_t t) {
+    uint64_t quarter = period_ps(bus.clock_hz, 4);
+    emit(t, bus.sda, 0);
+    t += quarter;
+    emit(t, bus.scl, 1);
+    t += quarter;
+    emit(t, bus.sda, 1);
+    return t + quarter;
+}
+
+uint64_t NhalVcdRecorder::i2c_bit(const I2cBus &bus, uint64_t t, bool bit) {
+    uint64_t quarter = period_ps(bus.clock_hz, 4);
+    emit(t, bus.sda, bit ? 1 : 0);
+    t += quarter;
+    emit(t, bus.scl, 1);
+    t += 2 * quarter;
+    emit(t, bus.scl, 0);
+    return t + quarter;
+}
+
+uint64_t NhalVcdRecorder::i2c_byte(const I2cBus &bus, uint64_t t, uint8_t byte, bool ack) {
+    for (int bit = 7; bit >= 0; bit--) {
+        t = i2c_bit(bus, t, ((byte >> bit) & 1u) != 0);
+    }
+    return i2c_bit(bus, t, !ack);
+}
+
+uint64_t NhalVcdRecorder::i2c_address(const I2cBus &bus, uint64_t t, nhal_i2c_address_t address, bool read,
+                                      bool repeated) {
+    if (address.type == NHAL_I2C_10BIT_ADDR) {
+        uint16_t addr = address.addr.address_10bit;
+        t = i2c_byte(bus, t, static_cast<uint8_t>(0xF0 | ((addr >> 7) & 0x06) | (read ? 1 : 0)), true);
+        if (repeated) {
+            // After a repeated start the device is still addressed: only the first byte is sent again
+            return t;
+        }
+        return i2c_byte(bus, t, static_cast<uint8_t>(addr & 0xFF), true);
+    }
+    return i2c_byte(bus, t, static_cast<uint8_t>((address.addr.address_7bit << 1) | (read ? 1 : 0)), true);
+}
+
+uint64_t NhalVcdRecorder::i2c_write(const I2cBus &bus, uint64_t start_ns, nhal_i2c_address_t address,
+                                    const uint8_t *data, size_t len) {
+    return i2c_write_read(bus, start_ns, address, data, len, nullptr, 0);
+}
+
+uint64_t NhalVcdRecorder::i2c_read(const I2cBus &bus, uint64_t start_ns, nhal_i2c_address_t address,
+                                   const uint8_t *data, size_t len) {
+    return i2c_write_read(bus, start_ns, address, nullptr, 0, data, len);
+}
+
+uint64_t NhalVcdRecorder::i2c_write_read(const I2cBus &bus, uint64_t start_ns, nhal_i2c_address_t address,
+                                         const uint8_t *tx, size_t tx_len, const uint8_t *rx, size_t rx_len) {
+    bool ten_bit = address.type == NHAL_I2C_10BIT_ADDR;
+    bool repeated = false;
+    uint64_t t = i2c_start(bus, start_ns * PS_PER_NS);
+
+    // 10-bit reads always address the device in write direction first
+    if (tx_len != 0 || rx_len == 0 || ten_bit) {
+        t = i2c_address(bus, t, address, false, false);
+        for (size_t i = 0; i < tx_len; i++) {
+            t = i2c_byte(bus, t, tx[i], true);
+        }
+        if (rx_len != 0) {
+            t = i2c_start(bus, t);    // Repeated start
+            repeated = true;
+        }
+    }
+    if (rx_len != 0) {
+        t = i2c_address(bus, t, address, true, repeated);
+        for (size_t i = 0; i < rx_len; i++) {
+            // The master acknowledges every byte but the last
+            t = i2c_byte(bus, t, rx != nullptr ? rx[i] : 0xFF, i + 1 < rx_len);
+        }
+    }
+    return ps_to_ns_ceil(i2c_stop(bus, t));
+}
+
+// UART: start bit, data LSB first, parity, stop bits
+
+uint64_t NhalVcdRecorder::uart_frames(const UartLine &uart, uint64_t start_ns, const uint8_t *data, size_t len) {
+    uint64_t bit_time = period_ps(uart.baud, 1);
+    unsigned data_bits = uart.data_bits == NHAL_UART_DATA_BITS_7 ? 7 : 8;
+    unsigned stop_bits = uart.stop_bits == NHAL_UART_STOP_BITS_2 ? 2 : 1;
+    uint64_t t = start_ns * PS_PER_NS;
+
+    for (size_t i = 0; i < len; i++) {
+        unsigned ones = 0;
+        emit(t, uart.line, 0);
+        t += bit_time;
+        for (unsigned bit = 0; bit < data_bits; bit++) {
+            unsigned value = (data[i] >> bit) & 1u;
+            ones += value;
+            emit(t, uart.line, value);
+            t += bit_time;
+        }
+        if (uart.parity != NHAL_UART_PARITY_NONE) {
+            emit(t, uart.line, uart.parity == NHAL_UART_PARITY_EVEN ? ones & 1u : ~ones & 1u);
+            t += bit_time;
+        }
+        emit(t, uart.line, 1);
+        t += stop_bits * bit_time;
+    }
+    return ps_to_ns_ceil(t);
+}
+
+// Handlers
+
+nhal_result_t NhalVcdRecorder::uart_set_config(struct nhal_uart_context *ctx, struct nhal_uart_config *cfg) {
+    if (cfg == nullptr) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    std::map<struct nhal_uart_context *, UartLine> *lines[] = { &uart_lines_, &uart_rx_lines_ };
+    for (std::map<struct nhal_uart_context *, UartLine> *attached : lines) {
+        std::map<struct nhal_uart_context *, UartLine>::iterator it = attached->find(ctx);
+        if (it != attached->end()) {
+            it->second.baud = cfg->baudrate;
+            it->second.data_bits = cfg->data_bits;
+            it->second.parity = cfg->parity;
+            it->second.stop_bits = cfg->stop_bits;
+        }
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t NhalVcdRecorder::pin_set_state(struct nhal_pin_context *ctx, nhal_pin_state_t value) {
+    std::map<struct nhal_pin_context *, Signal>::const_iterator it = pins_.find(ctx);
+    if (it != pins_.end()) {
+        change(it->second, value == NHAL_PIN_HIGH ? 1 : 0);
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t NhalVcdRecorder::spi_write(struct nhal_spi_context *ctx, const uint8_t *data, size_t len) {
+    return spi_write_read(ctx, data, len, nullptr, 0);
+}
+
+nhal_result_t NhalVcdRecorder::spi_read(struct nhal_spi_context *ctx, uint8_t *data, size_t len) {
+    return spi_write_read(ctx, nullptr, 0, data, len);
+}
+
+nhal_result_t NhalVcdRecorder::spi_write_read(struct nhal_spi_context *ctx, const uint8_t *tx_data, size_t tx_len,
+                                              uint8_t *rx_data, size_t rx_len) {
+    std::map<struct nhal_spi_context *, SpiBus>::const_iterator it = spi_buses_.find(ctx);
+    if (it == spi_buses_.end()) {
+        return NHAL_OK;
+    }
+    // Chip select stays asserted across the write and read phases
+    uint64_t t = spi_begin(it->second, handler_start_ps());
+    t = spi_bytes(it->second, t, tx_data, nullptr, tx_len);
+    t = spi_bytes(it->second, t, nullptr, rx_data, rx_len);
+    handler_end(spi_end(it->second, t));
+    return NHAL_OK;
+}
+
+nhal_result_t NhalVcdRecorder::i2c_master_write(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                                const uint8_t *data, size_t len) {
+    return i2c_master_write_read_reg(ctx, dev_address, data, len, nullptr, 0);
+}
+
+nhal_result_t NhalVcdRecorder::i2c_master_read(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                               uint8_t *data, size_t len) {
+    return i2c_master_write_read_reg(ctx, dev_address, nullptr, 0, data, len);
+}
+
+nhal_result_t NhalVcdRecorder::i2c_master_write_read_reg(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                                         const uint8_t *reg_address, size_t reg_len,
+                                                         uint8_t *data, size_t data_len) {
+    std::map<struct nhal_i2c_context *, I2cBus>::const_iterator it = i2c_buses_.find(ctx);
+    if (it == i2c_buses_.end()) {
+        return NHAL_OK;
+    }
+    uint64_t start_ps = handler_start_ps();
+    uint64_t end_ns = i2c_write_read(it->second, ps_to_ns_ceil(start_ps), dev_address, reg_address, reg_len, data, data_len);
+    handler_end(end_ns * PS_PER_NS);
+    return NHAL_OK;
+}
+
+nhal_result_t NhalVcdRecorder::uart_write(struct nhal_uart_context *ctx, const uint8_t *data, size_t len) {
+    std::map<struct nhal_uart_context *, UartLine>::const_iterator it = uart_lines_.find(ctx);
+    if (it == uart_lines_.end()) {
+        return NHAL_OK;
+    }
+    uint64_t start_ps = handler_start_ps();
+    uint64_t end_ns = uart_frames(it->second, ps_to_ns_ceil(start_ps), data, len);
+    handler_end(end_ns * PS_PER_NS);
+    return NHAL_OK;
+}
+
+nhal_result_t NhalVcdRecorder::uart_read(struct nhal_uart_context *ctx, uint8_t *data, size_t len) {
+    std::map<struct nhal_uart_context *, UartLine>::const_iterator it = uart_rx_lines_.find(ctx);
+    if (it == uart_rx_lines_.end()) {
+        return NHAL_OK;
+    }
+    uint64_t start_ps = handler_start_ps();
+    uint64_t end_ns = uart_frames(it->second, ps_to_ns_ceil(start_ps), data, len);
+    handler_end(end_ns * PS_PER_NS);
+    return NHAL_OK;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file nhal_virtual_clock.cpp
+ * @brief Discrete-event virtual clock implementation
+ */
+
+#include "nhal_virtual_clock.hpp"
+
+NhalVirtualClock::NhalVirtualClock(uint64_t start_ns)
+    : now_ns_(start_ns), timestamp_step_ns_(0), next_id_(1), binding_(*this) {}
+
+uint64_t NhalVirtualClock::now_ns() {
+    std::lock_guard<std::mutex> guard(lock_);
+    return now_ns_;
+}
+
+bool NhalVirtualClock::pop_due_event(uint64_t limit_ns, std::function<void()> *fn) {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (events_.empty() || events_.begin()->first.first > limit_ns) {
+        if (limit_ns > now_ns_) {
+            now_ns_ = limit_ns;
+        }
+        return false;
+    }
+    auto it = events_.begin();
+    if (it->first.first > now_ns_) {
+        now_ns_ = it->first.first;
+    }
+    *fn = std::move(it->second);
+    event_times_.erase(it->first.second);
+    events_.erase(it);
+    return true;
+}
+
+void NhalVirtualClock::advance_ns(uint64_t ns) {
+    advance_to_ns(now_ns() + ns);
+}
+
+void NhalVirtualClock::advance_to_ns(uint64_t time_ns) {
+    std::function<void()> fn;
+    // Events run without the lock held: they may schedule, cancel or delay
+    while (pop_due_event(time_ns, &fn)) {
+        fn();
+    }
+}
+
+bool NhalVirtualClock::run_next_event() {
+    uint64_t next_time;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (events_.empty()) {
+            return false;
+        }
+        next_time = events_.begin()->first.first;
+    }
+    std::function<void()> fn;
+    if (!pop_due_event(next_time, &fn)) {
+        return false;
+    }
+    fn();
+    return true;
+}
+
+NhalVirtualClock::EventId NhalVirtualClock::schedule_at_ns(uint64_t time_ns, std::function<void()> fn) {
+    std::lock_guard<std::mutex> guard(lock_);
+    EventId id = next_id_++;
+    events_[EventKey(time_ns, id)] = std::move(fn);
+    event_times_[id] = time_ns;
+    return id;
+}
+
+bool NhalVirtualClock::cancel(EventId id) {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto it = event_times_.find(id);
+    if (it == event_times_.end()) {
+        return false;
+    }
+    events_.erase(EventKey(it->second, id));
+    event_times_.erase(it);
+    return true;
+}
+
+size_t NhalVirtualClock::pending_events() {
+    std::lock_guard<std::mutex> guard(lock_);
+    return events_.size();
+}
+
+void NhalVirtualClock::set_timestamp_step_ns(uint64_t step_ns) {
+    std::lock_guard<std::mutex> guard(lock_);
+    timestamp_step_ns_ = step_ns;
+}
+
+uint64_t NhalVirtualClock::read_timestamp_ns() {
+    uint64_t step;
+    uint64_t now;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        step = timestamp_step_ns_;
+        now = now_ns_;
+    }
+    if (step != 0) {
+        advance_ns(step);
+    }
+    return now;
+}
@@ -0,0 +1,7 @@
+/**
+ * @file nhal_bitbang_engine.c
+ * @brief Bit-bang engine instance under test
+ */
+
+#define NHAL_BITBANG_IMPLEMENTATION
+#include "nhal_bitbang.h"
@@ -0,0 +1,648 @@
+/**
+ * @file nhal_bitbang_test.cpp
+ * @brief Bit-bang engine against simulated devices on simulated pins, with bit rate benchmarks
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "nhal_bitbang.h"
+#include "nhal_pin_mock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+struct nhal_pin_group_context {
+    int unused;
+};
+
+namespace {
+
+// Lines of the simulated pin group
+const uint8_t SCK = 0, MOSI = 1, MISO = 2, CS = 3, SCL = 4, SDA = 5, DQ = 6;
+
+bool level(uint32_t lines, uint8_t bit) { return (lines >> bit) & 1u; }
+
+/** @brief Device model: sees the master's line states, returns the bus states at the end of each step */
+class Device {
+public:
+    virtual ~Device() {}
+    virtual uint32_t step(uint32_t driven, uint32_t step_ns) = 0;
+};
+
+/** @brief Pin group backend playing sequences into a device, in virtual time */
+class SimulatedPins {
+public:
+    explicit SimulatedPins(Device &device) : device_(device) {
+        ON_CALL(pin_.mock(), nhal_pin_group_write(_, _, _))
+            .WillByDefault(Invoke([this](struct nhal_pin_group_context *, nhal_pin_group_mask_t mask, nhal_pin_group_mask_t values) {
+                driven_ = (driven_ & ~mask) | (values & mask);
+                device_.step(driven_, 0);
+                return NHAL_OK;
+            }));
+        ON_CALL(pin_.mock(), nhal_pin_group_run_sequence(_, _, _, _, _, _))
+            .WillByDefault(Invoke([this](struct nhal_pin_group_context *, nhal_pin_group_mask_t mask, const nhal_pin_group_mask_t *out,
+                                         nhal_pin_group_mask_t *in, size_t count, uint32_t step_ns) {
+                for (size_t i = 0; i < count; i++) {
+                    driven_ = (driven_ & ~mask) | (out[i] & mask);
+                    uint32_t lines = device_.step(driven_, step_ns);
+                    if (in != nullptr) {
+                        in[i] = lines;
+                    }
+                    bus_ns += step_ns;
+                }
+                sequences++;
+                steps += count;
+                return NHAL_OK;
+            }));
+    }
+
+    uint64_t bus_ns = 0;
+    uint64_t sequences = 0;
+    uint64_t steps = 0;
+
+private:
+    NhalMockScope<NhalPinMock, NiceMock<NhalPinMock> > pin_;
+    Device &device_;
+    uint32_t driven_ = 0xFFFFFFFFu;
+};
+
+// ---------------------------------------------------------------------------
+// SPI
+// ---------------------------------------------------------------------------
+
+/** @brief SPI slave: records MOSI bytes, answers with a counting pattern */
+class SpiSlave : public Device {
+public:
+    SpiSlave(nhal_spi_mode_t mode, bool lsb_first) : cpol_(mode >= NHAL_SPI_MODE_2), cpha_(mode & 1), lsb_first_(lsb_first) {}
+
+    uint32_t step(uint32_t driven, uint32_t) override {
+        bool sck = level(driven, SCK);
+        if (!level(driven, CS)) {
+            if (!selected_) {
+                selected_ = true;
+                rx_bits_ = 0;
+                tx_bits_ = 0;
+                if (!cpha_) {
+                    present();
+                }
+            } else if (sck != sck_) {
+                bool leading = sck != cpol_;
+                if (leading != cpha_) {
+                    uint8_t bit = level(driven, MOSI);
+                    rx_ = lsb_first_ ? (uint8_t)((rx_ >> 1) | (bit << 7)) : (uint8_t)((rx_ << 1) | bit);
+                    if (++rx_bits_ == 8) {
+                        received.push_back(rx_);
+                        rx_bits_ = 0;
+                    }
+                } else {
+                    present();
+                }
+            }
+        } else {
+            selected_ = false;
+        }
+        sck_ = sck;
+        return (driven & ~(1u << MISO)) | ((uint32_t)miso_ << MISO);
+    }
+
+    std::vector<uint8_t> received;
+    uint8_t next_response = 0x10;
+
+private:
+    void present() {
+        if (tx_bits_ == 0) {
+            tx_ = next_response++;
+        }
+        miso_ = lsb_first_ ? (tx_ >> tx_bits_) & 1u : (tx_ >> (7 - tx_bits_)) & 1u;
+        tx_bits_ = (tx_bits_ + 1) % 8;
+    }
+
+    bool cpol_, cpha_, lsb_first_;
+    bool selected_ = false;
+    bool sck_ = false;
+    uint8_t rx_ = 0, tx_ = 0, miso_ = 1;
+    int rx_bits_ = 0, tx_bits_ = 0;
+};
+
+class BitbangSpiTest : public ::testing::TestWithParam<int> {};
+
+TEST_P(BitbangSpiTest, WriteThenReadInEveryMode) {
+    nhal_spi_mode_t mode = static_cast<nhal_spi_mode_t>(GetParam() % 4);
+    bool lsb_first = GetParam() >= 4;
+    SpiSlave slave(mode, lsb_first);
+    SimulatedPins pins(slave);
+    struct nhal_pin_group_context group;
+    struct nhal_bitbang_spi bus;
+
+    nhal_bitbang_spi_setup(&bus, &group, SCK, MOSI, MISO, CS);
+    struct nhal_spi_config config;
+    memset(&config, 0, sizeof(config));
+    config.mode = mode;
+    config.bit_order = lsb_first ? NHAL_SPI_BIT_ORDER_LSB_FIRST : NHAL_SPI_BIT_ORDER_MSB_FIRST;
+    config.clock_hz = 2000000;
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_spi_set_config(&bus, &config));
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_spi_init(&bus));
+
+    const uint8_t command[] = { 0x9F, 0x01, 0x80 };
+    uint8_t answer[40];
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_spi_write_read(&bus, command, sizeof(command), answer, sizeof(answer)));
+
+    ASSERT_EQ(sizeof(command) + sizeof(answer), slave.received.size());
+    EXPECT_EQ(0x9F, slave.received[0]);
+    EXPECT_EQ(0x01, slave.received[1]);
+    EXPECT_EQ(0x80, slave.received[2]);
+    EXPECT_EQ(0xFF, slave.received[3]);
+    for (size_t i = 0; i < sizeof(answer); i++) {
+        EXPECT_EQ((uint8_t)(0x10 + sizeof(command) + i), answer[i]) << "byte " << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(ModesAndBitOrders, BitbangSpiTest, ::testing::Range(0, 8));
+
+TEST(BitbangSpiTest, RejectsWhatItCannotDo) {
+    struct nhal_pin_group_context group;
+    struct nhal_bitbang_spi bus;
+    struct nhal_spi_config config;
+    uint8_t data[1];
+
+    nhal_bitbang_spi_setup(&bus, &group, SCK, MOSI, NHAL_BITBANG_NO_PIN, CS);
+    memset(&config, 0, sizeof(config));
+    config.word_size = NHAL_SPI_WORD_SIZE_16;
+    EXPECT_EQ(NHAL_ERR_UNSUPPORTED, nhal_bitbang_spi_set_config(&bus, &config));
+    config.word_size = NHAL_SPI_WORD_SIZE_8;
+    config.duplex = NHAL_SPI_HALF_DUPLEX;
+    EXPECT_EQ(NHAL_ERR_UNSUPPORTED, nhal_bitbang_spi_set_config(&bus, &config));
+
+    SpiSlave slave(NHAL_SPI_MODE_0, false);
+    SimulatedPins pins(slave);
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_spi_init(&bus));
+    EXPECT_EQ(NHAL_ERR_UNSUPPORTED, nhal_bitbang_spi_write_read(&bus, nullptr, 0, data, 1));
+}
+
+// ---------------------------------------------------------------------------
+// I2C
+// ---------------------------------------------------------------------------
+
+/** @brief I2C memory target: first written byte sets the register pointer */
+class I2cMemory : public Device {
+public:
+    explicit I2cMemory(uint16_t address, bool ten_bit = false) : address_(address), ten_bit_(ten_bit) {
+        for (size_t i = 0; i < sizeof(memory); i++) {
+            memory[i] = (uint8_t)(i ^ 0x5A);
+        }
+    }
+
+    uint32_t step(uint32_t driven, uint32_t) override {
+        bool scl = level(driven, SCL);
+        bool sda = level(driven, SDA) && sda_out_;
+
+        if (scl && scl_) {
+            if (sda_ && !sda) {
+                start();
+            } else if (!sda_ && sda) {
+                state_ = IDLE;
+                sda_out_ = true;
+                sda = level(driven, SDA);
+                stops++;
+            }
+        } else if (scl && !scl_) {
+            rising(sda);
+        } else if (!scl && scl_) {
+            falling();
+            sda = level(driven, SDA) && sda_out_;
+        }
+        scl_ = scl;
+        sda_ = sda;
+        return (driven & ~(1u << SDA)) | ((uint32_t)sda << SDA);
+    }
+
+    uint8_t memory[256];
+    uint8_t pointer = 0;
+    unsigned stops = 0;
+    unsigned nacks = 0;
+
+private:
+    enum State { IDLE, ADDRESS, ADDRESS_LOW, WRITE, READ };
+
+    void start() {
+        state_ = ADDRESS;
+        bits_ = 0;
+        ack_slot_ = false;
+        sda_out_ = true;
+    }
+
+    void rising(bool sda) {
+        if (state_ == IDLE) {
+            return;
+        }
+        if (ack_slot_) {
+            master_ack_ = !sda;
+        } else if (bits_ < 8) {
+            shift_ = (uint8_t)((shift_ << 1) | sda);
+            bits_++;
+        }
+    }
+
+    void falling() {
+        if (state_ == IDLE) {
+            return;
+        }
+        if (!ack_slot_ && bits_ == 8) {
+            ack_slot_ = true;
+            sda_out_ = !byte_complete();
+            if (sda_out_ && state_ != READ) {
+                nacks++;
+                state_ = IDLE;
+            }
+            return;
+        }
+        if (ack_slot_) {
+            ack_slot_ = false;
+            bits_ = 0;
+            if (state_ == READ && !master_ack_ && started_read_) {
+                state_ = IDLE;
+                sda_out_ = true;
+                return;
+            }
+            if (state_ == READ) {
+                started_read_ = true;
+                tx_ = memory[pointer++];
+            }
+        }
+        sda_out_ = state_ == READ ? ((tx_ >> (7 - bits_)) & 1u) != 0 : true;
+    }
+
+    // Acknowledge decision for the byte just received
+    bool byte_complete() {
+        switch (state_) {
+        case ADDRESS:
+            if (ten_bit_ && (shift_ & 0xF8u) == 0xF0u && ((shift_ >> 1) & 3u) == (address_ >> 8)) {
+                if (shift_ & 1u) {
+                    enter_read(matched_);
+                    return matched_;
+                }
+                state_ = ADDRESS_LOW;
+                return true;
+            }
+            if (!ten_bit_ && (shift_ >> 1) == address_) {
+                if (shift_ & 1u) {
+                    enter_read(true);
+                } else {
+                    state_ = WRITE;
+                    first_write_ = true;
+                }
+                return true;
+            }
+            return false;
+        case ADDRESS_LOW:
+            matched_ = shift_ == (address_ & 0xFFu);
+            state_ = WRITE;
+            first_write_ = true;
+            return matched_;
+        case WRITE:
+            if (first_write_) {
+                pointer = shift_;
+                first_write_ = false;
+            } else {
+                memory[pointer++] = shift_;
+            }
+            return true;
+        case READ:
+            return false;
+        default:
+            return false;
+        }
+    }
+
+    void enter_read(bool matched) {
+        if (matched) {
+            state_ = READ;
+            started_read_ = false;
+            master_ack_ = true;
+        }
+    }
+
+    uint16_t address_;
+    bool ten_bit_;
+    State state_ = IDLE;
+    bool scl_ = true, sda_ = true, sda_out_ = true;
+    bool ack_slot_ = false, master_ack_ = true, first_write_ = false, started_read_ = false, matched_ = false;
+    uint8_t shift_ = 0, tx_ = 0;
+    int bits_ = 0;
+};
+
+nhal_i2c_address_t seven_bit(uint8_t address) {
+    nhal_i2c_address_t result;
+    result.type = NHAL_I2C_7BIT_ADDR;
+    result.addr.address_7bit = address;
+    return result;
+}
+
+nhal_i2c_transfer_op_t write_op(const uint8_t *bytes, size_t length, uint16_t flags = 0) {
+    nhal_i2c_transfer_op_t op;
+    memset(&op, 0, sizeof(op));
+    op.type = NHAL_I2C_WRITE_OP;
+    op.flags = flags;
+    op.write.bytes = bytes;
+    op.write.length = length;
+    return op;
+}
+
+nhal_i2c_transfer_op_t read_op(uint8_t *buffer, size_t length, uint16_t flags = 0) {
+    nhal_i2c_transfer_op_t op;
+    memset(&op, 0, sizeof(op));
+    op.type = NHAL_I2C_READ_OP;
+    op.flags = flags;
+    op.read.buffer = buffer;
+    op.read.length = length;
+    return op;
+}
+
+TEST(BitbangI2cTest, WritesAndReadsRegisters) {
+    I2cMemory memory(0x50);
+    SimulatedPins pins(memory);
+    struct nhal_pin_group_context group;
+    struct nhal_bitbang_i2c bus;
+
+    nhal_bitbang_i2c_setup(&bus, &group, SCL, SDA, 400000);
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_i2c_init(&bus));
+
+    uint8_t payload[21] = { 0x20 };
+    for (size_t i = 1; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)(0xC0 + i);
+    }
+    nhal_i2c_transfer_op_t write = write_op(payload, sizeof(payload));
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_i2c_transfer(&bus, seven_bit(0x50), &write, 1));
+    for (size_t i = 1; i < sizeof(payload); i++) {
+        EXPECT_EQ(payload[i], memory.memory[0x20 + i - 1]);
+    }
+
+    // Register read: write pointer, repeated start, read
+    const uint8_t reg = 0x1E;
+    uint8_t data[16];
+    nhal_i2c_transfer_op_t ops[2] = { write_op(&reg, 1, NHAL_I2C_TRANSFER_MSG_NO_STOP), read_op(data, sizeof(data)) };
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_i2c_transfer(&bus, seven_bit(0x50), ops, 2));
+    EXPECT_EQ(memory.memory[0x1E], data[0]);
+    EXPECT_EQ(memory.memory[0x1F], data[1]);
+    EXPECT_EQ(0xC1, data[2]);
+    EXPECT_EQ(0xCE, data[15]);
+    EXPECT_EQ(2u, memory.stops);
+}
+
+TEST(BitbangI2cTest, ReportsMissingTarget) {
+    I2cMemory memory(0x50);
+    SimulatedPins pins(memory);
+    struct nhal_pin_group_context group;
+    struct nhal_bitbang_i2c bus;
+    uint8_t data[2];
+
+    nhal_bitbang_i2c_setup(&bus, &group, SCL, SDA, 100000);
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_i2c_init(&bus));
+    nhal_i2c_transfer_op_t read = read_op(data, sizeof(data));
+    EXPECT_EQ(NHAL_ERR_NO_RESPONSE, nhal_bitbang_i2c_transfer(&bus, seven_bit(0x51), &read, 1));
+    EXPECT_EQ(1u, memory.stops);
+
+    // The bus is left idle: the next transaction works
+    EXPECT_EQ(NHAL_OK, nhal_bitbang_i2c_transfer(&bus, seven_bit(0x50), &read, 1));
+}
+
+TEST(BitbangI2cTest, TenBitAddressRead) {
+    I2cMemory memory(0x2A5, true);
+    SimulatedPins pins(memory);
+    struct nhal_pin_group_context group;
+    struct nhal_bitbang_i2c bus;
+    nhal_i2c_address_t address;
+    uint8_t data[4];
+
+    nhal_bitbang_i2c_setup(&bus, &group, SCL, SDA, 100000);
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_i2c_init(&bus));
+    address.type = NHAL_I2C_10BIT_ADDR;
+    address.addr.address_10bit = 0x2A5;
+    memory.pointer = 0x40;
+    nhal_i2c_transfer_op_t read = read_op(data, sizeof(data));
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_i2c_transfer(&bus, address, &read, 1));
+    EXPECT_EQ(memory.memory[0x40], data[0]);
+    EXPECT_EQ(memory.memory[0x43], data[3]);
+    EXPECT_EQ(0u, memory.nacks);
+}
+
+// ---------------------------------------------------------------------------
+// 1-Wire
+// ---------------------------------------------------------------------------
+
+/** @brief 1-Wire device: answers resets, records written bits, transmits queued bytes */
+class OneWireDevice : public Device {
+public:
+    explicit OneWireDevice(bool overdrive) : overdrive_(overdrive) {}
+
+    uint32_t step(uint32_t driven, uint32_t step_ns) override {
+        bool master = level(driven, DQ);
+        if (!master && master_) {
+            fall_ns_ = now_ns_;
+            in_slot_ = true;
+            sampled_ = false;
+            driving_zero_ = false;
+            if (!transmit.empty()) {
+                driving_zero_ = !((transmit.front() >> tx_bit_) & 1u);
+                if (++tx_bit_ == 8) {
+                    tx_bit_ = 0;
+                    transmit.pop_front();
+                }
+                transmitting_ = true;
+            } else {
+                transmitting_ = false;
+            }
+        } else if (master && !master_ && now_ns_ - fall_ns_ >= us(overdrive_ ? 48 : 480)) {
+            // The reset pulse also looked like a slot start: drop that bit
+            resets++;
+            in_slot_ = false;
+            rx_ = 0;
+            rx_bit_ = 0;
+            presence_start_ns_ = now_ns_ + us(overdrive_ ? 3 : 30);
+            presence_end_ns_ = now_ns_ + us(overdrive_ ? 15 : 150);
+        }
+        master_ = master;
+        now_ns_ += step_ns;
+
+        // A written bit is sampled at a fixed delay after the falling edge
+        uint64_t sample_ns = fall_ns_ + (overdrive_ ? 3500u : 30000u);
+        if (in_slot_ && !sampled_ && !transmitting_ && now_ns_ >= sample_ns) {
+            sampled_ = true;
+            rx_ |= (uint8_t)((master ? 1u : 0u) << rx_bit_);
+            if (++rx_bit_ == 8) {
+                received.push_back(rx_);
+                rx_ = 0;
+                rx_bit_ = 0;
+            }
+        }
+
+        bool device_low = (now_ns_ >= presence_start_ns_ && now_ns_ < presence_end_ns_)
+            || (in_slot_ && driving_zero_ && now_ns_ < fall_ns_ + (overdrive_ ? 3000u : 30000u));
+        return (driven & ~(1u << DQ)) | ((uint32_t)(master && !device_low) << DQ);
+    }
+
+    std::vector<uint8_t> received;
+    std::deque<uint8_t> transmit;
+    unsigned resets = 0;
+
+private:
+    static uint64_t us(uint64_t value) { return value * 1000u; }
+
+    bool overdrive_;
+    uint64_t now_ns_ = 0, fall_ns_ = 0, presence_start_ns_ = 0, presence_end_ns_ = 0;
+    bool master_ = true, in_slot_ = false, sampled_ = false, driving_zero_ = false, transmitting_ = false;
+    uint8_t rx_ = 0;
+    int rx_bit_ = 0, tx_bit_ = 0;
+};
+
+class BitbangOneWireTest : public ::testing::TestWithParam<bool> {};
+
+TEST_P(BitbangOneWireTest, ResetWriteAndRead) {
+    bool overdrive = GetParam();
+    OneWireDevice device(overdrive);
+    SimulatedPins pins(device);
+    struct nhal_pin_group_context group;
+    struct nhal_bitbang_onewire bus;
+    struct nhal_onewire_config config;
+    bool presence = false;
+
+    nhal_bitbang_onewire_setup(&bus, &group, DQ);
+    memset(&config, 0, sizeof(config));
+    config.speed = overdrive ? NHAL_ONEWIRE_SPEED_OVERDRIVE : NHAL_ONEWIRE_SPEED_STANDARD;
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_onewire_set_config(&bus, &config));
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_onewire_init(&bus));
+
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_onewire_reset(&bus, &presence));
+    EXPECT_TRUE(presence);
+    EXPECT_EQ(1u, device.resets);
+
+    const uint8_t command[] = { 0xCC, 0xBE, 0x00, 0xFF, 0x81 };
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_onewire_write_bits(&bus, command, sizeof(command) * 8));
+    ASSERT_EQ(std::vector<uint8_t>(command, command + sizeof(command)), device.received);
+
+    const uint8_t scratchpad[] = { 0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0x1C };
+    device.transmit.assign(scratchpad, scratchpad + sizeof(scratchpad));
+    uint8_t data[sizeof(scratchpad)];
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_onewire_read_bits(&bus, data, sizeof(data) * 8));
+    EXPECT_EQ(0, memcmp(scratchpad, data, sizeof(data)));
+}
+
+INSTANTIATE_TEST_SUITE_P(Speeds, BitbangOneWireTest, ::testing::Bool());
+
+class Silence : public Device {
+public:
+    uint32_t step(uint32_t driven, uint32_t) override { return driven; }
+};
+
+TEST(BitbangOneWireTest, NoPresenceOnEmptyBus) {
+    Silence nobody;
+    SimulatedPins pins(nobody);
+    struct nhal_pin_group_context group;
+    struct nhal_bitbang_onewire bus;
+    bool presence = true;
+
+    nhal_bitbang_onewire_setup(&bus, &group, DQ);
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_onewire_init(&bus));
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_onewire_reset(&bus, &presence));
+    EXPECT_FALSE(presence);
+}
+
+// ---------------------------------------------------------------------------
+// Bit rate benchmarks
+// ---------------------------------------------------------------------------
+
+double host_ns_per_bit(std::chrono::steady_clock::time_point start, uint64_t bits) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return (double)elapsed / (double)bits;
+}
+
+void report(const char *name, uint64_t payload_bits, const SimulatedPins &pins, double nominal_bps, double host_ns) {
+    double achieved_bps = (double)payload_bits * 1e9 / (double)pins.bus_ns;
+    std::printf("%-28s achieved %10.0f bit/s (%5.1f%% of %.0f), %6.2f pin calls/byte, host %6.1f ns/bit\n", name, achieved_bps,
+                100.0 * achieved_bps / nominal_bps, nominal_bps, (double)pins.sequences * 8.0 / (double)payload_bits, host_ns);
+    ::testing::Test::RecordProperty(std::string(name) + "_bps", (int)achieved_bps);
+}
+
+TEST(BitbangBenchmark, SpiBitRate) {
+    SpiSlave slave(NHAL_SPI_MODE_0, false);
+    SimulatedPins pins(slave);
+    struct nhal_pin_group_context group;
+    struct nhal_bitbang_spi bus;
+    struct nhal_spi_config config;
+    std::vector<uint8_t> frame(8192, 0xA5);
+
+    nhal_bitbang_spi_setup(&bus, &group, SCK, MOSI, MISO, CS);
+    memset(&config, 0, sizeof(config));
+    config.clock_hz = 8000000;
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_spi_set_config(&bus, &config));
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_spi_init(&bus));
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_spi_write_read(&bus, frame.data(), frame.size(), nullptr, 0));
+    double host_ns = host_ns_per_bit(start, frame.size() * 8);
+    report("SPI 8 MHz write", frame.size() * 8, pins, 8e6, host_ns);
+
+    // One call per 15 bytes instead of three pin calls per bit
+    EXPECT_LE(pins.sequences, frame.size() / 15 + 1);
+    EXPECT_GT((double)frame.size() * 8 * 1e9 / (double)pins.bus_ns, 0.99 * 8e6);
+}
+
+TEST(BitbangBenchmark, I2cBitRate) {
+    I2cMemory memory(0x50);
+    SimulatedPins pins(memory);
+    struct nhal_pin_group_context group;
+    struct nhal_bitbang_i2c bus;
+    uint8_t block[129] = { 0 };
+    uint8_t data[128];
+
+    nhal_bitbang_i2c_setup(&bus, &group, SCL, SDA, 400000);
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_i2c_init(&bus));
+
+    auto start = std::chrono::steady_clock::now();
+    nhal_i2c_transfer_op_t write = write_op(block, sizeof(block));
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_i2c_transfer(&bus, seven_bit(0x50), &write, 1));
+    nhal_i2c_transfer_op_t ops[2] = { write_op(block, 1, NHAL_I2C_TRANSFER_MSG_NO_STOP), read_op(data, sizeof(data)) };
+    ASSERT_EQ(NHAL_OK, nhal_bitbang_i2c_transfer(&bus, seven_bit(0x50), ops, 2));
+    uint64_t payload_bits = (sizeof(block) - 1 + sizeof(data)) * 8;
+    double host_ns = host_ns_per_bit(start, payload_bits);
+    report("I2C 400 kHz write+read", payload_bits, pins, 400000, host_ns);
+
+    // Nine clocks per byte plus start, address and stop
+    EXPECT_GT((double)payload_bits * 1e9 / (double)pins.bus_ns, 0.85 * 400000 * 8 / 9);
+}
+
+TEST(BitbangBenchmark, OneWireBitRate) {
+    for (int overdrive = 0; overdrive < 2; overdrive++) {
+        OneWireDevice device(overdrive != 0);
+        SimulatedPins pins(device);
+        struct nhal_pin_group_context group;
+        struct nhal_bitbang_onewire bus;
+        struct nhal_onewire_config config;
+        std::vector<uint8_t> data(512);
+
+        nhal_bitbang_onewire_setup(&bus, &group, DQ);
+        memset(&config, 0, sizeof(config));
+        config.speed = overdrive ? NHAL_ONEWIRE_SPEED_OVERDRIVE : NHAL_ONEWIRE_SPEED_STANDARD;
+        ASSERT_EQ(NHAL_OK, nhal_bitbang_onewire_set_config(&bus, &config));
+        ASSERT_EQ(NHAL_OK, nhal_bitbang_onewire_init(&bus));
+        device.transmit.assign(data.size(), 0x3C);
+
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_EQ(NHAL_OK, nhal_bitbang_onewire_read_bits(&bus, data.data(), data.size() * 8));
+        double host_ns = host_ns_per_bit(start, data.size() * 8);
+        EXPECT_EQ(0x3C, data.back());
+
+        double nominal = overdrive ? 125000 : 15400;
+        report(overdrive ? "1-Wire overdrive read" : "1-Wire standard read", data.size() * 8, pins, nominal, host_ns);
+        EXPECT_GT((double)data.size() * 8 * 1e9 / (double)pins.bus_ns, 0.75 * nominal);
+    }
+}
+
+}  // namespace
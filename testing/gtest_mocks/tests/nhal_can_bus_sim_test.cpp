@@ -0,0 +1,315 @@
+/**
+ * @file nhal_can_bus_sim_test.cpp
+ * @brief NhalCanBusSim filter semantics, TX mailbox ordering across nodes, RX watermark callbacks, loopback, and
+ * frame rate and filter efficiency of a saturated bus
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "nhal_can_bus_sim.hpp"
+#include "nhal_can_mock.hpp"
+#include "nhal_virtual_clock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+struct nhal_can_context {
+    int unused;
+};
+
+namespace {
+
+class CanBusSimTest : public ::testing::Test {
+protected:
+    void bind(NhalCanBusSim &bus) {
+        NhalCanMock &can = can_.mock();
+        ON_CALL(can, nhal_can_init(_)).WillByDefault(Invoke(&bus, &NhalCanBusSim::init));
+        ON_CALL(can, nhal_can_set_config(_, _)).WillByDefault(Invoke(&bus, &NhalCanBusSim::set_config));
+        ON_CALL(can, nhal_can_set_filters(_, _, _)).WillByDefault(Invoke(&bus, &NhalCanBusSim::set_filters));
+        ON_CALL(can, nhal_can_start(_)).WillByDefault(Invoke(&bus, &NhalCanBusSim::start));
+        ON_CALL(can, nhal_can_stop(_)).WillByDefault(Invoke(&bus, &NhalCanBusSim::stop));
+        ON_CALL(can, nhal_can_transmit(_, _, _)).WillByDefault(Invoke(&bus, &NhalCanBusSim::transmit));
+        ON_CALL(can, nhal_can_receive(_, _, _, _, _, _)).WillByDefault(Invoke(&bus, &NhalCanBusSim::receive));
+        ON_CALL(can, nhal_can_get_stats(_, _)).WillByDefault(Invoke(&bus, &NhalCanBusSim::get_stats));
+    }
+
+    static void start_node(struct nhal_can_context *ctx, struct nhal_can_config *config) {
+        ASSERT_EQ(NHAL_OK, nhal_can_init(ctx));
+        ASSERT_EQ(NHAL_OK, nhal_can_set_config(ctx, config));
+        ASSERT_EQ(NHAL_OK, nhal_can_start(ctx));
+    }
+
+    void start_node(uint32_t bitrate) {
+        struct nhal_can_config config = {};
+        config.bitrate = bitrate;
+        start_node(&ctx_, &config);
+    }
+
+    /** @brief Every standard frame into FIFO 0 */
+    static void accept_all(struct nhal_can_context *ctx) {
+        const nhal_can_filter_t all = { 0, 0, 0, 0 };
+        ASSERT_EQ(NHAL_OK, nhal_can_set_filters(ctx, &all, 1));
+    }
+
+    static nhal_can_frame_t traffic(uint64_t n) {
+        return NhalCanBusSim::make_frame(0x080 + (uint32_t)(n % 0x700), 8);
+    }
+
+    NhalMockScope<NhalCanMock, NiceMock<NhalCanMock> > can_;
+    struct nhal_can_context ctx_;
+};
+
+TEST_F(CanBusSimTest, EmptyFilterTableReceivesNothing) {
+    NhalCanBusSim bus(500000);
+    bind(bus);
+    start_node(500000);
+    bus.saturate(traffic);
+    nhal_can_frame_t frames[4];
+    size_t received = 0;
+
+    // The table after init is empty: every frame is rejected by the hardware
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(bus.step());
+    }
+    EXPECT_EQ(NHAL_ERR_TIMEOUT, nhal_can_receive(&ctx_, 0, frames, 4, &received, 0));
+    EXPECT_EQ(10u, bus.node_stats(&ctx_).frames_rejected);
+    EXPECT_EQ(0u, bus.node_stats(&ctx_).frames_accepted);
+
+    // A mask of 0 accepts every identifier of its type
+    const nhal_can_filter_t accept_all = { 0, 0, 0, 1 };
+    ASSERT_EQ(NHAL_OK, nhal_can_set_filters(&ctx_, &accept_all, 1));
+    ASSERT_TRUE(bus.step());
+    ASSERT_EQ(NHAL_OK, nhal_can_receive(&ctx_, 1, frames, 4, &received, 0));
+    EXPECT_EQ(1u, received);
+    EXPECT_EQ(0, frames[0].filter_index);
+}
+
+TEST_F(CanBusSimTest, TxPriorityOrdersTheMailboxesOfEachNode) {
+    NhalCanBusSim bus(500000);
+    bind(bus);
+    struct nhal_can_context fifo_node;
+    struct nhal_can_context id_node;
+    NhalCanBusSim::NodeConfig listener_resources;
+    listener_resources.fifo_depth = 8;
+    bus.attach(&ctx_, listener_resources);
+
+    struct nhal_can_config config = {};
+    config.bitrate = 500000;
+    start_node(&ctx_, &config);
+    accept_all(&ctx_);
+    config.tx_priority = NHAL_CAN_TX_PRIORITY_ID;
+    start_node(&id_node, &config);
+    config.tx_priority = NHAL_CAN_TX_PRIORITY_FIFO;
+    start_node(&fifo_node, &config);
+
+    auto run = [&](const std::vector<uint32_t> &fifo_ids, const std::vector<uint32_t> &id_ids) {
+        for (size_t i = 0; i < fifo_ids.size(); i++) {
+            nhal_can_frame_t frame = NhalCanBusSim::make_frame(fifo_ids[i], 2);
+            EXPECT_EQ(NHAL_OK, nhal_can_transmit(&fifo_node, &frame, 0));
+            frame = NhalCanBusSim::make_frame(id_ids[i], 2);
+            EXPECT_EQ(NHAL_OK, nhal_can_transmit(&id_node, &frame, 0));
+        }
+        while (bus.step()) {
+        }
+        nhal_can_frame_t frames[8];
+        size_t received = 0;
+        std::vector<uint32_t> order;
+        EXPECT_EQ(NHAL_OK, nhal_can_receive(&ctx_, 0, frames, 8, &received, 0));
+        for (size_t i = 0; i < received; i++) {
+            order.push_back(frames[i].id);
+        }
+        return order;
+    };
+
+    // Each controller offers one mailbox per round and the bus takes the lowest
+    // identifier offered: the FIFO node holds 0x100 behind its older 0x300
+    const std::vector<uint32_t> in_order = { 0x050, 0x150, 0x250, 0x300, 0x100, 0x200 };
+    EXPECT_EQ(in_order, run({ 0x300, 0x100, 0x200 }, { 0x250, 0x050, 0x150 }));
+
+    // The same submissions with the FIFO node in identifier order
+    config.tx_priority = NHAL_CAN_TX_PRIORITY_ID;
+    ASSERT_EQ(NHAL_OK, nhal_can_stop(&fifo_node));
+    ASSERT_EQ(NHAL_OK, nhal_can_set_config(&fifo_node, &config));
+    ASSERT_EQ(NHAL_OK, nhal_can_start(&fifo_node));
+    const std::vector<uint32_t> by_id = { 0x050, 0x100, 0x150, 0x200, 0x250, 0x300 };
+    EXPECT_EQ(by_id, run({ 0x300, 0x100, 0x200 }, { 0x250, 0x050, 0x150 }));
+
+    // Frames are not delivered to their sender outside loopback
+    struct nhal_can_stats stats;
+    ASSERT_EQ(NHAL_OK, nhal_can_get_stats(&id_node, &stats));
+    EXPECT_EQ(6u, stats.frames_transmitted);
+    EXPECT_EQ(6u, bus.node_stats(&id_node).frames_seen);
+    EXPECT_EQ(3u, bus.node_stats(&fifo_node).frames_seen);      // Since its restart
+    EXPECT_EQ(12u, bus.node_stats(&ctx_).frames_accepted);
+}
+
+struct Batches {
+    bool drain;
+    std::vector<size_t> sizes;
+};
+
+void read_batch(struct nhal_can_context *ctx, uint8_t fifo, void *user_data)
+{
+    Batches *batches = static_cast<Batches *>(user_data);
+    nhal_can_frame_t frames[8];
+    size_t received = 0;
+    if (!batches->drain) {
+        batches->sizes.push_back(0);
+        return;
+    }
+    EXPECT_EQ(NHAL_OK, nhal_can_receive(ctx, fifo, frames, 8, &received, 0));
+    batches->sizes.push_back(received);
+}
+
+TEST_F(CanBusSimTest, RxWatermarkCallbackFiresOncePerBatch) {
+    NhalCanBusSim bus(500000);
+    bind(bus);
+    NhalCanBusSim::NodeConfig resources;
+    resources.fifo_depth = 8;
+    bus.attach(&ctx_, resources);
+    Batches batches = { true, std::vector<size_t>() };
+    struct nhal_can_config config = {};
+    config.bitrate = 500000;
+    config.rx_watermark = 4;
+    config.rx_callback = read_batch;
+    config.user_data = &batches;
+    start_node(&ctx_, &config);
+    accept_all(&ctx_);
+    auto deliver = [&bus](unsigned frames) {
+        for (unsigned i = 0; i < frames; i++) {
+            bus.inject(NhalCanBusSim::make_frame(0x100 + i, 8));
+            ASSERT_TRUE(bus.step());
+        }
+    };
+
+    // A consumer reading from the callback: one call per 4 frames
+    deliver(12);
+    EXPECT_EQ(std::vector<size_t>({ 4, 4, 4 }), batches.sizes);
+    EXPECT_EQ(3u, bus.node_stats(&ctx_).receive_calls);
+
+    // Left unread, the FIFO passes the watermark without calling again
+    batches.drain = false;
+    batches.sizes.clear();
+    deliver(6);
+    EXPECT_EQ(std::vector<size_t>(1, 0), batches.sizes);
+    nhal_can_frame_t frames[8];
+    size_t received = 0;
+    ASSERT_EQ(NHAL_OK, nhal_can_receive(&ctx_, 0, frames, 8, &received, 0));
+    EXPECT_EQ(6u, received);
+
+    // Drained, it arms again
+    deliver(4);
+    EXPECT_EQ(2u, batches.sizes.size());
+    EXPECT_EQ(5u, bus.node_stats(&ctx_).rx_callbacks);
+    EXPECT_EQ(0u, bus.node_stats(&ctx_).rx_overruns);
+
+    // A watermark of 0 calls back for every frame
+    config.rx_watermark = 0;
+    ASSERT_EQ(NHAL_OK, nhal_can_stop(&ctx_));
+    ASSERT_EQ(NHAL_OK, nhal_can_set_config(&ctx_, &config));
+    ASSERT_EQ(NHAL_OK, nhal_can_start(&ctx_));
+    batches.drain = true;
+    batches.sizes.clear();
+    deliver(3);
+    EXPECT_EQ(std::vector<size_t>({ 1, 1, 1 }), batches.sizes);
+}
+
+TEST_F(CanBusSimTest, LoopbackNodeReceivesItsOwnFrames) {
+    NhalVirtualClock clock;
+    NhalCanBusSim bus(500000);
+    bind(bus);
+    struct nhal_can_context peer;
+    struct nhal_can_config config = {};
+    config.bitrate = 500000;
+    start_node(&peer, &config);
+    accept_all(&peer);
+    config.mode = NHAL_CAN_MODE_LOOPBACK;
+    start_node(&ctx_, &config);
+    accept_all(&ctx_);
+
+    nhal_can_frame_t frame = NhalCanBusSim::make_frame(0x123, 8);
+    nhal_can_frame_t frames[4];
+    size_t received = 0;
+    const uint64_t frame_ns = (uint64_t)NhalCanBusSim::frame_bits(frame) * 1000000000u / 500000;
+
+    // The sender receives its frame when it has crossed the bus, as the peer does
+    ASSERT_EQ(NHAL_OK, nhal_can_transmit(&ctx_, &frame, 0));
+    ASSERT_EQ(NHAL_OK, nhal_can_receive(&ctx_, 0, frames, 4, &received, 10));
+    ASSERT_EQ(1u, received);
+    EXPECT_EQ(0x123u, frames[0].id);
+    EXPECT_EQ(0, memcmp(frame.data, frames[0].data, 8));
+    EXPECT_EQ(frame_ns, frames[0].timestamp_ticks);
+    ASSERT_EQ(NHAL_OK, nhal_can_receive(&peer, 0, frames, 4, &received, 0));
+    EXPECT_EQ(1u, received);
+
+    // A node in normal mode does not
+    frame = NhalCanBusSim::make_frame(0x456, 1);
+    ASSERT_EQ(NHAL_OK, nhal_can_transmit(&peer, &frame, 0));
+    ASSERT_EQ(NHAL_OK, nhal_can_receive(&ctx_, 0, frames, 4, &received, 10));
+    EXPECT_EQ(0x456u, frames[0].id);
+    EXPECT_EQ(NHAL_ERR_TIMEOUT, nhal_can_receive(&peer, 0, frames, 4, &received, 10));
+
+    struct nhal_can_stats stats;
+    ASSERT_EQ(NHAL_OK, nhal_can_get_stats(&ctx_, &stats));
+    EXPECT_EQ(1u, stats.frames_transmitted);
+    EXPECT_EQ(2u, stats.frames_received);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark: a gateway on a saturated 1 Mbit/s bus for one virtual second
+// ---------------------------------------------------------------------------
+
+TEST_F(CanBusSimTest, SaturatedBusFrameRateAndFilterEfficiency) {
+    NhalVirtualClock clock;
+    NhalCanBusSim bus(1000000);
+    bind(bus);
+    start_node(1000000);
+
+    // The gateway forwards 0x100-0x107 and 0x200; the first bank is one bit
+    // too wide and lets 0x108-0x10F through to software
+    const nhal_can_filter_t filters[] = {
+        { 0x100, 0x7F0, 0, 0 },
+        { 0x200, NHAL_CAN_STD_ID_MASK, 0, 0 },
+    };
+    ASSERT_EQ(NHAL_OK, nhal_can_set_filters(&ctx_, filters, 2));
+    bus.set_wanted(&ctx_, [](const nhal_can_frame_t &frame) { return frame.id < 0x108 || frame.id == 0x200; });
+    bus.saturate(traffic);
+
+    nhal_can_frame_t frames[8];
+    size_t received = 0;
+    uint64_t forwarded = 0;
+    while (clock.now_ns() < 1000000000u) {
+        if (nhal_can_receive(&ctx_, 0, frames, 8, &received, 1) == NHAL_OK) {
+            forwarded += received;
+        }
+    }
+
+    NhalCanBusSim::NodeStats stats = bus.node_stats(&ctx_);
+    double fps = bus.frames_per_second();
+    double efficiency = bus.filter_efficiency(&ctx_);
+
+    // 8-byte standard frames take 111 bits before stuffing, interframe space included
+    EXPECT_GT(fps, 8000.0);
+    EXPECT_LT(fps, 1e6 / 111);
+    EXPECT_NEAR(1.0, bus.bus_load(), 0.01);
+    EXPECT_GT(efficiency, 0.95);
+    EXPECT_EQ(stats.frames_seen, stats.frames_accepted + stats.frames_rejected);
+    EXPECT_EQ(0u, stats.rx_overruns);
+    EXPECT_EQ(stats.frames_accepted, forwarded);
+    EXPECT_GT(stats.frames_unwanted, 0u);
+
+    std::printf("1 Mbit/s saturated: %.0f frames/s, load %.3f; filters rejected %llu of %llu frames "
+                "(efficiency %.4f), %llu accepted, %llu of them unwanted\n",
+                fps, bus.bus_load(), (unsigned long long)stats.frames_rejected,
+                (unsigned long long)stats.frames_seen, efficiency, (unsigned long long)stats.frames_accepted,
+                (unsigned long long)stats.frames_unwanted);
+    RecordProperty("frames_per_second", (int)fps);
+    RecordProperty("filter_efficiency_ppm", (int)(efficiency * 1e6));
+}
+
+}  // namespace
@@ -0,0 +1,242 @@
+/**
+ * @file nhal_config_switch_test.cpp
+ * @brief Cost of switching SPI configurations between devices sharing a bus
+ *
+ * A reference backend models a typical SPI peripheral (control, format and
+ * clock divider registers, disabled while reprogrammed) and implements the
+ * three ways a driver can select its device's configuration before each
+ * access: full set_config, set_config with config_id elision, and prebuilt
+ * config images. The benchmark reports register writes and host time per
+ * access for an access pattern mixing three devices.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "nhal_spi_types.h"
+
+namespace {
+
+const uint32_t KERNEL_CLOCK_HZ = 80000000;
+
+/** @brief Simulated peripheral registers, every write counted */
+struct SpiRegisters {
+    volatile uint32_t cr1 = 0;
+    volatile uint32_t cr2 = 0;
+    volatile uint32_t div = 0;
+    uint64_t writes = 0;
+
+    void write(volatile uint32_t &reg, uint32_t value) {
+        reg = value;
+        writes++;
+    }
+};
+
+struct Image {
+    nhal_config_id_t config_id;
+    const struct nhal_spi_impl_config *impl_config;
+    uint32_t cr1;
+    uint32_t cr2;
+    uint32_t div;
+};
+
+const uint32_t CR1_ENABLE = 1u << 6;
+
+/** @brief Reference set_config/config_image implementation following the nhal_config_id_t contract */
+class ReferenceSpi {
+public:
+    nhal_result_t set_config(const struct nhal_spi_config *config) {
+        if (config == nullptr) {
+            return NHAL_ERR_INVALID_ARG;
+        }
+        nhal_config_id_t token = NHAL_CONFIG_ID_TOKEN(config->config_id);
+        if (token != NHAL_CONFIG_ID_NONE && token == applied_.config_id && config->impl_config == applied_.impl_config) {
+            return NHAL_OK;
+        }
+        Image image;
+        nhal_result_t result = build(config, &image);
+        if (result != NHAL_OK) {
+            return result;
+        }
+        program(image);
+        return NHAL_OK;
+    }
+
+    nhal_result_t image_build(const struct nhal_spi_config *config, Image *image) const {
+        return config != nullptr && image != nullptr ? build(config, image) : NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_result_t image_apply(const Image *image) {
+        if (image == nullptr) {
+            return NHAL_ERR_INVALID_ARG;
+        }
+        if (image == applied_image_) {
+            return NHAL_OK;
+        }
+        program(*image);
+        applied_image_ = image;
+        return NHAL_OK;
+    }
+
+    SpiRegisters regs;
+
+private:
+    nhal_result_t build(const struct nhal_spi_config *config, Image *image) const {
+        if (config->mode > NHAL_SPI_MODE_3 || config->bit_order > NHAL_SPI_BIT_ORDER_LSB_FIRST
+            || config->duplex > NHAL_SPI_HALF_DUPLEX || config->word_size > NHAL_SPI_WORD_SIZE_32) {
+            return NHAL_ERR_INVALID_CONFIG;
+        }
+        // Power of two prescalers 2..256: the highest SCK not above clock_hz
+        uint32_t prescaler = 0;
+        uint32_t limit = config->clock_hz != 0 ? config->clock_hz : 1000000;
+        while (prescaler < 7 && (KERNEL_CLOCK_HZ >> (prescaler + 1)) > limit) {
+            prescaler++;
+        }
+        if ((KERNEL_CLOCK_HZ >> (prescaler + 1)) > limit) {
+            return NHAL_ERR_UNSUPPORTED;
+        }
+        static const uint32_t word_bits[] = { 8, 16, 32 };
+        image->config_id = NHAL_CONFIG_ID_TOKEN(config->config_id);
+        image->impl_config = config->impl_config;
+        image->cr1 = (uint32_t)config->mode | ((uint32_t)config->bit_order << 2) | ((uint32_t)config->duplex << 3) | CR1_ENABLE;
+        image->cr2 = word_bits[config->word_size] - 1;
+        image->div = prescaler;
+        return NHAL_OK;
+    }
+
+    void program(const Image &image) {
+        regs.write(regs.cr1, regs.cr1 & ~CR1_ENABLE);
+        regs.write(regs.cr2, image.cr2);
+        regs.write(regs.div, image.div);
+        regs.write(regs.cr1, image.cr1);
+        applied_ = image;
+        applied_image_ = nullptr;
+    }
+
+    Image applied_ = Image();
+    const Image *applied_image_ = nullptr;
+};
+
+struct nhal_spi_config device_config(nhal_spi_mode_t mode, uint32_t clock_hz, nhal_config_id_t id) {
+    struct nhal_spi_config config;
+    memset(&config, 0, sizeof(config));
+    config.mode = mode;
+    config.clock_hz = clock_hz;
+    config.config_id = id;
+    return config;
+}
+
+TEST(ConfigIdTest, MakeAndNext) {
+    nhal_config_id_t id = NHAL_CONFIG_ID_MAKE(3, 0xFFFF);
+    EXPECT_NE(NHAL_CONFIG_ID_NONE, id);
+    EXPECT_EQ(3, NHAL_CONFIG_ID_OWNER(id));
+    EXPECT_EQ(NHAL_CONFIG_ID_MAKE(3, 0), NHAL_CONFIG_ID_NEXT(id));
+    EXPECT_NE(NHAL_CONFIG_ID_MAKE(4, 1), NHAL_CONFIG_ID_MAKE(3, 1));
+    EXPECT_EQ(NHAL_CONFIG_ID_PREVALIDATED | NHAL_CONFIG_ID_MAKE(3, 2),
+              NHAL_CONFIG_ID_NEXT(NHAL_CONFIG_ID_PREVALIDATED | NHAL_CONFIG_ID_MAKE(3, 1)));
+    EXPECT_EQ(0, NHAL_CONFIG_ID_PREVALIDATED & NHAL_CONFIG_ID_MAKE(0xFFFF, 0xFFFF));
+}
+
+TEST(ConfigIdTest, ElisionNeedsSameTokenAndImplConfig) {
+    ReferenceSpi spi;
+    struct nhal_spi_impl_config *impl_a = reinterpret_cast<struct nhal_spi_impl_config *>(0x1000);
+    struct nhal_spi_impl_config *impl_b = reinterpret_cast<struct nhal_spi_impl_config *>(0x2000);
+    struct nhal_spi_config config = device_config(NHAL_SPI_MODE_1, 1000000, NHAL_CONFIG_ID_MAKE(1, 0));
+    config.impl_config = impl_a;
+
+    ASSERT_EQ(NHAL_OK, spi.set_config(&config));
+    uint64_t writes = spi.regs.writes;
+    ASSERT_EQ(NHAL_OK, spi.set_config(&config));
+    EXPECT_EQ(writes, spi.regs.writes);
+
+    config.impl_config = impl_b;
+    ASSERT_EQ(NHAL_OK, spi.set_config(&config));
+    EXPECT_GT(spi.regs.writes, writes);
+
+    // NHAL_CONFIG_ID_NONE is always applied in full
+    writes = spi.regs.writes;
+    config.config_id = NHAL_CONFIG_ID_NONE;
+    ASSERT_EQ(NHAL_OK, spi.set_config(&config));
+    ASSERT_EQ(NHAL_OK, spi.set_config(&config));
+    EXPECT_EQ(writes + 8, spi.regs.writes);
+}
+
+// ---------------------------------------------------------------------------
+// Config-switch benchmark
+// ---------------------------------------------------------------------------
+
+const int ACCESSES = 200000;
+const int DEVICES = 3;
+
+/** @brief Access pattern: runs of accesses to one device, as when polling a sensor between flash reads */
+int device_of(int access) {
+    uint32_t x = (uint32_t)access / 4 * 2654435761u;
+    return (int)((x >> 16) % DEVICES);
+}
+
+struct Result {
+    double writes_per_access;
+    double ns_per_access;
+};
+
+template <typename Select>
+Result run(ReferenceSpi &spi, Select select) {
+    uint64_t writes = spi.regs.writes;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ACCESSES; i++) {
+        if (select(device_of(i)) != NHAL_OK) {
+            ADD_FAILURE() << "select failed";
+            break;
+        }
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    Result result;
+    result.writes_per_access = (double)(spi.regs.writes - writes) / ACCESSES;
+    result.ns_per_access = (double)ns / ACCESSES;
+    return result;
+}
+
+void report(const char *name, const Result &result) {
+    std::printf("%-32s %5.2f register writes/access, %6.1f ns/access\n", name, result.writes_per_access, result.ns_per_access);
+    ::testing::Test::RecordProperty(std::string(name) + "_writes_x100", (int)(result.writes_per_access * 100));
+}
+
+TEST(ConfigSwitchBenchmark, SharedBusOfThreeDevices) {
+    int switches = 0;
+    for (int i = 1; i < ACCESSES; i++) {
+        switches += device_of(i) != device_of(i - 1);
+    }
+    std::printf("%d accesses over %d devices, %d device switches\n", ACCESSES, DEVICES, switches);
+
+    struct nhal_spi_config anonymous[DEVICES] = {
+        device_config(NHAL_SPI_MODE_0, 20000000, NHAL_CONFIG_ID_NONE),
+        device_config(NHAL_SPI_MODE_3, 1000000, NHAL_CONFIG_ID_NONE),
+        device_config(NHAL_SPI_MODE_1, 8000000, NHAL_CONFIG_ID_NONE),
+    };
+    struct nhal_spi_config identified[DEVICES];
+    Image images[DEVICES];
+    ReferenceSpi spi;
+    for (int d = 0; d < DEVICES; d++) {
+        identified[d] = anonymous[d];
+        identified[d].config_id = NHAL_CONFIG_ID_MAKE(d + 1, 0);
+        ASSERT_EQ(NHAL_OK, spi.image_build(&identified[d], &images[d]));
+    }
+
+    Result full = run(spi, [&](int d) { return spi.set_config(&anonymous[d]); });
+    Result elided = run(spi, [&](int d) { return spi.set_config(&identified[d]); });
+    Result imaged = run(spi, [&](int d) { return spi.image_apply(&images[d]); });
+
+    report("set_config, no config_id", full);
+    report("set_config, config_id elision", elided);
+    report("config image apply", imaged);
+
+    double writes_per_switch = 4.0 * switches / ACCESSES;
+    EXPECT_DOUBLE_EQ(4.0, full.writes_per_access);
+    EXPECT_NEAR(writes_per_switch, elided.writes_per_access, 0.001);
+    EXPECT_NEAR(writes_per_switch, imaged.writes_per_access, 0.001);
+}
+
+}  // namespace
@@ -0,0 +1,206 @@
+/**
+ * @file nhal_config_test.cpp
+ * @brief nhal_config.hpp builders: defaults, chained UART fields, config_id stamping and set/get round trips
+ */
+
+#include <gtest/gtest.h>
+
+#include <type_traits>
+
+#include "nhal_config.hpp"
+#include "nhal_i2c_mock.hpp"
+#include "nhal_spi_mock.hpp"
+#include "nhal_uart_mock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+struct nhal_uart_context {
+    int unused;
+};
+
+struct nhal_spi_context {
+    int unused;
+};
+
+struct nhal_i2c_context {
+    int unused;
+};
+
+struct nhal_uart_impl_config {
+    uint32_t divisor;
+};
+
+namespace {
+
+struct test_mcu_caps : nhal::generic_caps {
+    static constexpr bool is_platform = true;
+    static constexpr uint32_t uart_clock_hz = 48000000;
+    static constexpr uint32_t i2c_clock_hz = 16000000;
+};
+
+typedef nhal::uart_config<115200> console_uart;
+typedef nhal::uart_config<230400, NHAL_UART_PARITY_EVEN, NHAL_UART_STOP_BITS_2, NHAL_UART_DATA_BITS_8, test_mcu_caps>
+    ::flow_control<NHAL_UART_FLOW_CONTROL_RTS_CTS>::rx_fifo_threshold<12>::rx_idle_timeout_bits<20> modem_uart;
+
+// The builders are usable in constant expressions
+constexpr struct nhal_uart_config console_config = console_uart::make();
+static_assert(console_config.baudrate == 115200, "constexpr make()");
+
+TEST(ConfigBuilderTest, DefaultsMatchAZeroInitializedConfiguration) {
+    struct nhal_uart_config uart = console_uart::make();
+    EXPECT_EQ(115200u, uart.baudrate);
+    EXPECT_EQ(NHAL_UART_PARITY_NONE, uart.parity);
+    EXPECT_EQ(NHAL_UART_STOP_BITS_1, uart.stop_bits);
+    EXPECT_EQ(NHAL_UART_DATA_BITS_8, uart.data_bits);
+    EXPECT_EQ(nullptr, uart.impl_config);
+    EXPECT_EQ(NHAL_CONFIG_ID_NONE, uart.config_id);
+    EXPECT_EQ(NHAL_UART_FLOW_CONTROL_NONE, uart.flow_control);
+    EXPECT_EQ(0u, uart.rx_fifo_threshold);
+    EXPECT_EQ(0u, uart.rx_idle_timeout_bits);
+
+    struct nhal_spi_config spi = nhal::spi_config<NHAL_SPI_MODE_3>::make();
+    EXPECT_EQ(NHAL_SPI_FULL_DUPLEX, spi.duplex);
+    EXPECT_EQ(NHAL_SPI_MODE_3, spi.mode);
+    EXPECT_EQ(NHAL_SPI_BIT_ORDER_MSB_FIRST, spi.bit_order);
+    EXPECT_EQ(nullptr, spi.impl_config);
+    EXPECT_EQ(NHAL_CONFIG_ID_NONE, spi.config_id);
+    EXPECT_EQ(0u, spi.clock_hz);
+    EXPECT_EQ(NHAL_SPI_WORD_SIZE_8, spi.word_size);
+
+    struct nhal_i2c_config i2c = nhal::i2c_config<400000>::make();
+    EXPECT_EQ(nullptr, i2c.impl_config);
+    EXPECT_EQ(NHAL_CONFIG_ID_NONE, i2c.config_id);
+}
+
+TEST(ConfigBuilderTest, ChainedUartFieldsChangeOneFieldEach) {
+    struct nhal_uart_config modem = modem_uart::make();
+    EXPECT_EQ(230400u, modem.baudrate);
+    EXPECT_EQ(NHAL_UART_PARITY_EVEN, modem.parity);
+    EXPECT_EQ(NHAL_UART_STOP_BITS_2, modem.stop_bits);
+    EXPECT_EQ(NHAL_UART_FLOW_CONTROL_RTS_CTS, modem.flow_control);
+    EXPECT_EQ(12u, modem.rx_fifo_threshold);
+    EXPECT_EQ(20u, modem.rx_idle_timeout_bits);
+
+    // Order does not matter, and the last value set wins
+    static_assert(std::is_same<modem_uart,
+                               nhal::uart_config<230400, NHAL_UART_PARITY_EVEN, NHAL_UART_STOP_BITS_2,
+                                                 NHAL_UART_DATA_BITS_8, test_mcu_caps>
+                                   ::rx_idle_timeout_bits<20>::rx_fifo_threshold<4>::rx_fifo_threshold<12>
+                                   ::flow_control<NHAL_UART_FLOW_CONTROL_RTS_CTS> >::value,
+                  "chained fields");
+    struct nhal_uart_config rs485 = console_uart::flow_control<NHAL_UART_FLOW_CONTROL_RS485_DE>::make();
+    EXPECT_EQ(NHAL_UART_FLOW_CONTROL_RS485_DE, rs485.flow_control);
+    EXPECT_EQ(0u, rs485.rx_fifo_threshold);
+
+    // Divisors follow the platform clock
+    EXPECT_EQ(13u, modem_uart::divisor::value);
+    EXPECT_EQ(26u, (nhal::uart_config<115200, NHAL_UART_PARITY_NONE, NHAL_UART_STOP_BITS_1, NHAL_UART_DATA_BITS_8,
+                                      test_mcu_caps>::divisor::value));
+    EXPECT_EQ(20u, (nhal::i2c_config<400000, test_mcu_caps>::divisor::value));
+}
+
+TEST(ConfigBuilderTest, ConfigIdCarriesTheTokenAndPlatformValidation) {
+    const nhal_config_id_t token = NHAL_CONFIG_ID_MAKE(3, 7);
+    struct nhal_uart_impl_config impl = { modem_uart::divisor::value };
+
+    // Generic capabilities validate nothing platform specific
+    EXPECT_EQ(token, console_uart::make(nullptr, token).config_id);
+    EXPECT_EQ(token, (nhal::spi_config<NHAL_SPI_MODE_0>::make(nullptr, token).config_id));
+    EXPECT_EQ(token, nhal::i2c_config<100000>::make(nullptr, token).config_id);
+
+    struct nhal_uart_config modem = modem_uart::make(&impl, token);
+    EXPECT_EQ(token | NHAL_CONFIG_ID_PREVALIDATED, modem.config_id);
+    EXPECT_EQ(&impl, modem.impl_config);
+    EXPECT_EQ(NHAL_CONFIG_ID_PREVALIDATED, modem_uart::make().config_id);
+    EXPECT_EQ(NHAL_CONFIG_ID_PREVALIDATED | token,
+              (nhal::spi_config<NHAL_SPI_MODE_0, NHAL_SPI_BIT_ORDER_MSB_FIRST, NHAL_SPI_FULL_DUPLEX, test_mcu_caps>
+                   ::make(nullptr, token).config_id));
+
+    // A flag passed in by hand is not trusted
+    EXPECT_EQ(token, console_uart::make(nullptr, token | NHAL_CONFIG_ID_PREVALIDATED).config_id);
+}
+
+class ConfigRoundTripTest : public ::testing::Test {
+protected:
+    NhalMockScope<NhalUartMock, NiceMock<NhalUartMock> > uart_;
+    NhalMockScope<NhalSpiMock, NiceMock<NhalSpiMock> > spi_;
+    NhalMockScope<NhalI2cMock, NiceMock<NhalI2cMock> > i2c_;
+};
+
+TEST_F(ConfigRoundTripTest, BuiltConfigurationsSurviveSetAndGet) {
+    struct nhal_uart_config uart_applied = {};
+    struct nhal_spi_config spi_applied = {};
+    struct nhal_i2c_config i2c_applied = {};
+    ON_CALL(uart_.mock(), nhal_uart_set_config(_, _))
+        .WillByDefault(Invoke([&](struct nhal_uart_context *, struct nhal_uart_config *cfg) {
+            uart_applied = *cfg;
+            return NHAL_OK;
+        }));
+    ON_CALL(uart_.mock(), nhal_uart_get_config(_, _))
+        .WillByDefault(Invoke([&](struct nhal_uart_context *, struct nhal_uart_config *cfg) {
+            *cfg = uart_applied;
+            return NHAL_OK;
+        }));
+    ON_CALL(spi_.mock(), nhal_spi_master_set_config(_, _))
+        .WillByDefault(Invoke([&](struct nhal_spi_context *, struct nhal_spi_config *cfg) {
+            spi_applied = *cfg;
+            return NHAL_OK;
+        }));
+    ON_CALL(spi_.mock(), nhal_spi_master_get_config(_, _))
+        .WillByDefault(Invoke([&](struct nhal_spi_context *, struct nhal_spi_config *cfg) {
+            *cfg = spi_applied;
+            return NHAL_OK;
+        }));
+    ON_CALL(i2c_.mock(), nhal_i2c_master_set_config(_, _))
+        .WillByDefault(Invoke([&](struct nhal_i2c_context *, struct nhal_i2c_config *cfg) {
+            i2c_applied = *cfg;
+            return NHAL_OK;
+        }));
+    ON_CALL(i2c_.mock(), nhal_i2c_master_get_config(_, _))
+        .WillByDefault(Invoke([&](struct nhal_i2c_context *, struct nhal_i2c_config *cfg) {
+            *cfg = i2c_applied;
+            return NHAL_OK;
+        }));
+
+    struct nhal_uart_context uart_ctx;
+    struct nhal_spi_context spi_ctx;
+    struct nhal_i2c_context i2c_ctx;
+    struct nhal_uart_impl_config impl = { modem_uart::divisor::value };
+
+    struct nhal_uart_config uart = modem_uart::make(&impl, NHAL_CONFIG_ID_MAKE(1, 0));
+    struct nhal_uart_config uart_read = {};
+    ASSERT_EQ(NHAL_OK, nhal_uart_set_config(&uart_ctx, &uart));
+    ASSERT_EQ(NHAL_OK, nhal_uart_get_config(&uart_ctx, &uart_read));
+    EXPECT_EQ(uart.baudrate, uart_read.baudrate);
+    EXPECT_EQ(uart.parity, uart_read.parity);
+    EXPECT_EQ(uart.stop_bits, uart_read.stop_bits);
+    EXPECT_EQ(uart.data_bits, uart_read.data_bits);
+    EXPECT_EQ(&impl, uart_read.impl_config);
+    EXPECT_EQ(uart.config_id, uart_read.config_id);
+    EXPECT_EQ(NHAL_UART_FLOW_CONTROL_RTS_CTS, uart_read.flow_control);
+    EXPECT_EQ(12u, uart_read.rx_fifo_threshold);
+    EXPECT_EQ(20u, uart_read.rx_idle_timeout_bits);
+
+    typedef nhal::spi_config<NHAL_SPI_MODE_1, NHAL_SPI_BIT_ORDER_LSB_FIRST, NHAL_SPI_HALF_DUPLEX, nhal::generic_caps,
+                             8000000, NHAL_SPI_WORD_SIZE_16> flash_spi;
+    struct nhal_spi_config spi = flash_spi::make(nullptr, NHAL_CONFIG_ID_MAKE(2, 1));
+    struct nhal_spi_config spi_read = {};
+    ASSERT_EQ(NHAL_OK, nhal_spi_master_set_config(&spi_ctx, &spi));
+    ASSERT_EQ(NHAL_OK, nhal_spi_master_get_config(&spi_ctx, &spi_read));
+    EXPECT_EQ(NHAL_SPI_HALF_DUPLEX, spi_read.duplex);
+    EXPECT_EQ(NHAL_SPI_MODE_1, spi_read.mode);
+    EXPECT_EQ(NHAL_SPI_BIT_ORDER_LSB_FIRST, spi_read.bit_order);
+    EXPECT_EQ(NHAL_CONFIG_ID_MAKE(2, 1), spi_read.config_id);
+    EXPECT_EQ(8000000u, spi_read.clock_hz);
+    EXPECT_EQ(NHAL_SPI_WORD_SIZE_16, spi_read.word_size);
+
+    struct nhal_i2c_config i2c = nhal::i2c_config<400000, test_mcu_caps>::make(nullptr, NHAL_CONFIG_ID_MAKE(3, 0));
+    struct nhal_i2c_config i2c_read = {};
+    ASSERT_EQ(NHAL_OK, nhal_i2c_master_set_config(&i2c_ctx, &i2c));
+    ASSERT_EQ(NHAL_OK, nhal_i2c_master_get_config(&i2c_ctx, &i2c_read));
+    EXPECT_EQ(NHAL_CONFIG_ID_MAKE(3, 0) | NHAL_CONFIG_ID_PREVALIDATED, i2c_read.config_id);
+}
+
+}  // namespace
@@ -0,0 +1,161 @@
+/**
+ * @file nhal_dispatch_backend.c
+ * @brief Dispatch layer of all ops headers, and a probe backend recording what reaches it
+ *
+ * Built with NHAL_SPI_DISPATCH, NHAL_I2C_DISPATCH, NHAL_UART_DISPATCH and
+ * NHAL_PIN_DISPATCH. The probe ops are also called directly by the benchmark
+ * to measure the cost of the dispatch indirection; they live in this
+ * translation unit so that both paths pay for a real call.
+ */
+
+#define NHAL_DISPATCH_IMPLEMENTATION
+
+#include "nhal_dispatch_backend.h"
+
+struct nhal_dispatch_probe nhal_dispatch_probe;
+
+static void record(void *ctx, const char *op, size_t length)
+{
+    nhal_dispatch_probe.backend_ctx = ctx;
+    nhal_dispatch_probe.op = op;
+    nhal_dispatch_probe.length = length;
+    nhal_dispatch_probe.calls++;
+}
+
+__attribute__((noinline)) nhal_result_t probe_spi_write(struct nhal_spi_context *ctx, const uint8_t *data, size_t len)
+{
+    (void)data;
+    nhal_dispatch_probe.backend_ctx = ctx->backend_ctx;
+    nhal_dispatch_probe.length = len;
+    nhal_dispatch_probe.calls++;
+    return NHAL_OK;
+}
+
+__attribute__((noinline)) nhal_result_t probe_pin_set_state(struct nhal_pin_context *ctx, nhal_pin_state_t value)
+{
+    nhal_dispatch_probe.backend_ctx = ctx->backend_ctx;
+    nhal_dispatch_probe.length = value;
+    nhal_dispatch_probe.calls++;
+    return NHAL_OK;
+}
+
+static nhal_result_t probe_spi_plan_execute(struct nhal_spi_context *ctx, struct nhal_spi_plan *plan)
+{
+    (void)plan;
+    record(ctx->backend_ctx, "spi_plan_execute", 0);
+    return NHAL_OK;
+}
+
+static nhal_result_t probe_spi_config_image_apply(struct nhal_spi_context *ctx, const struct nhal_spi_config_image *image)
+{
+    (void)image;
+    record(ctx->backend_ctx, "spi_config_image_apply", 0);
+    return NHAL_OK;
+}
+
+static nhal_result_t probe_spi_exchange_words16(struct nhal_spi_context *ctx, const uint16_t *tx_data, uint16_t *rx_data, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++) {
+        rx_data[i] = (uint16_t)~tx_data[i];
+    }
+    record(ctx->backend_ctx, "spi_exchange_words16", count);
+    return NHAL_OK;
+}
+
+static nhal_result_t probe_spi_write_words32(struct nhal_spi_context *ctx, const uint32_t *data, size_t count)
+{
+    (void)data;
+    record(ctx->backend_ctx, "spi_write_words32", count);
+    return NHAL_OK;
+}
+
+static nhal_result_t probe_i2c_perform_transfer_packed(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                                       const struct nhal_i2c_packed_ops *ops)
+{
+    record(ctx->backend_ctx, "i2c_perform_transfer_packed", ops->num_ops + dev_address.addr.address_7bit);
+    return NHAL_OK;
+}
+
+static nhal_result_t probe_i2c_perform_transfer(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                                nhal_i2c_transfer_op_t *ops, size_t num_ops)
+{
+    size_t i;
+    for (i = 0; i < num_ops; i++) {
+        if (ops[i].address.addr.address_7bit != dev_address.addr.address_7bit) {
+            return NHAL_ERR_INVALID_ARG;
+        }
+    }
+    record(ctx->backend_ctx, "i2c_perform_transfer", num_ops + dev_address.addr.address_7bit);
+    return NHAL_OK;
+}
+
+static nhal_result_t probe_i2c_config_image_apply(struct nhal_i2c_context *ctx, const struct nhal_i2c_config_image *image)
+{
+    (void)image;
+    record(ctx->backend_ctx, "i2c_config_image_apply", 0);
+    return NHAL_OK;
+}
+
+static nhal_result_t probe_uart_rs485_transaction(struct nhal_uart_context *ctx, const uint8_t *request, size_t request_len,
+                                                  uint8_t *response, size_t response_max, size_t *response_len, uint32_t timeout_ms)
+{
+    (void)request;
+    (void)response;
+    (void)timeout_ms;
+    *response_len = response_max;
+    record(ctx->backend_ctx, "uart_rs485_transaction", request_len);
+    return NHAL_OK;
+}
+
+static nhal_result_t probe_pin_group_run_sequence(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask,
+                                                  const nhal_pin_group_mask_t *out_values, nhal_pin_group_mask_t *in_values,
+                                                  size_t count, uint32_t step_ns)
+{
+    size_t i;
+    (void)step_ns;
+    for (i = 0; i < count; i++) {
+        in_values[i] = out_values[i] & mask;
+    }
+    record(ctx->backend_ctx, "pin_group_run_sequence", count);
+    return NHAL_OK;
+}
+
+__attribute__((noinline)) nhal_result_t probe_pin_group_write(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask,
+                                                              nhal_pin_group_mask_t values)
+{
+    nhal_dispatch_probe.backend_ctx = ctx->backend_ctx;
+    nhal_dispatch_probe.length = mask & values;
+    nhal_dispatch_probe.calls++;
+    return NHAL_OK;
+}
+
+const struct nhal_spi_master_ops probe_spi_ops = {
+    .write = probe_spi_write,
+    .plan_execute = probe_spi_plan_execute,
+    .config_image_apply = probe_spi_config_image_apply,
+    .exchange_words16 = probe_spi_exchange_words16,
+    .write_words32 = probe_spi_write_words32,
+};
+
+const struct nhal_i2c_master_ops probe_i2c_ops = {
+    .config_image_apply = probe_i2c_config_image_apply,
+    .perform_transfer_packed = probe_i2c_perform_transfer_packed,
+};
+
+const struct nhal_i2c_master_ops probe_i2c_transfer_ops = {
+    .perform_transfer = probe_i2c_perform_transfer,
+};
+
+const struct nhal_uart_ops probe_uart_ops = {
+    .rs485_transaction = probe_uart_rs485_transaction,
+};
+
+const struct nhal_pin_ops probe_pin_ops = {
+    .set_state = probe_pin_set_state,
+};
+
+const struct nhal_pin_group_ops probe_pin_group_ops = {
+    .write = probe_pin_group_write,
+    .run_sequence = probe_pin_group_run_sequence,
+};
@@ -0,0 +1,45 @@
+/**
+ * @file nhal_dispatch_backend.h
+ * @brief Probe backend for the dispatch layer tests
+ */
+
+#ifndef NHAL_DISPATCH_BACKEND_H
+#define NHAL_DISPATCH_BACKEND_H
+
+#include "nhal_i2c_ops.h"
+#include "nhal_pin_ops.h"
+#include "nhal_spi_ops.h"
+#include "nhal_uart_ops.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Last call that reached the probe backend
+ */
+struct nhal_dispatch_probe {
+    void *backend_ctx;
+    const char *op;
+    size_t length;
+    unsigned long calls;
+};
+
+extern struct nhal_dispatch_probe nhal_dispatch_probe;
+
+extern const struct nhal_spi_master_ops probe_spi_ops;
+extern const struct nhal_i2c_master_ops probe_i2c_ops;
+extern const struct nhal_i2c_master_ops probe_i2c_transfer_ops;
+extern const struct nhal_uart_ops probe_uart_ops;
+extern const struct nhal_pin_ops probe_pin_ops;
+extern const struct nhal_pin_group_ops probe_pin_group_ops;
+
+nhal_result_t probe_spi_write(struct nhal_spi_context *ctx, const uint8_t *data, size_t len);
+nhal_result_t probe_pin_set_state(struct nhal_pin_context *ctx, nhal_pin_state_t value);
+nhal_result_t probe_pin_group_write(struct nhal_pin_group_context *ctx, nhal_pin_group_mask_t mask, nhal_pin_group_mask_t values);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_DISPATCH_BACKEND_H */
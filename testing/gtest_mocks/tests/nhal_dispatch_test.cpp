@@ -0,0 +1,165 @@
+/**
+ * @file nhal_dispatch_test.cpp
+ * @brief Ops-table dispatch of the extension APIs, and the cost of the indirect call
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "nhal_dispatch_backend.h"
+
+namespace {
+
+int backend_state;
+
+class DispatchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        memset(&nhal_dispatch_probe, 0, sizeof(nhal_dispatch_probe));
+        nhal_spi_context_bind(&spi, &probe_spi_ops, &backend_state);
+        nhal_i2c_context_bind(&i2c, &probe_i2c_ops, &backend_state);
+        nhal_uart_context_bind(&uart, &probe_uart_ops, &backend_state);
+        nhal_pin_context_bind(&pin, &probe_pin_ops, &backend_state);
+        nhal_pin_group_context_bind(&group, &probe_pin_group_ops, &backend_state);
+    }
+
+    void expect_reached(const char *op, size_t length) {
+        EXPECT_EQ(&backend_state, nhal_dispatch_probe.backend_ctx);
+        ASSERT_NE(nullptr, nhal_dispatch_probe.op);
+        EXPECT_STREQ(op, nhal_dispatch_probe.op);
+        EXPECT_EQ(length, nhal_dispatch_probe.length);
+    }
+
+    struct nhal_spi_context spi;
+    struct nhal_i2c_context i2c;
+    struct nhal_uart_context uart;
+    struct nhal_pin_context pin;
+    struct nhal_pin_group_context group;
+};
+
+TEST_F(DispatchTest, SpiExtensionsReachBackend) {
+    ASSERT_EQ(NHAL_OK, nhal_spi_master_plan_execute(&spi, nullptr));
+    expect_reached("spi_plan_execute", 0);
+    ASSERT_EQ(NHAL_OK, nhal_spi_master_config_image_apply(&spi, nullptr));
+    expect_reached("spi_config_image_apply", 0);
+
+    const uint16_t tx[3] = { 0x1234, 0x0000, 0xFFFF };
+    uint16_t rx[3];
+    ASSERT_EQ(NHAL_OK, nhal_spi_master_exchange_words16(&spi, tx, rx, 3));
+    expect_reached("spi_exchange_words16", 3);
+    EXPECT_EQ(0xEDCB, rx[0]);
+    EXPECT_EQ(0x0000, rx[2]);
+
+    const uint32_t words[5] = { 0 };
+    ASSERT_EQ(NHAL_OK, nhal_spi_master_write_words32(&spi, words, 5));
+    expect_reached("spi_write_words32", 5);
+}
+
+TEST_F(DispatchTest, I2cUartAndPinGroupExtensionsReachBackend) {
+    uint8_t storage[32];
+    struct nhal_i2c_packed_ops packed;
+    nhal_i2c_address_t address;
+    const uint8_t reg = 0x10;
+    uint8_t data[2];
+
+    nhal_i2c_packed_init(&packed, storage, sizeof(storage));
+    ASSERT_EQ(NHAL_OK, nhal_i2c_packed_add_write(&packed, NHAL_I2C_PACKED_NO_STOP, &reg, 1));
+    ASSERT_EQ(NHAL_OK, nhal_i2c_packed_add_read(&packed, 0, data, sizeof(data)));
+    address.type = NHAL_I2C_7BIT_ADDR;
+    address.addr.address_7bit = 0x50;
+    ASSERT_EQ(NHAL_OK, nhal_i2c_master_perform_transfer_packed(&i2c, address, &packed));
+    expect_reached("i2c_perform_transfer_packed", 2 + 0x50);
+    ASSERT_EQ(NHAL_OK, nhal_i2c_master_config_image_apply(&i2c, nullptr));
+    expect_reached("i2c_config_image_apply", 0);
+
+    const uint8_t request[8] = { 0 };
+    uint8_t response[16];
+    size_t response_len = 0;
+    ASSERT_EQ(NHAL_OK, nhal_uart_rs485_transaction(&uart, request, sizeof(request), response, sizeof(response), &response_len, 10));
+    expect_reached("uart_rs485_transaction", sizeof(request));
+    EXPECT_EQ(sizeof(response), response_len);
+
+    const nhal_pin_group_mask_t out[4] = { 0x0F, 0xF0, 0xFF, 0x00 };
+    nhal_pin_group_mask_t in[4];
+    ASSERT_EQ(NHAL_OK, nhal_pin_group_run_sequence(&group, 0x3C, out, in, 4, 100));
+    expect_reached("pin_group_run_sequence", 4);
+    EXPECT_EQ(0x0Cu, in[0]);
+    EXPECT_EQ(0x3Cu, in[2]);
+}
+
+TEST_F(DispatchTest, PackedTransferFallsBackToPerformTransfer) {
+    uint8_t storage[64];
+    struct nhal_i2c_packed_ops packed;
+    nhal_i2c_address_t address;
+    const uint8_t reg = 0x10;
+    uint8_t data[2];
+
+    nhal_i2c_context_bind(&i2c, &probe_i2c_transfer_ops, &backend_state);
+    nhal_i2c_packed_init(&packed, storage, sizeof(storage));
+    ASSERT_EQ(NHAL_OK, nhal_i2c_packed_add_write_inline(&packed, NHAL_I2C_PACKED_NO_STOP, &reg, 1));
+    ASSERT_EQ(NHAL_OK, nhal_i2c_packed_add_read(&packed, 0, data, sizeof(data)));
+    address.type = NHAL_I2C_7BIT_ADDR;
+    address.addr.address_7bit = 0x50;
+    ASSERT_EQ(NHAL_OK, nhal_i2c_master_perform_transfer_packed(&i2c, address, &packed));
+    expect_reached("i2c_perform_transfer", 2 + 0x50);
+    EXPECT_EQ(1u, nhal_dispatch_probe.calls);
+}
+
+TEST_F(DispatchTest, MissingOpsAreUnsupported) {
+    EXPECT_EQ(NHAL_ERR_UNSUPPORTED, nhal_spi_master_plan_prepare(&spi, nullptr, nullptr, nullptr, 0));
+    EXPECT_EQ(NHAL_ERR_UNSUPPORTED, nhal_spi_master_config_image_build(&spi, nullptr, nullptr));
+    EXPECT_EQ(NHAL_ERR_UNSUPPORTED, nhal_spi_master_read_words16(&spi, nullptr, 0));
+    EXPECT_EQ(NHAL_ERR_UNSUPPORTED, nhal_i2c_master_config_image_build(&i2c, nullptr, nullptr));
+    EXPECT_EQ(NHAL_ERR_UNSUPPORTED, nhal_uart_rs485_set_config(&uart, nullptr));
+    EXPECT_EQ(NHAL_ERR_UNSUPPORTED, nhal_pin_group_read(&group, nullptr));
+    EXPECT_EQ(0u, nhal_dispatch_probe.calls);
+
+    struct nhal_pin_group_context unbound;
+    nhal_pin_group_context_bind(&unbound, nullptr, nullptr);
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG, nhal_pin_group_init(&unbound));
+}
+
+// ---------------------------------------------------------------------------
+// Indirect call benchmark
+// ---------------------------------------------------------------------------
+
+const unsigned CALLS = 20000000;
+
+template <typename Call>
+double ns_per_call(Call call) {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < CALLS; i++) {
+        call(i);
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return (double)ns / CALLS;
+}
+
+void report(const char *name, double direct, double dispatched) {
+    std::printf("%-24s direct %5.2f ns/call, dispatched %5.2f ns/call, overhead %+5.2f ns\n", name, direct, dispatched,
+                dispatched - direct);
+    ::testing::Test::RecordProperty(std::string(name) + "_overhead_ps", (int)((dispatched - direct) * 1000));
+}
+
+TEST_F(DispatchTest, IndirectCallCost) {
+    const uint8_t byte = 0;
+
+    double direct = ns_per_call([&](unsigned) { probe_pin_set_state(&pin, NHAL_PIN_HIGH); });
+    double dispatched = ns_per_call([&](unsigned) { nhal_pin_set_state(&pin, NHAL_PIN_HIGH); });
+    report("nhal_pin_set_state", direct, dispatched);
+
+    direct = ns_per_call([&](unsigned i) { probe_pin_group_write(&group, 0xFF, i); });
+    dispatched = ns_per_call([&](unsigned i) { nhal_pin_group_write(&group, 0xFF, i); });
+    report("nhal_pin_group_write", direct, dispatched);
+
+    direct = ns_per_call([&](unsigned) { probe_spi_write(&spi, &byte, 1); });
+    dispatched = ns_per_call([&](unsigned) { nhal_spi_master_write(&spi, &byte, 1); });
+    report("nhal_spi_master_write", direct, dispatched);
+
+    EXPECT_EQ(6ul * CALLS, nhal_dispatch_probe.calls);
+}
+
+}  // namespace
@@ -0,0 +1,96 @@
+/**
+ * @file nhal_hpp_codegen.cpp
+ * @brief nhal.hpp accesses next to the hand-written register accesses they must compile to
+ *
+ * Each codegen_nhal_X function has a codegen_hand_X twin doing the same
+ * register access by hand. nhal_hpp_codegen_check.cmake compares the
+ * optimized assembly of every pair; nhal_hpp_test.cpp times them.
+ */
+
+#include "nhal.hpp"
+
+extern "C" {
+
+/** @brief Stand-in for a memory-mapped GPIO port */
+struct codegen_gpio_regs {
+    volatile uint32_t bsrr;     /**< Set (bits 0-15) / reset (bits 16-31) register. */
+    volatile uint32_t idr;      /**< Input data register. */
+    volatile uint32_t dir;      /**< Direction register, 1 = output. */
+};
+
+struct codegen_gpio_regs codegen_gpio;
+
+}
+
+namespace {
+
+struct GpioA {
+    static nhal_result_t write(uint32_t mask, uint32_t values) {
+        codegen_gpio.bsrr = (mask & values) | ((mask & ~values) << 16);
+        return NHAL_OK;
+    }
+    static nhal_result_t read(uint32_t *values) {
+        *values = codegen_gpio.idr;
+        return NHAL_OK;
+    }
+    static nhal_result_t configure(uint32_t mask, nhal_pin_dir_t direction, nhal_pin_pull_mode_t) {
+        codegen_gpio.dir = direction == NHAL_PIN_DIR_OUTPUT ? (codegen_gpio.dir | mask) : (codegen_gpio.dir & ~mask);
+        return NHAL_OK;
+    }
+};
+
+typedef nhal::Pin<nhal::port_pin<GpioA, 5>, nhal::Output> Led;
+typedef nhal::Pin<nhal::port_pin<GpioA, 0>, nhal::InputPullUp> Button;
+typedef nhal::PinGroup<nhal::Pin<nhal::port_pin<GpioA, 8>, nhal::Output>,
+                       nhal::Pin<nhal::port_pin<GpioA, 9>, nhal::Output> > Leds;
+
+}
+
+extern "C" {
+
+nhal_result_t codegen_nhal_led_on(void) { return Led::high(); }
+
+nhal_result_t codegen_hand_led_on(void)
+{
+    codegen_gpio.bsrr = 1u << 5;
+    return NHAL_OK;
+}
+
+nhal_result_t codegen_nhal_led_off(void) { return Led::low(); }
+
+nhal_result_t codegen_hand_led_off(void)
+{
+    codegen_gpio.bsrr = 1u << (5 + 16);
+    return NHAL_OK;
+}
+
+nhal_result_t codegen_nhal_led_init(void) { return Led::init(); }
+
+nhal_result_t codegen_hand_led_init(void)
+{
+    codegen_gpio.dir = codegen_gpio.dir | (1u << 5);
+    return NHAL_OK;
+}
+
+bool codegen_nhal_button_read(void)
+{
+    bool high = false;
+    Button::read(&high);
+    return high;
+}
+
+bool codegen_hand_button_read(void)
+{
+    return (codegen_gpio.idr & 1u) != 0;
+}
+
+nhal_result_t codegen_nhal_leds_write(uint32_t values) { return Leds::write(values); }
+
+nhal_result_t codegen_hand_leds_write(uint32_t values)
+{
+    uint32_t set = (values & 3u) << 8;
+    codegen_gpio.bsrr = set | ((~set & (3u << 8)) << 16);
+    return NHAL_OK;
+}
+
+}
@@ -0,0 +1,53 @@
+# Compares the optimized assembly of every codegen_nhal_X / codegen_hand_X pair
+#
+#   cmake -DASM=<file.s> -P nhal_hpp_codegen_check.cmake
+
+if(NOT ASM)
+    message(FATAL_ERROR "ASM not set")
+endif()
+
+file(STRINGS "${ASM}" lines)
+
+# Instructions of each function: indented lines that are neither directives nor labels
+set(current "")
+set(names "")
+foreach(line IN LISTS lines)
+    if(line MATCHES "^(codegen_(nhal|hand)_[A-Za-z0-9_]+):")
+        set(current "${CMAKE_MATCH_1}")
+        list(APPEND names "${current}")
+        set(body_${current} "")
+    elseif(line MATCHES "^[ \t]+\\.size[ \t]" OR line MATCHES "^[ \t]*\\.cfi_endproc")
+        set(current "")
+    elseif(current AND line MATCHES "^[ \t]+[^. \t]")
+        string(STRIP "${line}" instruction)
+        string(REGEX REPLACE "[ \t]+" " " instruction "${instruction}")
+        list(APPEND body_${current} "${instruction}")
+    endif()
+endforeach()
+
+set(pairs 0)
+set(failures 0)
+foreach(name IN LISTS names)
+    if(name MATCHES "^codegen_nhal_(.*)$")
+        set(hand "codegen_hand_${CMAKE_MATCH_1}")
+        math(EXPR pairs "${pairs} + 1")
+        list(LENGTH body_${name} nhal_count)
+        list(LENGTH body_${hand} hand_count)
+        if(NOT "${body_${name}}" STREQUAL "${body_${hand}}")
+            math(EXPR failures "${failures} + 1")
+            string(REPLACE ";" "\n    " nhal_text "${body_${name}}")
+            string(REPLACE ";" "\n    " hand_text "${body_${hand}}")
+            message("FAIL ${CMAKE_MATCH_1}: nhal.hpp ${nhal_count} instructions, hand-written ${hand_count}\n"
+                    "  nhal.hpp:\n    ${nhal_text}\n  hand-written:\n    ${hand_text}")
+        else()
+            message("ok   ${CMAKE_MATCH_1}: ${nhal_count} instructions, identical")
+        endif()
+    endif()
+endforeach()
+
+if(pairs EQUAL 0)
+    message(FATAL_ERROR "no codegen_nhal_* functions found in ${ASM}")
+endif()
+if(failures GREATER 0)
+    message(FATAL_ERROR "${failures} of ${pairs} nhal.hpp accesses differ from hand-written code")
+endif()
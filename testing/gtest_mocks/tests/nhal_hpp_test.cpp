@@ -0,0 +1,121 @@
+/**
+ * @file nhal_hpp_test.cpp
+ * @brief nhal.hpp bindings on the C interface, and their cost against hand-written register access
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include "nhal.hpp"
+#include "nhal_pin_mock.hpp"
+
+using ::testing::_;
+using ::testing::Return;
+
+struct nhal_pin_context {
+    int unused;
+};
+
+struct nhal_pin_group_context {
+    int unused;
+};
+
+extern "C" {
+nhal_result_t codegen_nhal_led_on(void);
+nhal_result_t codegen_hand_led_on(void);
+nhal_result_t codegen_nhal_leds_write(uint32_t values);
+nhal_result_t codegen_hand_leds_write(uint32_t values);
+bool codegen_nhal_button_read(void);
+bool codegen_hand_button_read(void);
+}
+
+namespace {
+
+struct nhal_pin_context led_pin;
+struct nhal_pin_group_context port_b;
+
+typedef nhal::context_port<&port_b> PortB;
+typedef nhal::Pin<nhal::port_pin<PortB, 3>, nhal::Output> Cs;
+typedef nhal::Pin<nhal::port_pin<PortB, 4>, nhal::InputPullDown> Miso;
+typedef nhal::PinGroup<nhal::Pin<nhal::port_pin<PortB, 6>, nhal::Output>,
+                       nhal::Pin<nhal::port_pin<PortB, 1>, nhal::Output> > Pair;
+typedef nhal::Pin<nhal::context_pin<&led_pin>, nhal::Output> Led;
+
+TEST(NhalHppTest, PortPinInitConfiguresItsBitThroughTheGroup) {
+    NhalMockScope<NhalPinMock> pins;
+
+    EXPECT_CALL(pins.mock(), nhal_pin_group_set_direction(&port_b, 1u << 3, NHAL_PIN_DIR_OUTPUT, NHAL_PIN_PMODE_NONE))
+        .WillOnce(Return(NHAL_OK));
+    EXPECT_CALL(pins.mock(), nhal_pin_group_set_direction(&port_b, 1u << 4, NHAL_PIN_DIR_INPUT, NHAL_PIN_PMODE_PULL_DOWN))
+        .WillOnce(Return(NHAL_OK));
+    EXPECT_EQ(NHAL_OK, Cs::init());
+    EXPECT_EQ(NHAL_OK, Miso::init());
+
+    EXPECT_CALL(pins.mock(), nhal_pin_group_write(&port_b, 1u << 3, 0u)).WillOnce(Return(NHAL_OK));
+    EXPECT_EQ(NHAL_OK, Cs::low());
+}
+
+TEST(NhalHppTest, GroupInitStopsAtFirstErrorAndWritesInOneCall) {
+    NhalMockScope<NhalPinMock> pins;
+
+    EXPECT_CALL(pins.mock(), nhal_pin_group_set_direction(&port_b, 1u << 6, NHAL_PIN_DIR_OUTPUT, NHAL_PIN_PMODE_NONE))
+        .WillOnce(Return(NHAL_ERR_HW_FAILURE));
+    EXPECT_EQ(NHAL_ERR_HW_FAILURE, Pair::init());
+
+    // Group bit 0 is port bit 6, group bit 1 is port bit 1
+    EXPECT_CALL(pins.mock(), nhal_pin_group_write(&port_b, (1u << 6) | (1u << 1), 1u << 1)).WillOnce(Return(NHAL_OK));
+    EXPECT_EQ(NHAL_OK, Pair::write(0x2));
+
+    EXPECT_CALL(pins.mock(), nhal_pin_group_read(&port_b, _))
+        .WillOnce(::testing::DoAll(::testing::SetArgPointee<1>(1u << 6), Return(NHAL_OK)));
+    uint32_t values = 0;
+    EXPECT_EQ(NHAL_OK, Pair::read(&values));
+    EXPECT_EQ(0x1u, values);
+}
+
+TEST(NhalHppTest, ContextPinUsesPinInterface) {
+    NhalMockScope<NhalPinMock> pins;
+
+    EXPECT_CALL(pins.mock(), nhal_pin_set_direction(&led_pin, NHAL_PIN_DIR_OUTPUT, NHAL_PIN_PMODE_NONE)).WillOnce(Return(NHAL_OK));
+    EXPECT_CALL(pins.mock(), nhal_pin_set_state(&led_pin, NHAL_PIN_HIGH)).WillOnce(Return(NHAL_OK));
+    EXPECT_EQ(NHAL_OK, Led::init());
+    EXPECT_EQ(NHAL_OK, Led::high());
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark: register-level backend against hand-written access
+// ---------------------------------------------------------------------------
+
+const unsigned CALLS = 50000000;
+
+template <typename Call>
+double ns_per_call(Call call) {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < CALLS; i++) {
+        call(i);
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return (double)ns / CALLS;
+}
+
+void report(const char *name, double nhal, double hand) {
+    std::printf("%-12s nhal.hpp %5.2f ns/call, hand-written %5.2f ns/call\n", name, nhal, hand);
+    ::testing::Test::RecordProperty(std::string(name) + "_nhal_ps", (int)(nhal * 1000));
+    ::testing::Test::RecordProperty(std::string(name) + "_hand_ps", (int)(hand * 1000));
+}
+
+TEST(NhalHppBenchmark, SameCostAsHandWrittenAccess) {
+    volatile bool sink = false;
+
+    report("led_on", ns_per_call([](unsigned) { codegen_nhal_led_on(); }),
+           ns_per_call([](unsigned) { codegen_hand_led_on(); }));
+    report("leds_write", ns_per_call([](unsigned i) { codegen_nhal_leds_write(i); }),
+           ns_per_call([](unsigned i) { codegen_hand_leds_write(i); }));
+    report("button_read", ns_per_call([&](unsigned) { sink = codegen_nhal_button_read(); }),
+           ns_per_call([&](unsigned) { sink = codegen_hand_button_read(); }));
+    (void)sink;
+}
+
+}  // namespace
@@ -0,0 +1,206 @@
+/**
+ * @file nhal_i2c_packed_test.cpp
+ * @brief nhal_i2c_transfer_packed.h: the perform_transfer adapter, and list size and walk cost against op arrays
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "nhal_i2c_mock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+struct nhal_i2c_context {
+    int unused;
+};
+
+namespace {
+
+nhal_i2c_address_t device_address()
+{
+    nhal_i2c_address_t address;
+    address.type = NHAL_I2C_7BIT_ADDR;
+    address.addr.address_7bit = 0x3C;
+    return address;
+}
+
+class I2cPackedTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ON_CALL(i2c_.mock(), nhal_i2c_master_perform_transfer(_, _, _, _))
+            .WillByDefault(Invoke([this](struct nhal_i2c_context *, nhal_i2c_address_t address,
+                                         nhal_i2c_transfer_op_t *ops, size_t num_ops) {
+                EXPECT_EQ(0x3C, address.addr.address_7bit);
+                batches_.push_back(num_ops);
+                performed_.insert(performed_.end(), ops, ops + num_ops);
+                return NHAL_OK;
+            }));
+        nhal_i2c_packed_init(&packed_, storage_, sizeof(storage_));
+    }
+
+    /** Register writes followed by a read after a repeated start, as a sensor dump does */
+    void add_register_reads(unsigned count) {
+        for (unsigned i = 0; i < count; i++) {
+            ASSERT_EQ(NHAL_OK, nhal_i2c_packed_add_write_inline(&packed_, NHAL_I2C_PACKED_NO_STOP, &registers_[i], 1));
+            ASSERT_EQ(NHAL_OK, nhal_i2c_packed_add_read(&packed_, 0, values_[i], sizeof(values_[i])));
+        }
+    }
+
+    NhalMockScope<NhalI2cMock, NiceMock<NhalI2cMock> > i2c_;
+    struct nhal_i2c_context ctx_;
+    struct nhal_i2c_packed_ops packed_;
+    uint8_t storage_[512];
+    uint8_t registers_[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                               0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F };
+    uint8_t values_[16][2];
+    std::vector<size_t> batches_;
+    std::vector<nhal_i2c_transfer_op_t> performed_;
+};
+
+TEST_F(I2cPackedTest, AdapterSplitsBatchesOnlyAfterStop) {
+    nhal_i2c_transfer_op_t scratch[5];
+
+    add_register_reads(5);
+    ASSERT_EQ(NHAL_OK, nhal_i2c_packed_perform_transfer(&ctx_, device_address(), &packed_, scratch, 5));
+
+    // Write/read pairs are never split: 5 scratch ops carry 2 pairs at a time
+    EXPECT_EQ((std::vector<size_t>{ 4, 4, 2 }), batches_);
+    ASSERT_EQ(10u, performed_.size());
+    for (unsigned i = 0; i < 5; i++) {
+        const nhal_i2c_transfer_op_t &write = performed_[2 * i];
+        const nhal_i2c_transfer_op_t &read = performed_[2 * i + 1];
+        EXPECT_EQ(NHAL_I2C_WRITE_OP, write.type);
+        EXPECT_EQ(NHAL_I2C_TRANSFER_MSG_NO_STOP, write.flags);
+        EXPECT_EQ(1u, write.write.length);
+        EXPECT_EQ(registers_[i], write.write.bytes[0]);
+        EXPECT_EQ(0x3C, write.address.addr.address_7bit);
+        EXPECT_EQ(NHAL_I2C_READ_OP, read.type);
+        EXPECT_EQ(0, read.flags);
+        EXPECT_EQ(values_[i], read.read.buffer);
+        EXPECT_EQ(2u, read.read.length);
+    }
+}
+
+TEST_F(I2cPackedTest, AdapterRejectsChainsLongerThanScratch) {
+    nhal_i2c_transfer_op_t scratch[2];
+    const uint8_t bytes[3] = { 1, 2, 3 };
+
+    for (unsigned i = 0; i < 3; i++) {
+        ASSERT_EQ(NHAL_OK, nhal_i2c_packed_add_write(&packed_, NHAL_I2C_PACKED_NO_STOP, bytes, sizeof(bytes)));
+    }
+    ASSERT_EQ(NHAL_OK, nhal_i2c_packed_add_write(&packed_, 0, bytes, sizeof(bytes)));
+    EXPECT_EQ(NHAL_ERR_BUFFER_FULL, nhal_i2c_packed_perform_transfer(&ctx_, device_address(), &packed_, scratch, 2));
+    EXPECT_TRUE(batches_.empty());
+
+    // Truncated lists are malformed
+    nhal_i2c_transfer_op_t large_scratch[8];
+    packed_.size--;
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG,
+              nhal_i2c_packed_perform_transfer(&ctx_, device_address(), &packed_, large_scratch, 8));
+    EXPECT_TRUE(batches_.empty());
+}
+
+TEST_F(I2cPackedTest, AdapterStopsAtTheFirstFailedBatch) {
+    nhal_i2c_transfer_op_t scratch[2];
+
+    add_register_reads(3);
+    EXPECT_CALL(i2c_.mock(), nhal_i2c_master_perform_transfer(_, _, _, _))
+        .WillOnce(Return(NHAL_OK))
+        .WillOnce(Return(NHAL_ERR_NO_RESPONSE));
+    EXPECT_EQ(NHAL_ERR_NO_RESPONSE, nhal_i2c_packed_perform_transfer(&ctx_, device_address(), &packed_, scratch, 2));
+}
+
+// ---------------------------------------------------------------------------
+// Benchmarks: cache footprint and list walk against nhal_i2c_transfer_op_t arrays
+// ---------------------------------------------------------------------------
+
+const size_t CACHE_LINE = 64;
+
+/** A display initialization sequence: one-byte command writes, every fourth followed by a two-byte argument */
+struct InitSequence {
+    explicit InitSequence(size_t num_ops) : ops(num_ops), storage(num_ops * NHAL_I2C_PACKED_POINTER_OP_SIZE) {
+        static const uint8_t command[2] = { 0x80, 0xAF };
+        nhal_i2c_packed_init(&packed, storage.data(), storage.size());
+        for (size_t i = 0; i < num_ops; i++) {
+            memset(&ops[i], 0, sizeof(ops[i]));
+            ops[i].type = NHAL_I2C_WRITE_OP;
+            ops[i].address = device_address();
+            ops[i].write.bytes = command;
+            ops[i].write.length = i % 4 == 3 ? 2 : 1;
+        }
+        EXPECT_EQ(NHAL_OK, nhal_i2c_packed_from_ops(&packed, ops.data(), ops.size(), 2));
+    }
+
+    std::vector<nhal_i2c_transfer_op_t> ops;
+    std::vector<uint8_t> storage;
+    struct nhal_i2c_packed_ops packed;
+};
+
+TEST(I2cPackedBench, CacheFootprint) {
+    const size_t lengths[] = { 16, 64, 256 };
+
+    for (size_t num_ops : lengths) {
+        InitSequence sequence(num_ops);
+        size_t array_bytes = num_ops * sizeof(nhal_i2c_transfer_op_t);
+        size_t array_lines = (array_bytes + CACHE_LINE - 1) / CACHE_LINE;
+        size_t packed_lines = (sequence.packed.size + CACHE_LINE - 1) / CACHE_LINE;
+
+        EXPECT_LT(sequence.packed.size, array_bytes);
+        std::printf("%3zu ops: op array %5zu bytes (%3zu lines), packed %4zu bytes (%3zu lines), %.1fx smaller\n", num_ops,
+                    array_bytes, array_lines, sequence.packed.size, packed_lines,
+                    (double)array_bytes / (double)sequence.packed.size);
+        RecordProperty("packed_lines_" + std::to_string(num_ops), (int)packed_lines);
+        RecordProperty("array_lines_" + std::to_string(num_ops), (int)array_lines);
+    }
+}
+
+template <typename Walk>
+double ns_per_op(size_t num_ops, Walk walk) {
+    const size_t total_ops = 16 * 1024 * 1024;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t done = 0; done < total_ops; done += num_ops) {
+        walk();
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return (double)ns / (double)total_ops;
+}
+
+TEST(I2cPackedBench, ListWalk) {
+    // Fits in L1, then well past the last level cache of most hosts
+    const size_t lengths[] = { 256, 1024 * 1024 };
+
+    for (size_t num_ops : lengths) {
+        InitSequence sequence(num_ops);
+        volatile size_t sink = 0;
+
+        double array_ns = ns_per_op(num_ops, [&] {
+            size_t bytes = 0;
+            for (const nhal_i2c_transfer_op_t &op : sequence.ops) {
+                bytes += op.write.length + op.write.bytes[0];
+            }
+            sink = sink + bytes;
+        });
+        double packed_ns = ns_per_op(num_ops, [&] {
+            size_t bytes = 0;
+            const uint8_t *pos = sequence.packed.data;
+            nhal_i2c_packed_op_t op;
+            while ((pos = nhal_i2c_packed_next(&sequence.packed, pos, &op)) != NULL) {
+                bytes += op.length + op.bytes[0];
+            }
+            sink = sink + bytes;
+        });
+
+        std::printf("%7zu ops: op array %.2f ns/op, packed %.2f ns/op\n", num_ops, array_ns, packed_ns);
+        RecordProperty("array_walk_ps_" + std::to_string(num_ops), (int)(array_ns * 1000));
+        RecordProperty("packed_walk_ps_" + std::to_string(num_ops), (int)(packed_ns * 1000));
+    }
+}
+
+}  // namespace
@@ -0,0 +1,419 @@
+/**
+ * @file nhal_log_test.cpp
+ * @brief nhal_log.h ring and encoder: empty ring, wrap-around and a concurrent producer; the NHAL_LOG_* macros
+ * decoded by scripts/nhal_log_decode.py from this executable's ELF, and call-site cost and bandwidth against text
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+static uint32_t test_timestamp;
+#define NHAL_LOG_TIMESTAMP() __atomic_add_fetch(&test_timestamp, 1, __ATOMIC_RELAXED)
+#define NHAL_LOG_IMPLEMENTATION
+#include "nhal_log.h"
+#include "nhal_uart_mock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+struct nhal_uart_context {
+    int unused;
+};
+
+namespace {
+
+// Format entries with 0 to 3 arguments, as NHAL_LOG_RECORD_ places them
+__attribute__((section("nhal_log_fmt"), used, aligned(1))) const char fmt0[] = "I\x1ftest:1\x1fno args";
+__attribute__((section("nhal_log_fmt"), used, aligned(1))) const char fmt1[] = "I\x1ftest:2\x1f%u";
+__attribute__((section("nhal_log_fmt"), used, aligned(1))) const char fmt2[] = "I\x1ftest:3\x1f%u %u";
+__attribute__((section("nhal_log_fmt"), used, aligned(1))) const char fmt3[] = "I\x1ftest:4\x1f%u %u %u";
+const char *const formats[] = { fmt0, fmt1, fmt2, fmt3 };
+
+struct Record {
+    uint32_t nargs;
+    uint32_t timestamp;
+    uint32_t args[3];
+};
+
+/** @brief Host side decoder: COBS frames of varints, as scripts/nhal_log_decode.py reads them */
+class Decoder {
+public:
+    void feed(const uint8_t *data, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            if (data[i] != 0) {
+                frame_.push_back(data[i]);
+                continue;
+            }
+            decode_frame();
+            frame_.clear();
+        }
+    }
+
+    std::vector<Record> records;
+    uint32_t dropped = 0;
+    uint32_t errors = 0;
+
+private:
+    static uint32_t unzigzag(uint32_t value) { return (value >> 1) ^ (uint32_t)-(int32_t)(value & 1); }
+
+    bool varint(const std::vector<uint8_t> &payload, size_t *pos, uint32_t *value) {
+        *value = 0;
+        for (unsigned shift = 0; *pos < payload.size() && shift < 35; shift += 7) {
+            uint8_t byte = payload[(*pos)++];
+            *value |= (uint32_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void decode_frame() {
+        std::vector<uint8_t> payload;
+        size_t pos = 0;
+        while (pos < frame_.size()) {
+            uint8_t code = frame_[pos++];
+            for (uint8_t i = 1; i < code && pos < frame_.size(); i++) {
+                payload.push_back(frame_[pos++]);
+            }
+            if (pos < frame_.size()) {
+                payload.push_back(0);
+            }
+        }
+
+        size_t at = 0;
+        uint32_t id = 0;
+        if (!varint(payload, &at, &id)) {
+            errors++;
+            return;
+        }
+        if (id == 0) {
+            uint32_t count = 0;
+            errors += varint(payload, &at, &count) ? 0 : 1;
+            dropped += count;
+            return;
+        }
+
+        Record record = {};
+        uint32_t delta = 0;
+        record.nargs = 4;
+        for (uint32_t n = 0; n < 4; n++) {
+            if (formats[n] - __start_nhal_log_fmt == (ptrdiff_t)(id - 1)) {
+                record.nargs = n;
+            }
+        }
+        if (record.nargs == 4 || !varint(payload, &at, &delta)) {
+            errors++;
+            return;
+        }
+        timestamp_ += unzigzag(delta);
+        record.timestamp = timestamp_;
+        for (uint32_t i = 0; i < record.nargs; i++) {
+            uint32_t arg = 0;
+            if (!varint(payload, &at, &arg)) {
+                errors++;
+                return;
+            }
+            record.args[i] = unzigzag(arg);
+        }
+        errors += at == payload.size() ? 0 : 1;
+        records.push_back(record);
+    }
+
+    std::vector<uint8_t> frame_;
+    uint32_t timestamp_ = 0;
+};
+
+class LogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        memset(storage_, 0, sizeof(storage_));
+        memset(&log_, 0, sizeof(log_));
+        log_.words = storage_;
+        log_.mask = RING_WORDS - 1;
+        test_timestamp = 0;
+    }
+
+    void record(uint32_t nargs, const uint32_t *args) {
+        nhal_log_record(&log_, formats[nargs], args, nargs);
+    }
+
+    void drain() {
+        uint8_t out[3 * NHAL_LOG_FRAME_MAX];
+        size_t len;
+        while ((len = nhal_log_encode(&log_, out, sizeof(out))) != 0) {
+            decoder_.feed(out, len);
+        }
+    }
+
+    static const uint32_t RING_WORDS = 16;
+    uint32_t storage_[RING_WORDS];
+    struct nhal_log log_;
+    Decoder decoder_;
+};
+
+TEST_F(LogTest, EmptyRingEncodesNothing) {
+    uint8_t out[NHAL_LOG_FRAME_MAX];
+    EXPECT_EQ(0u, nhal_log_encode(&log_, out, sizeof(out)));
+
+    const uint32_t args[1] = { 42 };
+    record(1, args);
+    drain();
+    ASSERT_EQ(1u, decoder_.records.size());
+    EXPECT_EQ(42u, decoder_.records[0].args[0]);
+
+    // Drained ring: nothing left, every word cleared
+    EXPECT_EQ(0u, nhal_log_encode(&log_, out, sizeof(out)));
+    for (uint32_t i = 0; i < RING_WORDS; i++) {
+        EXPECT_EQ(0u, storage_[i]) << "word " << i;
+    }
+}
+
+TEST_F(LogTest, UnpublishedRecordIsWaitedFor) {
+    uint8_t out[NHAL_LOG_FRAME_MAX];
+    const uint32_t args[3] = { 0xFFFFFFFFu, 0x80000000u, 0xFFFFFFFFu };
+
+    // Words 2-4 hold arguments with bit 31 set; then records of 5, 5 and 3
+    // words bring the next header, one lap later, onto word 2
+    record(3, args);
+    record(3, args);
+    drain();
+    record(3, args);
+    record(1, args);
+    drain();
+    ASSERT_EQ(4u, decoder_.records.size());
+    ASSERT_EQ(RING_WORDS + 2, log_.tail);
+
+    // A producer reserved its words there but has not published them yet
+    log_.head += 3;
+    EXPECT_EQ(0u, nhal_log_encode(&log_, out, sizeof(out)));
+
+    // Once published, the record goes out
+    storage_[(log_.tail + 1) & log_.mask] = test_timestamp + 1;
+    storage_[(log_.tail + 2) & log_.mask] = 9;
+    __atomic_store_n(&storage_[log_.tail & log_.mask],
+                     NHAL_LOG_HEADER_VALID | (1u << NHAL_LOG_HEADER_NARGS_SHIFT) | (uint32_t)(fmt1 - __start_nhal_log_fmt),
+                     __ATOMIC_RELEASE);
+    drain();
+    ASSERT_EQ(5u, decoder_.records.size());
+    EXPECT_EQ(9u, decoder_.records[4].args[0]);
+    EXPECT_EQ(0u, decoder_.errors);
+}
+
+TEST_F(LogTest, RecordsSurviveWrapAround) {
+    uint32_t expected_seq = 0;
+    uint32_t seq = 0;
+
+    // Varying record sizes so records start and split at every ring offset
+    for (unsigned round = 0; round < 2000; round++) {
+        for (unsigned n = 0; n < 1 + round % 3; n++) {
+            uint32_t nargs = (seq % 3) + 1;
+            const uint32_t args[3] = { seq, ~seq, seq | 0x80000000u };
+            record(nargs, args);
+            seq++;
+        }
+        drain();
+    }
+
+    EXPECT_EQ(0u, decoder_.errors);
+    EXPECT_EQ(0u, decoder_.dropped);
+    ASSERT_EQ(seq, decoder_.records.size());
+    for (const Record &r : decoder_.records) {
+        ASSERT_EQ((expected_seq % 3) + 1, r.nargs);
+        ASSERT_EQ(expected_seq, r.args[0]);
+        if (r.nargs > 1) {
+            ASSERT_EQ(~expected_seq, r.args[1]);
+        }
+        if (r.nargs > 2) {
+            ASSERT_EQ(expected_seq | 0x80000000u, r.args[2]);
+        }
+        expected_seq++;
+    }
+}
+
+TEST_F(LogTest, ConcurrentProducersLoseNothingUnaccounted) {
+    const unsigned PRODUCERS = 3;
+    const uint32_t RECORDS = 100000;
+    std::atomic<unsigned> running(PRODUCERS);
+    std::vector<std::thread> producers;
+    std::vector<uint32_t> storage(1024, 0);
+
+    log_.words = storage.data();
+    log_.mask = (uint32_t)storage.size() - 1;
+
+    for (unsigned p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&, p] {
+            for (uint32_t i = 0; i < RECORDS; i++) {
+                const uint32_t args[3] = { p, i, (p << 24) ^ i ^ 0xA5A5A5A5u };
+                record(3, args);
+                if (i % 64 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            running--;
+        });
+    }
+    while (running != 0) {
+        drain();
+    }
+    for (std::thread &t : producers) {
+        t.join();
+    }
+    drain();
+
+    std::vector<uint32_t> next(PRODUCERS, 0);
+    uint32_t received = 0;
+    EXPECT_EQ(0u, decoder_.errors);
+    for (const Record &r : decoder_.records) {
+        ASSERT_EQ(3u, r.nargs);
+        ASSERT_LT(r.args[0], PRODUCERS);
+        // Whole records only, in each producer's order
+        ASSERT_EQ((r.args[0] << 24) ^ r.args[1] ^ 0xA5A5A5A5u, r.args[2]);
+        ASSERT_GE(r.args[1], next[r.args[0]]);
+        next[r.args[0]] = r.args[1] + 1;
+        received++;
+    }
+    EXPECT_EQ(PRODUCERS * RECORDS, received + decoder_.dropped);
+    EXPECT_EQ(log_.head, log_.tail);
+    std::printf("%u records from %u producers: %u drained, %u dropped and reported\n", PRODUCERS * RECORDS,
+                PRODUCERS, received, decoder_.dropped);
+}
+
+/** @brief nhal_log_drain() of the macro ring, captured through the UART mock */
+class LogMacroTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ON_CALL(uart_.mock(), nhal_uart_write(_, _, _))
+            .WillByDefault(Invoke([this](struct nhal_uart_context *, const uint8_t *data, size_t len) {
+                wire_.insert(wire_.end(), data, data + len);
+                return NHAL_OK;
+            }));
+        test_timestamp = 0;
+        nhal_log_instance.last_timestamp = 0;
+    }
+
+    void drain() {
+        ASSERT_EQ(NHAL_OK, nhal_log_drain(&nhal_log_instance, &uart_ctx_));
+        ASSERT_EQ(nhal_log_instance.head, nhal_log_instance.tail);
+    }
+
+    NhalMockScope<NhalUartMock, NiceMock<NhalUartMock> > uart_;
+    struct nhal_uart_context uart_ctx_;
+    std::vector<uint8_t> wire_;
+};
+
+std::string location(int line)
+{
+    return std::string(__FILE__) + ":" + std::to_string(line) + ": ";
+}
+
+TEST_F(LogMacroTest, HostScriptDecodesTheMacrosFromTheElf) {
+#if defined(NHAL_LOG_DECODE_SCRIPT) && defined(NHAL_PYTHON)
+    const unsigned channel = 3;
+    const int millivolts = -42;
+    const int first_line = __LINE__ + 1;
+    NHAL_LOG_INFO("boot");
+    NHAL_LOG_INFO("adc ch%u = %d mV", channel, millivolts);
+    NHAL_LOG_WARN("reg 0x%08x, flag %c", 0xDEADBEEFu, 'y');
+    NHAL_LOG_ERROR("pid out %.2f after %u of %u %s", nhal_log_float(1.5f), 7u, 8u, "steps");
+    NHAL_LOG_DEBUG("compiled out at NHAL_LOG_LEVEL_INFO %u", 1u);
+    drain();
+
+    // The ring goes out as frames; the formats stay in this executable
+    char exe[4096];
+    ssize_t exe_len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    ASSERT_GT(exe_len, 0);
+    exe[exe_len] = '\0';
+    std::string capture = ::testing::TempDir() + "nhal_log_capture.bin";
+    std::ofstream(capture.c_str(), std::ios::binary).write((const char *)wire_.data(), (std::streamsize)wire_.size());
+
+    std::string command = std::string(NHAL_PYTHON) + " " + NHAL_LOG_DECODE_SCRIPT + " " + exe + " " + capture +
+                          " --tick-hz 1";
+    FILE *pipe = popen(command.c_str(), "r");
+    ASSERT_NE(nullptr, pipe);
+    std::vector<std::string> lines;
+    char line[512];
+    while (std::fgets(line, sizeof(line), pipe) != nullptr) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(0, pclose(pipe));
+    std::remove(capture.c_str());
+
+    const std::string expected[] = {
+        "[    1.000000] INFO  " + location(first_line) + "boot\n",
+        "[    2.000000] INFO  " + location(first_line + 1) + "adc ch3 = -42 mV\n",
+        "[    3.000000] WARN  " + location(first_line + 2) + "reg 0xdeadbeef, flag y\n",
+    };
+    ASSERT_EQ(4u, lines.size());
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_EQ(expected[i], lines[i]);
+    }
+    // Only the address of a string is deferred
+    const std::string error = "[    4.000000] ERROR " + location(first_line + 3) + "pid out 1.50 after 7 of 8 <str@0x";
+    EXPECT_EQ(error, lines[3].substr(0, error.size()));
+#else
+    GTEST_SKIP() << "Python 3 not found: no host decoder to check against";
+#endif
+}
+
+TEST_F(LogMacroTest, CallSiteCostAndBandwidthAgainstText) {
+    const int CALLS = 200000;
+    const int BATCH = 32;                   // 4-word records: half of the 256-word ring
+    std::chrono::nanoseconds binary_time(0);
+    std::chrono::nanoseconds text_time(0);
+    uint64_t text_bytes = 0;
+    char text[128];
+    unsigned sink = 0;
+
+    for (int done = 0; done < CALLS; done += BATCH) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = done; i < done + BATCH; i++) {
+            NHAL_LOG_INFO("adc ch%u = %d mV", (unsigned)(i & 7), i * 3 - 5000);
+        }
+        binary_time += std::chrono::steady_clock::now() - start;
+        drain();
+
+        // The same message formatted at the call site, as a text logger would send it
+        start = std::chrono::steady_clock::now();
+        for (int i = done; i < done + BATCH; i++) {
+            int len = std::snprintf(text, sizeof(text), "[%10.6f] I adc.c:42: adc ch%u = %d mV\n", i * 1e-6,
+                                    (unsigned)(i & 7), i * 3 - 5000);
+            text_bytes += (uint64_t)len;
+            sink += (unsigned)text[len - 2];
+        }
+        text_time += std::chrono::steady_clock::now() - start;
+    }
+    EXPECT_NE(0u, sink);
+    EXPECT_EQ(0u, nhal_log_instance.dropped);
+
+    double binary_ns = (double)binary_time.count() / CALLS;
+    double text_ns = (double)text_time.count() / CALLS;
+    double binary_per_record = (double)wire_.size() / CALLS;
+    double text_per_record = (double)text_bytes / CALLS;
+    // 10 bits per byte on an 8N1 line
+    double binary_rate = 921600.0 / 10 / binary_per_record;
+    double text_rate = 921600.0 / 10 / text_per_record;
+    std::printf("call site: %.1f ns deferred, %.1f ns snprintf; wire: %.1f bytes vs %.1f bytes of text per record, "
+                "%.0f vs %.0f records/s at 921600 baud\n",
+                binary_ns, text_ns, binary_per_record, text_per_record, binary_rate, text_rate);
+    RecordProperty("deferred_call_ps", (int)(binary_ns * 1000));
+    RecordProperty("snprintf_call_ps", (int)(text_ns * 1000));
+    RecordProperty("binary_bytes_x100", (int)(binary_per_record * 100));
+    RecordProperty("text_bytes_x100", (int)(text_per_record * 100));
+
+    // ID, timestamp delta and two arguments: a few varints against a full line
+    EXPECT_LT(binary_per_record * 3, text_per_record);
+}
+
+}  // namespace
@@ -0,0 +1,106 @@
+/**
+ * @file nhal_mock_scope_test.cpp
+ * @brief NhalMockScope and NhalMockBinding: per-thread isolation under concurrent calls, sharing and nesting
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "nhal_i2c_mock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::StrictMock;
+
+struct nhal_i2c_context {
+    unsigned owner;
+};
+
+namespace {
+
+nhal_i2c_address_t address_of(unsigned owner)
+{
+    nhal_i2c_address_t address;
+    address.type = NHAL_I2C_7BIT_ADDR;
+    address.addr.address_7bit = (uint8_t)(0x10 + owner);
+    return address;
+}
+
+TEST(MockScopeTest, ConcurrentScopesNeverShareExpectations) {
+    const unsigned THREADS = 8;
+    const unsigned CALLS = 1000;
+    std::atomic<unsigned> ready(0);
+    std::atomic<unsigned> misrouted(0);
+    std::vector<unsigned> served(THREADS, 0);
+    std::vector<std::thread> threads;
+
+    for (unsigned t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t] {
+            // Strict: a call routed to another thread's mock fails as unexpected there
+            NhalMockScope<NhalI2cMock, StrictMock<NhalI2cMock> > i2c;
+            struct nhal_i2c_context ctx = { t };
+            EXPECT_CALL(i2c.mock(), nhal_i2c_master_write(&ctx, _, _, 1))
+                .Times((int)CALLS)
+                .WillRepeatedly(Invoke([&, t](struct nhal_i2c_context *c, nhal_i2c_address_t address,
+                                              const uint8_t *data, size_t) {
+                    if (c->owner != t || address.addr.address_7bit != 0x10 + t || data[0] != (uint8_t)t) {
+                        misrouted++;
+                    }
+                    served[t]++;
+                    return (t % 2) != 0 ? NHAL_OK : NHAL_ERR_BUSY;
+                }));
+
+            // Every thread has its expectations set before any of them calls
+            ready++;
+            while (ready.load() < THREADS) {
+                std::this_thread::yield();
+            }
+            const uint8_t byte = (uint8_t)t;
+            for (unsigned n = 0; n < CALLS; n++) {
+                EXPECT_EQ((t % 2) != 0 ? NHAL_OK : NHAL_ERR_BUSY, nhal_i2c_master_write(&ctx, address_of(t), &byte, 1));
+                if (n % 16 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(0u, misrouted.load());
+    for (unsigned t = 0; t < THREADS; t++) {
+        EXPECT_EQ(CALLS, served[t]) << "thread " << t;
+    }
+}
+
+TEST(MockScopeTest, BindingSharesAMockWithAWorkerAndNests) {
+    NhalMockScope<NhalI2cMock, StrictMock<NhalI2cMock> > outer;
+    struct nhal_i2c_context ctx = { 0 };
+    const uint8_t byte = 0;
+
+    EXPECT_CALL(outer.mock(), nhal_i2c_master_write(&ctx, _, _, _)).Times(3);
+    {
+        NhalMockScope<NhalI2cMock, StrictMock<NhalI2cMock> > inner;
+        EXPECT_CALL(inner.mock(), nhal_i2c_master_write(&ctx, _, _, _)).Times(1);
+        EXPECT_EQ(&inner.mock(), &NhalI2cMock::instance());
+        nhal_i2c_master_write(&ctx, address_of(0), &byte, 1);
+    }
+    // The inner scope is gone: calls reach the outer mock again
+    EXPECT_EQ(&outer.mock(), &NhalI2cMock::instance());
+    nhal_i2c_master_write(&ctx, address_of(0), &byte, 1);
+
+    std::thread worker([&] {
+        // Unbound threads fall back to the process-wide mock
+        EXPECT_NE(&outer.mock(), &NhalI2cMock::instance());
+        NhalMockBinding<NhalI2cMock> bind(outer.mock());
+        nhal_i2c_master_write(&ctx, address_of(0), &byte, 1);
+        nhal_i2c_master_write(&ctx, address_of(0), &byte, 1);
+    });
+    worker.join();
+}
+
+}  // namespace
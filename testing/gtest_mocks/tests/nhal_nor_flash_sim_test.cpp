@@ -0,0 +1,317 @@
+/**
+ * @file nhal_nor_flash_sim_test.cpp
+ * @brief NhalNorFlashSim behind the QSPI mock: command sequences, busy timing, erase bounds, and XIP vs indirect reads
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "nhal_nor_flash_sim.hpp"
+#include "nhal_qspi_mock.hpp"
+#include "nhal_virtual_clock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+struct nhal_qspi_context {
+    int unused;
+};
+
+namespace {
+
+nhal_qspi_command_t make_command(uint16_t instruction, uint32_t address = 0,
+                                 nhal_qspi_width_t address_width = NHAL_QSPI_WIDTH_NONE,
+                                 nhal_qspi_width_t data_width = NHAL_QSPI_WIDTH_NONE, uint8_t dummy_cycles = 0)
+{
+    nhal_qspi_command_t cmd;
+    std::memset(&cmd, 0, sizeof(cmd));
+    cmd.instruction = instruction;
+    cmd.instruction_width = NHAL_QSPI_WIDTH_1;
+    cmd.address = address;
+    cmd.address_width = address_width;
+    cmd.address_bytes = address_width != NHAL_QSPI_WIDTH_NONE ? 3 : 0;
+    cmd.dummy_cycles = dummy_cycles;
+    cmd.data_width = data_width;
+    return cmd;
+}
+
+const nhal_qspi_command_t WRITE_ENABLE = make_command(0x06);
+const nhal_qspi_command_t WRITE_DISABLE = make_command(0x04);
+const nhal_qspi_command_t READ_STATUS = make_command(0x05, 0, NHAL_QSPI_WIDTH_NONE, NHAL_QSPI_WIDTH_1);
+
+nhal_qspi_command_t quad_program(uint32_t address)
+{
+    return make_command(0x32, address, NHAL_QSPI_WIDTH_1, NHAL_QSPI_WIDTH_4);
+}
+
+nhal_qspi_command_t fast_read(uint32_t address)
+{
+    return make_command(0x0B, address, NHAL_QSPI_WIDTH_1, NHAL_QSPI_WIDTH_1, 8);
+}
+
+/** @brief Quad I/O read (1-4-4): mode byte on 4 lines, then 4 dummy cycles */
+nhal_qspi_command_t quad_io_read(uint32_t address)
+{
+    nhal_qspi_command_t cmd = make_command(0xEB, address, NHAL_QSPI_WIDTH_4, NHAL_QSPI_WIDTH_4, 4);
+    cmd.alternate_width = NHAL_QSPI_WIDTH_4;
+    cmd.alternate_bytes = 1;
+    return cmd;
+}
+
+class NorFlashSimTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        bind(flash_);
+    }
+
+    void bind(NhalNorFlashSim &flash) {
+        NhalQspiMock &qspi = qspi_.mock();
+        ON_CALL(qspi, nhal_qspi_command(_, _)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::command));
+        ON_CALL(qspi, nhal_qspi_write(_, _, _, _)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::write));
+        ON_CALL(qspi, nhal_qspi_read(_, _, _, _)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::read));
+        ON_CALL(qspi, nhal_qspi_poll_status(_, _, _, _, _)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::poll_status));
+        ON_CALL(qspi, nhal_qspi_memory_map_enable(_, _, _))
+            .WillByDefault(Invoke(&flash, &NhalNorFlashSim::memory_map_enable));
+        ON_CALL(qspi, nhal_qspi_memory_map_disable(_)).WillByDefault(Invoke(&flash, &NhalNorFlashSim::memory_map_disable));
+    }
+
+    nhal_result_t wait_ready(uint32_t timeout_ms) {
+        return nhal_qspi_poll_status(&ctx_, &READ_STATUS, NhalNorFlashSim::STATUS_WIP, 0, timeout_ms);
+    }
+
+    nhal_result_t erase(uint16_t instruction, uint32_t address) {
+        nhal_qspi_command_t cmd = make_command(instruction, address, NHAL_QSPI_WIDTH_1);
+        nhal_result_t result = nhal_qspi_command(&ctx_, &WRITE_ENABLE);
+        return result == NHAL_OK ? nhal_qspi_command(&ctx_, &cmd) : result;
+    }
+
+    NhalVirtualClock clock_;
+    NhalNorFlashSim flash_{1024 * 1024};
+    NhalMockScope<NhalQspiMock, NiceMock<NhalQspiMock> > qspi_;
+    struct nhal_qspi_context ctx_;
+};
+
+TEST_F(NorFlashSimTest, ProgramPollAndReadBack) {
+    uint8_t page[NhalNorFlashSim::PAGE_SIZE];
+    uint8_t readback[NhalNorFlashSim::PAGE_SIZE];
+    for (size_t i = 0; i < sizeof(page); i++) {
+        page[i] = (uint8_t)(i * 7);
+    }
+    const nhal_qspi_command_t program = quad_program(0x1000);
+    const nhal_qspi_command_t read_fast = fast_read(0x1000);
+    const nhal_qspi_command_t read_quad = quad_io_read(0x1000);
+
+    ASSERT_EQ(NHAL_OK, nhal_qspi_command(&ctx_, &WRITE_ENABLE));
+    EXPECT_EQ(NhalNorFlashSim::STATUS_WEL, flash_.status());
+    uint64_t start_ns = clock_.now_ns();
+    ASSERT_EQ(NHAL_OK, nhal_qspi_write(&ctx_, &program, page, sizeof(page)));
+
+    // Busy for the page program time: only the status register answers
+    uint8_t status = 0;
+    ASSERT_EQ(NHAL_OK, nhal_qspi_read(&ctx_, &READ_STATUS, &status, 1));
+    EXPECT_EQ(NhalNorFlashSim::STATUS_WIP, status);
+    EXPECT_EQ(NHAL_ERR_BUSY, nhal_qspi_read(&ctx_, &read_fast, readback, sizeof(readback)));
+    EXPECT_EQ(1u, flash_.stats().busy_violations);
+
+    ASSERT_EQ(NHAL_OK, wait_ready(10));
+    EXPECT_EQ(700000u, clock_.now_ns() - start_ns);
+    EXPECT_EQ(0u, flash_.status());
+
+    ASSERT_EQ(NHAL_OK, nhal_qspi_read(&ctx_, &read_fast, readback, sizeof(readback)));
+    EXPECT_EQ(0, std::memcmp(page, readback, sizeof(page)));
+    std::memset(readback, 0, sizeof(readback));
+    ASSERT_EQ(NHAL_OK, nhal_qspi_read(&ctx_, &read_quad, readback, sizeof(readback)));
+    EXPECT_EQ(0, std::memcmp(page, readback, sizeof(page)));
+
+    EXPECT_EQ(256u, flash_.stats().bytes_programmed);
+    EXPECT_EQ(512u, flash_.stats().bytes_read);
+    EXPECT_EQ(700000u, flash_.stats().busy_ns);
+    EXPECT_EQ(0u, flash_.stats().protocol_errors);
+
+    // Wrong dummy cycle count for a fast read
+    nhal_qspi_command_t wrong = fast_read(0x1000);
+    wrong.dummy_cycles = 4;
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG, nhal_qspi_read(&ctx_, &wrong, readback, sizeof(readback)));
+    EXPECT_EQ(1u, flash_.stats().protocol_errors);
+}
+
+TEST_F(NorFlashSimTest, ProgramWithoutWriteEnableIsIgnored) {
+    const uint8_t data[4] = { 0x00, 0x11, 0x22, 0x33 };
+    const nhal_qspi_command_t program = quad_program(0x2000);
+    uint8_t readback[4];
+
+    // Accepted on the wire, ignored by the array like on a real part
+    ASSERT_EQ(NHAL_OK, nhal_qspi_write(&ctx_, &program, data, sizeof(data)));
+    EXPECT_EQ(0u, flash_.status());
+    EXPECT_EQ(1u, flash_.stats().ignored_writes);
+
+    ASSERT_EQ(NHAL_OK, nhal_qspi_command(&ctx_, &WRITE_ENABLE));
+    ASSERT_EQ(NHAL_OK, nhal_qspi_command(&ctx_, &WRITE_DISABLE));
+    ASSERT_EQ(NHAL_OK, nhal_qspi_write(&ctx_, &program, data, sizeof(data)));
+    EXPECT_EQ(2u, flash_.stats().ignored_writes);
+
+    const nhal_qspi_command_t read = fast_read(0x2000);
+    ASSERT_EQ(NHAL_OK, nhal_qspi_read(&ctx_, &read, readback, sizeof(readback)));
+    for (uint8_t byte : readback) {
+        EXPECT_EQ(0xFF, byte);
+    }
+    EXPECT_EQ(0u, flash_.stats().bytes_programmed);
+    EXPECT_EQ(0u, flash_.stats().busy_ns);
+
+    // The latch clears after one program
+    ASSERT_EQ(NHAL_OK, nhal_qspi_command(&ctx_, &WRITE_ENABLE));
+    ASSERT_EQ(NHAL_OK, nhal_qspi_write(&ctx_, &program, data, sizeof(data)));
+    ASSERT_EQ(NHAL_OK, wait_ready(10));
+    ASSERT_EQ(NHAL_OK, nhal_qspi_write(&ctx_, &program, data, sizeof(data)));
+    EXPECT_EQ(3u, flash_.stats().ignored_writes);
+    EXPECT_EQ(4u, flash_.stats().bytes_programmed);
+}
+
+TEST_F(NorFlashSimTest, PollTimesOutBeforeALongErase) {
+    uint64_t start_ns = clock_.now_ns();
+    ASSERT_EQ(NHAL_OK, erase(0x20, 0x3000));
+
+    EXPECT_EQ(NHAL_ERR_TIMEOUT, wait_ready(10));
+    EXPECT_EQ(10000000u, clock_.now_ns() - start_ns);
+    EXPECT_EQ(NhalNorFlashSim::STATUS_WIP, flash_.status() & NhalNorFlashSim::STATUS_WIP);
+
+    ASSERT_EQ(NHAL_OK, wait_ready(100));
+    EXPECT_EQ(45000000u, clock_.now_ns() - start_ns);
+    EXPECT_EQ(1u, flash_.erase_count(0x3000));
+    EXPECT_EQ(0u, flash_.erase_count(0x4000));
+}
+
+TEST_F(NorFlashSimTest, EraseStopsAtTheEndOfAnUnalignedMemory) {
+    // One block, three sectors and a 100-byte tail
+    const size_t size = NhalNorFlashSim::BLOCK_SIZE + 3 * NhalNorFlashSim::SECTOR_SIZE + 100;
+    NhalNorFlashSim flash(size);
+    bind(flash);
+    std::vector<uint8_t> zeros(size, 0);
+    flash.load(0, zeros.data(), size);
+
+    // The last block holds 3 sectors and the tail
+    ASSERT_EQ(NHAL_OK, erase(0xD8, (uint32_t)(size - 1)));
+    ASSERT_EQ(NHAL_OK, wait_ready(1000));
+    for (size_t i = NhalNorFlashSim::BLOCK_SIZE; i < size; i++) {
+        ASSERT_EQ(0xFF, flash.data()[i]) << i;
+    }
+    EXPECT_EQ(0x00, flash.data()[NhalNorFlashSim::BLOCK_SIZE - 1]);
+    EXPECT_EQ(1u, flash.erase_count((uint32_t)(size - 1)));
+    EXPECT_EQ(0u, flash.erase_count(0));
+
+    // The tail sector alone
+    ASSERT_EQ(NHAL_OK, erase(0x20, (uint32_t)(size - 1)));
+    ASSERT_EQ(NHAL_OK, wait_ready(1000));
+    EXPECT_EQ(2u, flash.erase_count((uint32_t)(size - 1)));
+    EXPECT_EQ(1u, flash.erase_count((uint32_t)(size - 200)));
+    EXPECT_EQ(2u, flash.max_erase_count());
+}
+
+TEST_F(NorFlashSimTest, MappedReadsAreAccountedAndTimed) {
+    const nhal_qspi_command_t read_quad = quad_io_read(0);
+    const volatile uint8_t *base = nullptr;
+    const uint8_t marker[4] = { 0xDE, 0xAD, 0xBE, 0xEF };
+    uint8_t line[32];
+    flash_.load(0x100, marker, sizeof(marker));
+    flash_.set_bus_clock_hz(80000000);
+
+    EXPECT_EQ(NHAL_ERR_NOT_CONFIGURED, flash_.mapped_read(0, line, sizeof(line)));
+    ASSERT_EQ(NHAL_OK, nhal_qspi_memory_map_enable(&ctx_, &read_quad, &base));
+    ASSERT_NE(nullptr, base);
+    EXPECT_TRUE(flash_.mapped());
+    EXPECT_EQ(1u, flash_.stats().map_sessions);
+
+    // 1-4-4 burst: 8 instruction + 6 address + 2 mode + 4 dummy + 64 data cycles, 1.05 us at 80 MHz
+    uint64_t start_ns = clock_.now_ns();
+    ASSERT_EQ(NHAL_OK, flash_.mapped_read(0x100, line, sizeof(line)));
+    EXPECT_EQ(0, std::memcmp(marker, line, sizeof(marker)));
+    EXPECT_EQ(84u, flash_.stats().bus_cycles);
+    EXPECT_EQ(1050u, clock_.now_ns() - start_ns);
+    EXPECT_EQ(1u, flash_.stats().mapped_reads);
+    EXPECT_EQ(32u, flash_.stats().mapped_bytes_read);
+    EXPECT_EQ(0u, flash_.stats().bytes_read);
+    EXPECT_EQ(0xDE, base[0x100]);
+
+    // Indirect commands wait until the window is closed
+    EXPECT_EQ(NHAL_ERR_BUSY, nhal_qspi_command(&ctx_, &WRITE_ENABLE));
+    EXPECT_EQ(NHAL_ERR_BUSY, nhal_qspi_memory_map_enable(&ctx_, &read_quad, &base));
+    ASSERT_EQ(NHAL_OK, nhal_qspi_memory_map_disable(&ctx_));
+    EXPECT_EQ(NHAL_ERR_NOT_CONFIGURED, flash_.mapped_read(0, line, sizeof(line)));
+
+    // Nor can the window open during an erase
+    ASSERT_EQ(NHAL_OK, erase(0x20, 0));
+    EXPECT_EQ(NHAL_ERR_BUSY, nhal_qspi_memory_map_enable(&ctx_, &read_quad, &base));
+    ASSERT_EQ(NHAL_OK, wait_ready(100));
+    ASSERT_EQ(NHAL_OK, nhal_qspi_memory_map_enable(&ctx_, &read_quad, &base));
+    EXPECT_EQ(2u, flash_.stats().map_sessions);
+}
+
+struct ReadCost {
+    uint64_t virtual_ns;
+    uint64_t bus_cycles;
+    double host_ns_per_byte;
+};
+
+void report(const char *name, const ReadCost &cost, size_t bytes)
+{
+    double mbps = (double)bytes * 1e3 / (double)cost.virtual_ns;
+    std::printf("%-26s %7.2f cycles/byte, %6.1f MB/s at 80 MHz, host %5.1f ns/byte\n", name,
+                (double)cost.bus_cycles / (double)bytes, mbps, cost.host_ns_per_byte);
+    ::testing::Test::RecordProperty(std::string(name) + "_kBps", (int)(mbps * 1000));
+}
+
+TEST_F(NorFlashSimTest, XipLinesVersusIndirectReads) {
+    const size_t TOTAL = 1024 * 1024;
+    const size_t LINE = 32;
+    const size_t CHUNK = 4096;
+    NhalNorFlashSim flash(16 * 1024 * 1024);
+    bind(flash);
+    flash.set_bus_clock_hz(80000000);
+    std::vector<uint8_t> buffer(CHUNK);
+    const volatile uint8_t *base = nullptr;
+
+    auto measure = [&](const std::function<void(uint32_t address, size_t len)> &read, size_t len) {
+        flash.reset_stats();
+        uint64_t start_ns = clock_.now_ns();
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t address = 0; address < TOTAL; address += (uint32_t)len) {
+            read(address, len);
+        }
+        auto host_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        ReadCost cost = { clock_.now_ns() - start_ns, flash.stats().bus_cycles, (double)host_ns / TOTAL };
+        return cost;
+    };
+    auto indirect = [&](uint32_t address, size_t len) {
+        nhal_qspi_command_t cmd = quad_io_read(address);
+        ASSERT_EQ(NHAL_OK, nhal_qspi_read(&ctx_, &cmd, buffer.data(), len));
+    };
+    auto mapped = [&](uint32_t address, size_t len) {
+        ASSERT_EQ(NHAL_OK, flash.mapped_read(address, buffer.data(), len));
+    };
+
+    ReadCost indirect_lines = measure(indirect, LINE);
+    ReadCost indirect_chunks = measure(indirect, CHUNK);
+    const nhal_qspi_command_t map_cmd = quad_io_read(0);
+    ASSERT_EQ(NHAL_OK, nhal_qspi_memory_map_enable(&ctx_, &map_cmd, &base));
+    ReadCost xip_lines = measure(mapped, LINE);
+    EXPECT_EQ(TOTAL, flash.stats().mapped_bytes_read);
+    ASSERT_EQ(NHAL_OK, nhal_qspi_memory_map_disable(&ctx_));
+
+    report("indirect 32 B reads", indirect_lines, TOTAL);
+    report("indirect 4 KiB reads", indirect_chunks, TOTAL);
+    report("XIP 32 B cache lines", xip_lines, TOTAL);
+
+    // XIP issues the same command per line as an indirect read of that size; only long bursts amortize it
+    EXPECT_EQ(indirect_lines.bus_cycles, xip_lines.bus_cycles);
+    EXPECT_EQ(indirect_lines.virtual_ns, xip_lines.virtual_ns);
+    EXPECT_LT(indirect_chunks.virtual_ns * 5, xip_lines.virtual_ns * 4);
+}
+
+}  // namespace
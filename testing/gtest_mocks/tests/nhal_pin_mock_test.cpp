@@ -0,0 +1,136 @@
+/**
+ * @file nhal_pin_mock_test.cpp
+ * @brief NhalPinMock edge injection: trigger filtering, enable state and reconfiguration
+ */
+
+#include <gtest/gtest.h>
+
+#include "nhal_pin_mock.hpp"
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+struct nhal_pin_context {
+    int unused;
+};
+
+namespace {
+
+void count_callback(struct nhal_pin_context *, void *user_data)
+{
+    (*static_cast<unsigned *>(user_data))++;
+}
+
+class PinMockTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ON_CALL(pin_.mock(), nhal_pin_set_interrupt_config(_, _, _, _)).WillByDefault(Return(NHAL_OK));
+        ON_CALL(pin_.mock(), nhal_pin_interrupt_enable(_)).WillByDefault(Return(NHAL_OK));
+        ON_CALL(pin_.mock(), nhal_pin_interrupt_disable(_)).WillByDefault(Return(NHAL_OK));
+    }
+
+    void arm(nhal_pin_int_trigger_t trigger) {
+        ASSERT_EQ(NHAL_OK, nhal_pin_set_interrupt_config(&ctx_, trigger, count_callback, &fired_));
+        ASSERT_EQ(NHAL_OK, nhal_pin_interrupt_enable(&ctx_));
+    }
+
+    NhalMockScope<NhalPinMock, NiceMock<NhalPinMock> > pin_;
+    struct nhal_pin_context ctx_;
+    unsigned fired_ = 0;
+};
+
+TEST_F(PinMockTest, EdgeTriggersFilterTransitions) {
+    // The pin starts low
+    arm(NHAL_PIN_INT_TRIGGER_RISING_EDGE);
+    EXPECT_TRUE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_HIGH));
+    EXPECT_FALSE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_HIGH));
+    EXPECT_FALSE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_LOW));
+    EXPECT_EQ(1u, fired_);
+
+    arm(NHAL_PIN_INT_TRIGGER_FALLING_EDGE);
+    EXPECT_FALSE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_LOW));
+    EXPECT_FALSE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_HIGH));
+    EXPECT_TRUE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_LOW));
+    EXPECT_EQ(2u, fired_);
+
+    fired_ = 0;
+    arm(NHAL_PIN_INT_TRIGGER_RISING_EDGE);
+    EXPECT_EQ(10u, pin_.mock().inject_pulses(&ctx_, 10));
+    arm(NHAL_PIN_INT_TRIGGER_FALLING_EDGE);
+    EXPECT_EQ(10u, pin_.mock().inject_pulses(&ctx_, 10));
+    arm(NHAL_PIN_INT_TRIGGER_BOTH_EDGES);
+    EXPECT_EQ(20u, pin_.mock().inject_pulses(&ctx_, 10));
+    EXPECT_EQ(40u, fired_);
+}
+
+TEST_F(PinMockTest, LevelTriggersFireWhileTheLevelHolds) {
+    arm(NHAL_PIN_INT_TRIGGER_HIGH_LEVEL);
+    EXPECT_TRUE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_HIGH));
+    EXPECT_TRUE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_HIGH));
+    EXPECT_FALSE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_LOW));
+    EXPECT_EQ(2u, fired_);
+
+    arm(NHAL_PIN_INT_TRIGGER_LOW_LEVEL);
+    EXPECT_TRUE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_LOW));
+    EXPECT_FALSE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_HIGH));
+    // Each pulse ends low
+    EXPECT_EQ(5u, pin_.mock().inject_pulses(&ctx_, 5));
+    EXPECT_EQ(8u, fired_);
+
+    arm(NHAL_PIN_INT_TRIGGER_NONE);
+    EXPECT_EQ(0u, pin_.mock().inject_pulses(&ctx_, 5));
+}
+
+TEST_F(PinMockTest, DisabledInterruptsDoNotFire) {
+    // Unregistered pin
+    EXPECT_FALSE(pin_.mock().inject_edge(&ctx_, NHAL_PIN_HIGH));
+    EXPECT_FALSE(pin_.mock().interrupt_enabled(&ctx_));
+
+    // Registered but not enabled yet
+    ASSERT_EQ(NHAL_OK, nhal_pin_set_interrupt_config(&ctx_, NHAL_PIN_INT_TRIGGER_BOTH_EDGES, count_callback, &fired_));
+    EXPECT_FALSE(pin_.mock().interrupt_enabled(&ctx_));
+    EXPECT_EQ(0u, pin_.mock().inject_pulses(&ctx_, 3));
+
+    ASSERT_EQ(NHAL_OK, nhal_pin_interrupt_enable(&ctx_));
+    EXPECT_EQ(6u, pin_.mock().inject_pulses(&ctx_, 3));
+    ASSERT_EQ(NHAL_OK, nhal_pin_interrupt_disable(&ctx_));
+    EXPECT_EQ(0u, pin_.mock().inject_pulses(&ctx_, 3));
+    EXPECT_EQ(6u, fired_);
+
+    // A failed enable leaves the interrupt disabled
+    EXPECT_CALL(pin_.mock(), nhal_pin_interrupt_enable(_))
+        .WillOnce(Return(NHAL_ERR_HW_FAILURE))
+        .WillRepeatedly(Return(NHAL_OK));
+    EXPECT_EQ(NHAL_ERR_HW_FAILURE, nhal_pin_interrupt_enable(&ctx_));
+    EXPECT_FALSE(pin_.mock().interrupt_enabled(&ctx_));
+
+    ASSERT_EQ(NHAL_OK, nhal_pin_interrupt_enable(&ctx_));
+    pin_.mock().clear_interrupts();
+    EXPECT_EQ(0u, pin_.mock().inject_pulses(&ctx_, 3));
+}
+
+TEST_F(PinMockTest, ReconfigurationDisablesTheInterrupt) {
+    unsigned other = 0;
+    arm(NHAL_PIN_INT_TRIGGER_RISING_EDGE);
+    EXPECT_EQ(1u, pin_.mock().inject_pulses(&ctx_, 1));
+
+    ASSERT_EQ(NHAL_OK, nhal_pin_set_interrupt_config(&ctx_, NHAL_PIN_INT_TRIGGER_BOTH_EDGES, count_callback, &other));
+    EXPECT_FALSE(pin_.mock().interrupt_enabled(&ctx_));
+    EXPECT_EQ(0u, pin_.mock().inject_pulses(&ctx_, 4));
+
+    // Once enabled again, the new trigger and callback are used
+    ASSERT_EQ(NHAL_OK, nhal_pin_interrupt_enable(&ctx_));
+    EXPECT_EQ(8u, pin_.mock().inject_pulses(&ctx_, 4));
+    EXPECT_EQ(1u, fired_);
+    EXPECT_EQ(8u, other);
+
+    // A rejected configuration is not recorded
+    EXPECT_CALL(pin_.mock(), nhal_pin_set_interrupt_config(_, _, _, _)).WillOnce(Return(NHAL_ERR_INVALID_ARG));
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG,
+              nhal_pin_set_interrupt_config(&ctx_, NHAL_PIN_INT_TRIGGER_RISING_EDGE, count_callback, &fired_));
+    EXPECT_TRUE(pin_.mock().interrupt_enabled(&ctx_));
+    EXPECT_EQ(8u, pin_.mock().inject_pulses(&ctx_, 4));
+}
+
+}  // namespace
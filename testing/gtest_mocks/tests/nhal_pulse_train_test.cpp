@@ -0,0 +1,141 @@
+/**
+ * @file nhal_pulse_train_test.cpp
+ * @brief NhalPulseTrain measurements, edge modes, prescaler and overrun accounting behind the capture mock
+ */
+
+#include <gtest/gtest.h>
+
+#include "nhal_pin_capture_mock.hpp"
+#include "nhal_pulse_train.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+struct nhal_pin_capture_context {
+    int unused;
+};
+
+namespace {
+
+class PulseTrainTest : public ::testing::Test {
+protected:
+    void bind(NhalPulseTrain &train) {
+        NhalPinCaptureMock &capture = capture_.mock();
+        ON_CALL(capture, nhal_pin_capture_set_config(_, _)).WillByDefault(Invoke(&train, &NhalPulseTrain::set_config));
+        ON_CALL(capture, nhal_pin_capture_read(_, _, _, _)).WillByDefault(Invoke(&train, &NhalPulseTrain::read));
+        ON_CALL(capture, nhal_pin_capture_get_stats(_, _)).WillByDefault(Invoke(&train, &NhalPulseTrain::get_stats));
+    }
+
+    struct nhal_pin_capture_stats stats() {
+        struct nhal_pin_capture_stats stats;
+        EXPECT_EQ(NHAL_OK, nhal_pin_capture_get_stats(&ctx_, &stats));
+        return stats;
+    }
+
+    NhalMockScope<NhalPinCaptureMock, NiceMock<NhalPinCaptureMock> > capture_;
+    struct nhal_pin_capture_context ctx_;
+    nhal_pin_capture_sample_t samples_[16];
+    size_t count_ = 0;
+};
+
+TEST_F(PulseTrainTest, GeneratesPeriodAndWidth) {
+    NhalPulseTrain train(1000, 250);
+    bind(train);
+    train.set_pulses_per_read(4);
+
+    ASSERT_EQ(NHAL_OK, nhal_pin_capture_read(&ctx_, samples_, 16, &count_));
+    ASSERT_EQ(4u, count_);
+    for (size_t i = 0; i < count_; i++) {
+        EXPECT_EQ(1000u, samples_[i].period_ticks);
+        EXPECT_EQ(250u, samples_[i].high_ticks);
+    }
+    EXPECT_EQ(8u, stats().edge_count);
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG, nhal_pin_capture_read(&ctx_, nullptr, 16, &count_));
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG, nhal_pin_capture_get_stats(&ctx_, nullptr));
+}
+
+TEST_F(PulseTrainTest, JitterIsBoundedAndReproducible) {
+    NhalPulseTrain train(1000, 250, 5, 42);
+    NhalPulseTrain twin(1000, 250, 5, 42);
+
+    for (int i = 0; i < 1000; i++) {
+        nhal_pin_capture_sample_t sample = train.next();
+        nhal_pin_capture_sample_t expected = twin.next();
+        ASSERT_EQ(expected.period_ticks, sample.period_ticks);
+        ASSERT_EQ(expected.high_ticks, sample.high_ticks);
+        ASSERT_GE(sample.period_ticks, 995u);
+        ASSERT_LE(sample.period_ticks, 1005u);
+        ASSERT_GE(sample.high_ticks, 245u);
+        ASSERT_LE(sample.high_ticks, 255u);
+    }
+}
+
+TEST_F(PulseTrainTest, SingleEdgeModesMeasureNoWidth) {
+    NhalPulseTrain train(1000, 250);
+    bind(train);
+    train.set_pulses_per_read(3);
+    const nhal_pin_capture_edge_t edges[] = { NHAL_PIN_CAPTURE_EDGE_RISING, NHAL_PIN_CAPTURE_EDGE_FALLING };
+    uint64_t edge_count = 0;
+
+    for (nhal_pin_capture_edge_t edge : edges) {
+        struct nhal_pin_capture_config config = { edge, 0, nullptr };
+        ASSERT_EQ(NHAL_OK, nhal_pin_capture_set_config(&ctx_, &config));
+        ASSERT_EQ(NHAL_OK, nhal_pin_capture_read(&ctx_, samples_, 16, &count_));
+        ASSERT_EQ(3u, count_);
+        for (size_t i = 0; i < count_; i++) {
+            EXPECT_EQ(1000u, samples_[i].period_ticks);
+            EXPECT_EQ(0u, samples_[i].high_ticks);
+        }
+        // One active edge per pulse
+        edge_count += 3;
+        EXPECT_EQ(edge_count, stats().edge_count);
+    }
+
+    struct nhal_pin_capture_config invalid = { NHAL_PIN_CAPTURE_EDGE_TOTAL_NUM, 0, nullptr };
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG, nhal_pin_capture_set_config(&ctx_, &invalid));
+}
+
+TEST_F(PulseTrainTest, PrescalerCapturesOneOutOfEveryNPeriods) {
+    NhalPulseTrain train(1000, 250);
+    bind(train);
+    struct nhal_pin_capture_config config = { NHAL_PIN_CAPTURE_EDGE_RISING, 4, nullptr };
+    ASSERT_EQ(NHAL_OK, nhal_pin_capture_set_config(&ctx_, &config));
+    train.set_pulses_per_read(6);
+
+    // 6 then 12 pulses: the measurement boundary carries over between reads
+    ASSERT_EQ(NHAL_OK, nhal_pin_capture_read(&ctx_, samples_, 16, &count_));
+    EXPECT_EQ(1u, count_);
+    ASSERT_EQ(NHAL_OK, nhal_pin_capture_read(&ctx_, samples_ + 1, 15, &count_));
+    EXPECT_EQ(2u, count_);
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_EQ(4000u, samples_[i].period_ticks);
+    }
+    EXPECT_EQ(12u, stats().edge_count);
+}
+
+TEST_F(PulseTrainTest, SlowReaderCountsOverruns) {
+    NhalPulseTrain train(1000, 250);
+    bind(train);
+    train.set_pulses_per_read(10);
+    train.set_buffer_capacity(16);
+
+    // Reading 4 out of 10 new pulses fills the buffer on the second read
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(NHAL_OK, nhal_pin_capture_read(&ctx_, samples_, 4, &count_));
+        EXPECT_EQ(4u, count_);
+    }
+    EXPECT_EQ(0u, stats().overrun_count);
+    ASSERT_EQ(NHAL_OK, nhal_pin_capture_read(&ctx_, samples_, 4, &count_));
+    EXPECT_EQ(6u, stats().overrun_count);
+    ASSERT_EQ(NHAL_OK, nhal_pin_capture_read(&ctx_, samples_, 4, &count_));
+    EXPECT_EQ(12u, stats().overrun_count);
+
+    // Draining: 12 left, room for 4 of the 10 new pulses; every edge still counts
+    ASSERT_EQ(NHAL_OK, nhal_pin_capture_read(&ctx_, samples_, 16, &count_));
+    EXPECT_EQ(16u, count_);
+    EXPECT_EQ(18u, stats().overrun_count);
+    EXPECT_EQ(100u, stats().edge_count);
+}
+
+}  // namespace
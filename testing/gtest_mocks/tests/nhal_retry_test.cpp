@@ -0,0 +1,172 @@
+/**
+ * @file nhal_retry_test.cpp
+ * @brief nhal_retry.h attempt limits, backoff growth and cap, retryable results and total delay, in virtual time
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "nhal_retry.h"
+#include "nhal_virtual_clock.hpp"
+
+namespace {
+
+/** @brief Operation failing with a result a given number of times, then succeeding */
+struct FlakyOperation {
+    nhal_result_t call() {
+        calls++;
+        call_times_ns.push_back(NhalVirtualClock::current()->now_ns());
+        return calls <= failures ? failure : NHAL_OK;
+    }
+
+    nhal_result_t failure;
+    unsigned failures;
+    unsigned calls = 0;
+    std::vector<uint64_t> call_times_ns;
+};
+
+nhal_retry_policy_t make_policy(uint8_t max_attempts, uint32_t base_delay_us, uint32_t max_delay_us,
+                                uint8_t jitter_percent = 0)
+{
+    nhal_retry_policy_t policy;
+    policy.max_attempts = max_attempts;
+    policy.base_delay_us = base_delay_us;
+    policy.max_delay_us = max_delay_us;
+    policy.jitter_percent = jitter_percent;
+    policy.retryable_mask = NHAL_RETRY_DEFAULT_MASK;
+    return policy;
+}
+
+class RetryTest : public ::testing::Test {
+protected:
+    nhal_result_t run(FlakyOperation &op) {
+        nhal_result_t result;
+        NHAL_RETRY(&rctx_, result, op.call());
+        return result;
+    }
+
+    NhalVirtualClock clock_;
+    struct nhal_retry_context rctx_;
+};
+
+TEST_F(RetryTest, StopsAtMaxAttempts) {
+    nhal_retry_policy_t policy = make_policy(4, 100, 0);
+    nhal_retry_init(&rctx_, &policy, 1);
+    FlakyOperation op = { NHAL_ERR_TIMEOUT, 10 };
+
+    EXPECT_EQ(NHAL_ERR_TIMEOUT, run(op));
+    EXPECT_EQ(4u, op.calls);
+    EXPECT_EQ(1u, rctx_.stats.operations);
+    EXPECT_EQ(4u, rctx_.stats.attempts);
+    EXPECT_EQ(3u, rctx_.stats.retries);
+    EXPECT_EQ(1u, rctx_.stats.failures);
+    EXPECT_EQ(4u, rctx_.stats.result_counts[NHAL_ERR_TIMEOUT]);
+
+    // 0 and 1 both mean a single attempt
+    for (uint8_t max_attempts = 0; max_attempts <= 1; max_attempts++) {
+        policy.max_attempts = max_attempts;
+        nhal_retry_init(&rctx_, &policy, 1);
+        FlakyOperation once = { NHAL_ERR_BUSY, 10 };
+        EXPECT_EQ(NHAL_ERR_BUSY, run(once));
+        EXPECT_EQ(1u, once.calls);
+        EXPECT_EQ(0u, rctx_.stats.retries);
+    }
+}
+
+TEST_F(RetryTest, SuccessEndsTheOperationAndClearsTheFailureStreak) {
+    nhal_retry_policy_t policy = make_policy(3, 100, 0);
+    nhal_retry_init(&rctx_, &policy, 1);
+    FlakyOperation failing = { NHAL_ERR_NO_RESPONSE, 10 };
+    FlakyOperation recovering = { NHAL_ERR_NO_RESPONSE, 2 };
+
+    EXPECT_EQ(NHAL_ERR_NO_RESPONSE, run(failing));
+    EXPECT_EQ(NHAL_ERR_NO_RESPONSE, run(failing));
+    EXPECT_EQ(2u, rctx_.stats.consecutive_failures);
+
+    EXPECT_EQ(NHAL_OK, run(recovering));
+    EXPECT_EQ(3u, recovering.calls);
+    EXPECT_EQ(0u, rctx_.stats.consecutive_failures);
+    EXPECT_EQ(3u, rctx_.stats.operations);
+    EXPECT_EQ(2u, rctx_.stats.failures);
+    EXPECT_EQ(1u, rctx_.stats.result_counts[NHAL_OK]);
+}
+
+TEST_F(RetryTest, OnlyRetryableResultsAreRetried) {
+    nhal_retry_policy_t policy = make_policy(5, 10, 0);
+    const nhal_result_t retried[] = { NHAL_ERR_TIMEOUT, NHAL_ERR_BUSY, NHAL_ERR_NO_RESPONSE,
+                                      NHAL_ERR_TRANSMISSION_ERROR };
+    const nhal_result_t final[] = { NHAL_ERR_INVALID_ARG, NHAL_ERR_INVALID_CONFIG, NHAL_ERR_NOT_INITIALIZED,
+                                    NHAL_ERR_UNSUPPORTED, NHAL_ERR_HW_FAILURE, NHAL_ERR_OTHER };
+
+    for (nhal_result_t result : retried) {
+        nhal_retry_init(&rctx_, &policy, 1);
+        FlakyOperation op = { result, 1 };
+        EXPECT_EQ(NHAL_OK, run(op)) << "result " << result;
+        EXPECT_EQ(2u, op.calls) << "result " << result;
+    }
+    for (nhal_result_t result : final) {
+        nhal_retry_init(&rctx_, &policy, 1);
+        FlakyOperation op = { result, 1 };
+        EXPECT_EQ(result, run(op)) << "result " << result;
+        EXPECT_EQ(1u, op.calls) << "result " << result;
+        EXPECT_FALSE(nhal_retry_is_retryable(&policy, result));
+    }
+    EXPECT_FALSE(nhal_retry_is_retryable(&policy, NHAL_OK));
+    EXPECT_FALSE(nhal_retry_is_retryable(&policy, (nhal_result_t)NHAL_RESULT_COUNT));
+
+    // The mask is the policy's choice
+    policy.retryable_mask = NHAL_RESULT_MASK(NHAL_ERR_HW_FAILURE);
+    nhal_retry_init(&rctx_, &policy, 1);
+    FlakyOperation hw = { NHAL_ERR_HW_FAILURE, 1 };
+    FlakyOperation timeout = { NHAL_ERR_TIMEOUT, 1 };
+    EXPECT_EQ(NHAL_OK, run(hw));
+    EXPECT_EQ(NHAL_ERR_TIMEOUT, run(timeout));
+}
+
+TEST_F(RetryTest, BackoffDoublesUpToTheCap) {
+    nhal_retry_policy_t policy = make_policy(8, 100, 1000);
+    nhal_retry_init(&rctx_, &policy, 1);
+    const uint32_t expected[] = { 100, 200, 400, 800, 1000, 1000, 1000 };
+
+    for (uint8_t retry = 1; retry <= 7; retry++) {
+        EXPECT_EQ(expected[retry - 1], nhal_retry_backoff_us(&rctx_, retry)) << "retry " << (int)retry;
+    }
+
+    // The delays happen between the attempts
+    FlakyOperation op = { NHAL_ERR_TIMEOUT, 10 };
+    run(op);
+    ASSERT_EQ(8u, op.call_times_ns.size());
+    for (size_t i = 1; i < op.call_times_ns.size(); i++) {
+        EXPECT_EQ(expected[i - 1] * 1000ull, op.call_times_ns[i] - op.call_times_ns[i - 1]) << "retry " << i;
+    }
+
+    // Without a cap the delay saturates instead of wrapping
+    policy.max_delay_us = 0;
+    policy.base_delay_us = 0x40000000u;
+    nhal_retry_init(&rctx_, &policy, 1);
+    EXPECT_EQ(0x80000000u, nhal_retry_backoff_us(&rctx_, 2));
+    EXPECT_EQ(UINT32_MAX, nhal_retry_backoff_us(&rctx_, 3));
+    EXPECT_EQ(UINT32_MAX, nhal_retry_backoff_us(&rctx_, 40));
+}
+
+TEST_F(RetryTest, TotalDelayStaysWithinTheBackoffBounds) {
+    // 100 + 200 + 400 + 800 + 800 without jitter
+    const uint64_t upper_us = 2300;
+    nhal_retry_policy_t policy = make_policy(6, 100, 800, 50);
+
+    for (uint32_t seed = 1; seed <= 100; seed++) {
+        nhal_retry_init(&rctx_, &policy, seed);
+        FlakyOperation op = { NHAL_ERR_BUSY, 10 };
+        uint64_t start_ns = clock_.now_ns();
+        run(op);
+        uint64_t total_us = (clock_.now_ns() - start_ns) / 1000;
+
+        ASSERT_EQ(6u, op.calls);
+        ASSERT_LE(total_us, upper_us) << "seed " << seed;
+        // Jitter removes at most half of each delay
+        ASSERT_GE(total_us, upper_us / 2) << "seed " << seed;
+    }
+}
+
+}  // namespace
@@ -0,0 +1,259 @@
+/**
+ * @file nhal_spi_nor_test.cpp
+ * @brief nhal_spi_nor.h block device against the simulated NOR flash behind the SPI mock
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define NHAL_SPI_NOR_IMPLEMENTATION
+#include "nhal_spi_nor.h"
+#include "nhal_spi_mock.hpp"
+#include "nhal_nor_flash_sim.hpp"
+#include "nhal_virtual_clock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+struct nhal_spi_context {
+    int unused;
+};
+
+namespace {
+
+const size_t RECORD_SIZE = 20;
+const size_t RECORDS = 200;
+
+class SpiNorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ON_CALL(spi_.mock(), nhal_spi_master_write(_, _, _))
+            .WillByDefault(Invoke([this](struct nhal_spi_context *ctx, const uint8_t *data, size_t len) {
+                // Program commands can be made to fail before reaching the flash
+                if (fail_programs_ > 0 && len > 1 && data[0] == 0x02) {
+                    fail_programs_--;
+                    return NHAL_ERR_HW_FAILURE;
+                }
+                return flash_.spi_write(ctx, data, len);
+            }));
+        ON_CALL(spi_.mock(), nhal_spi_master_write_read(_, _, _, _, _))
+            .WillByDefault(Invoke(&flash_, &NhalNorFlashSim::spi_write_read));
+
+        memset(&config_, 0, sizeof(config_));
+        config_.size = (uint32_t)flash_.size();
+        config_.page_size = NhalNorFlashSim::PAGE_SIZE;
+        config_.erase_size = NhalNorFlashSim::SECTOR_SIZE;
+        config_.address_bytes = 3;
+        config_.busy_timeout_ms = 500;
+        config_.write_buffer = write_buffer_;
+        config_.cache_buffer = cache_buffer_;
+        config_.cache_lines = cache_lines_;
+        config_.num_cache_lines = 8;
+        config_.cache_line_size = 64;
+        config_.readahead_lines = 3;
+        ASSERT_EQ(NHAL_OK, nhal_spi_nor_init(&dev_, &spi_ctx_, &config_));
+    }
+
+    static std::vector<uint8_t> record(size_t index) {
+        std::vector<uint8_t> bytes(RECORD_SIZE);
+        for (size_t i = 0; i < RECORD_SIZE; i++) {
+            bytes[i] = (uint8_t)(index * 7 + i);
+        }
+        return bytes;
+    }
+
+    void write_log() {
+        for (size_t r = 0; r < RECORDS; r++) {
+            std::vector<uint8_t> bytes = record(r);
+            ASSERT_EQ(NHAL_OK, nhal_spi_nor_program(&dev_, (uint32_t)(r * RECORD_SIZE), bytes.data(), bytes.size()));
+        }
+        ASSERT_EQ(NHAL_OK, nhal_spi_nor_sync(&dev_));
+    }
+
+    NhalVirtualClock clock_;
+    NhalNorFlashSim flash_{1024 * 1024};
+    NhalMockScope<NhalSpiMock, NiceMock<NhalSpiMock> > spi_;
+    struct nhal_spi_context spi_ctx_;
+    struct nhal_spi_nor_config config_;
+    uint8_t write_buffer_[NHAL_SPI_NOR_WRITE_BUFFER_SIZE(NhalNorFlashSim::PAGE_SIZE)];
+    uint8_t cache_buffer_[8 * 64];
+    struct nhal_spi_nor_cache_line cache_lines_[8];
+    struct nhal_spi_nor dev_;
+    int fail_programs_ = 0;
+};
+
+TEST_F(SpiNorTest, RecordWritesCoalesceIntoPagePrograms) {
+    write_log();
+
+    // 4000 bytes of records: 15 full pages and the partial last one
+    EXPECT_EQ(16u, dev_.stats.page_programs);
+    EXPECT_EQ(RECORDS * RECORD_SIZE, dev_.stats.bytes_programmed);
+    EXPECT_EQ(RECORDS * RECORD_SIZE, flash_.stats().bytes_programmed);
+    EXPECT_EQ(0u, flash_.stats().protocol_errors);
+    EXPECT_EQ(0u, flash_.stats().busy_violations);
+    EXPECT_EQ(0u, flash_.stats().program_conflicts);
+    for (size_t r = 0; r < RECORDS; r++) {
+        ASSERT_EQ(0, memcmp(record(r).data(), flash_.data() + r * RECORD_SIZE, RECORD_SIZE)) << "record " << r;
+    }
+    std::printf("%zu records of %zu bytes: %u page programs, %.1f ms busy\n", RECORDS, RECORD_SIZE,
+                (unsigned)dev_.stats.page_programs, (double)flash_.stats().busy_ns / 1e6);
+    RecordProperty("page_programs", (int)dev_.stats.page_programs);
+}
+
+TEST_F(SpiNorTest, SequentialRecordReadsUseReadahead) {
+    write_log();
+    dev_.stats.bus_reads = 0;
+
+    for (size_t r = 0; r < RECORDS; r++) {
+        uint8_t bytes[RECORD_SIZE];
+        ASSERT_EQ(NHAL_OK, nhal_spi_nor_read(&dev_, (uint32_t)(r * RECORD_SIZE), bytes, sizeof(bytes)));
+        ASSERT_EQ(0, memcmp(record(r).data(), bytes, RECORD_SIZE)) << "record " << r;
+    }
+
+    // The first read is not sequential and fetches one line; then each miss
+    // fetches 4 lines of 64 bytes: one read command per 256 bytes
+    EXPECT_EQ(17u, dev_.stats.bus_reads);
+    EXPECT_EQ(17u, dev_.stats.cache_misses);
+    EXPECT_EQ(48u, dev_.stats.readahead_lines);
+    EXPECT_EQ(0u, flash_.stats().protocol_errors);
+    std::printf("%zu records of %zu bytes: %u bus reads, %u cache hits\n", RECORDS, RECORD_SIZE,
+                (unsigned)dev_.stats.bus_reads, (unsigned)dev_.stats.cache_hits);
+    RecordProperty("bus_reads", (int)dev_.stats.bus_reads);
+}
+
+TEST_F(SpiNorTest, FailedSyncKeepsPendingData) {
+    const uint8_t tail[10] = { 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9 };
+    std::vector<uint8_t> head = record(1);
+
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_program(&dev_, 100, head.data(), head.size()));
+    fail_programs_ = 1;
+    EXPECT_EQ(NHAL_ERR_HW_FAILURE, nhal_spi_nor_sync(&dev_));
+    EXPECT_EQ(0u, flash_.stats().bytes_programmed);
+
+    // Extending the pending range downwards covers the bytes the failed
+    // command header was written over
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_program(&dev_, 90, tail, sizeof(tail)));
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_sync(&dev_));
+
+    EXPECT_EQ(1u, dev_.stats.page_programs);
+    EXPECT_EQ(0, memcmp(tail, flash_.data() + 90, sizeof(tail)));
+    EXPECT_EQ(0, memcmp(head.data(), flash_.data() + 100, head.size()));
+    EXPECT_EQ(0xFF, flash_.data()[89]);
+    EXPECT_EQ(0xFF, flash_.data()[120]);
+}
+
+TEST_F(SpiNorTest, UseCounterWrapKeepsCachedLinesValid) {
+    uint8_t bytes[4];
+
+    write_log();
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_read(&dev_, 0, bytes, sizeof(bytes)));
+    uint32_t bus_reads = dev_.stats.bus_reads;
+
+    // A hit that runs the counter out must not leave its line marked empty
+    dev_.use_counter = UINT32_MAX;
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_read(&dev_, 8, bytes, sizeof(bytes)));
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_read(&dev_, 8, bytes, sizeof(bytes)));
+    EXPECT_EQ(bus_reads, dev_.stats.bus_reads);
+    EXPECT_EQ(0, memcmp(record(0).data() + 8, bytes, sizeof(bytes)));
+
+    // Same for lines filled by a miss
+    dev_.use_counter = UINT32_MAX - 1;
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_read(&dev_, 2048, bytes, sizeof(bytes)));
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_read(&dev_, 2048, bytes, sizeof(bytes)));
+    EXPECT_EQ(bus_reads + 1, dev_.stats.bus_reads);
+    EXPECT_EQ(0, memcmp(flash_.data() + 2048, bytes, sizeof(bytes)));
+}
+
+TEST_F(SpiNorTest, EraseRejectsUnalignedRanges) {
+    const uint32_t SECTOR = NhalNorFlashSim::SECTOR_SIZE;
+
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG, nhal_spi_nor_erase(&dev_, 100, SECTOR));
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG, nhal_spi_nor_erase(&dev_, SECTOR, 100));
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG, nhal_spi_nor_erase(&dev_, SECTOR / 2, SECTOR + SECTOR / 2));
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG, nhal_spi_nor_erase(&dev_, (uint32_t)flash_.size() - SECTOR, 2 * SECTOR));
+    EXPECT_EQ(NHAL_ERR_INVALID_ARG, nhal_spi_nor_erase(&dev_, (uint32_t)flash_.size() + SECTOR, 0));
+    EXPECT_EQ(0u, dev_.stats.erases);
+    EXPECT_EQ(0u, flash_.stats().commands);
+    EXPECT_EQ(0u, flash_.max_erase_count());
+}
+
+TEST_F(SpiNorTest, EraseAcrossABlockBoundary) {
+    const uint32_t SECTOR = NhalNorFlashSim::SECTOR_SIZE;
+    const uint32_t start = NhalNorFlashSim::BLOCK_SIZE - 2 * SECTOR;
+    std::vector<uint8_t> zeros(6 * SECTOR, 0);
+    uint8_t bytes[4];
+
+    flash_.load(start - SECTOR, zeros.data(), zeros.size());
+    // Cached before the erase, must not be served stale after it
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_read(&dev_, start + 8, bytes, sizeof(bytes)));
+    EXPECT_EQ(0x00, bytes[0]);
+
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_erase(&dev_, start, 4 * SECTOR));
+    EXPECT_EQ(4u, dev_.stats.erases);
+    EXPECT_EQ(4u, flash_.stats().sector_erases);
+    EXPECT_EQ(0u, flash_.stats().block_erases);
+    EXPECT_EQ(0u, flash_.stats().ignored_writes);
+    EXPECT_EQ(0u, flash_.stats().busy_violations);
+    for (uint32_t address = start; address < start + 4 * SECTOR; address++) {
+        ASSERT_EQ(0xFF, flash_.data()[address]) << address;
+    }
+    EXPECT_EQ(0x00, flash_.data()[start - 1]);
+    EXPECT_EQ(0x00, flash_.data()[start + 4 * SECTOR]);
+
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_read(&dev_, start + 8, bytes, sizeof(bytes)));
+    EXPECT_EQ(0xFF, bytes[0]);
+    EXPECT_EQ(0u, flash_.erase_count(start - SECTOR));
+    for (uint32_t sector = 0; sector < 4; sector++) {
+        EXPECT_EQ(1u, flash_.erase_count(start + sector * SECTOR)) << "sector " << sector;
+    }
+    EXPECT_EQ(0u, flash_.erase_count(start + 4 * SECTOR));
+}
+
+TEST_F(SpiNorTest, EraseWearIsCountedPerSector) {
+    const uint32_t SECTOR = NhalNorFlashSim::SECTOR_SIZE;
+    NhalNorFlashSim::Timing timing = { 700000, 45000000, 150000000, 2000000 };
+    flash_.set_timing(timing);
+
+    // A log rewriting its first sector, and a ring spreading the same erases
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(NHAL_OK, nhal_spi_nor_erase(&dev_, 0, SECTOR));
+    }
+    for (uint32_t i = 0; i < 10; i++) {
+        ASSERT_EQ(NHAL_OK, nhal_spi_nor_erase(&dev_, (16 + i) * SECTOR, SECTOR));
+    }
+    EXPECT_EQ(10u, flash_.erase_count(0));
+    EXPECT_EQ(1u, flash_.erase_count(16 * SECTOR));
+    EXPECT_EQ(10u, flash_.max_erase_count());
+
+    // The whole memory at once is a single chip erase
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_erase(&dev_, 0, flash_.size()));
+    EXPECT_EQ(1u, flash_.stats().chip_erases);
+    EXPECT_EQ(21u, dev_.stats.erases);
+    EXPECT_EQ(11u, flash_.max_erase_count());
+    EXPECT_EQ(2u, flash_.erase_count(20 * SECTOR));
+    EXPECT_EQ(1u, flash_.erase_count((uint32_t)flash_.size() - 1));
+}
+
+TEST_F(SpiNorTest, EepromModeHasNoErase) {
+    const uint8_t data[3] = { 0x12, 0x34, 0x56 };
+    uint8_t bytes[3];
+
+    config_.erase_size = 0;
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_init(&dev_, &spi_ctx_, &config_));
+    EXPECT_EQ(NHAL_ERR_UNSUPPORTED, nhal_spi_nor_erase(&dev_, 0, NhalNorFlashSim::SECTOR_SIZE));
+    EXPECT_EQ(NHAL_ERR_UNSUPPORTED, nhal_spi_nor_erase(&dev_, 0, flash_.size()));
+    EXPECT_EQ(0u, dev_.stats.erases);
+    EXPECT_EQ(0u, flash_.stats().commands);
+
+    // Bytes are written in place
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_program(&dev_, 10, data, sizeof(data)));
+    ASSERT_EQ(NHAL_OK, nhal_spi_nor_read(&dev_, 10, bytes, sizeof(bytes)));
+    EXPECT_EQ(0, memcmp(data, bytes, sizeof(data)));
+    EXPECT_EQ(0u, flash_.max_erase_count());
+}
+
+}  // namespace
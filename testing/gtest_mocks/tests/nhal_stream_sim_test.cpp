@@ -0,0 +1,146 @@
+/**
+ * @file nhal_stream_sim_test.cpp
+ * @brief NhalStreamSim pacing, and the throughput a stream consumer sustains without dropping blocks
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "nhal_stream_mock.hpp"
+#include "nhal_stream_sim.hpp"
+#include "nhal_virtual_clock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+struct nhal_stream_context {
+    int unused;
+};
+
+namespace {
+
+const uint32_t SAMPLE_RATE_HZ = 16000;
+const uint16_t NUM_BLOCKS = 4;
+const size_t BLOCK_SAMPLES = 256;
+const uint64_t BLOCK_PERIOD_NS = BLOCK_SAMPLES * 1000000000ull / SAMPLE_RATE_HZ;
+
+class StreamSimTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        NhalStreamMock &mock = stream_.mock();
+        ON_CALL(mock, nhal_stream_set_config(_, _)).WillByDefault(Invoke(&mic_, &NhalStreamSim::set_config));
+        ON_CALL(mock, nhal_stream_start(_)).WillByDefault(Invoke(&mic_, &NhalStreamSim::start));
+        ON_CALL(mock, nhal_stream_stop(_)).WillByDefault(Invoke(&mic_, &NhalStreamSim::stop));
+        ON_CALL(mock, nhal_stream_acquire(_, _, _)).WillByDefault(Invoke(&mic_, &NhalStreamSim::acquire));
+        ON_CALL(mock, nhal_stream_release(_, _)).WillByDefault(Invoke(&mic_, &NhalStreamSim::release));
+        ON_CALL(mock, nhal_stream_get_stats(_, _)).WillByDefault(Invoke(&mic_, &NhalStreamSim::get_stats));
+
+        memset(&config_, 0, sizeof(config_));
+        config_.sample_rate_hz = SAMPLE_RATE_HZ;
+        config_.sample_size = sizeof(int16_t);
+        config_.buffer = ring_;
+        config_.buffer_size = sizeof(ring_);
+        config_.num_blocks = NUM_BLOCKS;
+        ASSERT_EQ(NHAL_OK, nhal_stream_set_config(&ctx_, &config_));
+    }
+
+    /**
+     * Consumer loop spending processing_ns of virtual time per block, for
+     * duration_ns of virtual time. Returns the samples it processed.
+     */
+    uint64_t consume(uint64_t processing_ns, uint64_t duration_ns, NhalVirtualClock &clock) {
+        uint64_t end_ns = clock.now_ns() + duration_ns;
+        uint64_t samples = 0;
+
+        while (clock.now_ns() < end_ns) {
+            nhal_stream_block_t block;
+            if (nhal_stream_acquire(&ctx_, &block, 100) != NHAL_OK) {
+                continue;
+            }
+            nhal_delay_microseconds((uint32_t)(processing_ns / 1000u));
+            samples += block.len / config_.sample_size;
+            EXPECT_EQ(NHAL_OK, nhal_stream_release(&ctx_, &block));
+        }
+        return samples;
+    }
+
+    NhalMockScope<NhalStreamMock, NiceMock<NhalStreamMock> > stream_;
+    NhalStreamSim mic_;
+    struct nhal_stream_context ctx_;
+    struct nhal_stream_config config_;
+    uint8_t ring_[NUM_BLOCKS * BLOCK_SAMPLES * sizeof(int16_t)];
+};
+
+TEST_F(StreamSimTest, WithoutClockBlocksOnlyCompleteOnRequest) {
+    nhal_stream_block_t block;
+
+    ASSERT_EQ(NHAL_OK, nhal_stream_start(&ctx_));
+    EXPECT_EQ(NHAL_ERR_TIMEOUT, nhal_stream_acquire(&ctx_, &block, 1000));
+    EXPECT_EQ(0u, mic_.stats().blocks_completed);
+
+    mic_.complete_block();
+    ASSERT_EQ(NHAL_OK, nhal_stream_acquire(&ctx_, &block, 0));
+    EXPECT_EQ(0u, block.sequence);
+    EXPECT_EQ(BLOCK_SAMPLES * sizeof(int16_t), block.len);
+    EXPECT_EQ(NHAL_OK, nhal_stream_release(&ctx_, &block));
+    EXPECT_EQ(NHAL_OK, nhal_stream_stop(&ctx_));
+}
+
+TEST_F(StreamSimTest, ConsumerSlowerThanTheSourceDropsBlocks) {
+    const uint64_t duration_ns = 10000000000ull;
+    const unsigned load_percent[] = { 50, 99, 110 };
+
+    for (unsigned load : load_percent) {
+        NhalVirtualClock clock;
+        ASSERT_EQ(NHAL_OK, nhal_stream_start(&ctx_));
+        uint64_t samples = consume(BLOCK_PERIOD_NS * load / 100u, duration_ns, clock);
+        struct nhal_stream_stats stats;
+        ASSERT_EQ(NHAL_OK, nhal_stream_get_stats(&ctx_, &stats));
+        ASSERT_EQ(NHAL_OK, nhal_stream_stop(&ctx_));
+
+        double rate = (double)samples * 1e9 / (double)duration_ns;
+        std::printf("consumer load %3u%%: %7.0f samples/s processed, %u of %u blocks dropped, max %u owned\n", load,
+                    rate, (unsigned)stats.blocks_dropped, (unsigned)(stats.blocks_completed + stats.blocks_dropped),
+                    (unsigned)stats.max_blocks_owned);
+        RecordProperty("dropped_at_" + std::to_string(load) + "_percent", (int)stats.blocks_dropped);
+        if (load < 100) {
+            EXPECT_EQ(0u, stats.blocks_dropped);
+            EXPECT_NEAR(SAMPLE_RATE_HZ, rate, SAMPLE_RATE_HZ * 0.01);
+        } else {
+            EXPECT_GT(stats.blocks_dropped, 0u);
+            EXPECT_LT(rate, SAMPLE_RATE_HZ);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark: host cost of the acquire/release path
+// ---------------------------------------------------------------------------
+
+TEST_F(StreamSimTest, AcquireReleaseThroughput) {
+    const unsigned BLOCKS = 20000;
+    NhalVirtualClock clock;
+    nhal_stream_block_t block;
+
+    ASSERT_EQ(NHAL_OK, nhal_stream_start(&ctx_));
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < BLOCKS; i++) {
+        ASSERT_EQ(NHAL_OK, nhal_stream_acquire(&ctx_, &block, 100));
+        ASSERT_EQ(i, block.sequence);
+        ASSERT_EQ(NHAL_OK, nhal_stream_release(&ctx_, &block));
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(NHAL_OK, nhal_stream_stop(&ctx_));
+
+    EXPECT_EQ(0u, mic_.stats().blocks_dropped);
+    std::printf("%u blocks: %.0f ns per acquire/release, %.2f M blocks/s, %.1f M samples/s on host\n", BLOCKS,
+                (double)ns / BLOCKS, BLOCKS * 1e3 / (double)ns, BLOCKS * (double)BLOCK_SAMPLES * 1e3 / (double)ns);
+    RecordProperty("acquire_release_ns", (int)(ns / BLOCKS));
+}
+
+}  // namespace
@@ -0,0 +1,201 @@
+/**
+ * @file nhal_uart_rs485_test.cpp
+ * @brief nhal_uart_rs485.h character and silence times, and RS-485 transactions on NhalRs485Sim in virtual time
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "nhal_rs485_sim.hpp"
+#include "nhal_uart_mock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+struct nhal_uart_context {
+    int unused;
+};
+
+namespace {
+
+struct nhal_uart_config make_config(uint32_t baudrate, nhal_uart_parity_t parity, nhal_uart_stop_bits_t stop_bits)
+{
+    struct nhal_uart_config cfg = {};
+    cfg.baudrate = baudrate;
+    cfg.parity = parity;
+    cfg.stop_bits = stop_bits;
+    cfg.data_bits = NHAL_UART_DATA_BITS_8;
+    return cfg;
+}
+
+TEST(UartRs485TimingTest, CharacterAndSilenceTimesFollowTheFrameFormat) {
+    struct Case {
+        const char *name;
+        nhal_uart_parity_t parity;
+        nhal_uart_stop_bits_t stop_bits;
+        uint32_t char_bits;
+        uint32_t inter_frame_bits;      // 3.5 characters, rounded up
+        uint32_t char_us_9600;
+        uint32_t inter_frame_us_9600;
+        uint32_t char_us_115200;
+        uint32_t inter_frame_us_115200;
+    };
+    const Case cases[] = {
+        { "8N1", NHAL_UART_PARITY_NONE, NHAL_UART_STOP_BITS_1, 10, 35, 1042, 3646, 87, 304 },
+        { "8E1", NHAL_UART_PARITY_EVEN, NHAL_UART_STOP_BITS_1, 11, 39, 1146, 4063, 96, 339 },
+        { "8E2", NHAL_UART_PARITY_EVEN, NHAL_UART_STOP_BITS_2, 12, 42, 1250, 4375, 105, 365 },
+    };
+    const struct nhal_uart_rs485_config rs485 = {};
+
+    for (const Case &c : cases) {
+        struct nhal_uart_config slow = make_config(9600, c.parity, c.stop_bits);
+        struct nhal_uart_config fast = make_config(115200, c.parity, c.stop_bits);
+        EXPECT_EQ(c.char_bits, nhal_uart_char_bits(&slow)) << c.name;
+        EXPECT_EQ(c.inter_frame_bits, nhal_uart_rs485_inter_frame_bits(&slow, &rs485)) << c.name;
+        EXPECT_EQ(c.char_us_9600, nhal_uart_bits_to_us(&slow, c.char_bits)) << c.name;
+        EXPECT_EQ(c.inter_frame_us_9600, nhal_uart_bits_to_us(&slow, c.inter_frame_bits)) << c.name;
+        EXPECT_EQ(c.char_us_115200, nhal_uart_bits_to_us(&fast, c.char_bits)) << c.name;
+        EXPECT_EQ(c.inter_frame_us_115200, nhal_uart_bits_to_us(&fast, c.inter_frame_bits)) << c.name;
+    }
+
+    // An explicit silence wins over 3.5 characters; no baud rate, no duration
+    struct nhal_uart_config cfg = make_config(0, NHAL_UART_PARITY_ODD, NHAL_UART_STOP_BITS_1);
+    cfg.data_bits = NHAL_UART_DATA_BITS_7;
+    struct nhal_uart_rs485_config fixed = {};
+    fixed.inter_frame_bits = 20;
+    EXPECT_EQ(10u, nhal_uart_char_bits(&cfg));
+    EXPECT_EQ(20u, nhal_uart_rs485_inter_frame_bits(&cfg, &fixed));
+    EXPECT_EQ(0u, nhal_uart_bits_to_us(&cfg, 100));
+}
+
+class UartRs485SimTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        NhalUartMock &uart = uart_.mock();
+        ON_CALL(uart, nhal_uart_set_config(_, _)).WillByDefault(Invoke(&link_, &NhalRs485Sim::set_config));
+        ON_CALL(uart, nhal_uart_rs485_set_config(_, _)).WillByDefault(Invoke(&link_, &NhalRs485Sim::rs485_set_config));
+        ON_CALL(uart, nhal_uart_rs485_transaction(_, _, _, _, _, _, _))
+            .WillByDefault(Invoke(&link_, &NhalRs485Sim::transaction));
+
+        // Modbus RTU at 9600 8E1: 11 bits per character, 39 bits of silence
+        struct nhal_uart_config cfg = make_config(9600, NHAL_UART_PARITY_EVEN, NHAL_UART_STOP_BITS_1);
+        ASSERT_EQ(NHAL_OK, nhal_uart_set_config(&ctx_, &cfg));
+        rs485_.de_active_high = true;
+        rs485_.de_assert_bits = 2;
+        rs485_.de_release_bits = 1;
+        ASSERT_EQ(NHAL_OK, nhal_uart_rs485_set_config(&ctx_, &rs485_));
+
+        // Read holding registers: 8-byte request, 7-byte response
+        link_.set_slave([](const std::vector<uint8_t> &request) {
+            return request.size() == 8 ? std::vector<uint8_t>(7, 0x5A) : std::vector<uint8_t>();
+        });
+    }
+
+    nhal_result_t poll(uint8_t *response, size_t response_max, size_t *response_len, uint32_t timeout_ms = 100) {
+        const uint8_t request[8] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x01, 0x84, 0x0A };
+        return nhal_uart_rs485_transaction(&ctx_, request, sizeof(request), response, response_max, response_len,
+                                           timeout_ms);
+    }
+
+    NhalVirtualClock clock_;
+    NhalRs485Sim link_;
+    NhalMockScope<NhalUartMock, NiceMock<NhalUartMock> > uart_;
+    struct nhal_uart_context ctx_;
+    struct nhal_uart_rs485_config rs485_ = {};
+};
+
+TEST_F(UartRs485SimTest, TransactionTurnsTheBusAroundOnTime) {
+    uint8_t response[16];
+    size_t response_len = 0;
+    const uint64_t silence_ns = link_.bits_to_ns(39);
+
+    ASSERT_EQ(NHAL_OK, poll(response, sizeof(response), &response_len));
+    EXPECT_EQ(7u, response_len);
+    EXPECT_EQ(0x5A, response[6]);
+
+    // DE leads the first start bit and trails the last stop bit
+    EXPECT_EQ(0u, link_.last(NhalRs485Sim::DE_ASSERT));
+    EXPECT_EQ(link_.bits_to_ns(2), link_.last(NhalRs485Sim::TX_START));
+    EXPECT_EQ(link_.bits_to_ns(8 * 11), link_.last(NhalRs485Sim::TX_END) - link_.last(NhalRs485Sim::TX_START));
+    EXPECT_EQ(link_.bits_to_ns(1), link_.last(NhalRs485Sim::DE_RELEASE) - link_.last(NhalRs485Sim::TX_END));
+
+    // The slave answers after 3.5 characters of silence, once the master has released the bus
+    EXPECT_EQ(silence_ns, link_.last(NhalRs485Sim::RX_START) - link_.last(NhalRs485Sim::TX_END));
+    EXPECT_GE(silence_ns * 2, 7u * link_.bits_to_ns(11));
+    EXPECT_GT(link_.last(NhalRs485Sim::RX_START), link_.last(NhalRs485Sim::DE_RELEASE));
+    EXPECT_EQ(link_.bits_to_ns(7 * 11), link_.last(NhalRs485Sim::RX_END) - link_.last(NhalRs485Sim::RX_START));
+
+    // The frame ends when the line has been silent again
+    EXPECT_EQ(link_.last(NhalRs485Sim::RX_END) + silence_ns, clock_.now_ns());
+    EXPECT_EQ(0u, link_.collisions());
+}
+
+TEST_F(UartRs485SimTest, FramesAreSeparatedByTheInterFrameSilence) {
+    const uint8_t broadcast[8] = { 0x00, 0x06, 0x00, 0x01, 0x00, 0x03, 0x98, 0x1A };
+    uint8_t response[16];
+    size_t response_len = 0;
+
+    // A broadcast returns at DE release, before the silence has elapsed
+    ASSERT_EQ(NHAL_OK, nhal_uart_rs485_transaction(&ctx_, broadcast, sizeof(broadcast), nullptr, 0, nullptr, 100));
+    uint64_t broadcast_end_ns = link_.last(NhalRs485Sim::TX_END);
+    EXPECT_EQ(link_.last(NhalRs485Sim::DE_RELEASE), clock_.now_ns());
+
+    // An immediate poll is held back until it has elapsed
+    ASSERT_EQ(NHAL_OK, poll(response, sizeof(response), &response_len));
+    EXPECT_EQ(broadcast_end_ns + link_.inter_frame_ns(), link_.last(NhalRs485Sim::DE_ASSERT));
+
+    // Back-to-back polls: the transaction already waited for it after the response
+    uint64_t response_end_ns = link_.last(NhalRs485Sim::RX_END);
+    ASSERT_EQ(NHAL_OK, poll(response, sizeof(response), &response_len));
+    EXPECT_EQ(response_end_ns + link_.inter_frame_ns(), link_.last(NhalRs485Sim::DE_ASSERT));
+
+    // A late poll starts at once
+    clock_.advance_us(10000);
+    uint64_t requested_ns = clock_.now_ns();
+    ASSERT_EQ(NHAL_OK, poll(response, sizeof(response), &response_len));
+    EXPECT_EQ(requested_ns, link_.last(NhalRs485Sim::DE_ASSERT));
+    EXPECT_EQ(4u, link_.requests().size());
+    EXPECT_EQ(0u, link_.collisions());
+}
+
+TEST_F(UartRs485SimTest, MissingLateAndOversizedResponses) {
+    uint8_t response[16];
+    size_t response_len = 1;
+
+    // Nobody answers: the timeout runs from DE release
+    const uint8_t unknown[2] = { 0x07, 0x11 };
+    ASSERT_EQ(NHAL_ERR_NO_RESPONSE, nhal_uart_rs485_transaction(&ctx_, unknown, sizeof(unknown), response,
+                                                                sizeof(response), &response_len, 50));
+    EXPECT_EQ(0u, response_len);
+    EXPECT_EQ(link_.last(NhalRs485Sim::DE_RELEASE) + 50000000u, clock_.now_ns());
+
+    // A slave slower than the timeout
+    link_.set_slave([](const std::vector<uint8_t> &) { return std::vector<uint8_t>(7, 0); }, 60000);
+    EXPECT_EQ(NHAL_ERR_NO_RESPONSE, poll(response, sizeof(response), &response_len, 50));
+    EXPECT_EQ(NHAL_OK, poll(response, sizeof(response), &response_len, 100));
+
+    // Truncated to the buffer
+    EXPECT_EQ(NHAL_ERR_BUFFER_OVERFLOW, poll(response, 4, &response_len));
+    EXPECT_EQ(4u, response_len);
+}
+
+TEST_F(UartRs485SimTest, DriverHeldTooLongCollidesWithTheResponse) {
+    uint8_t response[16];
+    size_t response_len = 0;
+
+    // DE released after 50 bit times, the slave answers after 39
+    rs485_.de_release_bits = 50;
+    ASSERT_EQ(NHAL_OK, nhal_uart_rs485_set_config(&ctx_, &rs485_));
+    ASSERT_EQ(NHAL_OK, poll(response, sizeof(response), &response_len));
+    EXPECT_LT(link_.last(NhalRs485Sim::RX_START), link_.last(NhalRs485Sim::DE_RELEASE));
+    EXPECT_EQ(1u, link_.collisions());
+
+    // Leaving RS-485 mode
+    struct nhal_uart_config cfg = make_config(9600, NHAL_UART_PARITY_EVEN, NHAL_UART_STOP_BITS_1);
+    ASSERT_EQ(NHAL_OK, nhal_uart_set_config(&ctx_, &cfg));
+    EXPECT_EQ(NHAL_ERR_NOT_CONFIGURED, poll(response, sizeof(response), &response_len));
+}
+
+}  // namespace
@@ -0,0 +1,581 @@
+/**
+ * @file nhal_vcd_recorder_test.cpp
+ * @brief NhalVcdRecorder waveforms decoded back from the VCD file (SPI modes 0-3, I2C, UART frame formats, pins),
+ * model pass-through and constant memory
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "nhal_i2c_mock.hpp"
+#include "nhal_pin_mock.hpp"
+#include "nhal_spi_mock.hpp"
+#include "nhal_uart_mock.hpp"
+#include "nhal_vcd_recorder.hpp"
+#include "nhal_virtual_clock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+struct nhal_i2c_context {
+    int unused;
+};
+
+struct nhal_pin_context {
+    int unused;
+};
+
+struct nhal_spi_context {
+    int unused;
+};
+
+struct nhal_uart_context {
+    int unused;
+};
+
+namespace {
+
+/** @brief Value changes of a VCD file, in file order */
+class VcdTrace {
+public:
+    struct Change {
+        uint64_t time_ps;
+        std::string name;
+        char value;
+    };
+
+    VcdTrace() {}
+
+    explicit VcdTrace(const std::string &path) {
+        std::ifstream file(path.c_str());
+        std::map<std::string, std::string> names;
+        std::string line;
+        uint64_t time_ps = 0;
+
+        while (std::getline(file, line)) {
+            std::istringstream words(line);
+            std::string word;
+            words >> word;
+            if (word == "$var") {
+                std::string type, width, id, name;
+                words >> type >> width >> id >> name;
+                names[id] = name;
+            } else if (!word.empty() && word[0] == '#') {
+                time_ps = std::stoull(word.substr(1));
+            } else if (!word.empty() && std::strchr("01xz", word[0]) != nullptr) {
+                Change change = { time_ps, names[word.substr(1)], word[0] };
+                changes.push_back(change);
+            }
+        }
+    }
+
+    /** @brief Value of a signal at a time, after the changes made at that time */
+    char value_at(const std::string &name, uint64_t time_ps) const {
+        char value = 'x';
+        for (const Change &change : changes) {
+            if (change.time_ps > time_ps) {
+                break;
+            }
+            if (change.name == name) {
+                value = change.value;
+            }
+        }
+        return value;
+    }
+
+    /** @brief Changes in [from_ps, to_ps), starting from the levels at from_ps */
+    VcdTrace window(uint64_t from_ps, uint64_t to_ps) const {
+        VcdTrace part;
+        std::map<std::string, char> levels;
+        for (const Change &change : changes) {
+            if (change.time_ps <= from_ps) {
+                levels[change.name] = change.value;
+            }
+        }
+        for (const std::pair<const std::string, char> &level : levels) {
+            Change change = { from_ps, level.first, level.second };
+            part.changes.push_back(change);
+        }
+        for (const Change &change : changes) {
+            if (change.time_ps > from_ps && change.time_ps < to_ps) {
+                part.changes.push_back(change);
+            }
+        }
+        return part;
+    }
+
+    /**
+     * @brief I2C decoded from SCL/SDA: one entry per START, each a list of
+     *        9-bit words (byte << 1 | NACK)
+     */
+    std::vector<std::vector<unsigned> > i2c_segments() const {
+        std::vector<std::vector<unsigned> > segments;
+        std::vector<int> bits;
+        char scl = 'x';
+        char sda = 'x';
+
+        for (const Change &change : changes) {
+            if (change.name == "scl") {
+                if (scl == '0' && change.value == '1') {
+                    bits.push_back(sda == '1' ? 1 : 0);
+                }
+                scl = change.value;
+            } else if (change.name == "sda") {
+                if (scl == '1' && sda == '1' && change.value == '0') {
+                    segments.push_back(std::vector<unsigned>());
+                    bits.clear();
+                }
+                sda = change.value;
+            }
+            if (bits.size() == 9 && !segments.empty()) {
+                unsigned word = 0;
+                for (int bit : bits) {
+                    word = (word << 1) | (unsigned)bit;
+                }
+                segments.back().push_back(word);
+                bits.clear();
+            }
+        }
+        return segments;
+    }
+
+    /**
+     * @brief UART frames on a line, sampled mid-bit; a bad parity or stop bit
+     *        is decoded as 0xFFFF
+     */
+    std::vector<unsigned> uart_frames(const std::string &name, uint32_t baud, unsigned data_bits = 8,
+                                      nhal_uart_parity_t parity = NHAL_UART_PARITY_NONE,
+                                      unsigned stop_bits = 1) const {
+        const uint64_t bit_ps = 1000000000000ull / baud;
+        const unsigned frame_bits = 1 + data_bits + (parity != NHAL_UART_PARITY_NONE ? 1 : 0) + stop_bits;
+        std::vector<unsigned> frames;
+        uint64_t idle_from = 0;
+        char level = 'x';
+
+        for (const Change &change : changes) {
+            if (change.name != name) {
+                continue;
+            }
+            if (level == '1' && change.value == '0' && change.time_ps >= idle_from) {
+                unsigned word = 0;
+                unsigned ones = 0;
+                for (unsigned bit = 1; bit < frame_bits; bit++) {
+                    if (value_at(name, change.time_ps + bit_ps * (2 * bit + 1) / 2) == '1') {
+                        word |= 1u << (bit - 1);
+                        ones += bit <= data_bits + (parity != NHAL_UART_PARITY_NONE ? 1 : 0) ? 1 : 0;
+                    }
+                }
+                unsigned stop_mask = ((1u << stop_bits) - 1) << (frame_bits - 1 - stop_bits);
+                bool parity_ok = parity == NHAL_UART_PARITY_NONE || (ones & 1u) == (parity == NHAL_UART_PARITY_ODD);
+                frames.push_back((word & stop_mask) == stop_mask && parity_ok ? word & ((1u << data_bits) - 1)
+                                                                               : 0xFFFFu);
+                idle_from = change.time_ps + (frame_bits - 1) * bit_ps;
+            }
+            level = change.value;
+        }
+        return frames;
+    }
+
+    /** @brief One SPI byte as seen on the sampling edges */
+    struct SpiByte {
+        uint8_t mosi;
+        int miso;       /**< -1 when MISO was not driven */
+
+        bool operator==(const SpiByte &other) const { return mosi == other.mosi && miso == other.miso; }
+    };
+
+    /**
+     * @brief SPI decoded from SCK/MOSI/MISO/CS for a mode: data is sampled on
+     *        the leading SCK edge with CPHA 0 and on the trailing one with
+     *        CPHA 1, as it stood before the edge
+     */
+    std::vector<SpiByte> spi_bytes(nhal_spi_mode_t mode, bool lsb_first = false) const {
+        const bool cpol = mode == NHAL_SPI_MODE_2 || mode == NHAL_SPI_MODE_3;
+        const bool cpha = mode == NHAL_SPI_MODE_1 || mode == NHAL_SPI_MODE_3;
+        // Leading edge leaves the idle level
+        const char sample_level = (cpol != cpha) ? '0' : '1';
+        std::vector<SpiByte> bytes;
+        unsigned mosi = 0;
+        unsigned miso = 0;
+        bool driven = true;
+        unsigned bits = 0;
+        char sck = 'x';
+
+        for (const Change &change : changes) {
+            if (change.name != "sck") {
+                continue;
+            }
+            bool edge = sck != 'x' && sck != change.value;
+            if (edge && change.value == sample_level && value_at("cs", change.time_ps) == '0') {
+                char mosi_bit = value_at("mosi", change.time_ps - 1);
+                char miso_bit = value_at("miso", change.time_ps - 1);
+                unsigned shift = lsb_first ? bits : 7 - bits;
+                mosi |= (mosi_bit == '1' ? 1u : 0u) << shift;
+                miso |= (miso_bit == '1' ? 1u : 0u) << shift;
+                driven = driven && (miso_bit == '0' || miso_bit == '1');
+                if (++bits == 8) {
+                    SpiByte byte = { (uint8_t)mosi, driven ? (int)miso : -1 };
+                    bytes.push_back(byte);
+                    mosi = miso = bits = 0;
+                    driven = true;
+                }
+            }
+            sck = change.value;
+        }
+        return bytes;
+    }
+
+    std::vector<Change> changes;
+};
+
+std::string vcd_path(const char *name)
+{
+    return ::testing::TempDir() + name;
+}
+
+class VcdRecorderTest : public ::testing::Test {
+protected:
+    static nhal_i2c_address_t ten_bit_address() {
+        nhal_i2c_address_t address;
+        address.type = NHAL_I2C_10BIT_ADDR;
+        address.addr.address_10bit = 0x2A5;
+        return address;
+    }
+
+    NhalMockScope<NhalI2cMock, NiceMock<NhalI2cMock> > i2c_;
+    NhalMockScope<NhalUartMock, NiceMock<NhalUartMock> > uart_;
+    struct nhal_i2c_context i2c_ctx_;
+    struct nhal_uart_context uart_ctx_;
+};
+
+TEST_F(VcdRecorderTest, TenBitReadSendsOnlyTheFirstAddressByteAfterRepeatedStart) {
+    const std::string path = vcd_path("ten_bit.vcd");
+    {
+        NhalVirtualClock clock;
+        NhalVcdRecorder vcd(path);
+        vcd.attach_i2c(&i2c_ctx_, vcd.add_i2c_bus("i2c", 400000));
+        const uint8_t reg = 0x10;
+        uint8_t data[2] = { 0xAB, 0xCD };
+
+        ASSERT_EQ(NHAL_OK, vcd.i2c_master_write_read_reg(&i2c_ctx_, ten_bit_address(), &reg, 1, data, sizeof(data)));
+        ASSERT_EQ(NHAL_OK, vcd.i2c_master_read(&i2c_ctx_, ten_bit_address(), data, 1));
+    }
+
+    // 0x2A5: 11110 10 R/W header, then the low 8 bits; every byte ACKed but the last read
+    const std::vector<std::vector<unsigned> > expected = {
+        { 0xF4u << 1, 0xA5u << 1, 0x10u << 1 },
+        { 0xF5u << 1, 0xABu << 1, (0xCDu << 1) | 1 },
+        { 0xF4u << 1, 0xA5u << 1 },
+        { 0xF5u << 1, (0xABu << 1) | 1 },
+    };
+    EXPECT_EQ(expected, VcdTrace(path).i2c_segments());
+}
+
+TEST_F(VcdRecorderTest, RecordingPassesTheModelResultThrough) {
+    const std::string path = vcd_path("pass_through.vcd");
+    nhal_result_t answer = NHAL_ERR_NO_RESPONSE;
+    auto eeprom = [&answer](struct nhal_i2c_context *, nhal_i2c_address_t, const uint8_t *, size_t, uint8_t *data,
+                            size_t data_len) {
+        if (answer == NHAL_OK) {
+            memset(data, 0x5A, data_len);
+        }
+        return answer;
+    };
+    nhal_i2c_address_t address;
+    address.type = NHAL_I2C_7BIT_ADDR;
+    address.addr.address_7bit = 0x50;
+    {
+        NhalVirtualClock clock;
+        NhalVcdRecorder vcd(path);
+        vcd.attach_i2c(&i2c_ctx_, vcd.add_i2c_bus("i2c", 100000));
+        ON_CALL(i2c_.mock(), nhal_i2c_master_write_read_reg(_, _, _, _, _, _))
+            .WillByDefault(Invoke(vcd.recording(&NhalVcdRecorder::i2c_master_write_read_reg, eeprom)));
+        const uint8_t reg = 0x00;
+        uint8_t data[1] = { 0 };
+
+        // A failed call reaches the caller and leaves no waveform behind
+        EXPECT_EQ(NHAL_ERR_NO_RESPONSE, nhal_i2c_master_write_read_reg(&i2c_ctx_, address, &reg, 1, data, 1));
+        EXPECT_EQ(0u, vcd.transitions());
+        EXPECT_EQ(0u, clock.now_ns());
+
+        answer = NHAL_OK;
+        EXPECT_EQ(NHAL_OK, nhal_i2c_master_write_read_reg(&i2c_ctx_, address, &reg, 1, data, 1));
+        EXPECT_EQ(0x5A, data[0]);
+        EXPECT_GT(clock.now_ns(), 0u);
+    }
+
+    // The recorded read data is the model's answer
+    const std::vector<std::vector<unsigned> > expected = {
+        { 0xA0u << 1, 0x00u << 1 },
+        { 0xA1u << 1, (0x5Au << 1) | 1 },
+    };
+    EXPECT_EQ(expected, VcdTrace(path).i2c_segments());
+}
+
+TEST_F(VcdRecorderTest, UartReadRecordsReceivedFrames) {
+    const std::string path = vcd_path("uart.vcd");
+    const uint8_t reply[] = { 'O', 'K', '\r', '\n' };
+    const uint8_t command[] = { 'A', 'T', '\r' };
+    {
+        NhalVirtualClock clock;
+        NhalVcdRecorder vcd(path);
+        vcd.attach_uart(&uart_ctx_, vcd.add_uart_line("uart", "tx", 115200));
+        vcd.attach_uart_rx(&uart_ctx_, vcd.add_uart_line("uart", "rx", 115200));
+        auto modem = [&reply](struct nhal_uart_context *, uint8_t *data, size_t len) {
+            memcpy(data, reply, len);
+            return NHAL_OK;
+        };
+        ON_CALL(uart_.mock(), nhal_uart_write(_, _, _)).WillByDefault(Invoke(&vcd, &NhalVcdRecorder::uart_write));
+        ON_CALL(uart_.mock(), nhal_uart_read(_, _, _))
+            .WillByDefault(Invoke(vcd.recording(&NhalVcdRecorder::uart_read, modem)));
+        uint8_t received[sizeof(reply)];
+
+        ASSERT_EQ(NHAL_OK, nhal_uart_write(&uart_ctx_, command, sizeof(command)));
+        ASSERT_EQ(NHAL_OK, nhal_uart_read(&uart_ctx_, received, sizeof(received)));
+
+        // Each direction takes 10 bit times per byte, one after the other
+        EXPECT_NEAR(7 * 10 * 1e9 / 115200, (double)clock.now_ns(), 2.0);
+    }
+
+    VcdTrace trace(path);
+    EXPECT_EQ(std::vector<unsigned>(command, command + sizeof(command)), trace.uart_frames("tx", 115200));
+    EXPECT_EQ(std::vector<unsigned>(reply, reply + sizeof(reply)), trace.uart_frames("rx", 115200));
+}
+
+TEST_F(VcdRecorderTest, UartFramesFollowTheConfiguredFormat) {
+    const std::string path = vcd_path("uart_format.vcd");
+    const uint8_t data[] = { 0x00, 0x41, 0x7F, 0x96 };
+    struct nhal_uart_config seven_even = {};
+    seven_even.baudrate = 9600;
+    seven_even.data_bits = NHAL_UART_DATA_BITS_7;
+    seven_even.parity = NHAL_UART_PARITY_EVEN;
+    seven_even.stop_bits = NHAL_UART_STOP_BITS_1;
+    struct nhal_uart_config eight_odd = seven_even;
+    eight_odd.baudrate = 19200;
+    eight_odd.data_bits = NHAL_UART_DATA_BITS_8;
+    eight_odd.parity = NHAL_UART_PARITY_ODD;
+    eight_odd.stop_bits = NHAL_UART_STOP_BITS_2;
+    {
+        NhalVirtualClock clock;
+        NhalVcdRecorder vcd(path);
+        vcd.attach_uart(&uart_ctx_, vcd.add_uart_line("uart", "tx", seven_even));
+        ON_CALL(uart_.mock(), nhal_uart_set_config(_, _)).WillByDefault(Invoke(&vcd, &NhalVcdRecorder::uart_set_config));
+        ON_CALL(uart_.mock(), nhal_uart_write(_, _, _)).WillByDefault(Invoke(&vcd, &NhalVcdRecorder::uart_write));
+
+        // 7E1: 10 bit times per character, the top data bit is not sent
+        clock.advance_us(1000);
+        uint64_t start_ns = clock.now_ns();
+        ASSERT_EQ(NHAL_OK, nhal_uart_write(&uart_ctx_, data, sizeof(data)));
+        EXPECT_NEAR(4 * 10 * 1e9 / 9600, (double)(clock.now_ns() - start_ns), 2.0);
+
+        // 8O2 after reconfiguration: 12 bit times per character
+        clock.advance_us(10000);
+        start_ns = clock.now_ns();
+        ASSERT_EQ(NHAL_OK, nhal_uart_set_config(&uart_ctx_, &eight_odd));
+        ASSERT_EQ(NHAL_OK, nhal_uart_write(&uart_ctx_, data, sizeof(data)));
+        EXPECT_NEAR(4 * 12 * 1e9 / 19200, (double)(clock.now_ns() - start_ns), 2.0);
+        EXPECT_EQ(NHAL_ERR_INVALID_ARG, vcd.uart_set_config(&uart_ctx_, nullptr));
+    }
+
+    VcdTrace trace(path);
+    const uint64_t split_ps = 1000000000ull + (uint64_t)(4 * 10 * 1e12 / 9600) + 5000000000ull;
+    VcdTrace first = trace.window(0, split_ps);
+    VcdTrace second = trace.window(split_ps, UINT64_MAX);
+    const std::vector<unsigned> seven = { 0x00, 0x41, 0x7F, 0x16 };
+    const std::vector<unsigned> eight = { 0x00, 0x41, 0x7F, 0x96 };
+    EXPECT_EQ(seven, first.uart_frames("tx", 9600, 7, NHAL_UART_PARITY_EVEN, 1));
+    EXPECT_EQ(eight, second.uart_frames("tx", 19200, 8, NHAL_UART_PARITY_ODD, 2));
+
+    // Decoded with the wrong parity, every frame is rejected
+    EXPECT_EQ(std::vector<unsigned>(4, 0xFFFFu), second.uart_frames("tx", 19200, 8, NHAL_UART_PARITY_EVEN, 2));
+}
+
+TEST_F(VcdRecorderTest, SpiModesIdleAndSampleOnTheirEdges) {
+    const nhal_spi_mode_t modes[] = { NHAL_SPI_MODE_0, NHAL_SPI_MODE_1, NHAL_SPI_MODE_2, NHAL_SPI_MODE_3 };
+    const uint8_t mosi[] = { 0xA5, 0x01, 0x80 };
+    const uint8_t miso[] = { 0x3C, 0xFE, 0x7F };
+    const uint32_t clock_hz = 1000000;
+    const uint64_t half_ps = 500000;
+
+    for (nhal_spi_mode_t mode : modes) {
+        const bool cpol = mode == NHAL_SPI_MODE_2 || mode == NHAL_SPI_MODE_3;
+        const bool cpha = mode == NHAL_SPI_MODE_1 || mode == NHAL_SPI_MODE_3;
+        const char idle = cpol ? '1' : '0';
+        const std::string path = vcd_path("spi_mode.vcd");
+        uint64_t end_ns = 0;
+        {
+            NhalVcdRecorder vcd(path);
+            NhalVcdRecorder::SpiBus bus = vcd.add_spi_bus("spi", clock_hz, mode);
+            end_ns = vcd.spi_transfer(bus, 1000, mosi, miso, sizeof(mosi));
+        }
+        VcdTrace trace(path);
+
+        // 3 bytes, 16 clock edges each, framed by chip select
+        std::vector<uint64_t> edges;
+        for (const VcdTrace::Change &change : trace.changes) {
+            if (change.name == "sck" && change.time_ps != 0) {
+                edges.push_back(change.time_ps);
+            }
+        }
+        ASSERT_EQ(48u, edges.size()) << "mode " << mode;
+
+        // SCK idles at CPOL around the transfer and while CS falls and rises
+        const uint64_t cs_low_ps = 1000000;
+        EXPECT_EQ(idle, trace.value_at("sck", 0)) << "mode " << mode;
+        EXPECT_EQ('0', trace.value_at("cs", cs_low_ps)) << "mode " << mode;
+        EXPECT_EQ(idle, trace.value_at("sck", cs_low_ps)) << "mode " << mode;
+        EXPECT_EQ(cs_low_ps + (cpha ? 1 : 2) * half_ps, edges.front()) << "mode " << mode;
+        EXPECT_EQ('1', trace.value_at("cs", end_ns * 1000)) << "mode " << mode;
+        EXPECT_EQ(idle, trace.value_at("sck", end_ns * 1000)) << "mode " << mode;
+        EXPECT_EQ(end_ns * 1000 - (cpha ? 2 : 1) * half_ps, edges.back()) << "mode " << mode;
+        EXPECT_EQ('z', trace.value_at("miso", end_ns * 1000)) << "mode " << mode;
+
+        // CPHA 0: the first bit is set up half a clock before the leading edge;
+        // CPHA 1: it changes on the leading edge and is sampled on the trailing one
+        const uint64_t first_bit_ps = cpha ? edges[0] : edges[0] - half_ps;
+        EXPECT_EQ('1', trace.value_at("mosi", first_bit_ps)) << "mode " << mode;
+        EXPECT_EQ('x', trace.value_at("mosi", first_bit_ps - 1)) << "mode " << mode;
+
+        // After that, data only changes on the shifting edges, never on the sampling ones
+        std::vector<uint64_t> sampling;
+        std::vector<uint64_t> shifting(1, first_bit_ps);
+        for (size_t i = 0; i < edges.size(); i++) {
+            ((i % 2 == 1) == cpha ? sampling : shifting).push_back(edges[i]);
+        }
+        for (const VcdTrace::Change &change : trace.changes) {
+            if ((change.name == "mosi" || change.name == "miso") && change.time_ps != 0 &&
+                change.time_ps < end_ns * 1000) {
+                EXPECT_EQ(0, std::count(sampling.begin(), sampling.end(), change.time_ps))
+                    << "mode " << mode << ": " << change.name << " changes on a sampling edge at " << change.time_ps;
+                EXPECT_NE(0, std::count(shifting.begin(), shifting.end(), change.time_ps))
+                    << "mode " << mode << ": " << change.name << " changes between edges at " << change.time_ps;
+            }
+        }
+
+        const std::vector<VcdTrace::SpiByte> expected = { { 0xA5, 0x3C }, { 0x01, 0xFE }, { 0x80, 0x7F } };
+        EXPECT_EQ(expected, trace.spi_bytes(mode)) << "mode " << mode;
+    }
+}
+
+TEST_F(VcdRecorderTest, SpiHandlerRecordsTheWriteThenTheReadPhase) {
+    const std::string path = vcd_path("spi_handler.vcd");
+    NhalMockScope<NhalSpiMock, NiceMock<NhalSpiMock> > spi;
+    struct nhal_spi_context spi_ctx;
+    const uint8_t command[] = { 0x9F };
+    const uint8_t id[] = { 0xEF, 0x40, 0x18 };
+    {
+        NhalVirtualClock clock;
+        NhalVcdRecorder vcd(path);
+        vcd.attach_spi(&spi_ctx, vcd.add_spi_bus("spi", 8000000, NHAL_SPI_MODE_3, NHAL_SPI_BIT_ORDER_LSB_FIRST));
+        auto flash = [&id](struct nhal_spi_context *, const uint8_t *, size_t, uint8_t *rx, size_t rx_len) {
+            memcpy(rx, id, rx_len);
+            return NHAL_OK;
+        };
+        ON_CALL(spi.mock(), nhal_spi_master_write_read(_, _, _, _, _))
+            .WillByDefault(Invoke(vcd.recording(&NhalVcdRecorder::spi_write_read, flash)));
+        uint8_t rx[sizeof(id)];
+
+        ASSERT_EQ(NHAL_OK, nhal_spi_master_write_read(&spi_ctx, command, sizeof(command), rx, sizeof(rx)));
+        // Half a clock of setup and hold around 4 bytes of 8 clocks each
+        EXPECT_EQ(4u * 8 * 125 + 125, clock.now_ns());
+    }
+
+    // MOSI idles high and MISO is not driven during the other phase
+    const std::vector<VcdTrace::SpiByte> expected = { { 0x9F, -1 }, { 0xFF, 0xEF }, { 0xFF, 0x40 }, { 0xFF, 0x18 } };
+    EXPECT_EQ(expected, VcdTrace(path).spi_bytes(NHAL_SPI_MODE_3, true));
+}
+
+TEST_F(VcdRecorderTest, PinChangesAreRecordedAtTheirVirtualTime) {
+    const std::string path = vcd_path("pin.vcd");
+    NhalMockScope<NhalPinMock, NiceMock<NhalPinMock> > pin;
+    struct nhal_pin_context led;
+    struct nhal_pin_context other;
+    {
+        NhalVirtualClock clock;
+        NhalVcdRecorder vcd(path);
+        vcd.attach_pin(&led, vcd.add_signal("gpio", "led"));
+        ON_CALL(pin.mock(), nhal_pin_set_state(_, _)).WillByDefault(Invoke(&vcd, &NhalVcdRecorder::pin_set_state));
+
+        clock.advance_us(10);
+        ASSERT_EQ(NHAL_OK, nhal_pin_set_state(&led, NHAL_PIN_HIGH));
+        ASSERT_EQ(NHAL_OK, nhal_pin_set_state(&led, NHAL_PIN_HIGH));
+        clock.advance_us(5);
+        ASSERT_EQ(NHAL_OK, nhal_pin_set_state(&led, NHAL_PIN_LOW));
+        ASSERT_EQ(NHAL_OK, nhal_pin_set_state(&other, NHAL_PIN_HIGH));
+        clock.advance_us(1);
+        ASSERT_EQ(NHAL_OK, nhal_pin_set_state(&led, NHAL_PIN_HIGH));
+        // The initial dump and three changes
+        EXPECT_EQ(4u, vcd.transitions());
+    }
+
+    // Unknown until first driven; a repeated level and an unattached pin write nothing
+    VcdTrace trace(path);
+    ASSERT_EQ(4u, trace.changes.size());
+    const uint64_t times_ps[] = { 0, 10000000, 15000000, 16000000 };
+    const char values[] = { 'x', '1', '0', '1' };
+    for (size_t i = 0; i < 4; i++) {
+        EXPECT_EQ("led", trace.changes[i].name);
+        EXPECT_EQ(times_ps[i], trace.changes[i].time_ps);
+        EXPECT_EQ(values[i], trace.changes[i].value);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Long capture: memory stays constant, recording rate
+// ---------------------------------------------------------------------------
+
+long resident_kib()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    return -1;
+}
+
+TEST_F(VcdRecorderTest, LongCaptureRunsInConstantMemory) {
+    const size_t CHUNK = 4096;
+    const unsigned CHUNKS = 256;
+    NhalVcdRecorder vcd("/dev/null");
+    NhalVcdRecorder::UartLine line = vcd.add_uart_line("uart", "tx", 1000000);
+    std::vector<uint8_t> data(CHUNK);
+    uint64_t t = 0;
+
+    for (size_t i = 0; i < CHUNK; i++) {
+        data[i] = (uint8_t)(i * 37);
+    }
+    // The first chunk brings the output buffer in
+    t = vcd.uart_frames(line, t, data.data(), CHUNK);
+    long before = resident_kib();
+    if (before < 0) {
+        GTEST_SKIP() << "no /proc/self/status";
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned n = 1; n < CHUNKS; n++) {
+        t = vcd.uart_frames(line, t, data.data(), CHUNK);
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    long growth = resident_kib() - before;
+
+    EXPECT_LT(growth, 256) << "resident memory grew by " << growth << " KiB";
+    std::printf("%u KiB of UART frames: %llu transitions, %.0f ns/transition, resident growth %ld KiB\n",
+                (unsigned)(CHUNK * CHUNKS / 1024), (unsigned long long)vcd.transitions(),
+                (double)ns / (double)vcd.transitions(), growth);
+    RecordProperty("resident_growth_kib", (int)growth);
+}
+
+}  // namespace
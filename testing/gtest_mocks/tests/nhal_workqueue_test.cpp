@@ -0,0 +1,180 @@
+/**
+ * @file nhal_workqueue_test.cpp
+ * @brief nhal_workqueue.h ordering and coalescing, and a multi-threaded post/run stress test
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static uint32_t test_timestamp_us()
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#define NHAL_WORKQUEUE_TIMESTAMP() test_timestamp_us()
+#include "nhal_workqueue.h"
+
+namespace {
+
+std::vector<int> run_order;
+
+void record_handler(struct nhal_work *work)
+{
+    run_order.push_back((int)(intptr_t)work->arg);
+}
+
+TEST(WorkqueueTest, RunsByPriorityThenPostingOrder) {
+    struct nhal_workqueue wq;
+    struct nhal_work items[6];
+    const uint8_t priorities[6] = { 3, 1, 3, 0, 1, 2 };
+
+    nhal_workqueue_init(&wq, nullptr, nullptr);
+    for (int i = 0; i < 6; i++) {
+        nhal_work_init(&items[i], record_handler, (void *)(intptr_t)i, priorities[i]);
+        EXPECT_TRUE(nhal_workqueue_post(&wq, &items[i]));
+    }
+    run_order.clear();
+    EXPECT_EQ(6u, nhal_workqueue_run(&wq, 0));
+    EXPECT_EQ((std::vector<int>{ 3, 1, 4, 5, 0, 2 }), run_order);
+    EXPECT_EQ(0u, nhal_workqueue_run(&wq, 0));
+}
+
+TEST(WorkqueueTest, PendingPostsCoalesce) {
+    struct nhal_workqueue wq;
+    struct nhal_work item;
+    int notified = 0;
+
+    nhal_workqueue_init(&wq, [](void *arg) { (*(int *)arg)++; }, &notified);
+    nhal_work_init(&item, record_handler, (void *)(intptr_t)7, 0);
+    EXPECT_TRUE(nhal_workqueue_post(&wq, &item));
+    EXPECT_FALSE(nhal_workqueue_post(&wq, &item));
+    EXPECT_EQ(1, notified);
+
+    run_order.clear();
+    EXPECT_EQ(1u, nhal_workqueue_run(&wq, 0));
+    EXPECT_EQ(1u, run_order.size());
+    EXPECT_EQ(1u, wq.stats[0].posted);
+    EXPECT_EQ(1u, wq.stats[0].coalesced);
+    EXPECT_EQ(1u, wq.stats[0].executed);
+}
+
+// ---------------------------------------------------------------------------
+// Stress: producer threads standing in for interrupts, one worker thread
+// ---------------------------------------------------------------------------
+
+struct StressItem {
+    struct nhal_work work;
+    std::atomic<uint32_t> queued{0};     /**< Posts that returned true. */
+    std::atomic<uint32_t> runs{0};
+};
+
+void stress_handler(struct nhal_work *work)
+{
+    static_cast<StressItem *>(work->arg)->runs.fetch_add(1, std::memory_order_relaxed);
+}
+
+class Semaphore {
+public:
+    void give() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        count_++;
+        cv_.notify_one();
+    }
+    void take() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return count_ > 0; });
+        count_--;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    unsigned count_ = 0;
+};
+
+TEST(WorkqueueStress, EveryQueuedPostRunsExactlyOnce) {
+    const unsigned PRODUCERS = 8;
+    const unsigned ITEMS = 1024;
+    const uint32_t POSTS_PER_PRODUCER = 50000;
+    static struct nhal_workqueue wq;
+    static StressItem items[ITEMS];
+    Semaphore sem;
+    std::atomic<bool> done(false);
+
+    nhal_workqueue_init(&wq, [](void *arg) { static_cast<Semaphore *>(arg)->give(); }, &sem);
+    for (unsigned i = 0; i < ITEMS; i++) {
+        nhal_work_init(&items[i].work, stress_handler, &items[i], (uint8_t)(i % NHAL_WORKQUEUE_PRIORITIES));
+    }
+
+    std::thread worker([&] {
+        while (!done.load()) {
+            sem.take();
+            nhal_workqueue_run(&wq, 0);
+        }
+        nhal_workqueue_run(&wq, 0);
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (unsigned p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([p] {
+            // Producers share items, so posts race with each other and with the worker re-arming them
+            uint32_t state = p * 2654435761u + 1;
+            for (uint32_t n = 0; n < POSTS_PER_PRODUCER; n++) {
+                state = state * 1664525u + 1013904223u;
+                StressItem &item = items[(state >> 16) % ITEMS];
+                if (nhal_workqueue_post(&wq, &item.work)) {
+                    item.queued.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (n % 32 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread &t : producers) {
+        t.join();
+    }
+    done.store(true);
+    sem.give();
+    worker.join();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t queued = 0;
+    uint64_t runs = 0;
+    uint64_t coalesced = 0;
+    for (unsigned i = 0; i < ITEMS; i++) {
+        ASSERT_EQ(items[i].queued.load(), items[i].runs.load()) << "item " << i;
+        EXPECT_EQ(0u, items[i].work.pending) << "item " << i;
+        queued += items[i].queued.load();
+        runs += items[i].runs.load();
+    }
+    uint64_t executed = 0;
+    for (unsigned p = 0; p < NHAL_WORKQUEUE_PRIORITIES; p++) {
+        EXPECT_EQ(nullptr, wq.posted[p]);
+        EXPECT_EQ(nullptr, wq.ready_head[p]);
+        executed += wq.stats[p].executed;
+        coalesced += wq.stats[p].coalesced;
+    }
+    EXPECT_EQ(runs, executed);
+    EXPECT_EQ((uint64_t)PRODUCERS * POSTS_PER_PRODUCER, queued + coalesced);
+
+    std::printf("%u producers, %u posts: %llu queued, %llu coalesced, every queued post ran once, %.0f ns/post\n",
+                PRODUCERS, PRODUCERS * POSTS_PER_PRODUCER, (unsigned long long)queued,
+                (unsigned long long)coalesced, (double)ns / (PRODUCERS * POSTS_PER_PRODUCER));
+    for (unsigned p = 0; p < NHAL_WORKQUEUE_PRIORITIES; p++) {
+        std::printf("  priority %u: mean latency %.1f us, max %u us\n", p,
+                    wq.stats[p].executed ? (double)wq.stats[p].latency_total / wq.stats[p].executed : 0.0,
+                    (unsigned)wq.stats[p].latency_max);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,94 @@
+/**
+ * @file nhal_ticks_bench.c
+ * @brief Read cost of nhal_get_timestamp_ticks() against clock_gettime()
+ *
+ * Also checks that the counter is monotonic and that tick to nanosecond
+ * conversion agrees with CLOCK_MONOTONIC_RAW; exits non-zero if not.
+ * Timings are reported, not checked.
+ */
+
+#include "nhal_ticks.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define READS           10000000u
+#define ACCURACY_NS     100000000u      /**< Interval used for the conversion check. */
+#define ACCURACY_PPM    5000u
+
+static uint64_t clock_ns(clockid_t id)
+{
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static double ns_per_read(uint64_t start_ns, uint64_t end_ns)
+{
+    return (double)(end_ns - start_ns) / READS;
+}
+
+int main(void)
+{
+    struct nhal_tick_calibration cal;
+    uint64_t start, end, previous, ticks_start, ns_start, measured_ns, expected_ns, error_ppm;
+    volatile uint64_t sink = 0;
+    unsigned i;
+    int failures = 0;
+
+    if (nhal_get_tick_calibration(&cal) != NHAL_OK) {
+        printf("FAIL: calibration\n");
+        return 1;
+    }
+    printf("tick frequency: %llu Hz (mult %u, shift %u)\n",
+           (unsigned long long)cal.frequency_hz, (unsigned)cal.mult, (unsigned)cal.shift);
+
+    /* Read cost */
+    previous = nhal_get_timestamp_ticks();
+    start = clock_ns(CLOCK_MONOTONIC);
+    for (i = 0; i < READS; i++) {
+        uint64_t now = nhal_get_timestamp_ticks();
+        if (now < previous) {
+            failures++;
+        }
+        previous = now;
+    }
+    end = clock_ns(CLOCK_MONOTONIC);
+    printf("nhal_get_timestamp_ticks():       %6.2f ns/read\n", ns_per_read(start, end));
+
+    start = clock_ns(CLOCK_MONOTONIC);
+    for (i = 0; i < READS; i++) {
+        sink += clock_ns(CLOCK_MONOTONIC);
+    }
+    end = clock_ns(CLOCK_MONOTONIC);
+    printf("clock_gettime(CLOCK_MONOTONIC):   %6.2f ns/read\n", ns_per_read(start, end));
+
+    start = clock_ns(CLOCK_MONOTONIC);
+    for (i = 0; i < READS; i++) {
+        sink += clock_ns(CLOCK_MONOTONIC_RAW);
+    }
+    end = clock_ns(CLOCK_MONOTONIC);
+    printf("clock_gettime(CLOCK_MONOTONIC_RAW): %4.2f ns/read\n", ns_per_read(start, end));
+    (void)sink;
+
+    if (failures != 0) {
+        printf("FAIL: counter went backwards %d times\n", failures);
+    }
+
+    /* Conversion accuracy */
+    ns_start = clock_ns(CLOCK_MONOTONIC_RAW);
+    ticks_start = nhal_get_timestamp_ticks();
+    do {
+        expected_ns = clock_ns(CLOCK_MONOTONIC_RAW) - ns_start;
+    } while (expected_ns < ACCURACY_NS);
+    measured_ns = nhal_ticks_to_nanoseconds(&cal, nhal_get_timestamp_ticks() - ticks_start);
+    error_ppm = (measured_ns > expected_ns ? measured_ns - expected_ns : expected_ns - measured_ns) * 1000000u / expected_ns;
+    printf("conversion: %llu ns measured over %llu ns (%llu ppm)\n",
+           (unsigned long long)measured_ns, (unsigned long long)expected_ns, (unsigned long long)error_ppm);
+    if (error_ppm > ACCURACY_PPM) {
+        printf("FAIL: conversion off by more than %u ppm\n", ACCURACY_PPM);
+        failures++;
+    }
+
+    return failures != 0;
+}
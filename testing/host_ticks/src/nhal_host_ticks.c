@@ -0,0 +1,182 @@
+/**
+ * @file nhal_host_ticks.c
+ * @brief nhal_ticks.h for Linux hosts: TSC on x86-64, CNTVCT on AArch64
+ *
+ * The counter is read directly in user space, no system call:
+ * - x86-64: RDTSC, used only when the TSC is invariant and the kernel itself
+ *   runs its clock on it (clocksource "tsc"), i.e. the kernel verified it is
+ *   synchronized across CPUs. Its frequency comes from CPUID leaf 0x15 when
+ *   advertised, otherwise it is measured once against CLOCK_MONOTONIC_RAW.
+ * - AArch64: the virtual counter CNTVCT_EL0, frequency from CNTFRQ_EL0.
+ * Anything else falls back to CLOCK_MONOTONIC_RAW in nanoseconds.
+ */
+
+#include "nhal_ticks.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+#define NHAL_HOST_TICKS_CALIBRATION_NS  20000000u   /**< TSC measurement window. */
+
+enum nhal_host_tick_source {
+    NHAL_HOST_TICKS_UNKNOWN = 0,
+    NHAL_HOST_TICKS_CLOCK,
+    NHAL_HOST_TICKS_TSC,
+    NHAL_HOST_TICKS_CNTVCT,
+};
+
+static int tick_source;
+static pthread_once_t source_once = PTHREAD_ONCE_INIT;
+static pthread_once_t calibration_once = PTHREAD_ONCE_INIT;
+static struct nhal_tick_calibration calibration;
+static nhal_result_t calibration_result;
+
+static uint64_t clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+static int tsc_usable(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    char clocksource[32] = { 0 };
+    FILE *file;
+
+    /* Invariant TSC: constant rate across P-, C- and T-states */
+    if (__get_cpuid_max(0x80000000u, NULL) < 0x80000007u) {
+        return 0;
+    }
+    __cpuid(0x80000007u, eax, ebx, ecx, edx);
+    if ((edx & (1u << 8)) == 0) {
+        return 0;
+    }
+
+    /* The kernel only keeps "tsc" as clocksource once it found it synchronized */
+    file = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+    if (file == NULL) {
+        return 0;
+    }
+    if (fgets(clocksource, sizeof(clocksource), file) == NULL) {
+        clocksource[0] = '\0';
+    }
+    fclose(file);
+    return strncmp(clocksource, "tsc", 3) == 0 && (clocksource[3] == '\n' || clocksource[3] == '\0');
+}
+
+static uint64_t tsc_frequency(void)
+{
+    unsigned int denominator, numerator, crystal_hz, edx;
+    uint64_t tsc_start, tsc_end, ns_start, ns_end;
+
+    if (__get_cpuid_max(0, NULL) >= 0x15u) {
+        __cpuid(0x15u, denominator, numerator, crystal_hz, edx);
+        if (denominator != 0 && numerator != 0 && crystal_hz != 0) {
+            return (uint64_t)crystal_hz * numerator / denominator;
+        }
+    }
+
+    /* Bracket both ends tightly so the clock read cost does not skew the ratio */
+    ns_start = clock_ns();
+    tsc_start = __rdtsc();
+    do {
+        ns_end = clock_ns();
+    } while (ns_end - ns_start < NHAL_HOST_TICKS_CALIBRATION_NS);
+    tsc_end = __rdtsc();
+    ns_end = clock_ns();
+    return (tsc_end - tsc_start) * 1000000000u / (ns_end - ns_start);
+}
+
+#endif
+
+#if defined(__aarch64__)
+
+static uint64_t cntfrq(void)
+{
+    uint64_t value;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(value));
+    return value;
+}
+
+#endif
+
+static void select_source(void)
+{
+    int source = NHAL_HOST_TICKS_CLOCK;
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (tsc_usable()) {
+        source = NHAL_HOST_TICKS_TSC;
+    }
+#elif defined(__aarch64__)
+    if (cntfrq() != 0) {
+        source = NHAL_HOST_TICKS_CNTVCT;
+    }
+#endif
+    __atomic_store_n(&tick_source, source, __ATOMIC_RELEASE);
+}
+
+static void calibrate(void)
+{
+    uint64_t frequency_hz = 1000000000u;
+
+    pthread_once(&source_once, select_source);
+#if defined(__x86_64__) || defined(__i386__)
+    if (tick_source == NHAL_HOST_TICKS_TSC) {
+        frequency_hz = tsc_frequency();
+    }
+#elif defined(__aarch64__)
+    if (tick_source == NHAL_HOST_TICKS_CNTVCT) {
+        frequency_hz = cntfrq();
+    }
+#endif
+    calibration_result = frequency_hz != 0 ? nhal_tick_calibration_from_frequency(&calibration, frequency_hz)
+                                           : NHAL_ERR_HW_FAILURE;
+}
+
+uint64_t nhal_get_timestamp_ticks(void)
+{
+    int source = __atomic_load_n(&tick_source, __ATOMIC_ACQUIRE);
+
+    if (__builtin_expect(source == NHAL_HOST_TICKS_UNKNOWN, 0)) {
+        pthread_once(&source_once, select_source);
+        source = __atomic_load_n(&tick_source, __ATOMIC_ACQUIRE);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (source == NHAL_HOST_TICKS_TSC) {
+        return __rdtsc();
+    }
+#elif defined(__aarch64__)
+    if (source == NHAL_HOST_TICKS_CNTVCT) {
+        uint64_t value;
+        /* Keep the read from being hoisted above earlier instructions */
+        __asm__ volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(value) : : "memory");
+        return value;
+    }
+#endif
+    return clock_ns();
+}
+
+nhal_result_t nhal_get_tick_calibration(struct nhal_tick_calibration *cal)
+{
+    if (cal == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    pthread_once(&calibration_once, calibrate);
+    if (calibration_result != NHAL_OK) {
+        return calibration_result;
+    }
+    *cal = calibration;
+    return NHAL_OK;
+}
@@ -0,0 +1,256 @@
+/**
+ * @file nhal_shm_uart_bench.c
+ * @brief Loss-free UART throughput between two processes, and overrun accounting
+ *
+ * A writer process streams a known byte pattern to a reader process over one
+ * channel with RTS/CTS on both sides; the reader checks every byte and that
+ * nothing was dropped, once reading as fast as it can and once throttled so
+ * the writer is held off by RTS. Without flow control, bytes that do not fit
+ * the receive ring must be counted as overruns. Exits non-zero on any
+ * mismatch; throughput is reported, not checked.
+ */
+
+#include "nhal_shm.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define STREAM_BYTES        (64u * 1024u * 1024u)
+#define THROTTLED_BYTES     (1024u * 1024u)
+#define WRITE_CHUNK         1500u
+#define RTS_THRESHOLD       1024u
+#define TIMEOUT_MS          5000u
+
+static char bus_name[64];
+
+static uint8_t pattern(uint32_t i)
+{
+    return (uint8_t)(i ^ (i >> 8) ^ (i >> 16));
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static nhal_result_t uart_open(struct nhal_uart_context *uart, nhal_uart_flow_control_t flow_control)
+{
+    static struct nhal_uart_impl_config impl = { TIMEOUT_MS };
+    struct nhal_uart_config cfg;
+    nhal_result_t result = nhal_uart_init(uart);
+
+    if (result != NHAL_OK) {
+        return result;
+    }
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.baudrate = 115200;
+    cfg.parity = NHAL_UART_PARITY_NONE;
+    cfg.stop_bits = NHAL_UART_STOP_BITS_1;
+    cfg.data_bits = NHAL_UART_DATA_BITS_8;
+    cfg.flow_control = flow_control;
+    cfg.rx_fifo_threshold = RTS_THRESHOLD;
+    cfg.impl_config = &impl;
+    return nhal_uart_set_config(uart, &cfg);
+}
+
+/* Reader process: checks len bytes of the pattern, sleeping every 'throttle' bytes when non-zero */
+static int reader(uint32_t len, uint32_t throttle, int ready_fd)
+{
+    struct nhal_shm_bus bus;
+    struct nhal_uart_context uart = NHAL_SHM_UART_CONTEXT(&bus, 0, 1);
+    uint8_t buffer[4096];
+    uint32_t received = 0;
+    uint32_t chunk = 1;
+
+    if (nhal_shm_bus_open(&bus, bus_name) != NHAL_OK || uart_open(&uart, NHAL_UART_FLOW_CONTROL_RTS_CTS) != NHAL_OK) {
+        printf("FAIL: reader setup\n");
+        return 1;
+    }
+    /* RTS is driven from here on: release the writer */
+    if (write(ready_fd, "", 1) != 1) {
+        return 1;
+    }
+    close(ready_fd);
+    while (received < len) {
+        uint32_t i;
+
+        /* Vary the read size so reads straddle the ring wrap at every offset */
+        chunk = chunk * 7u % (uint32_t)sizeof(buffer) + 1u;
+        if (chunk > len - received) {
+            chunk = len - received;
+        }
+        if (nhal_uart_read(&uart, buffer, chunk) != NHAL_OK) {
+            printf("FAIL: read timed out after %u bytes\n", (unsigned)received);
+            return 1;
+        }
+        for (i = 0; i < chunk; i++) {
+            if (buffer[i] != pattern(received + i)) {
+                printf("FAIL: byte %u is 0x%02x, expected 0x%02x\n", (unsigned)(received + i), buffer[i],
+                       pattern(received + i));
+                return 1;
+            }
+        }
+        if (throttle != 0 && (received / throttle) != ((received + chunk) / throttle)) {
+            usleep(100);
+        }
+        received += chunk;
+    }
+    if (nhal_shm_uart_overruns(&uart) != 0) {
+        printf("FAIL: %u bytes overrun with RTS/CTS\n", (unsigned)nhal_shm_uart_overruns(&uart));
+        return 1;
+    }
+    nhal_uart_deinit(&uart);
+    nhal_shm_bus_close(&bus);
+    return 0;
+}
+
+/* Stream len bytes to a reader process; returns the elapsed time in ns, 0 on failure */
+static uint64_t stream(struct nhal_uart_context *uart, uint32_t len, uint32_t throttle)
+{
+    uint8_t buffer[WRITE_CHUNK];
+    uint32_t sent = 0;
+    uint64_t start;
+    int status = 0;
+    int ready[2];
+    char byte;
+    pid_t pid;
+
+    if (pipe(ready) != 0) {
+        return 0;
+    }
+    fflush(stdout);
+    pid = fork();
+    if (pid < 0) {
+        return 0;
+    }
+    if (pid == 0) {
+        close(ready[0]);
+        _exit(reader(len, throttle, ready[1]));
+    }
+    close(ready[1]);
+    if (read(ready[0], &byte, 1) != 1) {
+        close(ready[0]);
+        waitpid(pid, &status, 0);
+        return 0;
+    }
+    close(ready[0]);
+    start = now_ns();
+    while (sent < len) {
+        uint32_t chunk = len - sent < WRITE_CHUNK ? len - sent : WRITE_CHUNK;
+        uint32_t i;
+
+        for (i = 0; i < chunk; i++) {
+            buffer[i] = pattern(sent + i);
+        }
+        if (nhal_uart_write(uart, buffer, chunk) != NHAL_OK) {
+            printf("FAIL: write timed out after %u bytes\n", (unsigned)sent);
+            waitpid(pid, &status, 0);
+            return 0;
+        }
+        sent += chunk;
+    }
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return 0;
+    }
+    return now_ns() - start;
+}
+
+static int check_overruns(struct nhal_shm_bus *bus)
+{
+    struct nhal_uart_context tx = NHAL_SHM_UART_CONTEXT(bus, 1, 0);
+    struct nhal_uart_context rx = NHAL_SHM_UART_CONTEXT(bus, 1, 1);
+    static uint8_t buffer[3 * NHAL_SHM_UART_RING_SIZE];
+    struct nhal_uart_config cfg;
+    uint32_t i;
+    int failures = 0;
+
+    if (uart_open(&tx, NHAL_UART_FLOW_CONTROL_NONE) != NHAL_OK ||
+        uart_open(&rx, NHAL_UART_FLOW_CONTROL_NONE) != NHAL_OK) {
+        printf("FAIL: overrun setup\n");
+        return 1;
+    }
+    for (i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = pattern(i);
+    }
+    /* Nothing holds the writer back: only the first ring's worth arrives */
+    if (nhal_uart_write(&tx, buffer, sizeof(buffer)) != NHAL_OK) {
+        printf("FAIL: write without flow control\n");
+        failures++;
+    }
+    if (nhal_shm_uart_overruns(&rx) != 2 * NHAL_SHM_UART_RING_SIZE) {
+        printf("FAIL: %u overrun bytes, expected %u\n", (unsigned)nhal_shm_uart_overruns(&rx),
+               2u * NHAL_SHM_UART_RING_SIZE);
+        failures++;
+    }
+    memset(buffer, 0, sizeof(buffer));
+    if (nhal_uart_read(&rx, buffer, NHAL_SHM_UART_RING_SIZE) != NHAL_OK) {
+        printf("FAIL: read of the received bytes\n");
+        failures++;
+    }
+    for (i = 0; i < NHAL_SHM_UART_RING_SIZE; i++) {
+        if (buffer[i] != pattern(i)) {
+            printf("FAIL: received byte %u corrupted\n", (unsigned)i);
+            failures++;
+            break;
+        }
+    }
+
+    /* Modes the ring cannot honor are refused */
+    nhal_uart_get_config(&rx, &cfg);
+    cfg.flow_control = NHAL_UART_FLOW_CONTROL_RS485_DE;
+    failures += nhal_uart_set_config(&rx, &cfg) != NHAL_ERR_UNSUPPORTED;
+    cfg.flow_control = NHAL_UART_FLOW_CONTROL_RTS_CTS;
+    cfg.rx_fifo_threshold = NHAL_SHM_UART_RING_SIZE + 1;
+    failures += nhal_uart_set_config(&rx, &cfg) != NHAL_ERR_UNSUPPORTED;
+
+    nhal_uart_deinit(&tx);
+    nhal_uart_deinit(&rx);
+    printf("no flow control: %u of %u bytes received, %u counted as overruns\n", NHAL_SHM_UART_RING_SIZE,
+           (unsigned)sizeof(buffer), (unsigned)nhal_shm_uart_overruns(&rx));
+    return failures;
+}
+
+int main(void)
+{
+    struct nhal_shm_bus bus;
+    struct nhal_uart_context uart = NHAL_SHM_UART_CONTEXT(&bus, 0, 0);
+    uint64_t elapsed;
+    int failures = 0;
+
+    snprintf(bus_name, sizeof(bus_name), "uart_bench_%d", (int)getpid());
+    nhal_shm_bus_unlink(bus_name);
+    if (nhal_shm_bus_open(&bus, bus_name) != NHAL_OK || uart_open(&uart, NHAL_UART_FLOW_CONTROL_RTS_CTS) != NHAL_OK) {
+        printf("FAIL: bus setup\n");
+        return 1;
+    }
+
+    elapsed = stream(&uart, STREAM_BYTES, 0);
+    if (elapsed == 0) {
+        printf("FAIL: RTS/CTS stream\n");
+        failures++;
+    } else {
+        printf("RTS/CTS, free-running reader: %u MiB in %.1f ms, %.0f MB/s, no byte lost\n",
+               STREAM_BYTES >> 20, (double)elapsed / 1e6, (double)STREAM_BYTES * 1e3 / (double)elapsed);
+    }
+
+    elapsed = stream(&uart, THROTTLED_BYTES, 16384);
+    if (elapsed == 0) {
+        printf("FAIL: throttled RTS/CTS stream\n");
+        failures++;
+    } else {
+        printf("RTS/CTS, throttled reader:    %u MiB in %.1f ms, %.1f MB/s, no byte lost\n",
+               THROTTLED_BYTES >> 20, (double)elapsed / 1e6, (double)THROTTLED_BYTES * 1e3 / (double)elapsed);
+    }
+
+    failures += check_overruns(&bus);
+
+    nhal_uart_deinit(&uart);
+    nhal_shm_bus_close(&bus);
+    nhal_shm_bus_unlink(bus_name);
+    return failures != 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file nhal_shm.h
+ * @brief Shared-memory NHAL backend connecting processes on one Linux host.
+ *
+ * Implements nhal_uart.h, nhal_i2c_master.h, nhal_i2c_transfer.h and
+ * nhal_pin.h on top of a POSIX shared memory region, so firmware built for
+ * the host can run as separate processes wired together as on the board:
+ * - UART: channels of two lock-free single-producer/single-consumer byte
+ *   rings, one per direction. Each channel has two sides; one process opens
+ *   side 0 and its peer side 1.
+ * - I2C: one request/response mailbox per bus. Master processes use the
+ *   regular nhal_i2c_master API; a target process serves its address with
+ *   nhal_shm_i2c_target_serve(). nhal_i2c_master_perform_transfer() sends
+ *   the operations up to each STOP as one transaction: writes, then reads
+ *   after a repeated start (a write after a read is NHAL_ERR_UNSUPPORTED).
+ * - Pins: a shared bitmap. Outputs set their bit, every process reads it,
+ *   and pin interrupts of each process are dispatched by a background
+ *   thread, standing in for interrupt context.
+ *
+ * Data moves through the rings with plain loads and stores; a futex is only
+ * used when a side actually has to wait, so a busy link costs no system call
+ * per byte and a sleeping peer is woken within microseconds.
+ *
+ * Blocking calls wait up to impl_config->timeout_ms (0: forever) and return
+ * NHAL_ERR_TIMEOUT. Contexts start with NHAL_SHM_DEFAULT_TIMEOUT_MS, which a
+ * set_config without impl_config restores. An I2C transaction no target
+ * picks up in time is withdrawn and reported as NHAL_ERR_NO_RESPONSE, like
+ * an address NACK; one a target took but did not answer in time returns
+ * NHAL_ERR_TIMEOUT.
+ * Baud rates and bus clocks are accepted but do not pace the transfers.
+ *
+ * UART flow control behaves as on a wire whose receive FIFO is the ring:
+ * - NHAL_UART_FLOW_CONTROL_NONE: writes never wait; bytes the peer's ring
+ *   has no room for are dropped and counted (nhal_shm_uart_overruns()).
+ * - NHAL_UART_FLOW_CONTROL_RTS_CTS: the receiving side deasserts RTS once
+ *   rx_fifo_threshold bytes are pending (0: the whole ring), and a writer
+ *   also configured for RTS/CTS waits until it is asserted again. With
+ *   both sides configured the link is loss-free.
+ * RS-485 driver enable is rejected with NHAL_ERR_UNSUPPORTED.
+ *
+ * A non-zero rx_idle_timeout_bits ends nhal_uart_read() early: once at least
+ * one byte has arrived, rx_idle_timeout_bits bit times at the configured
+ * baud rate without a new byte return NHAL_OK with a short read, whose
+ * length nhal_shm_uart_last_read_len() reports. The first byte is still
+ * awaited for up to the timeout.
+ *
+ * @par Example usage:
+ * @code
+ * // Sensor process                            // Gateway process
+ * struct nhal_shm_bus bus;                      struct nhal_shm_bus bus;
+ * nhal_shm_bus_open(&bus, "hil");               nhal_shm_bus_open(&bus, "hil");
+ *
+ * struct nhal_uart_context uart =               struct nhal_uart_context uart =
+ *     NHAL_SHM_UART_CONTEXT(&bus, 0, 0);            NHAL_SHM_UART_CONTEXT(&bus, 0, 1);
+ * nhal_uart_init(&uart);                        nhal_uart_init(&uart);
+ * nhal_uart_write(&uart, frame, len);           nhal_uart_read(&uart, frame, len);
+ * @endcode
+ */
+#ifndef NHAL_SHM_H
+#define NHAL_SHM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "nhal_common.h"
+#include "nhal_uart.h"
+#include "nhal_i2c_master.h"
+#include "nhal_pin.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NHAL_SHM_UART_CHANNELS      4
+#define NHAL_SHM_UART_RING_SIZE     4096    /**< Bytes per direction (power of two). */
+#define NHAL_SHM_I2C_BUSES          2
+#define NHAL_SHM_I2C_MAX_TRANSFER   256     /**< Bytes per write or read phase. */
+#define NHAL_SHM_PINS               256
+#define NHAL_SHM_DEFAULT_TIMEOUT_MS 100     /**< Blocking timeout when set_config has no impl_config. */
+
+/**
+ * @brief Shared region layout (private to the backend)
+ */
+struct nhal_shm_region;
+
+/**
+ * @brief Process-local handle on a shared region
+ */
+struct nhal_shm_bus{
+    struct nhal_shm_region *region;
+    pthread_mutex_t pin_lock;              /**< Protects pin_list. */
+    struct nhal_pin_context *pin_list;     /**< Pins with an interrupt configured. */
+    pthread_t pin_thread;
+    bool pin_thread_running;
+    bool closing;                          /**< Stop request to the pin thread, accessed atomically. */
+    uint32_t pin_snapshot[NHAL_SHM_PINS / 32];
+};
+
+/**
+ * @brief Open (creating it if needed) the shared region called name
+ *
+ * @param bus Handle to initialize
+ * @param name Region name, shared by all connected processes
+ * @return NHAL_OK on success, error code otherwise
+ *
+ * @retval NHAL_ERR_INVALID_CONFIG Region exists with an incompatible layout
+ * @retval NHAL_ERR_HW_FAILURE Shared memory could not be created or mapped
+ */
+nhal_result_t nhal_shm_bus_open(struct nhal_shm_bus *bus, const char *name);
+
+/**
+ * @brief Close a handle (stops its pin interrupt thread)
+ * @param bus Handle to close
+ */
+void nhal_shm_bus_close(struct nhal_shm_bus *bus);
+
+/**
+ * @brief Remove the shared region name (processes still attached keep their mapping)
+ * @param name Region name
+ */
+void nhal_shm_bus_unlink(const char *name);
+
+/**
+ * @brief UART implementation configuration
+ */
+struct nhal_uart_impl_config{
+    uint32_t timeout_ms;         /**< Blocking read/write timeout, 0 to wait forever. */
+};
+
+/**
+ * @brief UART context: one side of a shared channel
+ */
+struct nhal_uart_context{
+    struct nhal_shm_bus *bus;
+    uint8_t channel;             /**< 0 to NHAL_SHM_UART_CHANNELS - 1. */
+    uint8_t side;                /**< 0 or 1, the peer uses the other one. */
+    bool initialized;
+    uint32_t timeout_ms;
+    struct nhal_uart_config config;
+    size_t last_read_len;
+};
+
+#define NHAL_SHM_UART_CONTEXT(bus, channel, side) { (bus), (channel), (side), false, NHAL_SHM_DEFAULT_TIMEOUT_MS, { 0 }, 0 }
+
+/**
+ * @brief Bytes the peer dropped because this side's receive ring was full
+ *
+ * Only counts when the peer writes without RTS/CTS flow control.
+ *
+ * @param ctx UART context
+ * @return Overrun byte count since the region was created (wraps)
+ */
+uint32_t nhal_shm_uart_overruns(const struct nhal_uart_context *ctx);
+
+/**
+ * @brief Bytes the last nhal_uart_read() on this context stored
+ *
+ * The full length on NHAL_OK unless the idle timeout ended the read early;
+ * what arrived before the timeout on NHAL_ERR_TIMEOUT.
+ *
+ * @param ctx UART context
+ * @return Byte count of the last read
+ */
+size_t nhal_shm_uart_last_read_len(const struct nhal_uart_context *ctx);
+
+/**
+ * @brief I2C implementation configuration
+ */
+struct nhal_i2c_impl_config{
+    uint32_t timeout_ms;         /**< Time to wait for the target's response, 0 to wait forever. */
+};
+
+/**
+ * @brief I2C master context on a shared bus
+ */
+struct nhal_i2c_context{
+    struct nhal_shm_bus *bus;
+    uint8_t index;               /**< 0 to NHAL_SHM_I2C_BUSES - 1. */
+    bool initialized;
+    uint32_t timeout_ms;
+    struct nhal_i2c_config config;
+};
+
+#define NHAL_SHM_I2C_CONTEXT(bus, index) { (bus), (index), false, NHAL_SHM_DEFAULT_TIMEOUT_MS, { 0 } }
+
+/**
+ * @brief Target side transaction handler
+ *
+ * Called once per master transaction: write_data holds the bytes the master
+ * wrote, read_data must be filled with read_len bytes for the master.
+ * Returning an error NACKs the transaction; the master receives it as its
+ * result (typically NHAL_ERR_NO_RESPONSE).
+ */
+typedef nhal_result_t (*nhal_shm_i2c_target_handler_t)(void *user_data, const uint8_t *write_data, size_t write_len,
+                                                       uint8_t *read_data, size_t read_len);
+
+/**
+ * @brief Serve one transaction addressed to a target
+ *
+ * If the master's timeout expires while the handler runs, the master
+ * returns NHAL_ERR_TIMEOUT, the response is discarded and this returns
+ * NHAL_ERR_TIMEOUT too.
+ *
+ * @param bus Shared region handle
+ * @param index I2C bus index
+ * @param address Target address (7-bit, or 10-bit with NHAL_I2C_10BIT_ADDR)
+ * @param handler Transaction handler
+ * @param user_data Passed to handler
+ * @param timeout_ms Time to wait for a transaction, 0 to wait forever
+ * @return NHAL_OK once a transaction was served and collected, NHAL_ERR_TIMEOUT otherwise
+ */
+nhal_result_t nhal_shm_i2c_target_serve(struct nhal_shm_bus *bus, uint8_t index, nhal_i2c_address_t address,
+                                        nhal_shm_i2c_target_handler_t handler, void *user_data, uint32_t timeout_ms);
+
+/**
+ * @brief Pin context on the shared bitmap
+ */
+struct nhal_pin_context{
+    struct nhal_shm_bus *bus;
+    uint16_t pin;                /**< 0 to NHAL_SHM_PINS - 1. */
+    bool initialized;
+    nhal_pin_dir_t direction;
+    nhal_pin_pull_mode_t pull_mode;
+    nhal_pin_int_trigger_t trigger;
+    nhal_pin_callback_t callback;
+    void *user_data;
+    bool interrupt_enabled;
+    struct nhal_pin_context *next;
+};
+
+#define NHAL_SHM_PIN_CONTEXT(bus, pin) { (bus), (pin), false, NHAL_PIN_DIR_INPUT, NHAL_PIN_PMODE_NONE, \
+                                          NHAL_PIN_INT_TRIGGER_NONE, NULL, NULL, false, NULL }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NHAL_SHM_H */
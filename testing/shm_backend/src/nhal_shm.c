@@ -0,0 +1,200 @@
+/**
+ * @file nhal_shm.c
+ * @brief Shared region management, wait primitives and timing functions
+ */
+
+#include "nhal_shm_internal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#define NHAL_SHM_SPIN_ITERATIONS 2000
+
+static void nhal_shm_path(char *path, size_t size, const char *name)
+{
+    snprintf(path, size, "/nhal_shm_%s", name);
+}
+
+uint64_t nhal_shm_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+nhal_result_t nhal_shm_bus_open(struct nhal_shm_bus *bus, const char *name)
+{
+    char path[NAME_MAX];
+    struct nhal_shm_region *region;
+    pthread_mutexattr_t attr;
+    uint32_t magic = 0;
+    int fd;
+
+    if (bus == NULL || name == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    memset(bus, 0, sizeof(*bus));
+
+    nhal_shm_path(path, sizeof(path), name);
+    fd = shm_open(path, O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        return NHAL_ERR_HW_FAILURE;
+    }
+    /* Both sides size the region identically, whoever gets there first */
+    if (ftruncate(fd, sizeof(struct nhal_shm_region)) != 0) {
+        close(fd);
+        return NHAL_ERR_HW_FAILURE;
+    }
+    region = mmap(NULL, sizeof(struct nhal_shm_region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region == MAP_FAILED) {
+        return NHAL_ERR_HW_FAILURE;
+    }
+
+    if (__atomic_compare_exchange_n(&region->magic, &magic, NHAL_SHM_MAGIC, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        __atomic_store_n(&region->version, NHAL_SHM_VERSION, __ATOMIC_RELEASE);
+    } else if (magic != NHAL_SHM_MAGIC) {
+        munmap(region, sizeof(*region));
+        return NHAL_ERR_INVALID_CONFIG;
+    } else {
+        /* Creator may still be publishing the version */
+        uint64_t deadline = nhal_shm_deadline(1000);
+        while (__atomic_load_n(&region->version, __ATOMIC_ACQUIRE) == 0 && nhal_shm_now_ns() < deadline) {
+            sched_yield();
+        }
+        if (__atomic_load_n(&region->version, __ATOMIC_ACQUIRE) != NHAL_SHM_VERSION) {
+            munmap(region, sizeof(*region));
+            return NHAL_ERR_INVALID_CONFIG;
+        }
+    }
+
+    bus->region = region;
+    /* Recursive: pin callbacks run with the lock held and may reconfigure pins */
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&bus->pin_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    memcpy(bus->pin_snapshot, region->pins, sizeof(bus->pin_snapshot));
+    return NHAL_OK;
+}
+
+void nhal_shm_bus_close(struct nhal_shm_bus *bus)
+{
+    if (bus == NULL || bus->region == NULL) {
+        return;
+    }
+    if (bus->pin_thread_running) {
+        __atomic_store_n(&bus->closing, true, __ATOMIC_RELEASE);
+        __atomic_fetch_add(&bus->region->pins_seq, 1, __ATOMIC_SEQ_CST);
+        nhal_shm_wake(&bus->region->pins_seq, NULL);
+        pthread_join(bus->pin_thread, NULL);
+        bus->pin_thread_running = false;
+    }
+    pthread_mutex_destroy(&bus->pin_lock);
+    munmap(bus->region, sizeof(*bus->region));
+    bus->region = NULL;
+}
+
+void nhal_shm_bus_unlink(const char *name)
+{
+    char path[NAME_MAX];
+
+    nhal_shm_path(path, sizeof(path), name);
+    shm_unlink(path);
+}
+
+uint64_t nhal_shm_deadline(uint32_t timeout_ms)
+{
+    if (timeout_ms == 0) {
+        return UINT64_MAX;
+    }
+    return nhal_shm_now_ns() + (uint64_t)timeout_ms * 1000000u;
+}
+
+bool nhal_shm_wait_change(uint32_t *word, uint32_t value, uint32_t *waiters, uint64_t deadline_ns)
+{
+    unsigned spin;
+
+    for (spin = 0; spin < NHAL_SHM_SPIN_ITERATIONS; spin++) {
+        if (__atomic_load_n(word, __ATOMIC_ACQUIRE) != value) {
+            return true;
+        }
+    }
+
+    for (;;) {
+        struct timespec timeout;
+        struct timespec *timeout_ptr = NULL;
+        uint64_t now = nhal_shm_now_ns();
+
+        if (now >= deadline_ns) {
+            return __atomic_load_n(word, __ATOMIC_ACQUIRE) != value;
+        }
+        if (deadline_ns != UINT64_MAX) {
+            timeout.tv_sec = (time_t)((deadline_ns - now) / 1000000000u);
+            timeout.tv_nsec = (long)((deadline_ns - now) % 1000000000u);
+            timeout_ptr = &timeout;
+        }
+
+        if (waiters != NULL) {
+            __atomic_fetch_add(waiters, 1, __ATOMIC_SEQ_CST);
+        }
+        /* The kernel rechecks *word == value atomically, so a change made
+         * after the check above is never slept through */
+        if (__atomic_load_n(word, __ATOMIC_SEQ_CST) == value) {
+            syscall(SYS_futex, word, FUTEX_WAIT, value, timeout_ptr, NULL, 0);
+        }
+        if (waiters != NULL) {
+            __atomic_fetch_sub(waiters, 1, __ATOMIC_SEQ_CST);
+        }
+        if (__atomic_load_n(word, __ATOMIC_ACQUIRE) != value) {
+            return true;
+        }
+    }
+}
+
+void nhal_shm_wake(uint32_t *word, uint32_t *waiters)
+{
+    if (waiters == NULL || __atomic_load_n(waiters, __ATOMIC_SEQ_CST) != 0) {
+        syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+/* Timing functions of nhal_common.h, on the host monotonic clock */
+
+void nhal_delay_microseconds(uint32_t microseconds)
+{
+    struct timespec ts;
+    ts.tv_sec = microseconds / 1000000u;
+    ts.tv_nsec = (long)(microseconds % 1000000u) * 1000;
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+void nhal_delay_milliseconds(uint32_t milliseconds)
+{
+    while (milliseconds > 1000) {
+        nhal_delay_microseconds(1000000u);
+        milliseconds -= 1000;
+    }
+    nhal_delay_microseconds(milliseconds * 1000u);
+}
+
+uint64_t nhal_get_timestamp_microseconds(void)
+{
+    return nhal_shm_now_ns() / 1000u;
+}
+
+uint32_t nhal_get_timestamp_milliseconds(void)
+{
+    return (uint32_t)(nhal_shm_now_ns() / 1000000u);
+}
@@ -0,0 +1,274 @@
+/**
+ * @file nhal_shm_i2c.c
+ * @brief I2C master and target over a shared request/response mailbox
+ */
+
+#include "nhal_shm_internal.h"
+
+#include <string.h>
+
+#include "nhal_i2c_transfer.h"
+
+static uint16_t nhal_shm_i2c_address_value(nhal_i2c_address_t address)
+{
+    return address.type == NHAL_I2C_10BIT_ADDR ? address.addr.address_10bit : address.addr.address_7bit;
+}
+
+/* Wait until the mailbox reaches state, false on timeout */
+static bool nhal_shm_i2c_wait_state(struct nhal_shm_i2c_mailbox *mb, uint32_t state, uint64_t deadline)
+{
+    for (;;) {
+        uint32_t current = __atomic_load_n(&mb->state, __ATOMIC_ACQUIRE);
+        if (current == state) {
+            return true;
+        }
+        if (!nhal_shm_wait_change(&mb->state, current, &mb->waiters, deadline)) {
+            return false;
+        }
+    }
+}
+
+static void nhal_shm_i2c_set_state(struct nhal_shm_i2c_mailbox *mb, uint32_t state)
+{
+    __atomic_store_n(&mb->state, state, __ATOMIC_SEQ_CST);
+    nhal_shm_wake(&mb->state, &mb->waiters);
+}
+
+static nhal_result_t nhal_shm_i2c_transaction(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                              const uint8_t *write_data, size_t write_len,
+                                              uint8_t *read_data, size_t read_len)
+{
+    struct nhal_shm_i2c_mailbox *mb;
+    uint64_t deadline;
+    uint32_t expected;
+    nhal_result_t result;
+
+    if (ctx == NULL || (write_data == NULL && write_len != 0) || (read_data == NULL && read_len != 0) ||
+        write_len > NHAL_SHM_I2C_MAX_TRANSFER || read_len > NHAL_SHM_I2C_MAX_TRANSFER) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!ctx->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    mb = &ctx->bus->region->i2c[ctx->index];
+    deadline = nhal_shm_deadline(ctx->timeout_ms);
+
+    /* Bus arbitration: one master transaction at a time */
+    for (;;) {
+        expected = NHAL_SHM_MAILBOX_IDLE;
+        if (__atomic_compare_exchange_n(&mb->state, &expected, NHAL_SHM_MAILBOX_CLAIMED, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+        if (!nhal_shm_wait_change(&mb->state, expected, &mb->waiters, deadline)) {
+            return NHAL_ERR_BUSY;
+        }
+    }
+
+    mb->address = nhal_shm_i2c_address_value(dev_address);
+    mb->ten_bit = dev_address.type == NHAL_I2C_10BIT_ADDR;
+    mb->write_len = (uint32_t)write_len;
+    mb->read_len = (uint32_t)read_len;
+    if (write_len != 0) {
+        memcpy(mb->write_data, write_data, write_len);
+    }
+    nhal_shm_i2c_set_state(mb, NHAL_SHM_MAILBOX_REQUEST);
+    __atomic_fetch_add(&mb->requests, 1, __ATOMIC_SEQ_CST);
+    nhal_shm_wake(&mb->requests, &mb->request_waiters);
+
+    if (!nhal_shm_i2c_wait_state(mb, NHAL_SHM_MAILBOX_RESPONSE, deadline)) {
+        /* Nobody answered the address: withdraw the request, as a NACK */
+        expected = NHAL_SHM_MAILBOX_REQUEST;
+        if (__atomic_compare_exchange_n(&mb->state, &expected, NHAL_SHM_MAILBOX_IDLE, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            nhal_shm_wake(&mb->state, &mb->waiters);
+            return NHAL_ERR_NO_RESPONSE;
+        }
+        /* A target is serving it: leave the mailbox for it to release */
+        expected = NHAL_SHM_MAILBOX_SERVING;
+        if (__atomic_compare_exchange_n(&mb->state, &expected, NHAL_SHM_MAILBOX_ABANDONED, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return NHAL_ERR_TIMEOUT;
+        }
+        /* Otherwise the response arrived meanwhile */
+    }
+
+    result = (nhal_result_t)mb->result;
+    if (result == NHAL_OK && read_len != 0) {
+        memcpy(read_data, mb->read_data, read_len);
+    }
+    nhal_shm_i2c_set_state(mb, NHAL_SHM_MAILBOX_IDLE);
+    return result;
+}
+
+nhal_result_t nhal_i2c_master_init(struct nhal_i2c_context *ctx)
+{
+    if (ctx == NULL || ctx->bus == NULL || ctx->bus->region == NULL || ctx->index >= NHAL_SHM_I2C_BUSES) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->initialized) {
+        return NHAL_ERR_ALREADY_INITIALIZED;
+    }
+    ctx->initialized = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_i2c_master_deinit(struct nhal_i2c_context *ctx)
+{
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    ctx->initialized = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_i2c_master_set_config(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config)
+{
+    if (ctx == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!ctx->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    ctx->config = *config;
+    ctx->timeout_ms = config->impl_config != NULL ? config->impl_config->timeout_ms : NHAL_SHM_DEFAULT_TIMEOUT_MS;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_i2c_master_get_config(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config)
+{
+    if (ctx == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    *config = ctx->config;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_i2c_master_write(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                    const uint8_t *data, size_t len)
+{
+    return nhal_shm_i2c_transaction(ctx, dev_address, data, len, NULL, 0);
+}
+
+nhal_result_t nhal_i2c_master_read(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                   uint8_t *data, size_t len)
+{
+    return nhal_shm_i2c_transaction(ctx, dev_address, NULL, 0, data, len);
+}
+
+nhal_result_t nhal_i2c_master_write_read_reg(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                             const uint8_t *reg_address, size_t reg_len,
+                                             uint8_t *data, size_t data_len)
+{
+    return nhal_shm_i2c_transaction(ctx, dev_address, reg_address, reg_len, data, data_len);
+}
+
+/*
+ * Operations up to each STOP form one mailbox transaction: writes first,
+ * their bytes concatenated, then reads after a repeated start. All
+ * operations address dev_address.
+ */
+nhal_result_t nhal_i2c_master_perform_transfer(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address,
+                                               nhal_i2c_transfer_op_t *ops, size_t num_ops)
+{
+    uint8_t write_data[NHAL_SHM_I2C_MAX_TRANSFER];
+    uint8_t read_data[NHAL_SHM_I2C_MAX_TRANSFER];
+    size_t first = 0;
+    size_t i;
+
+    if (ctx == NULL || (ops == NULL && num_ops != 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    for (i = 0; i < num_ops; i++) {
+        size_t write_len = 0;
+        size_t read_len = 0;
+        size_t j;
+        nhal_result_t result;
+
+        if ((ops[i].flags & NHAL_I2C_TRANSFER_MSG_NO_STOP) != 0 && i + 1 < num_ops) {
+            continue;
+        }
+        /* ops[first..i] end with a STOP */
+        for (j = first; j <= i; j++) {
+            bool read = ops[j].type == NHAL_I2C_READ_OP;
+            size_t len = read ? ops[j].read.length : ops[j].write.length;
+
+            if (len != 0 && (read ? (const void *)ops[j].read.buffer : (const void *)ops[j].write.bytes) == NULL) {
+                return NHAL_ERR_INVALID_ARG;
+            }
+            if (!read && read_len != 0) {
+                return NHAL_ERR_UNSUPPORTED;    /* No write phase after a read */
+            }
+            if (len > NHAL_SHM_I2C_MAX_TRANSFER - (read ? read_len : write_len)) {
+                return NHAL_ERR_INVALID_ARG;
+            }
+            if (read) {
+                read_len += len;
+            } else if (len != 0) {
+                memcpy(write_data + write_len, ops[j].write.bytes, len);
+                write_len += len;
+            }
+        }
+        result = nhal_shm_i2c_transaction(ctx, dev_address, write_data, write_len, read_data, read_len);
+        if (result != NHAL_OK) {
+            return result;
+        }
+        read_len = 0;
+        for (j = first; j <= i; j++) {
+            if (ops[j].type == NHAL_I2C_READ_OP && ops[j].read.length != 0) {
+                memcpy(ops[j].read.buffer, read_data + read_len, ops[j].read.length);
+                read_len += ops[j].read.length;
+            }
+        }
+        first = i + 1;
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_shm_i2c_target_serve(struct nhal_shm_bus *bus, uint8_t index, nhal_i2c_address_t address,
+                                        nhal_shm_i2c_target_handler_t handler, void *user_data, uint32_t timeout_ms)
+{
+    struct nhal_shm_i2c_mailbox *mb;
+    uint64_t deadline;
+    uint32_t state;
+    uint16_t value;
+    uint8_t ten_bit;
+
+    if (bus == NULL || bus->region == NULL || index >= NHAL_SHM_I2C_BUSES || handler == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    mb = &bus->region->i2c[index];
+    deadline = nhal_shm_deadline(timeout_ms);
+    value = nhal_shm_i2c_address_value(address);
+    ten_bit = address.type == NHAL_I2C_10BIT_ADDR;
+
+    /*
+     * Wait on the request count rather than the state: a request for another
+     * address can be withdrawn and replaced by one for this target before
+     * this process runs, leaving the state word where it was.
+     */
+    for (;;) {
+        uint32_t requests = __atomic_load_n(&mb->requests, __ATOMIC_ACQUIRE);
+
+        state = __atomic_load_n(&mb->state, __ATOMIC_ACQUIRE);
+        if (state == NHAL_SHM_MAILBOX_REQUEST && mb->address == value && mb->ten_bit == ten_bit &&
+            __atomic_compare_exchange_n(&mb->state, &state, NHAL_SHM_MAILBOX_SERVING, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+        if (!nhal_shm_wait_change(&mb->requests, requests, &mb->request_waiters, deadline)) {
+            return NHAL_ERR_TIMEOUT;
+        }
+    }
+
+    mb->result = handler(user_data, mb->write_data, mb->write_len, mb->read_data, mb->read_len);
+    state = NHAL_SHM_MAILBOX_SERVING;
+    if (!__atomic_compare_exchange_n(&mb->state, &state, NHAL_SHM_MAILBOX_RESPONSE, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        /* The master gave up: nobody collects the response */
+        nhal_shm_i2c_set_state(mb, NHAL_SHM_MAILBOX_IDLE);
+        return NHAL_ERR_TIMEOUT;
+    }
+    nhal_shm_wake(&mb->state, &mb->waiters);
+    return NHAL_OK;
+}
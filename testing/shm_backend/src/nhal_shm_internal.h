@@ -0,0 +1,83 @@
+/**
+ * @file nhal_shm_internal.h
+ * @brief Shared region layout and wait primitives of the shared-memory backend
+ */
+#ifndef NHAL_SHM_INTERNAL_H
+#define NHAL_SHM_INTERNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "nhal_shm.h"
+
+#define NHAL_SHM_MAGIC      UINT32_C(0x4E48534D)     /* "NHSM" */
+#define NHAL_SHM_VERSION    3
+#define NHAL_SHM_CACHE_LINE 64
+
+/*
+ * Every field is zero in a freshly created region, which is the valid
+ * initial state: empty rings, idle mailboxes, all pins low.
+ */
+
+/* Single-producer/single-consumer byte ring, indexes free running */
+struct nhal_shm_ring{
+    uint32_t head __attribute__((aligned(NHAL_SHM_CACHE_LINE)));   /* Written by the producer */
+    uint32_t head_waiters;                                         /* Consumers sleeping on head */
+    uint32_t overruns;                                             /* Bytes the producer dropped, ring full */
+    uint32_t tail __attribute__((aligned(NHAL_SHM_CACHE_LINE)));   /* Written by the consumer */
+    uint32_t tail_waiters;                                         /* Producers sleeping on tail */
+    uint32_t rts_level;                                            /* Consumer's RTS threshold, 0: RTS not driven */
+    uint8_t data[NHAL_SHM_UART_RING_SIZE] __attribute__((aligned(NHAL_SHM_CACHE_LINE)));
+};
+
+enum {
+    NHAL_SHM_MAILBOX_IDLE = 0,
+    NHAL_SHM_MAILBOX_CLAIMED,       /* A master is filling the request */
+    NHAL_SHM_MAILBOX_REQUEST,       /* Waiting for the target */
+    NHAL_SHM_MAILBOX_SERVING,       /* Target handler running */
+    NHAL_SHM_MAILBOX_RESPONSE,      /* Waiting for the master to collect it */
+    NHAL_SHM_MAILBOX_ABANDONED,     /* Master timed out while the handler ran */
+};
+
+struct nhal_shm_i2c_mailbox{
+    uint32_t state __attribute__((aligned(NHAL_SHM_CACHE_LINE)));
+    uint32_t waiters;               /* Masters and targets sleeping on state */
+    uint32_t requests;              /* Bumped on every request posted, targets wait on it */
+    uint32_t request_waiters;       /* Targets sleeping on requests */
+    uint16_t address;
+    uint8_t ten_bit;
+    int32_t result;
+    uint32_t write_len;
+    uint32_t read_len;
+    uint8_t write_data[NHAL_SHM_I2C_MAX_TRANSFER];
+    uint8_t read_data[NHAL_SHM_I2C_MAX_TRANSFER];
+};
+
+struct nhal_shm_region{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t pins_seq __attribute__((aligned(NHAL_SHM_CACHE_LINE)));   /* Bumped on every pin change */
+    uint32_t pins_waiters;                                               /* Dispatcher threads asleep */
+    uint32_t pins[NHAL_SHM_PINS / 32];
+    struct nhal_shm_i2c_mailbox i2c[NHAL_SHM_I2C_BUSES];
+    struct nhal_shm_ring uart[NHAL_SHM_UART_CHANNELS][2];                /* [channel][producing side] */
+};
+
+/* CLOCK_MONOTONIC time in ns */
+uint64_t nhal_shm_now_ns(void);
+
+/* Absolute CLOCK_MONOTONIC deadline in ns, UINT64_MAX for timeout_ms == 0 */
+uint64_t nhal_shm_deadline(uint32_t timeout_ms);
+
+/*
+ * Wait while *word == value, until the deadline. Spins briefly before
+ * sleeping on the futex; waiters, when given, is incremented while asleep
+ * so the other side only issues a wake-up system call when needed.
+ * Returns false on timeout.
+ */
+bool nhal_shm_wait_change(uint32_t *word, uint32_t value, uint32_t *waiters, uint64_t deadline_ns);
+
+/* Wake all processes sleeping on word (waiters NULL: unconditionally) */
+void nhal_shm_wake(uint32_t *word, uint32_t *waiters);
+
+#endif /* NHAL_SHM_INTERNAL_H */
@@ -0,0 +1,248 @@
+/**
+ * @file nhal_shm_pin.c
+ * @brief Pins over a shared bitmap, interrupts from a dispatcher thread
+ */
+
+#include "nhal_shm_internal.h"
+
+#include <string.h>
+
+#define NHAL_SHM_PIN_WORD(pin) ((pin) / 32u)
+#define NHAL_SHM_PIN_MASK(pin) (UINT32_C(1) << ((pin) % 32u))
+
+static bool nhal_shm_pin_fires(nhal_pin_int_trigger_t trigger, bool was_high, bool is_high)
+{
+    switch (trigger) {
+    case NHAL_PIN_INT_TRIGGER_RISING_EDGE:
+        return !was_high && is_high;
+    case NHAL_PIN_INT_TRIGGER_FALLING_EDGE:
+        return was_high && !is_high;
+    case NHAL_PIN_INT_TRIGGER_BOTH_EDGES:
+        return was_high != is_high;
+    case NHAL_PIN_INT_TRIGGER_HIGH_LEVEL:
+        return is_high;
+    case NHAL_PIN_INT_TRIGGER_LOW_LEVEL:
+        return !is_high;
+    default:
+        return false;
+    }
+}
+
+/*
+ * Runs each time the bitmap changes. Transitions are sampled, so a pin
+ * toggled twice between two passes shows no edge; level triggers fire on
+ * every pass while the level holds.
+ */
+static void *nhal_shm_pin_dispatcher(void *arg)
+{
+    struct nhal_shm_bus *bus = arg;
+    struct nhal_shm_region *region = bus->region;
+
+    while (!__atomic_load_n(&bus->closing, __ATOMIC_ACQUIRE)) {
+        uint32_t seq = __atomic_load_n(&region->pins_seq, __ATOMIC_ACQUIRE);
+        uint32_t current[NHAL_SHM_PINS / 32];
+        struct nhal_pin_context *ctx;
+        struct nhal_pin_context *next;
+        size_t i;
+
+        for (i = 0; i < NHAL_SHM_PINS / 32; i++) {
+            current[i] = __atomic_load_n(&region->pins[i], __ATOMIC_ACQUIRE);
+        }
+
+        pthread_mutex_lock(&bus->pin_lock);
+        for (ctx = bus->pin_list; ctx != NULL; ctx = next) {
+            uint32_t mask = NHAL_SHM_PIN_MASK(ctx->pin);
+            bool was_high = (bus->pin_snapshot[NHAL_SHM_PIN_WORD(ctx->pin)] & mask) != 0;
+            bool is_high = (current[NHAL_SHM_PIN_WORD(ctx->pin)] & mask) != 0;
+
+            next = ctx->next;
+            if (ctx->interrupt_enabled && ctx->callback != NULL &&
+                nhal_shm_pin_fires(ctx->trigger, was_high, is_high)) {
+                ctx->callback(ctx, ctx->user_data);
+            }
+        }
+        memcpy(bus->pin_snapshot, current, sizeof(current));
+        pthread_mutex_unlock(&bus->pin_lock);
+
+        nhal_shm_wait_change(&region->pins_seq, seq, &region->pins_waiters, UINT64_MAX);
+    }
+    return NULL;
+}
+
+static void nhal_shm_pin_unlink(struct nhal_pin_context *ctx)
+{
+    struct nhal_pin_context **link;
+
+    for (link = &ctx->bus->pin_list; *link != NULL; link = &(*link)->next) {
+        if (*link == ctx) {
+            *link = ctx->next;
+            ctx->next = NULL;
+            return;
+        }
+    }
+}
+
+nhal_result_t nhal_pin_init(struct nhal_pin_context *ctx)
+{
+    if (ctx == NULL || ctx->bus == NULL || ctx->bus->region == NULL || ctx->pin >= NHAL_SHM_PINS) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->initialized) {
+        return NHAL_ERR_ALREADY_INITIALIZED;
+    }
+    ctx->initialized = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_pin_deinit(struct nhal_pin_context *ctx)
+{
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->initialized) {
+        pthread_mutex_lock(&ctx->bus->pin_lock);
+        nhal_shm_pin_unlink(ctx);
+        pthread_mutex_unlock(&ctx->bus->pin_lock);
+    }
+    ctx->initialized = false;
+    ctx->interrupt_enabled = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_pin_set_config(struct nhal_pin_context *ctx, struct nhal_pin_config *config)
+{
+    if (ctx == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    return nhal_pin_set_direction(ctx, config->direction, config->pull_mode);
+}
+
+nhal_result_t nhal_pin_get_config(struct nhal_pin_context *ctx, struct nhal_pin_config *config)
+{
+    if (ctx == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    config->direction = ctx->direction;
+    config->pull_mode = ctx->pull_mode;
+    config->impl_config = NULL;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_pin_set_direction(struct nhal_pin_context *ctx, nhal_pin_dir_t direction, nhal_pin_pull_mode_t pull_mode)
+{
+    if (ctx == NULL || direction >= NHAL_PIN_DIR_TOTAL_NUM || pull_mode >= NHAL_PIN_PMODE_TOTAL_NUM) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!ctx->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    ctx->direction = direction;
+    ctx->pull_mode = pull_mode;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_pin_set_state(struct nhal_pin_context *ctx, nhal_pin_state_t value)
+{
+    struct nhal_shm_region *region;
+    uint32_t *word;
+    uint32_t mask;
+    uint32_t old;
+
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!ctx->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    if (ctx->direction != NHAL_PIN_DIR_OUTPUT) {
+        return NHAL_ERR_INVALID_CONFIG;
+    }
+    region = ctx->bus->region;
+    word = &region->pins[NHAL_SHM_PIN_WORD(ctx->pin)];
+    mask = NHAL_SHM_PIN_MASK(ctx->pin);
+
+    if (value == NHAL_PIN_HIGH) {
+        old = __atomic_fetch_or(word, mask, __ATOMIC_SEQ_CST);
+    } else {
+        old = __atomic_fetch_and(word, ~mask, __ATOMIC_SEQ_CST);
+    }
+    if (((old & mask) != 0) != (value == NHAL_PIN_HIGH)) {
+        __atomic_fetch_add(&region->pins_seq, 1, __ATOMIC_SEQ_CST);
+        nhal_shm_wake(&region->pins_seq, &region->pins_waiters);
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_pin_get_state(struct nhal_pin_context *ctx, nhal_pin_state_t *value)
+{
+    uint32_t word;
+
+    if (ctx == NULL || value == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!ctx->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    word = __atomic_load_n(&ctx->bus->region->pins[NHAL_SHM_PIN_WORD(ctx->pin)], __ATOMIC_ACQUIRE);
+    *value = (word & NHAL_SHM_PIN_MASK(ctx->pin)) != 0 ? NHAL_PIN_HIGH : NHAL_PIN_LOW;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_pin_set_interrupt_config(struct nhal_pin_context *ctx, nhal_pin_int_trigger_t trigger,
+                                            nhal_pin_callback_t callback, void *user_data)
+{
+    struct nhal_shm_bus *bus;
+    nhal_result_t result = NHAL_OK;
+
+    if (ctx == NULL || callback == NULL || trigger >= NHAL_PIN_INT_TRIGGER_TOTAL_NUM) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!ctx->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    bus = ctx->bus;
+
+    pthread_mutex_lock(&bus->pin_lock);
+    ctx->trigger = trigger;
+    ctx->callback = callback;
+    ctx->user_data = user_data;
+    nhal_shm_pin_unlink(ctx);
+    ctx->next = bus->pin_list;
+    bus->pin_list = ctx;
+
+    if (!bus->pin_thread_running) {
+        if (pthread_create(&bus->pin_thread, NULL, nhal_shm_pin_dispatcher, bus) == 0) {
+            bus->pin_thread_running = true;
+        } else {
+            nhal_shm_pin_unlink(ctx);
+            result = NHAL_ERR_OUT_OF_MEMORY;
+        }
+    }
+    pthread_mutex_unlock(&bus->pin_lock);
+    return result;
+}
+
+nhal_result_t nhal_pin_interrupt_enable(struct nhal_pin_context *ctx)
+{
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->callback == NULL) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+    pthread_mutex_lock(&ctx->bus->pin_lock);
+    ctx->interrupt_enabled = true;
+    pthread_mutex_unlock(&ctx->bus->pin_lock);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_pin_interrupt_disable(struct nhal_pin_context *ctx)
+{
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&ctx->bus->pin_lock);
+    ctx->interrupt_enabled = false;
+    pthread_mutex_unlock(&ctx->bus->pin_lock);
+    return NHAL_OK;
+}
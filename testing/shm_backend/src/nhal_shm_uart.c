@@ -0,0 +1,215 @@
+/**
+ * @file nhal_shm_uart.c
+ * @brief UART over shared-memory rings
+ */
+
+#include "nhal_shm_internal.h"
+
+#include <string.h>
+
+#define NHAL_SHM_RING_MASK (NHAL_SHM_UART_RING_SIZE - 1u)
+
+static struct nhal_shm_ring *nhal_shm_uart_tx_ring(struct nhal_uart_context *ctx)
+{
+    return &ctx->bus->region->uart[ctx->channel][ctx->side];
+}
+
+static struct nhal_shm_ring *nhal_shm_uart_rx_ring(struct nhal_uart_context *ctx)
+{
+    return &ctx->bus->region->uart[ctx->channel][ctx->side ^ 1u];
+}
+
+nhal_result_t nhal_uart_init(struct nhal_uart_context *ctx)
+{
+    if (ctx == NULL || ctx->bus == NULL || ctx->bus->region == NULL ||
+        ctx->channel >= NHAL_SHM_UART_CHANNELS || ctx->side > 1) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->initialized) {
+        return NHAL_ERR_ALREADY_INITIALIZED;
+    }
+    ctx->initialized = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_uart_deinit(struct nhal_uart_context *ctx)
+{
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (ctx->initialized) {
+        /* Stop driving RTS, the peer's next write no longer waits on this side */
+        __atomic_store_n(&nhal_shm_uart_rx_ring(ctx)->rts_level, 0, __ATOMIC_SEQ_CST);
+    }
+    ctx->initialized = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_uart_set_config(struct nhal_uart_context *ctx, struct nhal_uart_config *cfg)
+{
+    uint32_t rts_level = 0;
+
+    if (ctx == NULL || cfg == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!ctx->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    if (cfg->flow_control > NHAL_UART_FLOW_CONTROL_RTS_CTS || cfg->rx_fifo_threshold > NHAL_SHM_UART_RING_SIZE) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+    /* The idle timeout is counted in bit times */
+    if (cfg->rx_idle_timeout_bits != 0 && cfg->baudrate == 0) {
+        return NHAL_ERR_INVALID_CONFIG;
+    }
+    ctx->config = *cfg;
+    ctx->timeout_ms = cfg->impl_config != NULL ? cfg->impl_config->timeout_ms : NHAL_SHM_DEFAULT_TIMEOUT_MS;
+
+    if (cfg->flow_control == NHAL_UART_FLOW_CONTROL_RTS_CTS) {
+        rts_level = cfg->rx_fifo_threshold != 0 ? cfg->rx_fifo_threshold : NHAL_SHM_UART_RING_SIZE;
+    }
+    __atomic_store_n(&nhal_shm_uart_rx_ring(ctx)->rts_level, rts_level, __ATOMIC_SEQ_CST);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_uart_get_config(struct nhal_uart_context *ctx, struct nhal_uart_config *cfg)
+{
+    if (ctx == NULL || cfg == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    *cfg = ctx->config;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_uart_write(struct nhal_uart_context *ctx, const uint8_t *data, size_t len)
+{
+    struct nhal_shm_ring *ring;
+    uint64_t deadline;
+    uint32_t head;
+    bool cts;
+
+    if (ctx == NULL || (data == NULL && len != 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!ctx->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    ring = nhal_shm_uart_tx_ring(ctx);
+    deadline = nhal_shm_deadline(ctx->timeout_ms);
+    head = ring->head;
+    cts = ctx->config.flow_control == NHAL_UART_FLOW_CONTROL_RTS_CTS;
+
+    while (len != 0) {
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        uint32_t rts_level = __atomic_load_n(&ring->rts_level, __ATOMIC_ACQUIRE);
+        uint32_t level = head - tail;
+        uint32_t offset = head & NHAL_SHM_RING_MASK;
+        uint32_t space;
+        uint32_t chunk;
+
+        if (cts && rts_level != 0) {
+            /* Hold off while the receiver keeps RTS deasserted */
+            if (level >= rts_level) {
+                if (!nhal_shm_wait_change(&ring->tail, tail, &ring->tail_waiters, deadline)) {
+                    return NHAL_ERR_TIMEOUT;
+                }
+                continue;
+            }
+            space = rts_level - level;
+        } else {
+            /* Nothing holds the transmitter back: what the receiver has no room for is lost */
+            space = NHAL_SHM_UART_RING_SIZE - level;
+            if (space < len) {
+                __atomic_add_fetch(&ring->overruns, (uint32_t)(len - space), __ATOMIC_RELAXED);
+                len = space;
+                if (len == 0) {
+                    break;
+                }
+            }
+        }
+        chunk = space < len ? space : (uint32_t)len;
+        if (chunk > NHAL_SHM_UART_RING_SIZE - offset) {
+            chunk = NHAL_SHM_UART_RING_SIZE - offset;
+        }
+        memcpy(&ring->data[offset], data, chunk);
+        head += chunk;
+        data += chunk;
+        len -= chunk;
+
+        __atomic_store_n(&ring->head, head, __ATOMIC_SEQ_CST);
+        nhal_shm_wake(&ring->head, &ring->head_waiters);
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_uart_read(struct nhal_uart_context *ctx, uint8_t *data, size_t len)
+{
+    struct nhal_shm_ring *ring;
+    uint64_t deadline;
+    uint64_t idle_ns = 0;
+    size_t received = 0;
+    uint32_t tail;
+
+    if (ctx == NULL || (data == NULL && len != 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+    if (!ctx->initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+    ring = nhal_shm_uart_rx_ring(ctx);
+    deadline = nhal_shm_deadline(ctx->timeout_ms);
+    tail = ring->tail;
+    ctx->last_read_len = 0;
+    if (ctx->config.rx_idle_timeout_bits != 0) {
+        idle_ns = (uint64_t)ctx->config.rx_idle_timeout_bits * 1000000000u / ctx->config.baudrate;
+    }
+
+    while (len != 0) {
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint32_t available = head - tail;
+        uint32_t offset = tail & NHAL_SHM_RING_MASK;
+        uint32_t chunk;
+
+        if (available == 0) {
+            uint64_t wait_until = deadline;
+            bool idle = false;
+
+            /* Once a frame has started, a silent line ends it before the timeout does */
+            if (idle_ns != 0 && received != 0) {
+                uint64_t idle_deadline = nhal_shm_now_ns() + idle_ns;
+                if (idle_deadline < deadline) {
+                    wait_until = idle_deadline;
+                    idle = true;
+                }
+            }
+            if (!nhal_shm_wait_change(&ring->head, head, &ring->head_waiters, wait_until)) {
+                return idle ? NHAL_OK : NHAL_ERR_TIMEOUT;
+            }
+            continue;
+        }
+        chunk = available < len ? available : (uint32_t)len;
+        if (chunk > NHAL_SHM_UART_RING_SIZE - offset) {
+            chunk = NHAL_SHM_UART_RING_SIZE - offset;
+        }
+        memcpy(data, &ring->data[offset], chunk);
+        tail += chunk;
+        data += chunk;
+        len -= chunk;
+        received += chunk;
+        ctx->last_read_len = received;
+
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_SEQ_CST);
+        nhal_shm_wake(&ring->tail, &ring->tail_waiters);
+    }
+    return NHAL_OK;
+}
+
+uint32_t nhal_shm_uart_overruns(const struct nhal_uart_context *ctx)
+{
+    return __atomic_load_n(&ctx->bus->region->uart[ctx->channel][ctx->side ^ 1u].overruns, __ATOMIC_RELAXED);
+}
+
+size_t nhal_shm_uart_last_read_len(const struct nhal_uart_context *ctx)
+{
+    return ctx->last_read_len;
+}
@@ -0,0 +1,350 @@
+/**
+ * @file nhal_shm_test.c
+ * @brief Two-process I2C, pin and timeout checks of the shared-memory backend
+ *
+ * A target process serves a 256-byte register file on one I2C bus and
+ * raises a pin once it is serving; the test process, a master, checks:
+ * - register writes and reads through every master call, including
+ *   nhal_i2c_master_perform_transfer() with several STOPs in one list;
+ * - an address nobody serves is NHAL_ERR_NO_RESPONSE;
+ * - a target slower than the master's timeout is NHAL_ERR_TIMEOUT, and the
+ *   bus works again once the target is done;
+ * - the default timeout applies both before set_config and after a
+ *   set_config without impl_config, on I2C and UART alike;
+ * - a UART read with rx_idle_timeout_bits ends short once the line has been
+ *   idle that many bit times, but still waits the timeout for a first byte;
+ * - the pin interrupt thread of a handle stops on nhal_shm_bus_close().
+ * Exits non-zero on any failure.
+ */
+
+#include "nhal_shm.h"
+#include "nhal_i2c_transfer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define TARGET_ADDRESS      0x50
+#define READY_PIN           5
+#define SLOW_REGISTER       0xEE    /* Answered after SLOW_MS */
+#define QUIT_REGISTER       0xFF
+#define SLOW_MS             300u
+
+static char bus_name[64];
+static int failures;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("FAIL line %d: %s\n", __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static uint64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static nhal_i2c_address_t address7(uint8_t value)
+{
+    nhal_i2c_address_t address;
+    address.type = NHAL_I2C_7BIT_ADDR;
+    address.addr.address_7bit = value;
+    return address;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Target process                                                            */
+/* ------------------------------------------------------------------------- */
+
+struct register_file {
+    uint8_t regs[256];
+    bool slow;
+    bool quit;
+};
+
+/* First written byte selects the register, the rest is written from there; reads continue from it */
+static nhal_result_t serve_registers(void *user_data, const uint8_t *write_data, size_t write_len,
+                                     uint8_t *read_data, size_t read_len)
+{
+    struct register_file *file = user_data;
+    uint8_t reg = write_len != 0 ? write_data[0] : 0;
+    size_t i;
+
+    file->slow = reg == SLOW_REGISTER;
+    file->quit = reg == QUIT_REGISTER;
+    if (file->slow) {
+        usleep(SLOW_MS * 1000u);
+    }
+    for (i = 1; i < write_len; i++) {
+        file->regs[(uint8_t)(reg + i - 1)] = write_data[i];
+    }
+    for (i = 0; i < read_len; i++) {
+        read_data[i] = file->regs[(uint8_t)(reg + i)];
+    }
+    return NHAL_OK;
+}
+
+static int target(void)
+{
+    struct nhal_shm_bus bus;
+    struct nhal_pin_context ready = NHAL_SHM_PIN_CONTEXT(&bus, READY_PIN);
+    struct register_file file;
+    unsigned abandoned = 0;
+
+    memset(&file, 0, sizeof(file));
+    if (nhal_shm_bus_open(&bus, bus_name) != NHAL_OK || nhal_pin_init(&ready) != NHAL_OK ||
+        nhal_pin_set_direction(&ready, NHAL_PIN_DIR_OUTPUT, NHAL_PIN_PMODE_NONE) != NHAL_OK) {
+        printf("FAIL: target setup\n");
+        return 1;
+    }
+    nhal_pin_set_state(&ready, NHAL_PIN_HIGH);
+    while (!file.quit) {
+        nhal_result_t result = nhal_shm_i2c_target_serve(&bus, 0, address7(TARGET_ADDRESS), serve_registers, &file,
+                                                         5000);
+        if (result == NHAL_ERR_TIMEOUT && file.slow) {
+            /* The master gave up on the slow register, as expected */
+            file.slow = false;
+            abandoned++;
+            continue;
+        }
+        if (result != NHAL_OK) {
+            printf("FAIL: target serve returned %d\n", (int)result);
+            return 1;
+        }
+    }
+    nhal_pin_set_state(&ready, NHAL_PIN_LOW);
+    nhal_shm_bus_close(&bus);
+    return abandoned == 1 ? 0 : 2;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Master process                                                            */
+/* ------------------------------------------------------------------------- */
+
+static void on_ready(struct nhal_pin_context *pin_ctx, void *user_data)
+{
+    (void)pin_ctx;
+    __atomic_store_n((bool *)user_data, true, __ATOMIC_RELEASE);
+}
+
+static void check_transfers(struct nhal_i2c_context *i2c)
+{
+    const uint8_t write_regs[] = { 0x10, 0xA0, 0xA1, 0xA2, 0xA3 };
+    const uint8_t reg10 = 0x10;
+    const uint8_t reg12 = 0x12;
+    const uint8_t set20[] = { 0x20, 0x5A };
+    const uint8_t reg20 = 0x20;
+    uint8_t first[2];
+    uint8_t second[2];
+    uint8_t value = 0;
+    nhal_i2c_transfer_op_t ops[6];
+
+    CHECK(nhal_i2c_master_write(i2c, address7(TARGET_ADDRESS), write_regs, sizeof(write_regs)) == NHAL_OK);
+    CHECK(nhal_i2c_master_write_read_reg(i2c, address7(TARGET_ADDRESS), &reg12, 1, first, 2) == NHAL_OK);
+    CHECK(first[0] == 0xA2 && first[1] == 0xA3);
+
+    /* Three transactions in one list: register read, register write, register read in two parts */
+    memset(ops, 0, sizeof(ops));
+    ops[0].type = NHAL_I2C_WRITE_OP;
+    ops[0].flags = NHAL_I2C_TRANSFER_MSG_NO_STOP;
+    ops[0].write.bytes = &reg10;
+    ops[0].write.length = 1;
+    ops[1].type = NHAL_I2C_READ_OP;
+    ops[1].read.buffer = first;
+    ops[1].read.length = 2;
+    ops[2].type = NHAL_I2C_WRITE_OP;
+    ops[2].write.bytes = set20;
+    ops[2].write.length = sizeof(set20);
+    ops[3].type = NHAL_I2C_WRITE_OP;
+    ops[3].flags = NHAL_I2C_TRANSFER_MSG_NO_STOP;
+    ops[3].write.bytes = &reg20;
+    ops[3].write.length = 1;
+    ops[4].type = NHAL_I2C_READ_OP;
+    ops[4].flags = NHAL_I2C_TRANSFER_MSG_NO_STOP;
+    ops[4].read.buffer = &value;
+    ops[4].read.length = 1;
+    ops[5].type = NHAL_I2C_READ_OP;
+    ops[5].flags = NHAL_I2C_TRANSFER_MSG_NO_START;
+    ops[5].read.buffer = second;
+    ops[5].read.length = 2;
+    CHECK(nhal_i2c_master_perform_transfer(i2c, address7(TARGET_ADDRESS), ops, 6) == NHAL_OK);
+    CHECK(first[0] == 0xA0 && first[1] == 0xA1);
+    CHECK(value == 0x5A);
+    CHECK(second[0] == 0x00 && second[1] == 0x00);
+
+    /* The mailbox has one write phase per transaction */
+    ops[1].flags = NHAL_I2C_TRANSFER_MSG_NO_STOP;
+    CHECK(nhal_i2c_master_perform_transfer(i2c, address7(TARGET_ADDRESS), ops, 3) == NHAL_ERR_UNSUPPORTED);
+}
+
+static void check_timeouts(struct nhal_i2c_context *i2c, struct nhal_uart_context *uart)
+{
+    struct nhal_i2c_impl_config i2c_impl = { 1000 };
+    struct nhal_uart_impl_config uart_impl = { 20 };
+    struct nhal_i2c_config i2c_cfg;
+    struct nhal_uart_config uart_cfg;
+    const uint8_t slow = SLOW_REGISTER;
+    const uint8_t reg12 = 0x12;
+    uint8_t data[2];
+    uint64_t start;
+    uint64_t elapsed;
+
+    /* Nobody serves this address: withdrawn after the default timeout */
+    start = now_ms();
+    CHECK(nhal_i2c_master_write(i2c, address7(0x51), &reg12, 1) == NHAL_ERR_NO_RESPONSE);
+    elapsed = now_ms() - start;
+    CHECK(elapsed >= NHAL_SHM_DEFAULT_TIMEOUT_MS && elapsed < 2 * NHAL_SHM_DEFAULT_TIMEOUT_MS);
+
+    /* Taken by the target but answered too late */
+    start = now_ms();
+    CHECK(nhal_i2c_master_write_read_reg(i2c, address7(TARGET_ADDRESS), &slow, 1, data, 1) == NHAL_ERR_TIMEOUT);
+    elapsed = now_ms() - start;
+    CHECK(elapsed < SLOW_MS);
+
+    /* With a longer timeout the next transaction waits for the target to finish */
+    memset(&i2c_cfg, 0, sizeof(i2c_cfg));
+    i2c_cfg.impl_config = &i2c_impl;
+    CHECK(nhal_i2c_master_set_config(i2c, &i2c_cfg) == NHAL_OK);
+    CHECK(nhal_i2c_master_write_read_reg(i2c, address7(TARGET_ADDRESS), &reg12, 1, data, 2) == NHAL_OK);
+    CHECK(data[0] == 0xA2 && data[1] == 0xA3);
+
+    /* No impl_config: back to the default */
+    i2c_cfg.impl_config = NULL;
+    CHECK(nhal_i2c_master_set_config(i2c, &i2c_cfg) == NHAL_OK);
+    start = now_ms();
+    CHECK(nhal_i2c_master_write(i2c, address7(0x51), &reg12, 1) == NHAL_ERR_NO_RESPONSE);
+    elapsed = now_ms() - start;
+    CHECK(elapsed >= NHAL_SHM_DEFAULT_TIMEOUT_MS && elapsed < 2 * NHAL_SHM_DEFAULT_TIMEOUT_MS);
+
+    /* UART: same default before and after set_config */
+    start = now_ms();
+    CHECK(nhal_uart_read(uart, data, 1) == NHAL_ERR_TIMEOUT);
+    elapsed = now_ms() - start;
+    CHECK(elapsed >= NHAL_SHM_DEFAULT_TIMEOUT_MS && elapsed < 2 * NHAL_SHM_DEFAULT_TIMEOUT_MS);
+
+    memset(&uart_cfg, 0, sizeof(uart_cfg));
+    uart_cfg.baudrate = 115200;
+    uart_cfg.parity = NHAL_UART_PARITY_NONE;
+    uart_cfg.stop_bits = NHAL_UART_STOP_BITS_1;
+    uart_cfg.data_bits = NHAL_UART_DATA_BITS_8;
+    uart_cfg.impl_config = &uart_impl;
+    CHECK(nhal_uart_set_config(uart, &uart_cfg) == NHAL_OK);
+    start = now_ms();
+    CHECK(nhal_uart_read(uart, data, 1) == NHAL_ERR_TIMEOUT);
+    CHECK(now_ms() - start < NHAL_SHM_DEFAULT_TIMEOUT_MS);
+
+    uart_cfg.impl_config = NULL;
+    CHECK(nhal_uart_set_config(uart, &uart_cfg) == NHAL_OK);
+    start = now_ms();
+    CHECK(nhal_uart_read(uart, data, 1) == NHAL_ERR_TIMEOUT);
+    elapsed = now_ms() - start;
+    CHECK(elapsed >= NHAL_SHM_DEFAULT_TIMEOUT_MS && elapsed < 2 * NHAL_SHM_DEFAULT_TIMEOUT_MS);
+}
+
+static void check_idle_timeout(struct nhal_shm_bus *bus)
+{
+    struct nhal_uart_impl_config impl = { 500 };
+    struct nhal_uart_context tx = NHAL_SHM_UART_CONTEXT(bus, 2, 0);
+    struct nhal_uart_context rx = NHAL_SHM_UART_CONTEXT(bus, 2, 1);
+    struct nhal_uart_config cfg;
+    const uint8_t frame[] = { 1, 2, 3, 4, 5 };
+    uint8_t data[16];
+    uint64_t start;
+    uint64_t elapsed;
+
+    CHECK(nhal_uart_init(&tx) == NHAL_OK && nhal_uart_init(&rx) == NHAL_OK);
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.parity = NHAL_UART_PARITY_NONE;
+    cfg.stop_bits = NHAL_UART_STOP_BITS_1;
+    cfg.data_bits = NHAL_UART_DATA_BITS_8;
+    cfg.rx_idle_timeout_bits = 1000;
+    cfg.impl_config = &impl;
+    CHECK(nhal_uart_set_config(&rx, &cfg) == NHAL_ERR_INVALID_CONFIG);
+
+    /* 1000 bit times at 9600 baud: 104 ms */
+    cfg.baudrate = 9600;
+    CHECK(nhal_uart_set_config(&rx, &cfg) == NHAL_OK);
+
+    /* Five bytes of a sixteen-byte read, then silence */
+    CHECK(nhal_uart_write(&tx, frame, sizeof(frame)) == NHAL_OK);
+    start = now_ms();
+    CHECK(nhal_uart_read(&rx, data, sizeof(data)) == NHAL_OK);
+    elapsed = now_ms() - start;
+    CHECK(nhal_shm_uart_last_read_len(&rx) == sizeof(frame));
+    CHECK(memcmp(data, frame, sizeof(frame)) == 0);
+    CHECK(elapsed >= 100 && elapsed < impl.timeout_ms);
+
+    /* A read the pending bytes fill returns without waiting */
+    CHECK(nhal_uart_write(&tx, frame, sizeof(frame)) == NHAL_OK);
+    start = now_ms();
+    CHECK(nhal_uart_read(&rx, data, sizeof(frame)) == NHAL_OK);
+    CHECK(now_ms() - start < 100);
+    CHECK(nhal_shm_uart_last_read_len(&rx) == sizeof(frame));
+
+    /* Nothing received yet: the idle time does not start, the timeout applies */
+    start = now_ms();
+    CHECK(nhal_uart_read(&rx, data, sizeof(data)) == NHAL_ERR_TIMEOUT);
+    elapsed = now_ms() - start;
+    CHECK(nhal_shm_uart_last_read_len(&rx) == 0);
+    CHECK(elapsed >= impl.timeout_ms && elapsed < 2 * impl.timeout_ms);
+
+    nhal_uart_deinit(&tx);
+    nhal_uart_deinit(&rx);
+}
+
+int main(void)
+{
+    struct nhal_shm_bus bus;
+    struct nhal_i2c_context i2c = NHAL_SHM_I2C_CONTEXT(&bus, 0);
+    struct nhal_uart_context uart = NHAL_SHM_UART_CONTEXT(&bus, 0, 0);
+    struct nhal_pin_context ready = NHAL_SHM_PIN_CONTEXT(&bus, READY_PIN);
+    const uint8_t quit = QUIT_REGISTER;
+    bool target_ready = false;
+    uint64_t start;
+    int status = 0;
+    pid_t pid;
+
+    snprintf(bus_name, sizeof(bus_name), "shm_test_%d", (int)getpid());
+    nhal_shm_bus_unlink(bus_name);
+    if (nhal_shm_bus_open(&bus, bus_name) != NHAL_OK || nhal_i2c_master_init(&i2c) != NHAL_OK ||
+        nhal_uart_init(&uart) != NHAL_OK || nhal_pin_init(&ready) != NHAL_OK ||
+        nhal_pin_set_interrupt_config(&ready, NHAL_PIN_INT_TRIGGER_RISING_EDGE, on_ready, &target_ready) != NHAL_OK ||
+        nhal_pin_interrupt_enable(&ready) != NHAL_OK) {
+        printf("FAIL: bus setup\n");
+        return 1;
+    }
+
+    fflush(stdout);
+    pid = fork();
+    if (pid < 0) {
+        return 1;
+    }
+    if (pid == 0) {
+        _exit(target());
+    }
+
+    /* The target raises the pin once it serves: seen through this process's interrupt thread */
+    start = now_ms();
+    while (!__atomic_load_n(&target_ready, __ATOMIC_ACQUIRE) && now_ms() - start < 5000) {
+        usleep(1000);
+    }
+    CHECK(target_ready);
+
+    check_transfers(&i2c);
+    check_timeouts(&i2c, &uart);
+    check_idle_timeout(&bus);
+
+    CHECK(nhal_i2c_master_write(&i2c, address7(TARGET_ADDRESS), &quit, 1) == NHAL_OK);
+    CHECK(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    /* Joins the interrupt thread: hangs here if it misses the stop request */
+    nhal_shm_bus_close(&bus);
+    nhal_shm_bus_unlink(bus_name);
+    printf("%s\n", failures == 0 ? "all checks passed" : "checks failed");
+    return failures != 0;
+}